@@ -62,6 +62,8 @@
 #include "vtkPVPluginLoader.h"
 #include "vtkPVPluginTracker.h"
 #include "vtkPVPluginsInformation.h"
+#include "vtkPVProfiler.h"
+#include "vtkPVProfilingInformation.h"
 #include "vtkPVProgressHandler.h"
 #include "vtkPVPythonModule.h"
 #include "vtkPVPythonPluginInterface.h"
@@ -176,6 +178,8 @@ int main(int, char**)
   PRINT_SELF(vtkPVPluginLoader);
   PRINT_SELF(vtkPVPluginTracker);
   PRINT_SELF(vtkPVPluginsInformation);
+  PRINT_SELF(vtkPVProfiler);
+  PRINT_SELF(vtkPVProfilingInformation);
   PRINT_SELF(vtkPVProgressHandler);
   //PRINT_SELF(vtkPVPythonModule);
   //PRINT_SELF(vtkPVPythonPluginInterface);
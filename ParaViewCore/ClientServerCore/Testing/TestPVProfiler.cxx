@@ -0,0 +1,174 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVProfiler.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the events recorded by vtkPVProfiler, and that
+// vtkPVProfilingInformation gathers, serializes and merges them unchanged.
+
+#include "vtkClientServerStream.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkPVProfiler.h"
+#include "vtkPVProfilingInformation.h"
+#include "vtkSmartPointer.h"
+
+#include <string>
+
+#define TEST_ASSERT(cond) \
+  if (!(cond)) \
+    { \
+    cerr << "Failed (line " << __LINE__ << "): " << #cond << endl; \
+    return 1; \
+    }
+
+//----------------------------------------------------------------------------
+static bool SameEvent(vtkPVProfilingInformation* a, int i,
+  vtkPVProfilingInformation* b, int j)
+{
+  return a->GetEventProcessId(i) == b->GetEventProcessId(j) &&
+    a->GetEventProcessType(i) == b->GetEventProcessType(j) &&
+    a->GetEventCategory(i) == b->GetEventCategory(j) &&
+    std::string(a->GetEventName(i)) == b->GetEventName(j) &&
+    a->GetEventStartTime(i) == b->GetEventStartTime(j) &&
+    a->GetEventEndTime(i) == b->GetEventEndTime(j) &&
+    a->GetEventProxyId(i) == b->GetEventProxyId(j) &&
+    a->GetEventBytes(i) == b->GetEventBytes(j);
+}
+
+//----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  // Nothing is recorded until recording is turned on.
+  TEST_ASSERT(!vtkPVProfiler::GetEnabled());
+  vtkPVProfiler::StartEvent(vtkPVProfiler::RENDERING, "Ignored");
+  vtkPVProfiler::EndEvent(1);
+  vtkPVProfiler::AddEvent(vtkPVProfiler::OTHER, "Ignored", 1.0, 2.0);
+  TEST_ASSERT(vtkPVProfiler::GetNumberOfEvents() == 0);
+
+  // Nested events are recorded when they end, with the bytes given then.
+  vtkPVProfiler::SetEnabled(true);
+  vtkPVProfiler::StartEvent(vtkPVProfiler::FILTER_EXECUTE, "Outer", 12);
+  vtkPVProfiler::StartEvent(vtkPVProfiler::COMPRESSION, "Inner", 34);
+  vtkPVProfiler::EndEvent(100);
+    {
+    vtkPVProfilerScope scope(vtkPVProfiler::TRANSMISSION, "Scope");
+    scope.Bytes = 200;
+    }
+  vtkPVProfiler::EndEvent(300);
+  TEST_ASSERT(vtkPVProfiler::GetNumberOfEvents() == 3);
+  TEST_ASSERT(std::string(vtkPVProfiler::GetEventName(0)) == "Inner");
+  TEST_ASSERT(vtkPVProfiler::GetEventCategory(0) == vtkPVProfiler::COMPRESSION);
+  TEST_ASSERT(vtkPVProfiler::GetEventProxyId(0) == 34);
+  TEST_ASSERT(vtkPVProfiler::GetEventBytes(0) == 100);
+  TEST_ASSERT(std::string(vtkPVProfiler::GetEventName(1)) == "Scope");
+  TEST_ASSERT(vtkPVProfiler::GetEventCategory(1) ==
+    vtkPVProfiler::TRANSMISSION);
+  TEST_ASSERT(vtkPVProfiler::GetEventBytes(1) == 200);
+  TEST_ASSERT(std::string(vtkPVProfiler::GetEventName(2)) == "Outer");
+  TEST_ASSERT(vtkPVProfiler::GetEventCategory(2) ==
+    vtkPVProfiler::FILTER_EXECUTE);
+  TEST_ASSERT(vtkPVProfiler::GetEventProxyId(2) == 12);
+  TEST_ASSERT(vtkPVProfiler::GetEventBytes(2) == 300);
+  TEST_ASSERT(vtkPVProfiler::GetEventStartTime(2) <=
+    vtkPVProfiler::GetEventStartTime(0));
+  TEST_ASSERT(vtkPVProfiler::GetEventStartTime(0) <=
+    vtkPVProfiler::GetEventEndTime(0));
+  TEST_ASSERT(vtkPVProfiler::GetEventEndTime(1) <=
+    vtkPVProfiler::GetEventEndTime(2));
+
+  // Out of range accesses.
+  TEST_ASSERT(vtkPVProfiler::GetEventName(3) == NULL);
+  TEST_ASSERT(vtkPVProfiler::GetEventBytes(-1) == 0);
+  TEST_ASSERT(std::string(vtkPVProfiler::GetCategoryAsString(
+        vtkPVProfiler::DATA_DELIVERY)) == "data_delivery");
+  TEST_ASSERT(std::string(vtkPVProfiler::GetCategoryAsString(
+        vtkPVProfiler::NUMBER_OF_CATEGORIES)) == "other");
+
+  // Events started before recording is turned off are discarded.
+  vtkPVProfiler::StartEvent(vtkPVProfiler::RENDERING, "Discarded");
+  vtkPVProfiler::SetEnabled(false);
+  vtkPVProfiler::SetEnabled(true);
+  vtkPVProfiler::EndEvent(1);
+  TEST_ASSERT(vtkPVProfiler::GetNumberOfEvents() == 3);
+
+  // The oldest events are dropped beyond the maximum.
+  vtkPVProfiler::ClearEvents();
+  TEST_ASSERT(vtkPVProfiler::GetNumberOfEvents() == 0);
+  vtkPVProfiler::SetMaximumNumberOfEvents(3);
+  const char* names[] = { "E0", "E1", "E2", "E3", "E4" };
+  for (int cc = 0; cc < 5; cc++)
+    {
+    vtkPVProfiler::AddEvent(vtkPVProfiler::COMPOSITING, names[cc],
+      cc, cc + 0.5, cc + 1, 10 * cc);
+    }
+  TEST_ASSERT(vtkPVProfiler::GetNumberOfEvents() == 3);
+  for (int cc = 0; cc < 3; cc++)
+    {
+    TEST_ASSERT(std::string(vtkPVProfiler::GetEventName(cc)) == names[cc + 2]);
+    TEST_ASSERT(vtkPVProfiler::GetEventStartTime(cc) == cc + 2);
+    TEST_ASSERT(vtkPVProfiler::GetEventEndTime(cc) == cc + 2.5);
+    TEST_ASSERT(vtkPVProfiler::GetEventProxyId(cc) ==
+      static_cast<unsigned int>(cc + 3));
+    TEST_ASSERT(vtkPVProfiler::GetEventBytes(cc) == 10 * (cc + 2));
+    }
+  vtkPVProfiler::SetMaximumNumberOfEvents(2);
+  TEST_ASSERT(vtkPVProfiler::GetNumberOfEvents() == 2);
+  TEST_ASSERT(std::string(vtkPVProfiler::GetEventName(0)) == "E3");
+
+  // Gathering copies the events, then clears them when asked to.
+  vtkSmartPointer<vtkPVProfilingInformation> info =
+    vtkSmartPointer<vtkPVProfilingInformation>::New();
+  info->CopyFromObject(NULL);
+  TEST_ASSERT(info->GetNumberOfEvents() == 2);
+  TEST_ASSERT(vtkPVProfiler::GetNumberOfEvents() == 2);
+  info->ClearEventsOn();
+  info->CopyFromObject(NULL);
+  TEST_ASSERT(info->GetNumberOfEvents() == 2);
+  TEST_ASSERT(vtkPVProfiler::GetNumberOfEvents() == 0);
+  TEST_ASSERT(std::string(info->GetEventName(1)) == "E4");
+  TEST_ASSERT(info->GetEventCategory(1) == vtkPVProfiler::COMPOSITING);
+  TEST_ASSERT(info->GetEventProcessId(0) == 0);
+  TEST_ASSERT(info->GetEventProcessId(2) == -1);
+
+  // The parameters and the events go through streams unchanged.
+  vtkMultiProcessStream parameters;
+  info->CopyParametersToStream(parameters);
+  vtkSmartPointer<vtkPVProfilingInformation> copy =
+    vtkSmartPointer<vtkPVProfilingInformation>::New();
+  copy->CopyParametersFromStream(parameters);
+  TEST_ASSERT(copy->GetClearEvents() == 1);
+
+  vtkClientServerStream stream;
+  info->CopyToStream(&stream);
+  copy->CopyFromStream(&stream);
+  TEST_ASSERT(copy->GetNumberOfEvents() == 2);
+  for (int cc = 0; cc < 2; cc++)
+    {
+    TEST_ASSERT(SameEvent(info, cc, copy, cc));
+    }
+
+  // Merging appends the events of the other process.
+  vtkPVProfiler::AddEvent(vtkPVProfiler::DATA_DELIVERY, "Last", 5.0, 6.0,
+    7, 8);
+  vtkSmartPointer<vtkPVProfilingInformation> other =
+    vtkSmartPointer<vtkPVProfilingInformation>::New();
+  other->CopyFromObject(NULL);
+  copy->AddInformation(other);
+  TEST_ASSERT(copy->GetNumberOfEvents() == 3);
+  TEST_ASSERT(SameEvent(copy, 0, info, 0));
+  TEST_ASSERT(SameEvent(copy, 2, other, 0));
+  TEST_ASSERT(copy->GetEventBytes(2) == 8);
+
+  vtkPVProfiler::SetEnabled(false);
+  vtkPVProfiler::ClearEvents();
+  return 0;
+}
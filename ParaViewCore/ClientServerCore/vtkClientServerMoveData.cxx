@@ -19,6 +19,7 @@
 #include "vtkDataObjectTypes.h"
 #include "vtkGenericDataObjectReader.h"
 #include "vtkGenericDataObjectWriter.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiBlockDataSet.h"
@@ -26,11 +27,13 @@
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
+#include "vtkPVProfiler.h"
 #include "vtkPVSession.h"
 #include "vtkSelection.h"
 #include "vtkSelectionSerializer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnstructuredGrid.h"
+#include "vtk_zlib.h"
 
 #include <vtksys/ios/sstream>
 
@@ -49,6 +52,7 @@ vtkClientServerMoveData::vtkClientServerMoveData()
   this->WholeExtent[5] = -1;
   this->Controller = 0;
   this->ProcessType = AUTO;
+  this->CompressionLevel = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -227,10 +231,124 @@ int vtkClientServerMoveData::SendData(vtkDataObject* input,
       }
     }
 
+  if (this->CompressionLevel > 0)
+    {
+    return this->SendCompressedData(input, controller);
+    }
+
+  vtkPVProfilerScope profile(vtkPVProfiler::TRANSMISSION,
+    "Server sending to client");
+  if (input && vtkPVProfiler::GetEnabled())
+    {
+    profile.Bytes = static_cast<vtkIdType>(input->GetActualMemorySize())*1024;
+    }
   return controller->Send(input, 1,
     vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
 }
 
+//-----------------------------------------------------------------------------
+int vtkClientServerMoveData::SendCompressedData(vtkDataObject* input,
+  vtkMultiProcessController* controller)
+{
+  // The first message holds the serialized and compressed lengths. Both are 0
+  // when the data object follows uncompressed.
+  vtkIdType lengths[2] = {0, 0};
+  if (!input || input->IsA("vtkImageData"))
+    {
+    controller->Send(lengths, 2, 1,
+      vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    return controller->Send(input, 1,
+      vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    }
+
+  vtkGenericDataObjectWriter* writer = vtkGenericDataObjectWriter::New();
+  vtkDataObject* copy = input->NewInstance();
+  copy->ShallowCopy(input);
+  writer->SetInputData(copy);
+  copy->Delete();
+  writer->SetFileTypeToBinary();
+  writer->WriteToOutputStringOn();
+  writer->Write();
+
+  vtkPVProfiler::StartEvent(vtkPVProfiler::COMPRESSION, "Zlib compress");
+  uLongf compressed_length = compressBound(writer->GetOutputStringLength());
+  char* buffer = new char[compressed_length];
+  int result = compress2(reinterpret_cast<Bytef*>(buffer), &compressed_length,
+    reinterpret_cast<const Bytef*>(writer->GetOutputString()),
+    writer->GetOutputStringLength(), this->CompressionLevel);
+  vtkPVProfiler::EndEvent(writer->GetOutputStringLength());
+  lengths[0] = writer->GetOutputStringLength();
+  lengths[1] = static_cast<vtkIdType>(compressed_length);
+  writer->Delete();
+
+  if (result != Z_OK)
+    {
+    vtkErrorMacro("Failed to compress the data (zlib error " << result
+      << "), sending it uncompressed.");
+    delete [] buffer;
+    lengths[0] = lengths[1] = 0;
+    controller->Send(lengths, 2, 1,
+      vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    return controller->Send(input, 1,
+      vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    }
+
+  vtkPVProfilerScope profile(vtkPVProfiler::TRANSMISSION,
+    "Server sending to client");
+  profile.Bytes = lengths[1];
+  controller->Send(lengths, 2, 1,
+    vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  int status = controller->Send(buffer, lengths[1], 1,
+    vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  delete [] buffer;
+  return status;
+}
+
+//-----------------------------------------------------------------------------
+vtkDataObject* vtkClientServerMoveData::ReceiveCompressedData(
+  vtkMultiProcessController* controller)
+{
+  vtkIdType lengths[2] = {0, 0};
+  controller->Receive(lengths, 2, 1,
+    vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+  if (lengths[1] == 0)
+    {
+    return controller->ReceiveDataObject(
+      1, vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+    }
+
+  char* buffer = new char[lengths[1]];
+  controller->Receive(buffer, lengths[1], 1,
+    vtkClientServerMoveData::TRANSMIT_DATA_OBJECT);
+
+  vtkCharArray* serialized = vtkCharArray::New();
+  serialized->SetNumberOfTuples(lengths[0]);
+  uLongf length = static_cast<uLongf>(lengths[0]);
+  vtkPVProfiler::StartEvent(vtkPVProfiler::COMPRESSION, "Zlib uncompress");
+  int result = uncompress(reinterpret_cast<Bytef*>(serialized->GetPointer(0)),
+    &length, reinterpret_cast<const Bytef*>(buffer), lengths[1]);
+  vtkPVProfiler::EndEvent(lengths[0]);
+  delete [] buffer;
+  if (result != Z_OK || static_cast<vtkIdType>(length) != lengths[0])
+    {
+    vtkErrorMacro("Failed to uncompress the data received (zlib error "
+      << result << ").");
+    serialized->Delete();
+    return NULL;
+    }
+
+  vtkGenericDataObjectReader* reader = vtkGenericDataObjectReader::New();
+  reader->ReadFromInputStringOn();
+  reader->SetInputArray(serialized);
+  reader->Update();
+  serialized->Delete();
+
+  vtkDataObject* data = reader->GetOutputDataObject(0)->NewInstance();
+  data->ShallowCopy(reader->GetOutputDataObject(0));
+  reader->Delete();
+  return data;
+}
+
 //-----------------------------------------------------------------------------
 vtkDataObject* vtkClientServerMoveData::ReceiveData(vtkMultiProcessController* controller)
 {
@@ -257,6 +375,10 @@ vtkDataObject* vtkClientServerMoveData::ReceiveData(vtkMultiProcessController* c
     delete[] xml;
     data = sel;
     }
+  else if (this->CompressionLevel > 0)
+    {
+    data = this->ReceiveCompressedData(controller);
+    }
   else
     {
     data = controller->ReceiveDataObject(
@@ -278,5 +400,6 @@ void vtkClientServerMoveData::PrintSelf(ostream& os, vtkIndent indent)
     << this->WholeExtent[5] << endl;
   os << indent << "OutputDataType: " << this->OutputDataType << endl;
   os << indent << "ProcessType: " << this->ProcessType << endl;
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
   os << indent << "Controller: " << this->Controller << endl;
 }
@@ -68,6 +68,14 @@ public:
   // controller is obtained from the active session.
   void SetController(vtkMultiProcessController*);
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  // Description:
+  // When non-zero, the data is serialized and zlib-compressed with this
+  // level (1-9) before it is sent to the client. Image data is always sent
+  // uncompressed since the serialization does not preserve its extent.
+  // 0 (no compression) by default. It must be the same on client and server.
+  vtkSetClampMacro(CompressionLevel, int, 0, 9);
+  vtkGetMacro(CompressionLevel, int);
 //BTX
   enum ProcessTypes
     {
@@ -101,6 +109,8 @@ protected:
 
   virtual int SendData(vtkDataObject*, vtkMultiProcessController*);
   virtual vtkDataObject* ReceiveData(vtkMultiProcessController*);
+  int SendCompressedData(vtkDataObject*, vtkMultiProcessController*);
+  vtkDataObject* ReceiveCompressedData(vtkMultiProcessController*);
 
   enum Tags {
     TRANSMIT_DATA_OBJECT = 23483
@@ -109,6 +119,7 @@ protected:
   int OutputDataType;
   int WholeExtent[6];
   int ProcessType;
+  int CompressionLevel;
   vtkMultiProcessController* Controller;
 
 private:
@@ -229,7 +229,14 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         {
         int division = static_cast<int>(150 *
           inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())) + 10;
-        this->Decimator->SetNumberOfDivisions(division, division, division);
+        int* divisions = this->Decimator->GetNumberOfDivisions();
+        if (divisions[0] != division || divisions[1] != division ||
+          divisions[2] != division)
+          {
+          this->Decimator->SetNumberOfDivisions(division, division, division);
+          // the decimated geometry has to be delivered again.
+          this->LODDeliveryFilter->Modified();
+          }
         }
       this->LODDeliveryFilter->ProcessViewRequest(inInfo);
       if (this->LODDeliverySuppressor->GetForcedUpdateTimeStamp() <
@@ -418,6 +425,12 @@ vtkDataObject* vtkGeometryRepresentation::GetRenderedDataObject(int port)
   return NULL;
 }
 
+//----------------------------------------------------------------------------
+vtkDataObject* vtkGeometryRepresentation::GetRenderedLODDataObject()
+{
+  return this->LODUpdateSuppressor->GetOutputDataObject(0);
+}
+
 //----------------------------------------------------------------------------
 bool vtkGeometryRepresentation::GenerateMetaData(vtkInformation*,
   vtkInformation* outInfo)
@@ -124,6 +124,11 @@ public:
   // Returns the data object that is rendered from the given input port.
   virtual vtkDataObject* GetRenderedDataObject(int port);
 
+  // Description:
+  // Returns the geometry rendered by this process in LOD mode, as of the last
+  // LOD render.
+  vtkDataObject* GetRenderedLODDataObject();
+
   // Description:
   // Returns true if this class would like to get ghost-cells if available for
   // the connection whose information object is passed as the argument.
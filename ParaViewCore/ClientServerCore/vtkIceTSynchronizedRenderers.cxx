@@ -21,6 +21,7 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVDefaultPass.h"
+#include "vtkPVProfiler.h"
 #include "vtkRenderer.h"
 #include "vtkOpenGLRenderer.h"
 #include "vtkRenderState.h"
@@ -193,6 +194,15 @@ public:
       (GLclampf)background[2], 0.0f);
     icetEnable(ICET_CORRECT_COLORED_BACKGROUND);
     }
+
+  // Description:
+  // Overridden to record the time spent in IceT, which includes rendering the
+  // local geometry and compositing the images.
+  virtual void Render(const vtkRenderState* render_state)
+    {
+    vtkPVProfilerScope profile(vtkPVProfiler::COMPOSITING, "IceT Composite");
+    this->Superclass::Render(render_state);
+    }
 protected:
 
   vtkPVIceTCompositePass()
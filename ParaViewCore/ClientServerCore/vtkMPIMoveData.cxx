@@ -40,6 +40,7 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkProcessModule.h"
+#include "vtkPVProfiler.h"
 #include "vtkPVSession.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
@@ -676,6 +677,9 @@ void vtkMPIMoveData::DataServerGatherAll(vtkDataObject* input,
     return;
     }
 
+  vtkPVProfilerScope profile(vtkPVProfiler::DATA_DELIVERY,
+    "Dataserver gathering to all");
+
 #ifdef VTK_USE_MPI
   int idx;
   vtkMPICommunicator* com = vtkMPICommunicator::SafeDownCast(
@@ -695,6 +699,7 @@ void vtkMPIMoveData::DataServerGatherAll(vtkDataObject* input,
   // One data set, one buffer.
   vtkIdType inBufferLength = this->BufferTotalLength;
   char *inBuffer = this->Buffers;
+  profile.Bytes = inBufferLength;
   this->Buffers = NULL;
   this->ClearBuffer();
 
@@ -741,6 +746,8 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input,
     }
 
     vtkTimerLog::MarkStartEvent("Dataserver gathering to 0");
+  vtkPVProfilerScope profile(vtkPVProfiler::DATA_DELIVERY,
+    "Dataserver gathering to 0");
 
 #ifdef VTK_USE_MPI
   int idx;
@@ -762,6 +769,7 @@ void vtkMPIMoveData::DataServerGatherToZero(vtkDataObject* input,
   // One data set, one buffer.
   vtkIdType inBufferLength = this->BufferTotalLength;
   char *inBuffer = this->Buffers;
+  profile.Bytes = inBufferLength;
   this->Buffers = NULL;
   this->ClearBuffer();
 
@@ -940,6 +948,8 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
   if (myId == 0)
     {
     vtkTimerLog::MarkStartEvent("Dataserver sending to client");
+    vtkPVProfilerScope profile(vtkPVProfiler::TRANSMISSION,
+      "Dataserver sending to client");
 
     vtkSmartPointer<vtkDataObject> tosend = output;
     if (this->DeliverOutlineToClient)
@@ -965,6 +975,7 @@ void vtkMPIMoveData::DataServerSendToClient(vtkDataObject* output)
 
     this->ClearBuffer();
     this->MarshalDataToBuffer(tosend);
+    profile.Bytes = this->BufferTotalLength;
     this->ClientDataServerSocketController->Send(
                                      &(this->NumberOfBuffers), 1, 1, 23490);
     this->ClientDataServerSocketController->Send(this->BufferLengths,
@@ -987,6 +998,8 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
     return;
     }
 
+  vtkPVProfilerScope profile(vtkPVProfiler::TRANSMISSION,
+    "Client receiving from dataserver");
   this->ClearBuffer();
   com->Receive(&(this->NumberOfBuffers), 1, 1, 23490);
   this->BufferLengths = new vtkIdType[this->NumberOfBuffers];
@@ -1003,6 +1016,7 @@ void vtkMPIMoveData::ClientReceiveFromDataServer(vtkDataObject* output)
   this->Buffers = new char[this->BufferTotalLength];
   com->Receive(this->Buffers, this->BufferTotalLength,
                                   1, 23492);
+  profile.Bytes = this->BufferTotalLength;
   this->ReconstructDataFromBuffer(output);
   this->ClearBuffer();
 }
@@ -1137,6 +1151,7 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
   if (vtkMPIMoveData::UseZLibCompression)
     {
     vtkTimerLog::MarkStartEvent("Zlib compress");
+    vtkPVProfiler::StartEvent(vtkPVProfiler::COMPRESSION, "Zlib compress");
     // Use z-lib compression.
     uLongf out_size =compressBound(writer->GetOutputStringLength());
     buffer = new char[out_size + 8]; 
@@ -1147,6 +1162,7 @@ void vtkMPIMoveData::MarshalDataToBuffer(vtkDataObject* data)
       reinterpret_cast<const Bytef*>(writer->GetOutputString()),
       writer->GetOutputStringLength(), /* compression_level */ Z_DEFAULT_COMPRESSION);
     vtkTimerLog::MarkEndEvent("Zlib compress");
+    vtkPVProfiler::EndEvent(writer->GetOutputStringLength());
     int in_size = static_cast<int>(writer->GetOutputStringLength());
     for (int cc=0; cc < 4; cc++)
       {
@@ -1211,9 +1227,11 @@ void vtkMPIMoveData::ReconstructDataFromBuffer(vtkDataObject* data)
       realBuffer = new char[uncompressed_length];
       uLongf destLen = uncompressed_length;
       vtkTimerLog::MarkStartEvent("Zlib uncompress");
+      vtkPVProfiler::StartEvent(vtkPVProfiler::COMPRESSION, "Zlib uncompress");
       uncompress(reinterpret_cast<Bytef*>(realBuffer), &destLen,
         reinterpret_cast<const Bytef*>(bufferArray+8), compressed_length);
       vtkTimerLog::MarkEndEvent("Zlib uncompress");
+      vtkPVProfiler::EndEvent(uncompressed_length);
 
       bufferArray = realBuffer;
       bufferLength = uncompressed_length;
@@ -15,6 +15,7 @@
 #include "vtkPVClientServerSynchronizedRenderers.h"
 
 #include "vtkObjectFactory.h"
+#include "vtkPVProfiler.h"
 #include "vtkSquirtCompressor.h"
 #include "vtkZlibImageCompressor.h"
 #include "vtkMultiProcessController.h"
@@ -59,13 +60,19 @@ void vtkPVClientServerSynchronizedRenderers::MasterEndRender()
     if (this->Compressor)
       {
       vtkUnsignedCharArray* data = vtkUnsignedCharArray::New();
+      vtkPVProfiler::StartEvent(vtkPVProfiler::TRANSMISSION,
+        "Client receiving image");
       this->ParallelController->Receive(data, 1, 0x023430);
+      vtkPVProfiler::EndEvent(data->GetDataSize());
       this->Decompress(data, rawImage.GetRawPtr());
       data->Delete();
       }
     else
       {
+      vtkPVProfiler::StartEvent(vtkPVProfiler::TRANSMISSION,
+        "Client receiving image");
       this->ParallelController->Receive(rawImage.GetRawPtr(), 1, 0x023430);
+      vtkPVProfiler::EndEvent(rawImage.GetRawPtr()->GetDataSize());
       }
     rawImage.MarkValid();
     }
@@ -90,8 +97,11 @@ void vtkPVClientServerSynchronizedRenderers::SlaveEndRender()
   this->ParallelController->Send(header, 4, 1, 0x023430);
   if (rawImage.IsValid())
     {
-    this->ParallelController->Send(
-      this->Compress(rawImage.GetRawPtr()), 1, 0x023430);
+    vtkUnsignedCharArray* data = this->Compress(rawImage.GetRawPtr());
+    vtkPVProfiler::StartEvent(vtkPVProfiler::TRANSMISSION,
+      "Server sending image");
+    this->ParallelController->Send(data, 1, 0x023430);
+    vtkPVProfiler::EndEvent(data->GetDataSize());
     }
 }
 
@@ -103,6 +113,9 @@ vtkUnsignedCharArray* vtkPVClientServerSynchronizedRenderers::Compress(
     {
     this->Compressor->SetLossLessMode(this->LossLessCompression);
     this->Compressor->SetInput(data);
+    vtkPVProfilerScope profile(vtkPVProfiler::COMPRESSION,
+      this->Compressor->GetClassName());
+    profile.Bytes = data->GetDataSize();
     if (this->Compressor->Compress() == 0)
       {
       vtkErrorMacro("Image compression failed!");
@@ -123,6 +136,9 @@ void vtkPVClientServerSynchronizedRenderers::Decompress(
     this->Compressor->SetLossLessMode(this->LossLessCompression);
     this->Compressor->SetInput(data);
     this->Compressor->SetOutput(outputBuffer);
+    vtkPVProfilerScope profile(vtkPVProfiler::COMPRESSION,
+      this->Compressor->GetClassName());
+    profile.Bytes = data->GetDataSize();
     if (this->Compressor->Decompress() == 0)
       {
       vtkErrorMacro("Image de-compression failed!");
@@ -0,0 +1,245 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVProfiler.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVProfiler.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkPVProfiler);
+
+namespace
+{
+  struct vtkPVProfilerEvent
+    {
+    int Category;
+    std::string Name;
+    double StartTime;
+    double EndTime;
+    unsigned int ProxyId;
+    vtkIdType Bytes;
+    };
+
+  bool vtkPVProfilerEnabled = false;
+  int vtkPVProfilerMaximumNumberOfEvents = 100000;
+
+  // Events are appended when they end.
+  std::deque<vtkPVProfilerEvent>& vtkPVProfilerEvents()
+    {
+    static std::deque<vtkPVProfilerEvent> events;
+    return events;
+    }
+
+  std::vector<vtkPVProfilerEvent>& vtkPVProfilerOpenEvents()
+    {
+    static std::vector<vtkPVProfilerEvent> events;
+    return events;
+    }
+
+  void vtkPVProfilerRecord(const vtkPVProfilerEvent& event)
+    {
+    std::deque<vtkPVProfilerEvent>& events = vtkPVProfilerEvents();
+    events.push_back(event);
+    while (static_cast<int>(events.size()) >
+      vtkPVProfilerMaximumNumberOfEvents)
+      {
+      events.pop_front();
+      }
+    }
+
+  const vtkPVProfilerEvent* vtkPVProfilerGetEvent(int index)
+    {
+    std::deque<vtkPVProfilerEvent>& events = vtkPVProfilerEvents();
+    if (index < 0 || index >= static_cast<int>(events.size()))
+      {
+      return NULL;
+      }
+    return &events[index];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfiler::SetEnabled(bool enabled)
+{
+  vtkPVProfilerEnabled = enabled;
+  if (!enabled)
+    {
+    vtkPVProfilerOpenEvents().clear();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVProfiler::GetEnabled()
+{
+  return vtkPVProfilerEnabled;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfiler::SetMaximumNumberOfEvents(int num)
+{
+  vtkPVProfilerMaximumNumberOfEvents = num > 0? num : 0;
+  std::deque<vtkPVProfilerEvent>& events = vtkPVProfilerEvents();
+  while (static_cast<int>(events.size()) > vtkPVProfilerMaximumNumberOfEvents)
+    {
+    events.pop_front();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVProfiler::GetMaximumNumberOfEvents()
+{
+  return vtkPVProfilerMaximumNumberOfEvents;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfiler::StartEvent(int category, const char* name,
+  unsigned int proxyId)
+{
+  if (!vtkPVProfilerEnabled)
+    {
+    return;
+    }
+  vtkPVProfilerEvent event;
+  event.Category = category;
+  event.Name = name? name : "";
+  event.StartTime = vtkTimerLog::GetUniversalTime();
+  event.EndTime = event.StartTime;
+  event.ProxyId = proxyId;
+  event.Bytes = 0;
+  vtkPVProfilerOpenEvents().push_back(event);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfiler::EndEvent(vtkIdType bytes)
+{
+  std::vector<vtkPVProfilerEvent>& open = vtkPVProfilerOpenEvents();
+  if (!vtkPVProfilerEnabled || open.size() == 0)
+    {
+    return;
+    }
+  vtkPVProfilerEvent& event = open.back();
+  event.EndTime = vtkTimerLog::GetUniversalTime();
+  event.Bytes = bytes;
+  vtkPVProfilerRecord(event);
+  open.pop_back();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfiler::AddEvent(int category, const char* name,
+  double startTime, double endTime, unsigned int proxyId, vtkIdType bytes)
+{
+  if (!vtkPVProfilerEnabled)
+    {
+    return;
+    }
+  vtkPVProfilerEvent event;
+  event.Category = category;
+  event.Name = name? name : "";
+  event.StartTime = startTime;
+  event.EndTime = endTime;
+  event.ProxyId = proxyId;
+  event.Bytes = bytes;
+  vtkPVProfilerRecord(event);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfiler::ClearEvents()
+{
+  vtkPVProfilerEvents().clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVProfiler::GetNumberOfEvents()
+{
+  return static_cast<int>(vtkPVProfilerEvents().size());
+}
+
+//----------------------------------------------------------------------------
+int vtkPVProfiler::GetEventCategory(int index)
+{
+  const vtkPVProfilerEvent* event = vtkPVProfilerGetEvent(index);
+  return event? event->Category : OTHER;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVProfiler::GetEventName(int index)
+{
+  const vtkPVProfilerEvent* event = vtkPVProfilerGetEvent(index);
+  return event? event->Name.c_str() : NULL;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVProfiler::GetEventStartTime(int index)
+{
+  const vtkPVProfilerEvent* event = vtkPVProfilerGetEvent(index);
+  return event? event->StartTime : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVProfiler::GetEventEndTime(int index)
+{
+  const vtkPVProfilerEvent* event = vtkPVProfilerGetEvent(index);
+  return event? event->EndTime : 0.0;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkPVProfiler::GetEventProxyId(int index)
+{
+  const vtkPVProfilerEvent* event = vtkPVProfilerGetEvent(index);
+  return event? event->ProxyId : 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVProfiler::GetEventBytes(int index)
+{
+  const vtkPVProfilerEvent* event = vtkPVProfilerGetEvent(index);
+  return event? event->Bytes : 0;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVProfiler::GetCategoryAsString(int category)
+{
+  switch (category)
+    {
+  case FILTER_EXECUTE:
+    return "filter_execute";
+  case DATA_DELIVERY:
+    return "data_delivery";
+  case RENDERING:
+    return "rendering";
+  case COMPOSITING:
+    return "compositing";
+  case COMPRESSION:
+    return "compression";
+  case TRANSMISSION:
+    return "transmission";
+  default:
+    return "other";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfiler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkPVProfiler::GetEnabled() << endl;
+  os << indent << "MaximumNumberOfEvents: "
+    << vtkPVProfiler::GetMaximumNumberOfEvents() << endl;
+  os << indent << "NumberOfEvents: "
+    << vtkPVProfiler::GetNumberOfEvents() << endl;
+}
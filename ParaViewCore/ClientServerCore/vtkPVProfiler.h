@@ -0,0 +1,127 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVProfiler.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVProfiler - records typed timing events on this process.
+// .SECTION Description
+// vtkPVProfiler keeps the timing events recorded on this process as records
+// with a category, a name, the global id of the proxy they relate to (0 if
+// none) and the number of bytes they processed (0 if unknown). Unlike
+// vtkTimerLog, nothing is formatted as text, so the events can be gathered
+// from all processes with vtkPVProfilingInformation and analyzed without
+// parsing. Times are in seconds, as returned by
+// vtkTimerLog::GetUniversalTime().
+//
+// Recording is off by default. When more than MaximumNumberOfEvents events
+// are recorded, the oldest ones are dropped.
+// .SECTION See Also
+// vtkPVProfilingInformation
+
+#ifndef __vtkPVProfiler_h
+#define __vtkPVProfiler_h
+
+#include "vtkObject.h"
+
+class VTK_EXPORT vtkPVProfiler : public vtkObject
+{
+public:
+  static vtkPVProfiler* New();
+  vtkTypeMacro(vtkPVProfiler, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  enum Categories
+    {
+    OTHER = 0,
+    FILTER_EXECUTE,
+    DATA_DELIVERY,
+    RENDERING,
+    COMPOSITING,
+    COMPRESSION,
+    TRANSMISSION,
+    NUMBER_OF_CATEGORIES
+    };
+
+  // Description:
+  // Get/Set whether events are recorded. Turning recording off discards the
+  // events that were started but not ended.
+  static void SetEnabled(bool);
+  static bool GetEnabled();
+
+  // Description:
+  // Get/Set the maximum number of events kept. 100000 by default.
+  static void SetMaximumNumberOfEvents(int);
+  static int GetMaximumNumberOfEvents();
+
+  // Description:
+  // Start an event. Events can be nested: EndEvent() ends the last event
+  // started.
+  static void StartEvent(int category, const char* name,
+    unsigned int proxyId=0);
+
+  // Description:
+  // End the last event started, recording the number of bytes it processed.
+  static void EndEvent(vtkIdType bytes=0);
+
+  // Description:
+  // Record an event that has already been timed.
+  static void AddEvent(int category, const char* name, double startTime,
+    double endTime, unsigned int proxyId=0, vtkIdType bytes=0);
+
+  // Description:
+  // Discard all recorded events.
+  static void ClearEvents();
+
+  // Description:
+  // Access to the recorded events, oldest first.
+  static int GetNumberOfEvents();
+  static int GetEventCategory(int index);
+  static const char* GetEventName(int index);
+  static double GetEventStartTime(int index);
+  static double GetEventEndTime(int index);
+  static unsigned int GetEventProxyId(int index);
+  static vtkIdType GetEventBytes(int index);
+
+  // Description:
+  // Returns a lower-case name for the category, such as "filter_execute".
+  static const char* GetCategoryAsString(int category);
+
+protected:
+  vtkPVProfiler() {}
+  ~vtkPVProfiler() {}
+
+private:
+  vtkPVProfiler(const vtkPVProfiler&); // Not implemented
+  void operator=(const vtkPVProfiler&); // Not implemented
+};
+
+//BTX
+// Description:
+// Records an event for the lifetime of the object. Set Bytes before the
+// object goes out of scope to record the number of bytes processed.
+class VTK_EXPORT vtkPVProfilerScope
+{
+public:
+  vtkPVProfilerScope(int category, const char* name, unsigned int proxyId=0)
+    : Bytes(0)
+    {
+    vtkPVProfiler::StartEvent(category, name, proxyId);
+    }
+  ~vtkPVProfilerScope()
+    {
+    vtkPVProfiler::EndEvent(this->Bytes);
+    }
+  vtkIdType Bytes;
+};
+//ETX
+
+#endif
@@ -0,0 +1,257 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVProfilingInformation.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVProfilingInformation.h"
+
+#include "vtkClientServerStream.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkObjectFactory.h"
+#include "vtkProcessModule.h"
+#include "vtkPVProfiler.h"
+
+#include <string>
+#include <vector>
+
+class vtkPVProfilingInformation::vtkInternals
+{
+public:
+  struct EventType
+    {
+    int ProcessId;
+    int ProcessType;
+    int Category;
+    std::string Name;
+    double StartTime;
+    double EndTime;
+    unsigned int ProxyId;
+    vtkIdType Bytes;
+    };
+
+  std::vector<EventType> Events;
+
+  const EventType* GetEvent(int index)
+    {
+    if (index < 0 || index >= static_cast<int>(this->Events.size()))
+      {
+      return NULL;
+      }
+    return &this->Events[index];
+    }
+};
+
+vtkStandardNewMacro(vtkPVProfilingInformation);
+//----------------------------------------------------------------------------
+vtkPVProfilingInformation::vtkPVProfilingInformation()
+{
+  this->ClearEvents = 0;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVProfilingInformation::~vtkPVProfilingInformation()
+{
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVProfilingInformation::GetNumberOfEvents()
+{
+  return static_cast<int>(this->Internals->Events.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkPVProfilingInformation::GetEventProcessId(int index)
+{
+  const vtkInternals::EventType* event = this->Internals->GetEvent(index);
+  return event? event->ProcessId : -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVProfilingInformation::GetEventProcessType(int index)
+{
+  const vtkInternals::EventType* event = this->Internals->GetEvent(index);
+  return event? event->ProcessType : -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVProfilingInformation::GetEventCategory(int index)
+{
+  const vtkInternals::EventType* event = this->Internals->GetEvent(index);
+  return event? event->Category : vtkPVProfiler::OTHER;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVProfilingInformation::GetEventName(int index)
+{
+  const vtkInternals::EventType* event = this->Internals->GetEvent(index);
+  return event? event->Name.c_str() : NULL;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVProfilingInformation::GetEventStartTime(int index)
+{
+  const vtkInternals::EventType* event = this->Internals->GetEvent(index);
+  return event? event->StartTime : 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVProfilingInformation::GetEventEndTime(int index)
+{
+  const vtkInternals::EventType* event = this->Internals->GetEvent(index);
+  return event? event->EndTime : 0.0;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkPVProfilingInformation::GetEventProxyId(int index)
+{
+  const vtkInternals::EventType* event = this->Internals->GetEvent(index);
+  return event? event->ProxyId : 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPVProfilingInformation::GetEventBytes(int index)
+{
+  const vtkInternals::EventType* event = this->Internals->GetEvent(index);
+  return event? event->Bytes : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfilingInformation::CopyFromObject(vtkObject*)
+{
+  this->Internals->Events.clear();
+
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  int processId = pm? pm->GetPartitionId() : 0;
+  int processType = vtkProcessModule::GetProcessType();
+
+  int numEvents = vtkPVProfiler::GetNumberOfEvents();
+  this->Internals->Events.resize(numEvents);
+  for (int cc = 0; cc < numEvents; cc++)
+    {
+    vtkInternals::EventType& event = this->Internals->Events[cc];
+    event.ProcessId = processId;
+    event.ProcessType = processType;
+    event.Category = vtkPVProfiler::GetEventCategory(cc);
+    event.Name = vtkPVProfiler::GetEventName(cc);
+    event.StartTime = vtkPVProfiler::GetEventStartTime(cc);
+    event.EndTime = vtkPVProfiler::GetEventEndTime(cc);
+    event.ProxyId = vtkPVProfiler::GetEventProxyId(cc);
+    event.Bytes = vtkPVProfiler::GetEventBytes(cc);
+    }
+
+  if (this->ClearEvents)
+    {
+    vtkPVProfiler::ClearEvents();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfilingInformation::AddInformation(vtkPVInformation* pvother)
+{
+  vtkPVProfilingInformation* other =
+    vtkPVProfilingInformation::SafeDownCast(pvother);
+  if (other)
+    {
+    this->Internals->Events.insert(this->Internals->Events.end(),
+      other->Internals->Events.begin(), other->Internals->Events.end());
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfilingInformation::CopyToStream(vtkClientServerStream* stream)
+{
+  stream->Reset();
+  *stream << vtkClientServerStream::Reply
+          << static_cast<unsigned int>(this->Internals->Events.size());
+  std::vector<vtkInternals::EventType>::iterator iter;
+  for (iter = this->Internals->Events.begin();
+    iter != this->Internals->Events.end(); ++iter)
+    {
+    *stream << iter->ProcessId
+            << iter->ProcessType
+            << iter->Category
+            << iter->Name.c_str()
+            << iter->StartTime
+            << iter->EndTime
+            << iter->ProxyId
+            << static_cast<double>(iter->Bytes);
+    }
+  *stream << vtkClientServerStream::End;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfilingInformation::CopyFromStream(
+  const vtkClientServerStream* stream)
+{
+  this->Internals->Events.clear();
+
+  int offset = 0;
+  unsigned int count;
+  if (!stream->GetArgument(0, offset++, &count))
+    {
+    vtkErrorMacro("Error parsing count.");
+    return;
+    }
+
+  this->Internals->Events.resize(count);
+  for (unsigned int cc = 0; cc < count; cc++)
+    {
+    vtkInternals::EventType& event = this->Internals->Events[cc];
+    const char* name = NULL;
+    double bytes = 0;
+    if (!stream->GetArgument(0, offset++, &event.ProcessId) ||
+      !stream->GetArgument(0, offset++, &event.ProcessType) ||
+      !stream->GetArgument(0, offset++, &event.Category) ||
+      !stream->GetArgument(0, offset++, &name) ||
+      !stream->GetArgument(0, offset++, &event.StartTime) ||
+      !stream->GetArgument(0, offset++, &event.EndTime) ||
+      !stream->GetArgument(0, offset++, &event.ProxyId) ||
+      !stream->GetArgument(0, offset++, &bytes))
+      {
+      vtkErrorMacro("Failed to parse stream correctly.");
+      this->Internals->Events.resize(cc);
+      return;
+      }
+    event.Name = name? name : "";
+    event.Bytes = static_cast<vtkIdType>(bytes);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfilingInformation::CopyParametersToStream(
+  vtkMultiProcessStream& str)
+{
+  str << 828794 << this->ClearEvents;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfilingInformation::CopyParametersFromStream(
+  vtkMultiProcessStream& str)
+{
+  int magic_number;
+  str >> magic_number >> this->ClearEvents;
+  if (magic_number != 828794)
+    {
+    vtkErrorMacro("Magic number mismatch.");
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProfilingInformation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ClearEvents: " << this->ClearEvents << endl;
+  os << indent << "NumberOfEvents: " << this->GetNumberOfEvents() << endl;
+}
@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVProfilingInformation.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVProfilingInformation - gathers profiling events from all
+// processes.
+// .SECTION Description
+// vtkPVProfilingInformation collects the events recorded by vtkPVProfiler on
+// every process. Each event keeps its category, name, proxy id, byte count
+// and times, together with the partition id and process type of the process
+// that recorded it.
+// .SECTION See Also
+// vtkPVProfiler
+
+#ifndef __vtkPVProfilingInformation_h
+#define __vtkPVProfilingInformation_h
+
+#include "vtkPVInformation.h"
+
+class VTK_EXPORT vtkPVProfilingInformation : public vtkPVInformation
+{
+public:
+  static vtkPVProfilingInformation* New();
+  vtkTypeMacro(vtkPVProfilingInformation, vtkPVInformation);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // When set, the events are discarded on each process once gathered.
+  // This must be set before calling GatherInformation(). Off by default.
+  vtkSetMacro(ClearEvents, int);
+  vtkGetMacro(ClearEvents, int);
+  vtkBooleanMacro(ClearEvents, int);
+
+  // Description:
+  // Access to the gathered events.
+  int GetNumberOfEvents();
+  int GetEventProcessId(int index);
+  int GetEventProcessType(int index);
+  int GetEventCategory(int index);
+  const char* GetEventName(int index);
+  double GetEventStartTime(int index);
+  double GetEventEndTime(int index);
+  unsigned int GetEventProxyId(int index);
+  vtkIdType GetEventBytes(int index);
+
+  // Description:
+  // Transfer information about a single object into this object.
+  virtual void CopyFromObject(vtkObject*);
+
+  // Description:
+  // Merge another information object.
+  virtual void AddInformation(vtkPVInformation*);
+
+  //BTX
+  // Description:
+  // Manage a serialized version of the information.
+  virtual void CopyToStream(vtkClientServerStream*);
+  virtual void CopyFromStream(const vtkClientServerStream*);
+
+  // Description:
+  // Serialize/Deserialize the parameters that control how/what information is
+  // gathered.
+  virtual void CopyParametersToStream(vtkMultiProcessStream&);
+  virtual void CopyParametersFromStream(vtkMultiProcessStream&);
+
+protected:
+  vtkPVProfilingInformation();
+  ~vtkPVProfilingInformation();
+
+  int ClearEvents;
+
+private:
+  vtkPVProfilingInformation(const vtkPVProfilingInformation&); // Not implemented
+  void operator=(const vtkPVProfilingInformation&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+  //ETX
+};
+
+#endif
@@ -46,6 +46,7 @@
 #include "vtkPVHardwareSelector.h"
 #include "vtkPVInteractorStyle.h"
 #include "vtkPVOptions.h"
+#include "vtkPVProfiler.h"
 #include "vtkPVSession.h"
 #include "vtkPVSynchronizedRenderer.h"
 #include "vtkPVSynchronizedRenderWindows.h"
@@ -67,6 +68,9 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <algorithm>
+#include <deque>
+#include <cmath>
 
 class vtkPVRenderView::vtkInternals
 {
@@ -74,6 +78,10 @@ public:
   std::map<void*, int> RepToIdMap;
   std::map<int, vtkDataRepresentation*> IdToRepMap;
   int UniqueId;
+
+  // Times of the most recent interactive renders, used when
+  // UseAdaptiveInteractiveRendering is on.
+  std::deque<double> InteractiveRenderTimes;
   vtkInternals()
     {
     this->UniqueId = 0;
@@ -111,6 +119,7 @@ vtkPVRenderView::vtkPVRenderView()
   this->RemoteRenderingAvailable = vtkPVRenderView::RemoteRenderingAllowed;
 
   this->UsedLODForLastRender = false;
+  this->UsedDistributedRenderingForLastRender = false;
   this->MakingSelection = false;
   this->StillRenderImageReductionFactor = 1;
   this->InteractiveRenderImageReductionFactor = 2;
@@ -119,6 +128,13 @@ vtkPVRenderView::vtkPVRenderView()
   this->LODRenderingThreshold = 0;
   this->ClientOutlineThreshold = 5;
   this->LODResolution = 0.5;
+  this->UseAdaptiveInteractiveRendering = false;
+  this->TargetInteractiveRenderTime = 0.1;
+  this->NumberOfInteractiveRenderTimes = 5;
+  this->MaximumInteractiveRenderImageReductionFactor = 8;
+  this->AdaptiveImageReductionFactor = 2;
+  this->AdaptiveLODResolution = 0.5;
+  this->RequestedLODResolution = -1.0;
   this->UseLightKit = false;
   this->Interactor = 0;
   this->InteractorStyle = 0;
@@ -746,8 +762,13 @@ void vtkPVRenderView::Update()
 void vtkPVRenderView::StillRender()
 {
   vtkTimerLog::MarkStartEvent("Still Render");
+  vtkPVProfiler::StartEvent(vtkPVProfiler::RENDERING, "Still Render",
+    this->GetIdentifier());
+  // the next interaction starts measuring again.
+  this->Internals->InteractiveRenderTimes.clear();
   this->GetRenderWindow()->SetDesiredUpdateRate(0.002);
   this->Render(false, false);
+  vtkPVProfiler::EndEvent();
   vtkTimerLog::MarkEndEvent("Still Render");
 }
 
@@ -755,11 +776,121 @@ void vtkPVRenderView::StillRender()
 void vtkPVRenderView::InteractiveRender()
 {
   vtkTimerLog::MarkStartEvent("Interactive Render");
+  vtkPVProfiler::StartEvent(vtkPVProfiler::RENDERING, "Interactive Render",
+    this->GetIdentifier());
+  double startTime = vtkTimerLog::GetUniversalTime();
   this->GetRenderWindow()->SetDesiredUpdateRate(5.0);
   this->Render(true, false);
+  if (this->UseAdaptiveInteractiveRendering &&
+    this->SynchronizedWindows->GetLocalProcessIsDriver())
+    {
+    this->UpdateAdaptiveInteractiveRendering(
+      vtkTimerLog::GetUniversalTime() - startTime);
+    }
+  vtkPVProfiler::EndEvent();
   vtkTimerLog::MarkEndEvent("Interactive Render");
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetUseAdaptiveInteractiveRendering(bool enable)
+{
+  if (this->UseAdaptiveInteractiveRendering != enable)
+    {
+    this->UseAdaptiveInteractiveRendering = enable;
+    // start from the configured quality.
+    this->AdaptiveImageReductionFactor =
+      this->InteractiveRenderImageReductionFactor;
+    this->AdaptiveLODResolution = this->LODResolution;
+    this->Internals->InteractiveRenderTimes.clear();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderView::UpdateAdaptiveInteractiveRendering(double renderTime)
+{
+  std::deque<double>& times = this->Internals->InteractiveRenderTimes;
+  times.push_back(renderTime);
+  while (static_cast<int>(times.size()) > this->NumberOfInteractiveRenderTimes)
+    {
+    times.pop_front();
+    }
+  if (static_cast<int>(times.size()) < this->NumberOfInteractiveRenderTimes)
+    {
+    return;
+    }
+
+  double average = 0.0;
+  for (size_t cc = 0; cc < times.size(); cc++)
+    {
+    average += times[cc];
+    }
+  average /= times.size();
+  double ratio = average / this->TargetInteractiveRenderTime;
+
+  int factor = this->AdaptiveImageReductionFactor;
+  double resolution = std::min(this->AdaptiveLODResolution,
+    this->LODResolution);
+  int maxFactor = this->MaximumInteractiveRenderImageReductionFactor;
+
+  // The number of pixels to composite, compress and transfer goes as
+  // 1/factor^2, and the number of LOD triangles roughly as resolution^2, so
+  // both are scaled by the square root of the time ratio. Rendering within
+  // [0.6, 1.25] times the target is left alone to avoid oscillations.
+  if (ratio > 1.25)
+    {
+    if (this->UsedDistributedRenderingForLastRender && factor < maxFactor)
+      {
+      int next = static_cast<int>(ceil(factor * sqrt(ratio)));
+      factor = std::max(factor + 1, std::min(next, maxFactor));
+      }
+    else if (this->UsedLODForLastRender && resolution > 0.0)
+      {
+      resolution = std::min(0.9 * resolution, resolution / sqrt(ratio));
+      }
+    }
+  else if (ratio < 0.6)
+    {
+    if (this->UsedLODForLastRender && resolution < this->LODResolution)
+      {
+      resolution = std::min(this->LODResolution,
+        std::max(resolution + 0.05, resolution / sqrt(ratio)));
+      }
+    else if (factor > 1)
+      {
+      int next = static_cast<int>(floor(factor * sqrt(ratio)));
+      factor = std::max(1, std::min(next, factor - 1));
+      }
+    }
+
+  if (factor != this->AdaptiveImageReductionFactor ||
+    resolution != this->AdaptiveLODResolution)
+    {
+    this->AdaptiveImageReductionFactor = factor;
+    this->AdaptiveLODResolution = resolution;
+    // measure the new settings from scratch.
+    times.clear();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SynchronizeAdaptiveInteractiveRendering()
+{
+  vtkMultiProcessStream stream;
+  bool is_driver = this->SynchronizedWindows->GetLocalProcessIsDriver();
+  if (is_driver)
+    {
+    stream << this->AdaptiveImageReductionFactor
+           << this->AdaptiveLODResolution;
+    }
+  this->SynchronizedWindows->BroadcastFromDriver(stream);
+  if (!is_driver)
+    {
+    stream >> this->AdaptiveImageReductionFactor
+           >> this->AdaptiveLODResolution;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
 {
@@ -770,6 +901,11 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     this->SynchronizeForCollaboration();
     }
 
+  if (interactive && this->UseAdaptiveInteractiveRendering)
+    {
+    this->SynchronizeAdaptiveInteractiveRendering();
+    }
+
   // Use loss-less image compression for client-server for full-res renders.
   this->SynchronizedRenderers->SetLossLessCompression(!interactive);
 
@@ -872,9 +1008,12 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     this->RequestInformation, this->ReplyInformationVector);
 
   // set the image reduction factor.
+  int interactive_factor = this->UseAdaptiveInteractiveRendering?
+    this->AdaptiveImageReductionFactor :
+    this->InteractiveRenderImageReductionFactor;
   this->SynchronizedRenderers->SetImageReductionFactor(
     (interactive?
-     this->InteractiveRenderImageReductionFactor :
+     interactive_factor :
      this->StillRenderImageReductionFactor));
 
   if (!interactive)
@@ -889,6 +1028,7 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     }
 
   this->UsedLODForLastRender = use_lod_rendering;
+  this->UsedDistributedRenderingForLastRender = use_distributed_rendering;
 
   if (interactive)
     {
@@ -955,7 +1095,8 @@ void vtkPVRenderView::DoDataDelivery(
   )
 {
   if ((using_lod_rendering &&
-    this->InteractiveRenderTime > this->UpdateTime) ||
+    this->InteractiveRenderTime > this->UpdateTime &&
+    this->InteractiveRenderTime > this->LODResolutionTime) ||
     (!using_lod_rendering &&
      this->StillRenderTime > this->UpdateTime))
     {
@@ -1086,8 +1227,18 @@ void vtkPVRenderView::SetRequestLODRendering(bool enable)
 {
   if (enable)
     {
+    // The adaptive resolution is the same on all processes, so they all
+    // deliver the LOD geometry again when it changes.
+    double resolution = this->UseAdaptiveInteractiveRendering?
+      std::min(this->AdaptiveLODResolution, this->LODResolution) :
+      this->LODResolution;
+    if (resolution != this->RequestedLODResolution)
+      {
+      this->RequestedLODResolution = resolution;
+      this->LODResolutionTime.Modified();
+      }
     this->RequestInformation->Set(USE_LOD(), 1);
-    this->RequestInformation->Set(LOD_RESOLUTION(), this->LODResolution);
+    this->RequestInformation->Set(LOD_RESOLUTION(), resolution);
     }
   else
     {
@@ -1317,6 +1468,18 @@ void vtkPVRenderView::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "UseLightKit: " << this->UseLightKit << endl;
+  os << indent << "UseAdaptiveInteractiveRendering: "
+    << this->UseAdaptiveInteractiveRendering << endl;
+  os << indent << "TargetInteractiveRenderTime: "
+    << this->TargetInteractiveRenderTime << endl;
+  os << indent << "NumberOfInteractiveRenderTimes: "
+    << this->NumberOfInteractiveRenderTimes << endl;
+  os << indent << "MaximumInteractiveRenderImageReductionFactor: "
+    << this->MaximumInteractiveRenderImageReductionFactor << endl;
+  os << indent << "AdaptiveImageReductionFactor: "
+    << this->AdaptiveImageReductionFactor << endl;
+  os << indent << "AdaptiveLODResolution: "
+    << this->AdaptiveLODResolution << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -205,6 +205,49 @@ public:
   vtkSetClampMacro(LODResolution, double, 0.0, 1.0);
   vtkGetMacro(LODResolution, double);
 
+  // Description:
+  // When on, interactive renders adapt the image reduction factor and the LOD
+  // resolution to keep the time they take close to TargetInteractiveRenderTime.
+  // The time is that of the whole render (rendering, compositing, compression
+  // and transfer) on the client, or on the root node in batch mode, averaged
+  // over the last NumberOfInteractiveRenderTimes interactive renders. When too
+  // slow, the image reduction factor is increased first, up to
+  // MaximumInteractiveRenderImageReductionFactor, then the LOD resolution is
+  // lowered. When fast enough, the LOD resolution is restored first, up to
+  // LODResolution, then the image reduction factor is lowered, down to 1.
+  // Still renders are not affected. Off by default.
+  // @CallOnAllProcessess
+  void SetUseAdaptiveInteractiveRendering(bool);
+  vtkGetMacro(UseAdaptiveInteractiveRendering, bool);
+  vtkBooleanMacro(UseAdaptiveInteractiveRendering, bool);
+
+  // Description:
+  // Get/Set the time in seconds interactive renders should take when
+  // UseAdaptiveInteractiveRendering is on. 0.1 by default.
+  // @CallOnAllProcessess
+  vtkSetClampMacro(TargetInteractiveRenderTime, double, 0.001, VTK_DOUBLE_MAX);
+  vtkGetMacro(TargetInteractiveRenderTime, double);
+
+  // Description:
+  // Get/Set the number of interactive renders averaged to decide whether to
+  // adapt the interactive render quality. 5 by default.
+  // @CallOnAllProcessess
+  vtkSetClampMacro(NumberOfInteractiveRenderTimes, int, 1, 100);
+  vtkGetMacro(NumberOfInteractiveRenderTimes, int);
+
+  // Description:
+  // Get/Set the largest image reduction factor used when
+  // UseAdaptiveInteractiveRendering is on. 8 by default.
+  // @CallOnAllProcessess
+  vtkSetClampMacro(MaximumInteractiveRenderImageReductionFactor, int, 1, 20);
+  vtkGetMacro(MaximumInteractiveRenderImageReductionFactor, int);
+
+  // Description:
+  // Returns the image reduction factor and LOD resolution the next interactive
+  // render will use when UseAdaptiveInteractiveRendering is on.
+  vtkGetMacro(AdaptiveImageReductionFactor, int);
+  vtkGetMacro(AdaptiveLODResolution, double);
+
   // Description:
   // This threshold is only applicable when in client-server mode. It is the size
   // of geometry in megabytes beyond which the view should not deliver geometry
@@ -532,6 +575,17 @@ protected:
   // Synchronizes core ivars for multi-client setups.
   virtual void SynchronizeForCollaboration();
 
+  // Description:
+  // Adapts AdaptiveImageReductionFactor and AdaptiveLODResolution given the
+  // time the last interactive render took. Only called on the driver process.
+  void UpdateAdaptiveInteractiveRendering(double renderTime);
+
+  // Description:
+  // Sends AdaptiveImageReductionFactor and AdaptiveLODResolution from the
+  // driver process to all others.
+  // @CallOnAllProcessess
+  void SynchronizeAdaptiveInteractiveRendering();
+
   vtkLight* Light;
   vtkLightKit* LightKit;
   vtkRenderViewBase* RenderView;
@@ -570,6 +624,19 @@ protected:
   bool UseLightKit;
 
   bool UsedLODForLastRender;
+  bool UsedDistributedRenderingForLastRender;
+
+  bool UseAdaptiveInteractiveRendering;
+  double TargetInteractiveRenderTime;
+  int NumberOfInteractiveRenderTimes;
+  int MaximumInteractiveRenderImageReductionFactor;
+  int AdaptiveImageReductionFactor;
+  double AdaptiveLODResolution;
+
+  // LOD resolution of the last LOD render and time it last changed. The LOD
+  // geometry is delivered again after a change.
+  double RequestedLODResolution;
+  vtkTimeStamp LODResolutionTime;
 
   static bool RemoteRenderingAllowed;
 
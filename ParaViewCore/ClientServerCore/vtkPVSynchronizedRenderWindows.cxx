@@ -1586,6 +1586,68 @@ bool vtkPVSynchronizedRenderWindows::BroadcastToRenderServer(
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVSynchronizedRenderWindows::BroadcastFromDriver(
+  vtkMultiProcessStream& stream)
+{
+  // handle trivial case.
+  if (this->Mode == BUILTIN || this->Mode == INVALID)
+    {
+    return true;
+    }
+
+  // don't use this->GetParallelController() since that only works on rendering
+  // nodes.
+  vtkMultiProcessController* parallelController =
+    vtkMultiProcessController::GetGlobalController();
+  vtkMultiProcessController* c_rs_controller =
+    this->GetClientServerController();
+
+  // c_ds_controller is non-null only in client-dataserver-renderserver
+  // configuratrions.
+  vtkMultiProcessController* c_ds_controller =
+    this->GetClientDataServerController();
+  assert(c_ds_controller == NULL || c_ds_controller != c_rs_controller);
+
+  switch (this->Mode)
+    {
+  case CLIENT:
+    if (c_ds_controller)
+      {
+      c_ds_controller->Send(stream, 1, 41235);
+      }
+    if (c_rs_controller)
+      {
+      c_rs_controller->Send(stream, 1, 41235);
+      }
+    return true;
+
+  case DATA_SERVER:
+    // both can't be set on a server process.
+    if (c_ds_controller)
+      {
+      c_ds_controller->Receive(stream, 1, 41235);
+      }
+    break;
+
+  case RENDER_SERVER:
+    if (c_rs_controller)
+      {
+      c_rs_controller->Receive(stream, 1, 41235);
+      }
+    break;
+
+  default:
+    assert(c_ds_controller==NULL && c_rs_controller == NULL);
+    }
+
+  if (parallelController && parallelController->GetNumberOfProcesses() > 1)
+    {
+    parallelController->Broadcast(stream, 0);
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSynchronizedRenderWindows::TriggerRMI(
   vtkMultiProcessStream& stream, int tag)
@@ -118,6 +118,12 @@ public:
   bool BroadcastToDataServer(vtkSelection* selection);
   bool BroadcastToRenderServer(vtkDataObject*);
 
+  // Description:
+  // Sends the stream from the driver process (see GetLocalProcessIsDriver())
+  // to all other processes. Like the methods above, this must be called on
+  // all processes at the same time.
+  bool BroadcastFromDriver(vtkMultiProcessStream& stream);
+
   // Description:
   // Convenience method to trigger an RMI call from the client/root node.
   void TriggerRMI(vtkMultiProcessStream& stream, int tag);
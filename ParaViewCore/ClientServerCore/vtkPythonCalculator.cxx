@@ -201,9 +201,27 @@ void vtkPythonCalculator::Exec(const char* expression,
   
   if (expression && strlen(expression) > 0)  
     {
-    fscript += "  retVal = ";
-    fscript += orgscript;
-    fscript += "\n";
+    // Element-wise expressions are evaluated a block of tuples at a time by
+    // paraview.vtk.algorithms.evaluate() to avoid full-size temporaries.
+    fscript += "  from paraview.vtk.algorithms import evaluate\n";
+    fscript += "  retVal = evaluate(\"";
+    for (size_t i = 0; i < orgscript.size(); i++)
+      {
+      if (orgscript[i] == '\\' || orgscript[i] == '"')
+        {
+        fscript += '\\';
+        fscript.push_back(orgscript[i]);
+        }
+      else if (orgscript[i] == '\n')
+        {
+        fscript += "\\n";
+        }
+      else
+        {
+        fscript.push_back(orgscript[i]);
+        }
+      }
+    fscript += "\", globals(), locals())\n";
     fscript += "  if not isinstance(retVal, ndarray):\n";
     fscript += "    retVal = retVal * ones((inputs[0].GetNumberOf";
     if (this->ArrayAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
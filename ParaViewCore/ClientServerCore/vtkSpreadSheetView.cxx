@@ -21,6 +21,7 @@
 #include "vtkCompositeDataSet.h"
 #include "vtkCSVExporter.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMarkSelectedRows.h"
 #include "vtkMemberFunctionCommand.h"
 #include "vtkMultiProcessController.h"
@@ -33,10 +34,12 @@
 #include "vtkSmartPointer.h"
 #include "vtkSortedTableStreamer.h"
 #include "vtkSpreadSheetRepresentation.h"
+#include "vtkStringArray.h"
 #include "vtkTable.h"
 #include "vtkVariant.h"
 
 #include <map>
+#include <string>
 
 class vtkSpreadSheetView::vtkInternals
 {
@@ -136,6 +139,34 @@ namespace
     {
     }
 
+  void FindRowRMI(void *localArg,
+    void *remoteArg, int remoteArgLength, int)
+    {
+    vtkMultiProcessStream stream;
+    stream.SetRawData(
+      reinterpret_cast<unsigned char*>(remoteArg), remoteArgLength);
+    unsigned int id = 0;
+    std::string columnName;
+    int component = -1;
+    double min = 0, max = 0;
+    vtkTypeInt64 startRow = 0;
+    stream >> id >> columnName >> component >> min >> max >> startRow;
+    vtkSpreadSheetView* self =
+      reinterpret_cast<vtkSpreadSheetView*>(localArg);
+    if (self->GetIdentifier() == id)
+      {
+      self->FindRowCallback(columnName.c_str(), component, min, max,
+        static_cast<vtkIdType>(startRow));
+      }
+    }
+
+  // Returns the list of all columns when some are hidden, NULL otherwise.
+  vtkStringArray* vtkGetColumnNames(vtkTable* block)
+    {
+    return vtkStringArray::SafeDownCast(
+      block->GetFieldData()->GetAbstractArray("vtkColumnNames"));
+    }
+
   unsigned long vtkCountNumberOfRows(vtkDataObject* dobj)
     {
     vtkTable* table = vtkTable::SafeDownCast(dobj);
@@ -211,6 +242,9 @@ vtkSpreadSheetView::vtkSpreadSheetView()
   this->DeliveryFilter = vtkClientServerMoveData::New();
   this->DeliveryFilter->SetOutputDataType(VTK_TABLE);
 
+  this->FindRowDeliveryFilter = vtkClientServerMoveData::New();
+  this->FindRowDeliveryFilter->SetOutputDataType(VTK_TABLE);
+
   this->ReductionFilter->SetInputConnection(
     this->TableStreamer->GetOutputPort());
 
@@ -225,11 +259,15 @@ vtkSpreadSheetView::vtkSpreadSheetView()
     {
     this->RMICallbackTag = this->SynchronizedWindows->AddRMICallback(
       ::FetchRMI, this, FETCH_BLOCK_TAG);
+    this->FindRowRMICallbackTag = this->SynchronizedWindows->AddRMICallback(
+      ::FindRowRMI, this, FIND_ROW_TAG);
     }
   else
     {
     this->RMICallbackTag = this->SynchronizedWindows->AddRMICallback(
       ::FetchRMIBogus, this, FETCH_BLOCK_TAG);
+    this->FindRowRMICallbackTag = this->SynchronizedWindows->AddRMICallback(
+      ::FetchRMIBogus, this, FIND_ROW_TAG);
     }
 }
 
@@ -238,11 +276,14 @@ vtkSpreadSheetView::~vtkSpreadSheetView()
 {
   this->SynchronizedWindows->RemoveRMICallback(this->RMICallbackTag);
   this->RMICallbackTag = 0;
+  this->SynchronizedWindows->RemoveRMICallback(this->FindRowRMICallbackTag);
+  this->FindRowRMICallbackTag = 0;
 
   this->TableStreamer->Delete();
   this->TableSelectionMarker->Delete();
   this->ReductionFilter->Delete();
   this->DeliveryFilter->Delete();
+  this->FindRowDeliveryFilter->Delete();
 
   this->Internals->Observer->Delete();
   delete this->Internals;
@@ -396,6 +437,52 @@ void vtkSpreadSheetView::FetchBlockCallback(vtkIdType blockindex)
   this->DeliveryFilter->Update();
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkSpreadSheetView::FindRow(const char* columnName, int component,
+  double min, double max, vtkIdType startRow)
+{
+  if (!this->Internals->ActiveRepresentation || !columnName)
+    {
+    return -1;
+    }
+
+  this->FindRowCallback(columnName, component, min, max, startRow);
+  vtkTable* result = vtkTable::SafeDownCast(
+    this->FindRowDeliveryFilter->GetOutputDataObject(0));
+  vtkIdTypeArray* row = result? vtkIdTypeArray::SafeDownCast(
+    result->GetColumnByName("FoundRow")) : NULL;
+  if (row && row->GetNumberOfTuples() == 1)
+    {
+    return row->GetValue(0);
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::FindRowCallback(const char* columnName,
+  int component, double min, double max, vtkIdType startRow)
+{
+  vtkMultiProcessStream stream;
+  stream << this->Identifier << std::string(columnName) << component
+         << min << max << static_cast<vtkTypeInt64>(startRow);
+  this->SynchronizedWindows->TriggerRMI(stream, FIND_ROW_TAG);
+
+  // All processes agree on the result, the one of the root is delivered.
+  vtkIdType found = this->TableStreamer->FindRow(
+    columnName, component, min, max, startRow);
+  vtkTable* result = vtkTable::New();
+  vtkIdTypeArray* row = vtkIdTypeArray::New();
+  row->SetName("FoundRow");
+  row->InsertNextValue(found);
+  result->AddColumn(row);
+  row->Delete();
+
+  this->FindRowDeliveryFilter->SetInput(result);
+  result->Delete();
+  this->FindRowDeliveryFilter->Modified();
+  this->FindRowDeliveryFilter->Update();
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkSpreadSheetView::GetNumberOfColumns()
 {
@@ -405,7 +492,9 @@ vtkIdType vtkSpreadSheetView::GetNumberOfColumns()
       this->Internals->GetMostRecentlyAccessedBlock(this));
     if (block0)
       {
-      return block0->GetNumberOfColumns();
+      vtkStringArray* names = vtkGetColumnNames(block0);
+      return names? names->GetNumberOfTuples() :
+        block0->GetNumberOfColumns();
       }
     }
   return 0;
@@ -426,6 +515,12 @@ const char* vtkSpreadSheetView::GetColumnName(vtkIdType index)
       this->Internals->GetMostRecentlyAccessedBlock(this));
     if (block0)
       {
+      vtkStringArray* names = vtkGetColumnNames(block0);
+      if (names)
+        {
+        return (index >= 0 && index < names->GetNumberOfTuples())?
+          names->GetValue(index).c_str() : NULL;
+        }
       return block0->GetColumnName(index);
       }
     }
@@ -439,6 +534,16 @@ vtkVariant vtkSpreadSheetView::GetValue(vtkIdType row, vtkIdType col)
   vtkIdType blockIndex = row / blockSize;
   vtkTable* block = this->FetchBlock(blockIndex);
   vtkIdType blockOffset = row - (blockIndex * blockSize);
+  vtkStringArray* names = vtkGetColumnNames(block);
+  if (names)
+    {
+    // Hidden columns are listed but not delivered.
+    if (col < 0 || col >= names->GetNumberOfTuples())
+      {
+      return vtkVariant();
+      }
+    return this->GetValueByName(row, names->GetValue(col).c_str());
+    }
   return block->GetValue(blockOffset, col);
 }
 
@@ -450,6 +555,10 @@ vtkVariant vtkSpreadSheetView::GetValueByName(
   vtkIdType blockIndex = row / blockSize;
   vtkTable* block = this->FetchBlock(blockIndex);
   vtkIdType blockOffset = row - (blockIndex * blockSize);
+  if (!block->GetColumnByName(columnName))
+    {
+    return vtkVariant();
+    }
   return block->GetValueByName(blockOffset, columnName);
 }
 
@@ -529,3 +638,24 @@ void vtkSpreadSheetView::SetBlockSize(vtkIdType val)
   this->TableStreamer->SetBlockSize(val);
   this->ClearCache();
 }
+
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::AddHiddenColumn(const char* name)
+{
+  this->TableStreamer->AddHiddenColumn(name);
+  this->ClearCache();
+}
+
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::RemoveAllHiddenColumns()
+{
+  this->TableStreamer->RemoveAllHiddenColumns();
+  this->ClearCache();
+}
+
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::SetSampleSort(int val)
+{
+  this->TableStreamer->SetSampleSort(val);
+  this->ClearCache();
+}
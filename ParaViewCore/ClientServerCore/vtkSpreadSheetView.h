@@ -116,6 +116,28 @@ public:
   // @CallOnAllProcessess
   void SetBlockSize(vtkIdType val);
 
+  // Description:
+  // Columns that are not delivered to the client. They are still counted by
+  // GetNumberOfColumns() and named by GetColumnName() but have no values.
+  // @CallOnAllProcessess
+  void AddHiddenColumn(const char* name);
+  void RemoveAllHiddenColumns();
+
+  // Description:
+  // When on, the server computes the global order of the rows once per sort
+  // key with a sample sort, which makes fetching any block cheap.
+  // @CallOnAllProcessess
+  void SetSampleSort(int);
+
+  // Description:
+  // Search the data for the first row, at or after startRow, whose value of
+  // the given column (component, -1 for magnitude) is within [min, max].
+  // Returns the row index or -1 if there is none. Only the index is
+  // delivered to the client.
+  // @CallOnClient
+  vtkIdType FindRow(const char* columnName, int component,
+                    double min, double max, vtkIdType startRow=0);
+
   // Description:
   // Export the contents of this view using the exporter.
   bool Export(vtkCSVExporter* exporter);
@@ -123,6 +145,8 @@ public:
 //BTX
   // INTERNAL METHOD. Don't call directly.
   void FetchBlockCallback(vtkIdType blockindex);
+  void FindRowCallback(const char* columnName, int component,
+                       double min, double max, vtkIdType startRow);
 
 protected:
   vtkSpreadSheetView();
@@ -147,12 +171,14 @@ protected:
   vtkMarkSelectedRows* TableSelectionMarker;
   vtkReductionFilter* ReductionFilter;
   vtkClientServerMoveData* DeliveryFilter;
+  vtkClientServerMoveData* FindRowDeliveryFilter;
 
   vtkIdType NumberOfRows;
 
   enum
     {
-    FETCH_BLOCK_TAG = 394732
+    FETCH_BLOCK_TAG = 394732,
+    FIND_ROW_TAG = 394733
     };
 private:
   vtkSpreadSheetView(const vtkSpreadSheetView&); // Not implemented
@@ -165,6 +191,7 @@ private:
   bool SomethingUpdated;
 
   unsigned long RMICallbackTag;
+  unsigned long FindRowRMICallbackTag;
 //ETX
 };
 
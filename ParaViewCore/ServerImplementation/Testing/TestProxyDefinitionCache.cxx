@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestProxyDefinitionCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that a client which already has the core proxy definitions of the
+// server keeps them instead of receiving them again, that the definitions
+// received from the server are the same as the ones loaded from the modules,
+// and that definitions loaded later on extend the lazily loaded ones.
+
+#include "vtkPVProxyDefinitionIterator.h"
+#include "vtkPVXMLElement.h"
+#include "vtkSIProxyDefinitionManager.h"
+#include "vtkSMMessage.h"
+#include "vtkSmartPointer.h"
+
+#include <string>
+#include <vtksys/ios/sstream>
+
+#define TEST_ASSERT(cond) \
+  if (!(cond)) \
+    { \
+    cerr << "Failed (line " << __LINE__ << "): " << #cond << endl; \
+    return 1; \
+    }
+
+//----------------------------------------------------------------------------
+static int CountCoreDefinitions(vtkSIProxyDefinitionManager* manager)
+{
+  int count = 0;
+  vtkPVProxyDefinitionIterator* iter =
+    manager->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS);
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem())
+    {
+    if (iter->GetProxyDefinition())
+      {
+      count++;
+      }
+    }
+  iter->Delete();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+static std::string PrintDefinition(vtkSIProxyDefinitionManager* manager,
+  const char* group, const char* name)
+{
+  vtkPVXMLElement* definition = manager->GetProxyDefinition(group, name);
+  if (!definition)
+    {
+    return std::string();
+    }
+  vtksys_ios::ostringstream xml;
+  definition->PrintXML(xml, vtkIndent());
+  return xml.str();
+}
+
+//----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  vtkSmartPointer<vtkSIProxyDefinitionManager> server =
+    vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+  vtkSmartPointer<vtkSIProxyDefinitionManager> client =
+    vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+
+  // The same modules give the same hash, whether or not they were parsed.
+  std::string hash = server->GetCoreDefinitionsHash();
+  TEST_ASSERT(!hash.empty());
+  TEST_ASSERT(server->GetProxyDefinition("sources", "SphereSource") != NULL);
+  TEST_ASSERT(server->GetCoreDefinitionsHash() == hash);
+  TEST_ASSERT(client->GetCoreDefinitionsHash() == hash);
+
+  // A client with the same hash does not receive the core definitions and
+  // keeps its own.
+  vtkSMMessage cached;
+  Variant* var = cached.AddExtension(PullRequest::arguments);
+  var->set_type(Variant::STRING);
+  var->add_txt(client->GetCoreDefinitionsHash());
+  server->Pull(&cached);
+  TEST_ASSERT(
+    cached.ExtensionSize(ProxyDefinitionState::xml_definition_proxy) == 0);
+  TEST_ASSERT(
+    cached.GetExtension(ProxyDefinitionState::core_definitions_hash) == hash);
+  client->Push(&cached);
+  TEST_ASSERT(client->GetCoreDefinitionsHash() == hash);
+  TEST_ASSERT(client->HasDefinition("filters", "Cut"));
+  TEST_ASSERT(PrintDefinition(client, "sources", "SphereSource") ==
+    PrintDefinition(server, "sources", "SphereSource"));
+  int numDefinitions = CountCoreDefinitions(server);
+  TEST_ASSERT(numDefinitions > 0);
+  TEST_ASSERT(CountCoreDefinitions(client) == numDefinitions);
+
+  // Without a hash, all the core definitions are sent along with the hash of
+  // the server.
+  vtkSMMessage full;
+  server->Pull(&full);
+  TEST_ASSERT(full.ExtensionSize(ProxyDefinitionState::xml_definition_proxy)
+    == numDefinitions);
+  TEST_ASSERT(
+    full.GetExtension(ProxyDefinitionState::core_definitions_hash) == hash);
+  vtkSmartPointer<vtkSIProxyDefinitionManager> other =
+    vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+  other->Push(&full);
+  TEST_ASSERT(other->GetCoreDefinitionsHash() == hash);
+  TEST_ASSERT(PrintDefinition(other, "sources", "SphereSource") ==
+    PrintDefinition(server, "sources", "SphereSource"));
+  TEST_ASSERT(CountCoreDefinitions(other) == numDefinitions);
+
+  // Definitions loaded later extend the ones of the modules, and change the
+  // hash.
+  vtkSmartPointer<vtkSIProxyDefinitionManager> extended =
+    vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+  const char* extension =
+    "<ServerManagerConfiguration>"
+    "  <ProxyGroup name=\"sources\">"
+    "    <Extension name=\"SphereSource\">"
+    "      <IntVectorProperty name=\"TestExtension\" number_of_elements=\"1\""
+    "        default_values=\"0\" />"
+    "    </Extension>"
+    "  </ProxyGroup>"
+    "</ServerManagerConfiguration>";
+  TEST_ASSERT(extended->LoadConfigurationXMLFromString(extension));
+  TEST_ASSERT(extended->GetCoreDefinitionsHash() != hash);
+  vtkPVXMLElement* sphere =
+    extended->GetProxyDefinition("sources", "SphereSource");
+  TEST_ASSERT(sphere != NULL);
+  bool found = false;
+  for (unsigned int cc = 0; cc < sphere->GetNumberOfNestedElements(); cc++)
+    {
+    const char* name = sphere->GetNestedElement(cc)->GetAttribute("name");
+    found = found || (name && std::string(name) == "TestExtension");
+    }
+  TEST_ASSERT(found);
+  TEST_ASSERT(CountCoreDefinitions(extended) == numDefinitions);
+
+  return 0;
+}
@@ -45,6 +45,7 @@
 #include <vector>
 
 #include <assert.h>
+#include <ctype.h>
 
 // this file must be included after vtkPVConfig etc. are included.
 #include "vtkSMGeneratedModules.h"
@@ -55,23 +56,172 @@
 typedef vtkSmartPointer<vtkPVXMLElement>        XMLElement;
 typedef std::map<vtkStdString, XMLElement>   StrToXmlMap;
 typedef std::map<vtkStdString, StrToXmlMap>  StrToStrToXmlMap;
+typedef std::map<vtkStdString, std::string>  StrToStrMap;
+typedef std::map<vtkStdString, StrToStrMap>  StrToStrToStrMap;
 
+//---------------------------------------------------------------------------
+// Core definitions received from the server are only parsed the first time
+// they are used. Until then their entry holds a NULL element and the xml is
+// kept in the pending map.
+static vtkPVXMLElement* vtkParsePendingProxyDefinition(
+  StrToStrToStrMap& pending, const vtkStdString& groupName,
+  const vtkStdString& proxyName, XMLElement& element)
+{
+  StrToStrToStrMap::iterator it = pending.find(groupName);
+  if (it == pending.end())
+    {
+    return NULL;
+    }
+  StrToStrMap::iterator it2 = it->second.find(proxyName);
+  if (it2 == it->second.end())
+    {
+    return NULL;
+    }
+  vtkNew<vtkPVXMLParser> parser;
+  if (parser->Parse(it2->second.c_str()))
+    {
+    element = parser->GetRootElement();
+    }
+  it->second.erase(it2);
+  return element.GetPointer();
+}
+
+//---------------------------------------------------------------------------
+// FNV-1a, used to compare definition catalogs without transferring them.
+static void vtkHashProxyDefinition(vtkTypeUInt64& hash, const std::string& str)
+{
+  // Include the terminating null so that field boundaries count.
+  const char* data = str.c_str();
+  for (size_t cc=0; cc <= str.size(); cc++)
+    {
+    hash ^= static_cast<unsigned char>(data[cc]);
+    hash *= 1099511628211ULL;
+    }
+}
+
+//---------------------------------------------------------------------------
+// Collects the names of the proxy groups of a configuration xml without
+// parsing it. Returns false when the name of a group could not be read, in
+// which case the xml has to be considered as defining any group.
+static bool vtkScanProxyGroupNames(const std::string& xml,
+  std::set<std::string>& groupNames)
+{
+  const std::string tag = "<ProxyGroup";
+  const std::string attribute = "name=\"";
+  size_t pos = xml.find(tag);
+  while (pos != std::string::npos)
+    {
+    pos += tag.size();
+    // Skip longer element names such as ProxyGroupDomain.
+    if (pos < xml.size() && isspace(xml[pos]))
+      {
+      size_t end = xml.find('>', pos);
+      size_t name = xml.find(attribute, pos);
+      if (end == std::string::npos || name >= end || !isspace(xml[name - 1]))
+        {
+        return false;
+        }
+      name += attribute.size();
+      size_t nameEnd = xml.find('"', name);
+      if (nameEnd >= end)
+        {
+        return false;
+        }
+      groupNames.insert(xml.substr(name, nameEnd - name));
+      }
+    pos = xml.find(tag, pos);
+    }
+  return true;
+}
+
+//****************************************************************************/
 class vtkSIProxyDefinitionManager::vtkInternals
 {
 public:
+  // Configuration xml of a module that has not been parsed yet, with the
+  // groups it defines. No group means any group.
+  struct PendingModule
+    {
+    std::string XML;
+    std::set<std::string> GroupNames;
+    };
+
   // Keep State Flag of the ProcessType
   bool EnableXMLProxyDefinitionUpdate;
   // Keep track of ServerManager definition
   StrToStrToXmlMap CoreDefinitions;
   // Keep track of custom definition
   StrToStrToXmlMap CustomsDefinitions;
+  // Xml of the core definitions that have not been parsed yet
+  StrToStrToStrMap PendingDefinitions;
+  // Modules that have not been parsed yet, in the order they were loaded
+  std::vector<PendingModule> PendingModules;
+  // True while parsing pending modules, which does not notify observers
+  // since the definitions were already available to them.
+  bool LoadingPendingModules;
+  // Hash of the xml the core definitions were loaded from
+  vtkTypeUInt64 SourcesHash;
+  // Hash of the core definitions, empty when it needs to be recomputed
+  std::string CoreDefinitionsHash;
   //-------------------------------------------------------------------------
-  vtkInternals() : EnableXMLProxyDefinitionUpdate(true) {}
+  vtkInternals() : EnableXMLProxyDefinitionUpdate(true),
+    LoadingPendingModules(false), SourcesHash(14695981039346656037ULL) {}
   //-------------------------------------------------------------------------
   void Clear()
     {
     this->CoreDefinitions.clear();
     this->CustomsDefinitions.clear();
+    this->PendingDefinitions.clear();
+    this->PendingModules.clear();
+    this->SourcesHash = 14695981039346656037ULL;
+    this->CoreDefinitionsHash.clear();
+    }
+  //-------------------------------------------------------------------------
+  // Adds some xml the core definitions are loaded from to their hash.
+  void AddSource(const std::string& xml)
+    {
+    vtkHashProxyDefinition(this->SourcesHash, xml);
+    this->CoreDefinitionsHash.clear();
+    }
+  //-------------------------------------------------------------------------
+  const std::string& GetCoreDefinitionsHash()
+    {
+    if (this->CoreDefinitionsHash.empty())
+      {
+      std::ostringstream hashStr;
+      hashStr << std::hex << this->SourcesHash;
+      this->CoreDefinitionsHash = hashStr.str();
+      }
+    return this->CoreDefinitionsHash;
+    }
+  //-------------------------------------------------------------------------
+  // Adds the core definitions to msg, as they are sent by Pull().
+  void SerializeCoreDefinitions(vtkSMMessage* msg)
+    {
+    StrToStrToXmlMap::iterator it;
+    for (it = this->CoreDefinitions.begin();
+         it != this->CoreDefinitions.end(); ++it)
+      {
+      StrToXmlMap::iterator it2;
+      for (it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+        {
+        ProxyDefinitionState_ProxyXMLDefinition *xmlDef =
+          msg->AddExtension(ProxyDefinitionState::xml_definition_proxy);
+        xmlDef->set_group(it->first);
+        xmlDef->set_name(it2->first);
+        if (it2->second)
+          {
+          std::ostringstream xmlContent;
+          it2->second->PrintXML(xmlContent, vtkIndent());
+          xmlDef->set_xml(xmlContent.str());
+          }
+        else
+          {
+          // Not parsed yet, no need to.
+          xmlDef->set_xml(this->PendingDefinitions[it->first][it2->first]);
+          }
+        }
+      }
     }
   //-------------------------------------------------------------------------
   bool HasCoreDefinition( const char* groupName, const char* proxyName)
@@ -118,7 +268,7 @@ public:
     return elementToReturn;
   }
   //-------------------------------------------------------------------------
-  vtkPVXMLElement* GetProxyElement( const StrToStrToXmlMap& map,
+  vtkPVXMLElement* GetProxyElement( StrToStrToXmlMap& map,
                                     const char* firstStr,
                                     const char* secondStr)
   {
@@ -128,15 +278,20 @@ public:
     if (firstStr && secondStr)
       {
       // Find the value based on both keys
-      StrToStrToXmlMap::const_iterator it = map.find(firstStr);
+      StrToStrToXmlMap::iterator it = map.find(firstStr);
       if (it != map.end())
         {
         // We found a match for the first key
-        StrToXmlMap::const_iterator it2 = it->second.find(secondStr);
+        StrToXmlMap::iterator it2 = it->second.find(secondStr);
         if (it2 != it->second.end())
           {
           // We found a match for the second key
           elementToReturn = it2->second.GetPointer();
+          if (!elementToReturn)
+            {
+            elementToReturn = vtkParsePendingProxyDefinition(
+              this->PendingDefinitions, it->first, it2->first, it2->second);
+            }
           }
         }
       }
@@ -286,7 +441,14 @@ public:
       }
     else
       {
-      return this->CoreProxyIterator->second.GetPointer();
+      vtkPVXMLElement* definition = this->CoreProxyIterator->second.GetPointer();
+      if (!definition && this->PendingDefinitionMap)
+        {
+        definition = vtkParsePendingProxyDefinition(
+          *this->PendingDefinitionMap, this->CurrentGroupName,
+          this->CoreProxyIterator->first, this->CoreProxyIterator->second);
+        }
+      return definition;
       }
   }
   //-------------------------------------------------------------------------
@@ -311,6 +473,11 @@ public:
     this->InvalidCoreIterator = true;
   }
   //-------------------------------------------------------------------------
+  void RegisterPendingDefinitionMap(StrToStrToStrMap* map)
+  {
+    this->PendingDefinitionMap = map;
+  }
+  //-------------------------------------------------------------------------
   void RegisterCustomDefinitionMap(StrToStrToXmlMap* map)
   {
     this->CustomDefinitionMap = map;
@@ -329,6 +496,7 @@ protected:
     this->Initialized = false;
     this->CoreDefinitionMap = NULL;
     this->CustomDefinitionMap = 0;
+    this->PendingDefinitionMap = 0;
     this->InvalidCoreIterator = true;
     this->InvalidCustomIterator = true;
   }
@@ -442,6 +610,7 @@ private:
   StrToXmlMap::iterator CustomProxyIteratorEnd;
   StrToStrToXmlMap* CoreDefinitionMap;
   StrToStrToXmlMap* CustomDefinitionMap;
+  StrToStrToStrMap* PendingDefinitionMap;
   std::set<vtkStdString> GroupNames;
   std::set<vtkStdString>::iterator GroupNameIterator;
   bool InvalidCoreIterator;
@@ -519,10 +688,11 @@ void vtkSIProxyDefinitionManager::AddElement(const char* groupName,
     {
     // Just referenced it
     this->Internals->CoreDefinitions[groupName][proxyName] = element;
+    this->Internals->PendingDefinitions[groupName].erase(proxyName);
     updated = true;
     }
 
-  if (updated)
+  if (updated && !this->Internals->LoadingPendingModules)
     {
     // Let the world know that a core-definition was registered i.e. added or
     // modified.
@@ -536,6 +706,7 @@ vtkPVXMLElement* vtkSIProxyDefinitionManager::GetProxyDefinition(
                  const char* groupName, const char* proxyName,
                  const bool throwError)
 {
+  this->LoadPendingModules(groupName);
   vtkPVXMLElement* element = this->Internals->GetProxyElement( groupName,
                                                                proxyName );
   if (!throwError || element)
@@ -792,9 +963,17 @@ bool vtkSIProxyDefinitionManager::LoadConfigurationXMLFromString(const char* xml
 bool vtkSIProxyDefinitionManager::LoadConfigurationXMLFromString( const char* xmlContent,
                                                                   bool attachHints)
 {
+  // Keep the order in which the definitions override each other.
+  this->LoadPendingModules(NULL);
+
   vtkNew<vtkPVXMLParser> parser;
-  return (parser->Parse(xmlContent) != 0) &&
-      this->LoadConfigurationXML( parser->GetRootElement(), attachHints );
+  if (parser->Parse(xmlContent) == 0)
+    {
+    return false;
+    }
+  this->Internals->AddSource(xmlContent);
+  return this->LoadConfigurationXMLInternal(parser->GetRootElement(),
+    attachHints);
 }
 
 //---------------------------------------------------------------------------
@@ -805,6 +984,22 @@ bool vtkSIProxyDefinitionManager::LoadConfigurationXML(vtkPVXMLElement* root)
 
 //---------------------------------------------------------------------------
 bool vtkSIProxyDefinitionManager::LoadConfigurationXML(vtkPVXMLElement* root, bool attachHints)
+{
+  this->LoadPendingModules(NULL);
+  if (root)
+    {
+    // Only the definitions given without their xml need to be printed to be
+    // hashed.
+    std::ostringstream xmlContent;
+    root->PrintXML(xmlContent, vtkIndent());
+    this->Internals->AddSource(xmlContent.str());
+    }
+  return this->LoadConfigurationXMLInternal(root, attachHints);
+}
+
+//---------------------------------------------------------------------------
+bool vtkSIProxyDefinitionManager::LoadConfigurationXMLInternal(
+  vtkPVXMLElement* root, bool attachHints)
 {
   if (!root)
     {
@@ -836,10 +1031,69 @@ bool vtkSIProxyDefinitionManager::LoadConfigurationXML(vtkPVXMLElement* root, bo
         }
       }
     }
-  this->InvokeEvent(vtkSIProxyDefinitionManager::ProxyDefinitionsUpdated);
+  if (!this->Internals->LoadingPendingModules)
+    {
+    this->InvokeEvent(vtkSIProxyDefinitionManager::ProxyDefinitionsUpdated);
+    }
   return true;
 }
 
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::AddPendingModule(const char* xmlContent)
+{
+  vtkInternals::PendingModule module;
+  module.XML = xmlContent;
+  if (!vtkScanProxyGroupNames(module.XML, module.GroupNames))
+    {
+    module.GroupNames.clear();
+    }
+  this->Internals->AddSource(module.XML);
+  this->Internals->PendingModules.push_back(module);
+}
+
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::LoadPendingModules(const char* groupName)
+{
+  std::vector<vtkInternals::PendingModule>& pending =
+    this->Internals->PendingModules;
+
+  // The modules are parsed in the order they were loaded, up to the last one
+  // defining the group, so that their definitions override and extend each
+  // other as if they had all been parsed at once.
+  size_t count = 0;
+  for (size_t cc=0; cc < pending.size(); cc++)
+    {
+    if (!groupName || pending[cc].GroupNames.empty() ||
+      pending[cc].GroupNames.find(groupName) != pending[cc].GroupNames.end())
+      {
+      count = cc + 1;
+      }
+    }
+  if (count == 0)
+    {
+    return;
+    }
+
+  std::vector<vtkInternals::PendingModule> modules(pending.begin(),
+    pending.begin() + count);
+  pending.erase(pending.begin(), pending.begin() + count);
+
+  this->Internals->LoadingPendingModules = true;
+  vtkNew<vtkPVXMLParser> parser;
+  for (size_t cc=0; cc < modules.size(); cc++)
+    {
+    if (parser->Parse(modules[cc].XML.c_str()))
+      {
+      this->LoadConfigurationXMLInternal(parser->GetRootElement(), false);
+      }
+    else
+      {
+      vtkErrorMacro("Failed to parse the configuration of a module.");
+      }
+    }
+  this->Internals->LoadingPendingModules = false;
+}
+
 //---------------------------------------------------------------------------
 void vtkSIProxyDefinitionManager::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -863,17 +1117,25 @@ vtkPVProxyDefinitionIterator*
 // vtkSIProxyDefinitionManager::CUSTOM_DEFINITIONS = 2
 vtkPVProxyDefinitionIterator* vtkSIProxyDefinitionManager::NewIterator(int scope)
 {
+  if (scope != vtkSIProxyDefinitionManager::CUSTOM_DEFINITIONS)
+    {
+    this->LoadPendingModules(NULL);
+    }
   vtkInternalDefinitionIterator* iterator = vtkInternalDefinitionIterator::New();
   switch(scope)
     {
     case vtkSIProxyDefinitionManager::CORE_DEFINITIONS: // Core only
       iterator->RegisterCoreDefinitionMap( & this->Internals->CoreDefinitions);
+      iterator->RegisterPendingDefinitionMap(
+        & this->Internals->PendingDefinitions);
       break;
     case vtkSIProxyDefinitionManager::CUSTOM_DEFINITIONS: // Custom only
       iterator->RegisterCustomDefinitionMap( & this->Internals->CustomsDefinitions);
       break;
     default: // Both
       iterator->RegisterCoreDefinitionMap( & this->Internals->CoreDefinitions);
+      iterator->RegisterPendingDefinitionMap(
+        & this->Internals->PendingDefinitions);
       iterator->RegisterCustomDefinitionMap( & this->Internals->CustomsDefinitions);
       break;
     }
@@ -1080,9 +1342,23 @@ void vtkSIProxyDefinitionManager::MergeProxyDefinition(vtkPVXMLElement* element,
     }
 }
 
+//---------------------------------------------------------------------------
+std::string vtkSIProxyDefinitionManager::GetCoreDefinitionsHash()
+{
+  return this->Internals->GetCoreDefinitionsHash();
+}
+
 //---------------------------------------------------------------------------
 void vtkSIProxyDefinitionManager::Pull(vtkSMMessage* msg)
 {
+  // The client may send the hash of the core definitions it already has.
+  std::string clientHash;
+  if (msg->ExtensionSize(PullRequest::arguments) > 0 &&
+    msg->GetExtension(PullRequest::arguments, 0).txt_size() > 0)
+    {
+    clientHash = msg->GetExtension(PullRequest::arguments, 0).txt(0);
+    }
+
   // Setup required message header
   msg->Clear();
   msg->set_global_id(vtkSIProxyDefinitionManager::GetReservedGlobalID());
@@ -1096,22 +1372,14 @@ void vtkSIProxyDefinitionManager::Pull(vtkSMMessage* msg)
   ProxyDefinitionState_ProxyXMLDefinition *xmlDef;
   vtkPVProxyDefinitionIterator* iter;
 
-  // Core Definition
-  iter = this->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS);
-  iter->GoToFirstItem();
-  while( !iter->IsDoneWithTraversal() )
+  // Core Definition, skipped when the client already has the same ones.
+  std::string hash = this->GetCoreDefinitionsHash();
+  if (hash != clientHash)
     {
-    std::ostringstream xmlContent;
-    iter->GetProxyDefinition()->PrintXML(xmlContent, vtkIndent());
-
-    xmlDef = msg->AddExtension(ProxyDefinitionState::xml_definition_proxy);
-    xmlDef->set_group(iter->GetGroupName());
-    xmlDef->set_name(iter->GetProxyName());
-    xmlDef->set_xml(xmlContent.str());
-
-    iter->GoToNextItem();
+    this->LoadPendingModules(NULL);
+    this->Internals->SerializeCoreDefinitions(msg);
     }
-  iter->Delete();
+  msg->SetExtension(ProxyDefinitionState::core_definitions_hash, hash);
 
   // Custome Definition
   iter = this->NewIterator(vtkSIProxyDefinitionManager::CUSTOM_DEFINITIONS);
@@ -1135,20 +1403,58 @@ void vtkSIProxyDefinitionManager::Pull(vtkSMMessage* msg)
 void vtkSIProxyDefinitionManager::Push(vtkSMMessage* msg)
 {
   vtkTimerLog::MarkStartEvent("vtkSIProxyDefinitionManager Load Definitions");
+  int size = msg->ExtensionSize(ProxyDefinitionState::xml_definition_proxy);
+
+  // The core definitions are left out of the message when the server found
+  // that they match the ones we have.
+  bool keepCore = (size == 0 &&
+    msg->HasExtension(ProxyDefinitionState::core_definitions_hash));
+  if (keepCore && msg->GetExtension(ProxyDefinitionState::core_definitions_hash)
+    != this->GetCoreDefinitionsHash())
+    {
+    vtkWarningMacro("Core proxy definitions were not received and differ "
+      "from the local ones.");
+    }
+
   // Init and local vars
-  this->Internals->Clear();
+  if (keepCore)
+    {
+    this->Internals->CustomsDefinitions.clear();
+    }
+  else
+    {
+    this->Internals->Clear();
+    }
   this->InternalsFlatten->Clear();
   vtkNew<vtkPVXMLParser> parser;
 
-  // Fill the definition with the content of the state
-  int size = msg->ExtensionSize(ProxyDefinitionState::xml_definition_proxy);
+  // Fill the definition with the content of the state. The definitions are
+  // only parsed when first needed, most of them never are.
   const ProxyDefinitionState_ProxyXMLDefinition *xmlDef;
   for(int i=0; i < size; i++)
     {
     xmlDef = &msg->GetExtension(ProxyDefinitionState::xml_definition_proxy, i);
-    parser->Parse(xmlDef->xml().c_str());
-    this->AddElement( xmlDef->group().c_str(), xmlDef->name().c_str(),
-                      parser->GetRootElement());
+    const char* groupName = xmlDef->group().c_str();
+    const char* proxyName = xmlDef->name().c_str();
+    this->Internals->CoreDefinitions[groupName][proxyName] = NULL;
+    this->Internals->PendingDefinitions[groupName][proxyName] = xmlDef->xml();
+    if (!msg->HasExtension(ProxyDefinitionState::core_definitions_hash))
+      {
+      this->Internals->AddSource(xmlDef->group());
+      this->Internals->AddSource(xmlDef->name());
+      this->Internals->AddSource(xmlDef->xml());
+      }
+
+    RegisteredDefinitionInformation info(groupName, proxyName, false);
+    this->InvokeEvent(vtkCommand::RegisterEvent, &info);
+    }
+  if (!keepCore && msg->HasExtension(ProxyDefinitionState::core_definitions_hash))
+    {
+    // Use the hash of the server, definitions loaded later on change it.
+    const std::string& hash =
+      msg->GetExtension(ProxyDefinitionState::core_definitions_hash);
+    this->Internals->AddSource(hash);
+    this->Internals->CoreDefinitionsHash = hash;
     }
 
   // Manage custom ones
@@ -1204,6 +1510,7 @@ void vtkSIProxyDefinitionManager::HandlePlugin(vtkPVPlugin* plugin)
 bool vtkSIProxyDefinitionManager::HasDefinition( const char* groupName,
                                                  const char* proxyName)
 {
+  this->LoadPendingModules(groupName);
   return this->Internals->HasCustomDefinition(groupName, proxyName) ||
       this->Internals->HasCoreDefinition(groupName, proxyName);
 }
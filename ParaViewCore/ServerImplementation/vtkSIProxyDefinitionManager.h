@@ -40,6 +40,7 @@
 #define __vtkSIProxyDefinitionManager_h
 
 #include "vtkSIObject.h"
+#include <string> // needed for std::string
 
 class vtkPVPlugin;
 class vtkPVProxyDefinitionIterator;
@@ -194,6 +195,13 @@ public:
   // that has been previously pushed
   virtual void Pull(vtkSMMessage* msg);
 
+  // Description:
+  // Returns a hash of the core definitions. A client sends it when pulling
+  // the definitions and the server leaves the core definitions out of its
+  // reply when they have the same hash. It is computed from the xml the
+  // definitions are loaded from, so that none of them has to be parsed.
+  std::string GetCoreDefinitionsHash();
+
   // Description:
   // Information object used in Event notification
   struct RegisteredDefinitionInformation
@@ -237,6 +245,22 @@ protected:
   bool LoadConfigurationXML(vtkPVXMLElement* root, bool attachShowInMenuHints);
   bool LoadConfigurationXMLFromString(const char* xmlContent, bool attachShowInMenuHints);
 
+  // Description:
+  // Loads server-manager configuration xml without hashing it.
+  bool LoadConfigurationXMLInternal(vtkPVXMLElement* root,
+    bool attachShowInMenuHints);
+
+  // Description:
+  // Keeps the configuration xml of a module built in ParaView, which is only
+  // parsed by LoadPendingModules() when one of its proxy groups is first
+  // used. Most of them never are on the client.
+  void AddPendingModule(const char* xmlContent);
+
+  // Description:
+  // Parses the pending modules that define the given group, and those loaded
+  // before them. All of them are parsed when groupName is NULL.
+  void LoadPendingModules(const char* groupName);
+
   // Description:
   // Callback called when a plugin is loaded.
   void OnPluginLoaded(vtkObject* caller, unsigned long event, void* calldata);
@@ -19,6 +19,7 @@
 #include "vtkClientServerInterpreter.h"
 #include "vtkCommand.h"
 #include "vtkCompositeDataPipeline.h"
+#include "vtkDataObject.h"
 #include "vtkGeometryRepresentation.h"
 #include "vtkInformation.h"
 #include "vtkInstantiator.h"
@@ -28,6 +29,7 @@
 #include "vtkProcessModule.h"
 #include "vtkPVExtentTranslator.h"
 #include "vtkPVPostFilter.h"
+#include "vtkPVProfiler.h"
 #include "vtkPVXMLElement.h"
 #include "vtkSIPVRepresentationProxy.h"
 #include "vtkSMMessage.h"
@@ -461,6 +463,9 @@ void vtkSISourceProxy::MarkStartEvent()
     << (this->GetVTKClassName()?  this->GetVTKClassName() : this->GetClassName())
     << " id: " << this->GetGlobalID();
   vtkTimerLog::MarkStartEvent(filterName.str().c_str());
+  vtkPVProfiler::StartEvent(vtkPVProfiler::FILTER_EXECUTE,
+    this->GetVTKClassName()?  this->GetVTKClassName() : this->GetClassName(),
+    this->GetGlobalID());
 }
 
 //----------------------------------------------------------------------------
@@ -472,6 +477,18 @@ void vtkSISourceProxy::MarkEndEvent()
     << (this->GetVTKClassName()?  this->GetVTKClassName() : this->GetClassName())
     << " id: " << this->GetGlobalID();
   vtkTimerLog::MarkEndEvent(filterName.str().c_str());
+
+  // Record the size of the first output with the event.
+  vtkIdType bytes = 0;
+  vtkAlgorithm* algo = vtkAlgorithm::SafeDownCast(this->GetVTKObject());
+  if (vtkPVProfiler::GetEnabled() && algo &&
+    algo->GetNumberOfOutputPorts() > 0)
+    {
+    vtkDataObject* output = algo->GetOutputDataObject(0);
+    bytes = output?
+      static_cast<vtkIdType>(output->GetActualMemorySize())*1024 : 0;
+    }
+  vtkPVProfiler::EndEvent(bytes);
 }
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    BenchmarkStateLoad.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Times the loading of a synthetic state with a large number of proxies.
+// Every other proxy is a shrink filter whose input is the sphere before it,
+// so proxies are also located through their references.
+#include "vtkInitializationHelper.h"
+#include "vtkProcessModule.h"
+#include "vtkPVServerOptions.h"
+#include "vtkPVXMLElement.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMProxyManager.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkTimerLog.h"
+
+#include <vtksys/ios/sstream>
+
+#define NUMBER_OF_PROXIES 10000
+
+//----------------------------------------------------------------------------
+static vtkPVXMLElement* NewProxyElement(const char* group, const char* type,
+  int id)
+{
+  vtkPVXMLElement* proxyXml = vtkPVXMLElement::New();
+  proxyXml->SetName("Proxy");
+  proxyXml->AddAttribute("group", group);
+  proxyXml->AddAttribute("type", type);
+  proxyXml->AddAttribute("id", id);
+  proxyXml->AddAttribute("servers", 21);
+  return proxyXml;
+}
+
+//----------------------------------------------------------------------------
+static vtkPVXMLElement* NewSyntheticState(int numProxies)
+{
+  vtkPVXMLElement* root = vtkPVXMLElement::New();
+  root->SetName("ServerManagerState");
+  root->AddAttribute("version", "3.14.0");
+
+  vtkPVXMLElement* sources = vtkPVXMLElement::New();
+  sources->SetName("ProxyCollection");
+  sources->AddAttribute("name", "sources");
+
+  // Ids start past the ones a fresh session has already handed out.
+  const int firstId = 1000;
+  for (int cc=0; cc < numProxies; cc += 2)
+    {
+    int sphereId = firstId + cc;
+    int shrinkId = sphereId + 1;
+
+    vtkPVXMLElement* sphere = NewProxyElement("sources", "SphereSource",
+      sphereId);
+    root->AddNestedElement(sphere);
+    sphere->Delete();
+
+    vtkPVXMLElement* shrink = NewProxyElement("filters", "ShrinkFilter",
+      shrinkId);
+    vtksys_ios::ostringstream propId;
+    propId << shrinkId << ".Input";
+    vtkPVXMLElement* input = vtkPVXMLElement::New();
+    input->SetName("Property");
+    input->AddAttribute("name", "Input");
+    input->AddAttribute("id", propId.str().c_str());
+    input->AddAttribute("number_of_elements", 1);
+    vtkPVXMLElement* value = vtkPVXMLElement::New();
+    value->SetName("Proxy");
+    value->AddAttribute("value", sphereId);
+    value->AddAttribute("output_port", 0);
+    input->AddNestedElement(value);
+    value->Delete();
+    shrink->AddNestedElement(input);
+    input->Delete();
+    root->AddNestedElement(shrink);
+    shrink->Delete();
+
+    // Only the filters are registered, their inputs are found through the
+    // Input property.
+    vtksys_ios::ostringstream name;
+    name << "Shrink" << cc / 2;
+    vtkPVXMLElement* item = vtkPVXMLElement::New();
+    item->SetName("Item");
+    item->AddAttribute("id", shrinkId);
+    item->AddAttribute("name", name.str().c_str());
+    sources->AddNestedElement(item);
+    item->Delete();
+    }
+
+  root->AddNestedElement(sources);
+  sources->Delete();
+  return root;
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  vtkPVServerOptions* options = vtkPVServerOptions::New();
+  vtkInitializationHelper::Initialize( argc, argv,
+                                       vtkProcessModule::PROCESS_BATCH,
+                                       options );
+
+  int return_value = EXIT_SUCCESS;
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm =
+      vtkSMProxyManager::GetProxyManager()->GetSessionProxyManager(session);
+
+  vtkSmartPointer<vtkPVXMLElement> state;
+  state.TakeReference(NewSyntheticState(NUMBER_OF_PROXIES));
+
+  vtkTimerLog* timer = vtkTimerLog::New();
+  timer->StartTimer();
+  pxm->LoadXMLState(state);
+  timer->StopTimer();
+
+  unsigned int numRegistered = pxm->GetNumberOfProxies("sources");
+  cout << "Loaded " << NUMBER_OF_PROXIES << " proxies in "
+       << timer->GetElapsedTime() << " seconds, "
+       << numRegistered << " registered." << endl;
+  if (numRegistered != NUMBER_OF_PROXIES / 2)
+    {
+    cout << "ERROR: expected " << NUMBER_OF_PROXIES / 2
+         << " registered proxies." << endl;
+    return_value = EXIT_FAILURE;
+    }
+  timer->Delete();
+
+  state = 0;
+  pxm->UnRegisterProxies();
+  session->Delete();
+
+  vtkInitializationHelper::Finalize();
+  options->Delete();
+  return return_value;
+}
@@ -0,0 +1,202 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestStateLoadRegistrations.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that loading a state locates the proxies referenced by properties
+// and registers each proxy once per group: every shrink filter must get the
+// sphere with its own resolution as input, and a proxy listed twice in a
+// collection is only registered under its first name.
+#include "vtkInitializationHelper.h"
+#include "vtkProcessModule.h"
+#include "vtkPVServerOptions.h"
+#include "vtkPVXMLElement.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMProxy.h"
+#include "vtkSMProxyManager.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+
+#include <vtksys/ios/sstream>
+
+#define NUMBER_OF_PAIRS 20
+
+//----------------------------------------------------------------------------
+static vtkPVXMLElement* NewProxyElement(const char* group, const char* type,
+  int id)
+{
+  vtkPVXMLElement* proxyXml = vtkPVXMLElement::New();
+  proxyXml->SetName("Proxy");
+  proxyXml->AddAttribute("group", group);
+  proxyXml->AddAttribute("type", type);
+  proxyXml->AddAttribute("id", id);
+  proxyXml->AddAttribute("servers", 21);
+  return proxyXml;
+}
+
+//----------------------------------------------------------------------------
+// Adds a property with a single value, a proxy id when isProxy is true.
+static void AddProperty(vtkPVXMLElement* proxyXml, const char* name,
+  int proxyId, bool isProxy, int value)
+{
+  vtksys_ios::ostringstream propId;
+  propId << proxyId << "." << name;
+  vtkPVXMLElement* property = vtkPVXMLElement::New();
+  property->SetName("Property");
+  property->AddAttribute("name", name);
+  property->AddAttribute("id", propId.str().c_str());
+  property->AddAttribute("number_of_elements", 1);
+  vtkPVXMLElement* element = vtkPVXMLElement::New();
+  if (isProxy)
+    {
+    element->SetName("Proxy");
+    element->AddAttribute("value", value);
+    element->AddAttribute("output_port", 0);
+    }
+  else
+    {
+    element->SetName("Element");
+    element->AddAttribute("index", 0);
+    element->AddAttribute("value", value);
+    }
+  property->AddNestedElement(element);
+  element->Delete();
+  proxyXml->AddNestedElement(property);
+  property->Delete();
+}
+
+//----------------------------------------------------------------------------
+static void AddItem(vtkPVXMLElement* collection, int id, const char* name)
+{
+  vtkPVXMLElement* item = vtkPVXMLElement::New();
+  item->SetName("Item");
+  item->AddAttribute("id", id);
+  item->AddAttribute("name", name);
+  collection->AddNestedElement(item);
+  item->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Pairs of a sphere and a shrink filter taking it as input. Sphere cc has a
+// ThetaResolution of 3 + cc. The spheres are listed after all the filters so
+// that they are located through the Input properties. The first filter is
+// also listed a second time, under another name.
+static vtkPVXMLElement* NewState()
+{
+  vtkPVXMLElement* root = vtkPVXMLElement::New();
+  root->SetName("ServerManagerState");
+  root->AddAttribute("version", "3.14.0");
+
+  const int firstId = 1000;
+  for (int cc=0; cc < NUMBER_OF_PAIRS; cc++)
+    {
+    vtkPVXMLElement* shrink = NewProxyElement("filters", "ShrinkFilter",
+      firstId + 2 * cc + 1);
+    AddProperty(shrink, "Input", firstId + 2 * cc + 1, true,
+      firstId + 2 * cc);
+    root->AddNestedElement(shrink);
+    shrink->Delete();
+    }
+  for (int cc=0; cc < NUMBER_OF_PAIRS; cc++)
+    {
+    vtkPVXMLElement* sphere = NewProxyElement("sources", "SphereSource",
+      firstId + 2 * cc);
+    AddProperty(sphere, "ThetaResolution", firstId + 2 * cc, false, 3 + cc);
+    root->AddNestedElement(sphere);
+    sphere->Delete();
+    }
+
+  vtkPVXMLElement* sources = vtkPVXMLElement::New();
+  sources->SetName("ProxyCollection");
+  sources->AddAttribute("name", "sources");
+  for (int cc=0; cc < NUMBER_OF_PAIRS; cc++)
+    {
+    vtksys_ios::ostringstream name;
+    name << "Shrink" << cc;
+    AddItem(sources, firstId + 2 * cc + 1, name.str().c_str());
+    }
+  AddItem(sources, firstId + 1, "Alias");
+  root->AddNestedElement(sources);
+  sources->Delete();
+  return root;
+}
+
+//----------------------------------------------------------------------------
+static bool CheckLoadedState(vtkSMSessionProxyManager* pxm)
+{
+  bool ok = true;
+  unsigned int numRegistered = pxm->GetNumberOfProxies("sources");
+  if (numRegistered != NUMBER_OF_PAIRS)
+    {
+    cout << "ERROR: " << numRegistered << " registered proxies instead of "
+         << NUMBER_OF_PAIRS << "." << endl;
+    ok = false;
+    }
+  if (pxm->GetProxy("sources", "Alias"))
+    {
+    cout << "ERROR: a proxy was registered twice in the same group." << endl;
+    ok = false;
+    }
+  for (int cc=0; cc < NUMBER_OF_PAIRS; cc++)
+    {
+    vtksys_ios::ostringstream name;
+    name << "Shrink" << cc;
+    vtkSMProxy* shrink = pxm->GetProxy("sources", name.str().c_str());
+    vtkSMProxy* sphere = shrink?
+      vtkSMPropertyHelper(shrink, "Input").GetAsProxy() : 0;
+    if (!sphere ||
+      vtkSMPropertyHelper(sphere, "ThetaResolution").GetAsInt() != 3 + cc)
+      {
+      cout << "ERROR: " << name.str() << " does not have the right input."
+           << endl;
+      ok = false;
+      }
+    }
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  vtkPVServerOptions* options = vtkPVServerOptions::New();
+  vtkInitializationHelper::Initialize( argc, argv,
+                                       vtkProcessModule::PROCESS_BATCH,
+                                       options );
+
+  int return_value = EXIT_SUCCESS;
+  vtkSMSession* session = vtkSMSession::New();
+  vtkSMSessionProxyManager* pxm =
+      vtkSMProxyManager::GetProxyManager()->GetSessionProxyManager(session);
+
+  vtkSmartPointer<vtkPVXMLElement> state;
+  state.TakeReference(NewState());
+
+  // Loading again after clearing the proxy manager gives the same result.
+  for (int load=0; load < 2; load++)
+    {
+    pxm->LoadXMLState(state);
+    if (!CheckLoadedState(pxm))
+      {
+      cout << "ERROR: load " << load << " failed." << endl;
+      return_value = EXIT_FAILURE;
+      }
+    pxm->UnRegisterProxies();
+    }
+
+  state = 0;
+  session->Delete();
+
+  vtkInitializationHelper::Finalize();
+  options->Delete();
+  return return_value;
+}
@@ -23,6 +23,53 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkSMSession.h"
 #include "vtkSMSessionProxyManager.h"
 #include "vtkSMDoubleVectorProperty.h"
+#include "vtkSMMessage.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkCallbackCommand.h"
+#include "vtkSphereSource.h"
+
+namespace
+{
+  // Records the properties pushed by UpdateVTKObjects(). When Radius is
+  // pushed, ThetaResolution is modified.
+  struct UpdatedProperties
+  {
+    QStringList Names;
+    vtkSMProxy* Proxy;
+    int ThetaResolution;
+  };
+
+  void OnUpdateProperty(vtkObject*, unsigned long, void* clientdata,
+    void* calldata)
+  {
+    UpdatedProperties* self = static_cast<UpdatedProperties*>(clientdata);
+    QString name = static_cast<const char*>(calldata);
+    self->Names << name;
+    if (name == "Radius" && self->ThetaResolution)
+      {
+      vtkSMPropertyHelper(self->Proxy, "ThetaResolution").Set(
+        self->ThetaResolution);
+      self->ThetaResolution = 0;
+      }
+  }
+
+  // The value of a property in the full state of the proxy.
+  const Variant* GetStateValue(vtkSMProxy* proxy, const char* name)
+  {
+    const vtkSMMessage* state = proxy->GetFullState();
+    int nbProps = state->ExtensionSize(ProxyState::property);
+    for (int cc = 0; cc < nbProps; cc++)
+      {
+      const ProxyState_Property& prop =
+        state->GetExtension(ProxyState::property, cc);
+      if (prop.name() == name)
+        {
+        return &prop.value();
+        }
+      }
+    return NULL;
+  }
+}
 
 void vtkSMProxyTest::SetAnnotation()
 {
@@ -100,6 +147,69 @@ void vtkSMProxyTest::GetVTKClassName()
   proxy->Delete();
 }
 
+void vtkSMProxyTest::UpdateVTKObjects()
+{
+  vtkSMSession *session = vtkSMSession::New();
+  vtkSMSessionProxyManager *pxm = session->GetSessionProxyManager();
+  vtkSMProxy *proxy = pxm->NewProxy("sources", "SphereSource");
+  QVERIFY(proxy != NULL);
+  proxy->UpdateVTKObjects();
+  vtkSphereSource* sphere =
+    vtkSphereSource::SafeDownCast(proxy->GetClientSideObject());
+  QVERIFY(sphere != NULL);
+
+  UpdatedProperties updated;
+  updated.Proxy = proxy;
+  updated.ThetaResolution = 0;
+  vtkCallbackCommand* observer = vtkCallbackCommand::New();
+  observer->SetClientData(&updated);
+  observer->SetCallback(&OnUpdateProperty);
+  proxy->AddObserver(vtkCommand::UpdatePropertyEvent, observer);
+
+  // only the modified properties are pushed, in the order of their names,
+  // and the state keeps the values of the others.
+  double center[3] = { 1.0, 2.0, 3.0 };
+  vtkSMPropertyHelper(proxy, "Radius").Set(2.5);
+  vtkSMPropertyHelper(proxy, "Center").Set(center, 3);
+  proxy->UpdateVTKObjects();
+  QCOMPARE(updated.Names, QStringList() << "Center" << "Radius");
+  QCOMPARE(sphere->GetRadius(), 2.5);
+  QCOMPARE(sphere->GetCenter()[2], 3.0);
+  const Variant* value = GetStateValue(proxy, "Radius");
+  QVERIFY(value != NULL && value->float64_size() == 1);
+  QCOMPARE(value->float64(0), 2.5);
+  value = GetStateValue(proxy, "Center");
+  QVERIFY(value != NULL && value->float64_size() == 3);
+  QCOMPARE(value->float64(1), 2.0);
+  value = GetStateValue(proxy, "ThetaResolution");
+  QVERIFY(value != NULL && value->integer_size() == 1);
+  QCOMPARE(value->integer(0), sphere->GetThetaResolution());
+
+  // nothing is pushed when nothing was modified.
+  updated.Names.clear();
+  proxy->UpdateVTKObjects();
+  QVERIFY(updated.Names.isEmpty());
+
+  // a property modified while pushing is pushed by the next update.
+  updated.ThetaResolution = 12;
+  vtkSMPropertyHelper(proxy, "Radius").Set(3.0);
+  proxy->UpdateVTKObjects();
+  QCOMPARE(updated.Names, QStringList() << "Radius");
+  QCOMPARE(sphere->GetRadius(), 3.0);
+  updated.Names.clear();
+  proxy->UpdateVTKObjects();
+  QCOMPARE(updated.Names, QStringList() << "ThetaResolution");
+  QCOMPARE(sphere->GetThetaResolution(), 12);
+  value = GetStateValue(proxy, "ThetaResolution");
+  QVERIFY(value != NULL && value->integer_size() == 1);
+  QCOMPARE(value->integer(0), 12);
+
+  proxy->RemoveObserver(observer);
+  observer->Delete();
+  proxy->Delete();
+  session->Delete();
+}
+
 int main(int argc, char *argv[])
 {
   vtkPVServerOptions* options = vtkPVServerOptions::New();
@@ -26,6 +26,7 @@ private slots:
   void SetAnnotation();
   void GetProperty();
   void GetVTKClassName();
+  void UpdateVTKObjects();
 };
 
 #endif
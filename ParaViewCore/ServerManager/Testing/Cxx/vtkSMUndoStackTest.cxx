@@ -81,6 +81,148 @@ void vtkSMUndoStackTest::StackDepth()
   stack->Delete();
 }
 
+// Push an undo set that changes the radius of sphere.
+static void PushRadius(vtkSMUndoStack *undoStack, vtkSMSession *session,
+                       vtkSMProxy *sphere, double radius)
+{
+  vtkUndoSet *undoSet = vtkUndoSet::New();
+  vtkSMRemoteObjectUpdateUndoElement *undoElement =
+    vtkSMRemoteObjectUpdateUndoElement::New();
+  undoElement->SetSession(session);
+
+  vtkSMMessage before;
+  before.CopyFrom(*sphere->GetFullState());
+  vtkSMPropertyHelper(sphere, "Radius").Set(radius);
+  sphere->UpdateVTKObjects();
+  vtkSMMessage after;
+  after.CopyFrom(*sphere->GetFullState());
+  undoElement->SetUndoRedoState(&before, &after);
+
+  undoSet->AddElement(undoElement);
+  undoElement->Delete();
+  undoStack->Push("ChangeRadius", undoSet);
+  undoSet->Delete();
+}
+
+void vtkSMUndoStackTest::PropertyDelta()
+{
+  vtkSMSession *session = vtkSMSession::New();
+  vtkSMSessionProxyManager *pxm = session->GetSessionProxyManager();
+
+  vtkSMProxy *sphere = pxm->NewProxy("sources", "SphereSource");
+  sphere->UpdateVTKObjects();
+
+  vtkSMRemoteObjectUpdateUndoElement *undoElement =
+    vtkSMRemoteObjectUpdateUndoElement::New();
+  undoElement->SetSession(session);
+
+  vtkSMMessage before;
+  before.CopyFrom(*sphere->GetFullState());
+  vtkSMPropertyHelper(sphere, "Radius").Set(1.2);
+  sphere->UpdateVTKObjects();
+  vtkSMMessage after;
+  after.CopyFrom(*sphere->GetFullState());
+  undoElement->SetUndoRedoState(&before, &after);
+
+  // Only the radius is stored.
+  QCOMPARE(undoElement->BeforeState->ExtensionSize(ProxyState::property), 1);
+  QCOMPARE(undoElement->AfterState->ExtensionSize(ProxyState::property), 1);
+  QVERIFY(undoElement->GetStateSize() < before.ByteSize() + after.ByteSize());
+
+  // The full states are the ones that used to be stored.
+  vtkSMMessage fullBefore;
+  vtkSMMessage fullAfter;
+  QVERIFY(undoElement->GetFullBeforeState(&fullBefore));
+  QVERIFY(undoElement->GetFullAfterState(&fullAfter));
+  QVERIFY(fullBefore.SerializeAsString() == before.SerializeAsString());
+  QVERIFY(fullAfter.SerializeAsString() == after.SerializeAsString());
+
+  undoElement->Delete();
+  sphere->Delete();
+  session->Delete();
+}
+
+void vtkSMUndoStackTest::MergePushes()
+{
+  vtkSMSession *session = vtkSMSession::New();
+  vtkSMSessionProxyManager *pxm = session->GetSessionProxyManager();
+
+  vtkSMProxy *sphere = pxm->NewProxy("sources", "SphereSource");
+  sphere->UpdateVTKObjects();
+
+  // Updates of the same property close in time are undone in one step.
+  vtkSMUndoStack *undoStack = vtkSMUndoStack::New();
+  undoStack->SetMergeTimeWindow(60.0);
+  PushRadius(undoStack, session, sphere, 1.0);
+  PushRadius(undoStack, session, sphere, 1.5);
+  PushRadius(undoStack, session, sphere, 2.0);
+  QCOMPARE(undoStack->GetNumberOfUndoSets(), 1u);
+  undoStack->Undo();
+  sphere->UpdateVTKObjects();
+  QCOMPARE(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble(), 0.5);
+  undoStack->Redo();
+  sphere->UpdateVTKObjects();
+  QCOMPARE(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble(), 2.0);
+  undoStack->Delete();
+
+  // Without merging, each update is its own step.
+  undoStack = vtkSMUndoStack::New();
+  undoStack->SetMergeTimeWindow(0.0);
+  PushRadius(undoStack, session, sphere, 2.5);
+  PushRadius(undoStack, session, sphere, 3.0);
+  QCOMPARE(undoStack->GetNumberOfUndoSets(), 2u);
+  undoStack->Undo();
+  sphere->UpdateVTKObjects();
+  QCOMPARE(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble(), 2.5);
+  undoStack->Undo();
+  sphere->UpdateVTKObjects();
+  QCOMPARE(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble(), 2.0);
+  undoStack->Delete();
+
+  sphere->Delete();
+  session->Delete();
+}
+
+void vtkSMUndoStackTest::MaximumStateSize()
+{
+  vtkSMSession *session = vtkSMSession::New();
+  vtkSMSessionProxyManager *pxm = session->GetSessionProxyManager();
+
+  vtkSMProxy *sphere = pxm->NewProxy("sources", "SphereSource");
+  sphere->UpdateVTKObjects();
+
+  vtkSMUndoStack *undoStack = vtkSMUndoStack::New();
+  undoStack->SetMergeTimeWindow(0.0);
+  QCOMPARE(undoStack->GetMaximumStateSize(), static_cast<vtkIdType>(0));
+  PushRadius(undoStack, session, sphere, 1.0);
+  vtkIdType setSize = undoStack->GetUndoStackStateSize();
+  QVERIFY(setSize > 0);
+
+  // Room for two and a half sets, the oldest ones are dropped.
+  undoStack->SetMaximumStateSize(setSize * 5 / 2);
+  for (int cc=0; cc < 4; ++cc)
+    {
+    PushRadius(undoStack, session, sphere, 1.5 + cc);
+    }
+  QCOMPARE(undoStack->GetNumberOfUndoSets(), 2u);
+  QVERIFY(undoStack->GetUndoStackStateSize() <=
+          undoStack->GetMaximumStateSize());
+  undoStack->Undo();
+  undoStack->Undo();
+  sphere->UpdateVTKObjects();
+  QCOMPARE(vtkSMPropertyHelper(sphere, "Radius").GetAsDouble(), 2.5);
+  QVERIFY(static_cast<bool>(undoStack->CanUndo()) == false);
+
+  // The most recent set is kept even when it is too large.
+  undoStack->SetMaximumStateSize(1);
+  PushRadius(undoStack, session, sphere, 10.0);
+  QCOMPARE(undoStack->GetNumberOfUndoSets(), 1u);
+
+  undoStack->Delete();
+  sphere->Delete();
+  session->Delete();
+}
+
 int main(int argc, char *argv[])
 {
   vtkPVServerOptions* options = vtkPVServerOptions::New();
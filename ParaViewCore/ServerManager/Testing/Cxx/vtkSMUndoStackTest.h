@@ -25,6 +25,9 @@ class vtkSMUndoStackTest : public QObject
 private slots:
   void UndoRedo();
   void StackDepth();
+  void PropertyDelta();
+  void MergePushes();
+  void MaximumStateSize();
 };
 
 #endif
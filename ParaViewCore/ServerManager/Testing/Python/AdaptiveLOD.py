@@ -0,0 +1,56 @@
+# Test that the LOD geometry is delivered and rendered again when adaptive
+# interactive rendering lowers the LOD resolution.
+
+import SMPythonTesting
+import sys
+from paraview import servermanager
+
+SMPythonTesting.ProcessCommandLineArguments()
+
+servermanager.Connect()
+
+def Error(message):
+    print "ERROR:", message
+    sys.exit(1)
+
+def GetNumberOfLODPoints(representation):
+    geometry = representation.GetClientSideObject().GetActiveRepresentation()
+    info = servermanager.vtkPVDataInformation()
+    info.CopyFromObject(geometry.GetRenderedLODDataObject())
+    return info.GetNumberOfPoints()
+
+sphere = servermanager.sources.SphereSource(ThetaResolution=256,
+  PhiResolution=256)
+
+view = servermanager.CreateRenderView()
+if view.GetProperty("RemoteRenderThreshold"):
+    view.RemoteRenderThreshold = 1000000
+
+# Always render the LOD when interacting, and make every interactive render
+# too slow, so that the LOD resolution is lowered after each one.
+view.LODThreshold = 0
+view.LODResolution = 1
+view.UseAdaptiveInteractiveRendering = 1
+view.TargetInteractiveRenderTime = 1e-9
+view.NumberOfInteractiveRenderTimes = 1
+
+representation = servermanager.CreateRepresentation(sphere, view)
+view.StillRender()
+view.ResetCamera()
+view.StillRender()
+
+renderView = view.GetClientSideObject()
+view.SMProxy.InteractiveRender()
+resolution = renderView.GetAdaptiveLODResolution()
+numPoints = GetNumberOfLODPoints(representation)
+if numPoints == 0:
+    Error("No LOD geometry was rendered")
+if resolution >= 1:
+    Error("The LOD resolution was not lowered")
+
+# The next interactive render uses the lower resolution.
+view.SMProxy.InteractiveRender()
+lowNumPoints = GetNumberOfLODPoints(representation)
+if lowNumPoints == 0 or lowNumPoints >= numPoints:
+    Error("The LOD geometry has %d points at resolution %g, and %d at "
+          "resolution 1" % (lowNumPoints, resolution, numPoints))
@@ -0,0 +1,69 @@
+# Runs the benchmark scenarios from paraview.benchmark under pvpython or
+# pvbatch and optionally compares the results with a baseline.
+#
+# Usage: BenchmarkSuite.py [--scenario name] [--size n] [--repeat n]
+#          [--output results.json] [--baseline baseline.json]
+#          [--tolerance fraction] [--profile] [-T tempdir]
+#
+# --scenario may be repeated; all scenarios are run when it is not given.
+# The test fails when a scenario is slower than its baseline by more than the
+# tolerance (0.25 by default).
+
+import sys
+from paraview import servermanager
+
+if not servermanager.ActiveConnection:
+    servermanager.Connect()
+
+from paraview import benchmark
+
+names = []
+size = 64
+repeat = 5
+output = None
+baseline = None
+tolerance = 0.25
+profile = False
+tempdir = None
+
+index = 1
+while index < len(sys.argv):
+    key = sys.argv[index]
+    if key == "--profile":
+        profile = True
+        index += 1
+        continue
+    if index + 1 >= len(sys.argv):
+        break
+    value = sys.argv[index+1]
+    if key == "--scenario":
+        names.append(value)
+    elif key == "--size":
+        size = int(value)
+    elif key == "--repeat":
+        repeat = int(value)
+    elif key == "--output":
+        output = value
+    elif key == "--baseline":
+        baseline = value
+    elif key == "--tolerance":
+        tolerance = float(value)
+    elif key == "-T":
+        tempdir = value
+    index += 2
+
+for name in names:
+    if name not in benchmark.scenarios:
+        raise RuntimeError, "Unknown benchmark scenario '%s'" % name
+
+results = benchmark.run_scenarios(names or None, size, repeat, tempdir,
+                                  profile)
+if output:
+    benchmark.save_results(output, results)
+
+if baseline:
+    regressions = benchmark.compare_results(
+      results, benchmark.load_results(baseline), tolerance)
+    if regressions:
+        raise RuntimeError, "Performance regression in: %s" % \
+              ", ".join(regressions)
@@ -0,0 +1,93 @@
+# Test servermanager.FetchPieces and the vtkReductionFilter options it relies
+# on (PassThrough, PassSelectedArrays), with and without compression.
+
+import SMPythonTesting
+import sys
+from paraview import *
+
+SMPythonTesting.ProcessCommandLineArguments()
+
+servermanager.Connect()
+
+def Error(message):
+    print "ERROR:", message
+    sys.exit(1)
+
+def CheckArray(data, reference, name):
+    array = data.GetPointData().GetArray(name)
+    refArray = reference.GetPointData().GetArray(name)
+    if not array or not refArray:
+        Error("Missing array %s" % name)
+    if array.GetNumberOfTuples() != refArray.GetNumberOfTuples():
+        Error("Array %s has %d values instead of %d" % (name,
+          array.GetNumberOfTuples(), refArray.GetNumberOfTuples()))
+    for i in range(array.GetNumberOfTuples()):
+        for c in range(array.GetNumberOfComponents()):
+            if array.GetComponent(i, c) != refArray.GetComponent(i, c):
+                Error("Value %d of %s differs" % (i, name))
+
+def CheckSame(data, reference, arrays):
+    if data.GetNumberOfPoints() != reference.GetNumberOfPoints() or \
+      data.GetNumberOfCells() != reference.GetNumberOfCells():
+        Error("%d points and %d cells instead of %d and %d" % (
+          data.GetNumberOfPoints(), data.GetNumberOfCells(),
+          reference.GetNumberOfPoints(), reference.GetNumberOfCells()))
+    for name in arrays:
+        CheckArray(data, reference, name)
+
+# Polygonal data, so that compression applies.
+wavelet = servermanager.sources.Wavelet()
+elevation = servermanager.filters.ElevationFilter(Input=wavelet)
+surface = servermanager.filters.DataSetSurfaceFilter(Input=elevation)
+reference = servermanager.Fetch(surface)
+
+numProcs = surface.SMProxy.GetSession().GetServerInformation( \
+  ).GetNumberOfProcesses()
+
+# ReductionFilter only passing the data of process 0, then only some arrays.
+reducer = servermanager.filters.ReductionFilter(Input=surface)
+reducer.PassThrough = 0
+if numProcs == 1:
+    CheckSame(servermanager.Fetch(reducer), reference, ["RTData", "Elevation"])
+reducer.PassSelectedArrays = 1
+reducer.SelectedArrays = ["RTData"]
+passed = servermanager.Fetch(reducer)
+if passed.GetPointData().GetArray("Elevation"):
+    Error("Elevation was not removed")
+if numProcs == 1:
+    CheckSame(passed, reference, ["RTData"])
+
+# The pieces add up to the whole output.
+for compression in [0, 6]:
+    pieces = list(servermanager.FetchPieces(surface, compression=compression))
+    if len(pieces) < 1 or len(pieces) > numProcs:
+        Error("%d pieces for %d processes" % (len(pieces), numProcs))
+    numPoints = 0
+    for piece in pieces:
+        numPoints += piece.GetNumberOfPoints()
+    if numPoints != reference.GetNumberOfPoints():
+        Error("The pieces have %d points instead of %d" % (numPoints,
+          reference.GetNumberOfPoints()))
+    if numProcs == 1:
+        CheckSame(pieces[0], reference, ["RTData", "Elevation"])
+
+    pieces = list(servermanager.FetchPieces(surface, arrays=["Elevation"],
+      compression=compression))
+    for piece in pieces:
+        if piece.GetPointData().GetArray("RTData"):
+            Error("RTData was not removed")
+    if numProcs == 1:
+        CheckSame(pieces[0], reference, ["Elevation"])
+
+# One leaf block at a time.
+sphere = servermanager.sources.SphereSource()
+sphereReference = servermanager.Fetch(sphere)
+group = servermanager.filters.GroupDatasets(Input=[surface, sphere])
+for compression in [0, 6]:
+    pieces = list(servermanager.FetchPieces(group, blocks=True,
+      compression=compression))
+    if numProcs == 1:
+        if len(pieces) != 2:
+            Error("%d blocks instead of 2" % len(pieces))
+        CheckSame(pieces[0], reference, ["RTData", "Elevation"])
+        CheckSame(pieces[1], sphereReference, ["Normals"])
@@ -0,0 +1,51 @@
+# Test that the fused, block by block evaluation of paraview.vtk.algorithms
+# gives the same values and types as eval(), in particular when the result of
+# an operation on integers is a floating point array.
+
+import SMPythonTesting
+import sys
+
+SMPythonTesting.ProcessCommandLineArguments()
+
+import numpy
+from paraview.vtk import algorithms
+
+def Error(message):
+    print "ERROR:", message
+    sys.exit(1)
+
+n = 23
+namespace = { 'sqrt' : numpy.sqrt,
+              'sin' : numpy.sin,
+              'exp' : numpy.exp,
+              'absolute' : numpy.absolute,
+              'a' : numpy.arange(1, n + 1, dtype=numpy.int32),
+              'b' : numpy.arange(n, dtype=numpy.int32) % 5 + 1,
+              'c' : numpy.arange(n, dtype=numpy.int64) - 7,
+              'v' : numpy.arange(3 * n, dtype=numpy.int32).reshape(n, 3),
+              'x' : numpy.linspace(-1.0, 2.0, n),
+              'y' : numpy.linspace(3.0, 0.5, n),
+              'f' : numpy.linspace(0.0, 1.0, n).astype(numpy.float32) }
+
+expressions = [
+  # Integers
+  "a + b", "a * b + c", "-(a * b)", "(a + b) ** 2", "a * b / b", "v * 2 + 1",
+  # Integers giving floating point values
+  "sqrt(a * b)", "sin(a + b) * 2", "exp(-(a - b) * 0.1)", "(a + b) * 0.5",
+  "a * b + x", "sqrt(a * a + b * b) + c", "sqrt(v + 1)",
+  # Floating point values
+  "(x + y) * (x - y)", "f * f + 1", "f * 2.5 + x", "absolute(x - y) * f"]
+
+# Block sizes smaller than, dividing or not the number of tuples, and larger.
+for expression in expressions:
+    expected = eval(expression, namespace)
+    for blocksize in [1, 4, 7, 23, 100]:
+        result = algorithms.evaluate(expression, namespace, namespace,
+                                     blocksize=blocksize)
+        if result.dtype != expected.dtype or result.shape != expected.shape:
+            Error("%s in blocks of %d is %s %s instead of %s %s" % (expression,
+              blocksize, result.dtype, result.shape, expected.dtype,
+              expected.shape))
+        if not numpy.allclose(result, expected):
+            Error("%s in blocks of %d has different values" % (expression,
+              blocksize))
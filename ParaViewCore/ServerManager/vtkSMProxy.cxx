@@ -330,6 +330,45 @@ void vtkSMProxy::AddProperty(const char* name, vtkSMProperty* prop)
   this->Internals->PropertyNamesInOrder.push_back(name);
 }
 
+//---------------------------------------------------------------------------
+// vtkSMProperty, internal and state ignored properties are not kept in the
+// proxy state.
+static bool vtkSMProxyHasPropertyState(vtkSMProperty* property)
+{
+  return !(property->GetIsInternal() || property->IsStateIgnored() ||
+    strcmp(property->GetClassName(), "vtkSMProperty") == 0);
+}
+
+//---------------------------------------------------------------------------
+// Replaces the value of a property in the proxy state. The index of the
+// property in the state is remembered when the state is built so the other
+// properties are left alone. Falls back on a search by name if the state
+// has been changed under us.
+static void vtkSMProxyUpdatePropertyState(vtkSMMessage* state,
+  vtkSMProxyInternals::PropertyInfo& info, const ProxyState_Property& value)
+{
+  int nbProps = state->ExtensionSize(ProxyState::property);
+  int index = info.StateIndex;
+  if (index < 0 || index >= nbProps ||
+    state->GetExtension(ProxyState::property, index).name() != value.name())
+    {
+    for (index = 0; index < nbProps; ++index)
+      {
+      if (state->GetExtension(ProxyState::property, index).name() ==
+        value.name())
+        {
+        break;
+        }
+      }
+    if (index == nbProps)
+      {
+      state->AddExtension(ProxyState::property);
+      }
+    info.StateIndex = index;
+    }
+  state->MutableExtension(ProxyState::property, index)->CopyFrom(value);
+}
+
 //---------------------------------------------------------------------------
 bool vtkSMProxy::UpdateProperty(const char* name, int force)
 {
@@ -377,32 +416,15 @@ bool vtkSMProxy::UpdateProperty(const char* name, int force)
   it->second.ModifiedFlag = 0;
 
   vtkSMMessage message;
+  it->second.Property->WriteTo(&message);
 
   // Make sure the local state is updated as well
-  if(this->State)
+  if (this->State && vtkSMProxyHasPropertyState(it->second.Property))
     {
-    vtkSMMessage oldState;
-    oldState.CopyFrom(*this->State);
-    this->State->ClearExtension(ProxyState::property);
-    int nbProps = oldState.ExtensionSize(ProxyState::property);
-    for(int cc=0; cc < nbProps; cc++)
-      {
-      const ProxyState_Property *oldProperty =
-          &oldState.GetExtension(ProxyState::property, cc);
-
-      if(oldProperty->name() == it->second.Property->GetXMLName())
-        {
-        it->second.Property->WriteTo(this->State);
-        }
-      else
-        {
-        ProxyState_Property *newProperty = this->State->AddExtension(ProxyState::property);
-        newProperty->CopyFrom(oldState.GetExtension(ProxyState::property, cc));
-        }
-      }
+    vtkSMProxyUpdatePropertyState(this->State, it->second,
+      message.GetExtension(ProxyState::property, 0));
     }
 
-  it->second.Property->WriteTo(&message);
   this->PushState(&message);
 
   // Fire event to let everyone know that a property has been updated.
@@ -436,6 +458,7 @@ void vtkSMProxy::SetPropertyModifiedFlag(const char* name, int flag)
     return;
     }
 
+  int wasModified = it->second.ModifiedFlag;
   it->second.ModifiedFlag = flag;
 
   if (flag && !this->DoNotUpdateImmediately && prop->GetImmediateUpdate())
@@ -444,6 +467,10 @@ void vtkSMProxy::SetPropertyModifiedFlag(const char* name, int flag)
     }
   else
     {
+    if (flag && !wasModified)
+      {
+      this->Internals->ModifiedProperties.push_back(it);
+      }
     this->PropertiesModified = 1;
     }
 }
@@ -582,75 +609,47 @@ void vtkSMProxy::UpdateVTKObjects()
     {
     this->InUpdateVTKObjects = 1;
 
-    // Save previous property values and clear the State properties
-    vtkSMMessage oldState;
-    oldState.CopyFrom(*this->State);
-    this->State->ClearExtension(ProxyState::property);
+    // Only visit the properties that were modified, in the order of the
+    // property map. Properties modified while pushing end up in a new list.
+    vtkSMProxyInternals::ModifiedPropertiesType modified;
+    modified.swap(this->Internals->ModifiedProperties);
+    std::sort(modified.begin(), modified.end(),
+      vtkSMProxyInternals::PropertyNameLess);
 
-    // iterate over all properties and push modified ones.
     vtkSMMessage message;
-    vtkSMProxyInternals::PropertyInfoMap::iterator iter;
-    int cc = 0;
-    for (iter = this->Internals->Properties.begin();
-         iter != this->Internals->Properties.end(); ++iter)
+    vtkSMProxyInternals::ModifiedPropertiesType::iterator miter;
+    for (miter = modified.begin(); miter != modified.end(); ++miter)
       {
+      vtkSMProxyInternals::PropertyInfoMap::iterator iter = *miter;
       vtkSMProperty* property = iter->second.Property;
-      if (property && !property->GetInformationOnly())
+      if (!iter->second.ModifiedFlag ||
+        !property || property->GetInformationOnly())
         {
-        if (property->GetIsInternal() || property->IsStateIgnored() ||
-          strcmp(property->GetClassName(), "vtkSMProperty") == 0)
-          {
-          // Push only modified properties
-          if (iter->second.ModifiedFlag)
-            {
-            // Write to message because vtkSMProperty do not have state
-            property->WriteTo(&message);
-
-            // the property is no longer dirty.
-            iter->second.ModifiedFlag = 0;
-
-            // Fire event to let everyone know that a property has been updated.
-            // This is currently used by vtkSMLink. Need to see if we can avoid this
-            // as firing these events ain't inexpensive.
-            this->InvokeEvent(vtkCommand::UpdatePropertyEvent,
-              const_cast<char*>(iter->first.c_str()));
-            }
-          }
-        else
-          {
-          // Push only modified properties
-          if(iter->second.ModifiedFlag)
-            {
-            // Write to state
-            property->WriteTo(this->State);
-
-            // the property is no longer dirty.
-            iter->second.ModifiedFlag = 0;
+        continue;
+        }
 
-            // Write to Push message
-            ProxyState_Property *prop = message.AddExtension(ProxyState::property);
-            prop->CopyFrom(this->State->GetExtension(ProxyState::property, cc));
+      // Write to Push message
+      property->WriteTo(&message);
 
-            // Fire event to let everyone know that a property has been updated.
-            // This is currently used by vtkSMLink. Need to see if we can avoid this
-            // as firing these events ain't inexpensive.
-            this->InvokeEvent(vtkCommand::UpdatePropertyEvent,
-              const_cast<char*>(iter->first.c_str()));
-            }
-          else
-            {
-            // Just copy the previous old value to the state
-            ProxyState_Property *prop = this->State->AddExtension(ProxyState::property);
-            prop->CopyFrom(oldState.GetExtension(ProxyState::property, cc));
-            }
+      // the property is no longer dirty.
+      iter->second.ModifiedFlag = 0;
 
-          // One more property
-          ++cc;
-          }
+      // Keep the local state up to date as well.
+      if (vtkSMProxyHasPropertyState(property))
+        {
+        vtkSMProxyUpdatePropertyState(this->State, iter->second,
+          message.GetExtension(ProxyState::property,
+            message.ExtensionSize(ProxyState::property) - 1));
         }
+
+      // Fire event to let everyone know that a property has been updated.
+      // This is currently used by vtkSMLink. Need to see if we can avoid this
+      // as firing these events ain't inexpensive.
+      this->InvokeEvent(vtkCommand::UpdatePropertyEvent,
+        const_cast<char*>(iter->first.c_str()));
       }
     this->InUpdateVTKObjects = 0;
-    this->PropertiesModified = false;
+    this->PropertiesModified = !this->Internals->ModifiedProperties.empty();
 
     // Send the message
     this->PushState(&message);
@@ -741,6 +740,8 @@ void vtkSMProxy::CreateVTKObjects()
       else
         {
         // Write empty property inside state
+        iter->second.StateIndex =
+          this->State->ExtensionSize(ProxyState::property);
         property->WriteTo(this->State);
         }
       }
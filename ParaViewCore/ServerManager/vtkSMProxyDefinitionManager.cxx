@@ -85,7 +85,13 @@ void vtkSMProxyDefinitionManager::SynchronizeDefinitions()
     return;
     }
 
+  // Send the hash of the core definitions we already have, the server does
+  // not send them again if they are the same.
   vtkSMMessage message;
+  Variant* var = message.AddExtension(PullRequest::arguments);
+  var->set_type(Variant::STRING);
+  var->add_txt(this->ProxyDefinitionManager->GetCoreDefinitionsHash());
+
   this->SetLocation(vtkPVSession::SERVERS);
   if (this->PullState(&message) == false)
     {
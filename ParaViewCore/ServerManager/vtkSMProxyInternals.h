@@ -35,6 +35,8 @@
 // * DoUpdate : should the propery be updated (pushed) during UpdateVTKObjects 
 // * ObserverTag : the tag returned by AddObserver(). Used to remove the
 // observer.
+// * StateIndex : index of the property in the proxy's state, -1 when the
+// property has no state.
 struct vtkSMProxyInternals
 {
   struct PropertyInfo
@@ -43,16 +45,31 @@ struct vtkSMProxyInternals
       {
         this->ModifiedFlag = 0;
         this->ObserverTag = 0;
+        this->StateIndex = -1;
       };
     vtkSmartPointer<vtkSMProperty> Property;
     int ModifiedFlag;
     unsigned int ObserverTag;
+    int StateIndex;
   };
   // Note that the name of the property is the map key. That is the
   // only place where name is stored
   typedef std::map<vtkStdString,  PropertyInfo> PropertyInfoMap;
   PropertyInfoMap Properties;
 
+  // Properties whose ModifiedFlag was set since the last UpdateVTKObjects(),
+  // so that only those are visited when pushing. Entries may be repeated or
+  // no longer modified, the ModifiedFlag is the authority.
+  typedef std::vector<PropertyInfoMap::iterator> ModifiedPropertiesType;
+  ModifiedPropertiesType ModifiedProperties;
+
+  // Orders ModifiedProperties as the properties are in the map.
+  static bool PropertyNameLess(const PropertyInfoMap::iterator& a,
+                               const PropertyInfoMap::iterator& b)
+    {
+    return a->first < b->first;
+    }
+
   // This vector keeps track of the order in which properties
   // were added for the Property iterator
   std::vector<vtkStdString> PropertyNamesInOrder;
@@ -23,9 +23,89 @@
 #include "vtkSMProxyLocator.h"
 #include "vtkSMProxyManager.h"
 #include "vtkSMProxy.h"
+#include "vtkTimerLog.h"
 
 #include <vtkNew.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // Position of the properties of a state, by name.
+  typedef std::map<std::string, int> PropertyIndexType;
+
+  void IndexProperties(const vtkSMMessage* state, PropertyIndexType& index)
+    {
+    index.clear();
+    int size = state->ExtensionSize(ProxyState::property);
+    for (int cc=0; cc < size; ++cc)
+      {
+      index[state->GetExtension(ProxyState::property, cc).name()] = cc;
+      }
+    }
+
+  // Only keep the properties of state flagged in keep.
+  void KeepProperties(vtkSMMessage* state, const std::vector<bool>& keep)
+    {
+    vtkSMMessage copy;
+    copy.CopyFrom(*state);
+    state->ClearExtension(ProxyState::property);
+    for (size_t cc=0; cc < keep.size(); ++cc)
+      {
+      if (keep[cc])
+        {
+        state->AddExtension(ProxyState::property)->CopyFrom(
+          copy.GetExtension(ProxyState::property, static_cast<int>(cc)));
+        }
+      }
+    }
+
+  // Drop the properties that have the same value in both states.
+  void StripUnchangedProperties(vtkSMMessage* before, vtkSMMessage* after)
+    {
+    PropertyIndexType afterIndex;
+    IndexProperties(after, afterIndex);
+    std::vector<bool> keepBefore(before->ExtensionSize(ProxyState::property),
+                                 true);
+    std::vector<bool> keepAfter(after->ExtensionSize(ProxyState::property),
+                                true);
+    for (size_t cc=0; cc < keepBefore.size(); ++cc)
+      {
+      const ProxyState_Property& prop =
+        before->GetExtension(ProxyState::property, static_cast<int>(cc));
+      PropertyIndexType::iterator iter = afterIndex.find(prop.name());
+      if (iter != afterIndex.end() &&
+          prop.SerializeAsString() == after->GetExtension(
+            ProxyState::property, iter->second).SerializeAsString())
+        {
+        keepBefore[cc] = false;
+        keepAfter[iter->second] = false;
+        }
+      }
+    KeepProperties(before, keepBefore);
+    KeepProperties(after, keepAfter);
+    }
+
+  // Append to state the properties of other that state does not have.
+  void AddMissingProperties(vtkSMMessage* state, const vtkSMMessage* other)
+    {
+    PropertyIndexType index;
+    IndexProperties(state, index);
+    int size = other->ExtensionSize(ProxyState::property);
+    for (int cc=0; cc < size; ++cc)
+      {
+      const ProxyState_Property& prop =
+        other->GetExtension(ProxyState::property, cc);
+      if (index.find(prop.name()) == index.end())
+        {
+        state->AddExtension(ProxyState::property)->CopyFrom(prop);
+        }
+      }
+    }
+}
+
 vtkStandardNewMacro(vtkSMRemoteObjectUpdateUndoElement);
 vtkSetObjectImplementationMacro(vtkSMRemoteObjectUpdateUndoElement, ProxyLocator, vtkSMProxyLocator);
 //-----------------------------------------------------------------------------
@@ -34,6 +114,9 @@ vtkSMRemoteObjectUpdateUndoElement::vtkSMRemoteObjectUpdateUndoElement()
   this->ProxyLocator = NULL;
   this->AfterState   = new vtkSMMessage();
   this->BeforeState  = new vtkSMMessage();
+  this->StateSize    = 0;
+  this->TimeStamp    = 0.0;
+  this->SetMergeable(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -52,6 +135,8 @@ void vtkSMRemoteObjectUpdateUndoElement::PrintSelf(ostream& os, vtkIndent indent
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "GlobalId: " << this->GetGlobalId() << endl;
+  os << indent << "StateSize: " << this->StateSize << endl;
+  os << indent << "TimeStamp: " << this->TimeStamp << endl;
   os << indent << "Before state: " << endl;
   if(this->BeforeState) this->BeforeState->PrintDebugString();
   os << indent << "After state: " << endl;
@@ -108,12 +193,132 @@ void vtkSMRemoteObjectUpdateUndoElement::SetUndoRedoState(
     {
     this->BeforeState->CopyFrom(*before);
     this->AfterState->CopyFrom(*after);
+    StripUnchangedProperties(this->BeforeState, this->AfterState);
     }
   else
     {
     vtkErrorMacro( "Invalid SetUndoRedoState. "
                    << "At least one of the provided states is NULL.");
     }
+  this->StateSize = this->BeforeState->ByteSize() +
+                    this->AfterState->ByteSize();
+  this->TimeStamp = vtkTimerLog::GetUniversalTime();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMRemoteObjectUpdateUndoElement::Merge(vtkUndoElement* new_element)
+{
+  vtkSMRemoteObjectUpdateUndoElement* elem =
+    vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(new_element);
+  if (!elem || elem->GetSession() != this->GetSession() ||
+      elem->GetGlobalId() != this->GetGlobalId())
+    {
+    return false;
+    }
+
+  // A property only modified by the new element was, before it, still at the
+  // value it had before this one. A property only modified by this element
+  // kept its value through the new one.
+  AddMissingProperties(this->BeforeState, elem->BeforeState);
+  vtkSMMessage after;
+  after.CopyFrom(*elem->AfterState);
+  AddMissingProperties(&after, this->AfterState);
+  this->AfterState->CopyFrom(after);
+  StripUnchangedProperties(this->BeforeState, this->AfterState);
+
+  this->StateSize = this->BeforeState->ByteSize() +
+                    this->AfterState->ByteSize();
+  this->TimeStamp = elem->TimeStamp;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMRemoteObjectUpdateUndoElement::HasSameModifiedProperties(
+  vtkSMRemoteObjectUpdateUndoElement* other)
+{
+  if (!other || other->GetGlobalId() != this->GetGlobalId())
+    {
+    return false;
+    }
+  PropertyIndexType index;
+  PropertyIndexType otherIndex;
+  IndexProperties(this->AfterState, index);
+  IndexProperties(other->AfterState, otherIndex);
+  if (index.size() != otherIndex.size())
+    {
+    return false;
+    }
+  PropertyIndexType::iterator iter = index.begin();
+  PropertyIndexType::iterator otherIter = otherIndex.begin();
+  for (; iter != index.end(); ++iter, ++otherIter)
+    {
+    if (iter->first != otherIter->first)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMRemoteObjectUpdateUndoElement::GetFullBeforeState(
+  vtkSMMessage* state)
+{
+  return this->GetFullState(this->BeforeState, state);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMRemoteObjectUpdateUndoElement::GetFullAfterState(vtkSMMessage* state)
+{
+  return this->GetFullState(this->AfterState, state);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMRemoteObjectUpdateUndoElement::GetFullState(
+  const vtkSMMessage* delta, vtkSMMessage* state)
+{
+  state->CopyFrom(*delta);
+  if (!this->Session)
+    {
+    return false;
+    }
+
+  vtkSMMessage base;
+  vtkSMRemoteObject* remoteObj = vtkSMRemoteObject::SafeDownCast(
+    this->Session->GetRemoteObject(delta->global_id()));
+  if (remoteObj && remoteObj->GetFullState())
+    {
+    base.CopyFrom(*remoteObj->GetFullState());
+    }
+  else if (!this->Session->GetStateLocator()->FindState(
+             delta->global_id(), &base))
+    {
+    return false;
+    }
+
+  // Keep the order of the base properties, with the stored values replacing
+  // the current ones.
+  PropertyIndexType deltaIndex;
+  IndexProperties(delta, deltaIndex);
+  state->ClearExtension(ProxyState::property);
+  int size = base.ExtensionSize(ProxyState::property);
+  for (int cc=0; cc < size; ++cc)
+    {
+    const ProxyState_Property& prop =
+      base.GetExtension(ProxyState::property, cc);
+    PropertyIndexType::iterator iter = deltaIndex.find(prop.name());
+    if (iter != deltaIndex.end())
+      {
+      state->AddExtension(ProxyState::property)->CopyFrom(
+        delta->GetExtension(ProxyState::property, iter->second));
+      }
+    else
+      {
+      state->AddExtension(ProxyState::property)->CopyFrom(prop);
+      }
+    }
+  AddMissingProperties(state, delta);
+  return true;
 }
 //-----------------------------------------------------------------------------
 vtkTypeUInt32 vtkSMRemoteObjectUpdateUndoElement::GetGlobalId()
@@ -17,6 +17,10 @@
 // This class keeps the before and after state of the RemoteObject in the
 // vtkSMMessage form. It works with any proxy and RemoteObject. It is a very
 // generic undoElement.
+// Only the properties that differ between the before and after states are
+// stored, the full states can be rebuilt from the current state of the
+// RemoteObject with GetFullBeforeState() and GetFullAfterState().
+// Consecutive updates of the same RemoteObject are merged into one element.
 
 #ifndef __vtkSMRemoteObjectUpdateUndoElement_h
 #define __vtkSMRemoteObjectUpdateUndoElement_h
@@ -51,16 +55,45 @@ public:
 //BTX
 
   // Description:
-  // Set the state of the UndoElement
+  // Set the state of the UndoElement. Properties that have the same value in
+  // both states are dropped.
   virtual void SetUndoRedoState(const vtkSMMessage* before,
                                 const vtkSMMessage* after);
 
-  // Current full state of the UndoElement
+  // Current state of the UndoElement, restricted to the modified properties.
   vtkSMMessage* BeforeState;
   vtkSMMessage* AfterState;
 
   virtual vtkTypeUInt32 GetGlobalId();
 
+  // Description:
+  // Merge an update of the same RemoteObject that happened after this one.
+  // The result goes from the before state of this element to the after
+  // state of new_element.
+  virtual bool Merge(vtkUndoElement* new_element);
+
+  // Description:
+  // Fill state with the stored properties applied over the current state of
+  // the RemoteObject, or over the one kept by the session state locator if
+  // the object does not exist anymore. Return false if no such state was
+  // found, state then only holds the stored properties.
+  bool GetFullBeforeState(vtkSMMessage* state);
+  bool GetFullAfterState(vtkSMMessage* state);
+
+  // Description:
+  // Return true if both elements modify the same properties of the same
+  // RemoteObject.
+  bool HasSameModifiedProperties(vtkSMRemoteObjectUpdateUndoElement* other);
+
+  // Description:
+  // Size in bytes of the stored states.
+  vtkGetMacro(StateSize, int);
+
+  // Description:
+  // Time at which the last update held by this element was recorded, as
+  // given by vtkTimerLog::GetUniversalTime().
+  vtkGetMacro(TimeStamp, double);
+
 protected:
   vtkSMRemoteObjectUpdateUndoElement();
   ~vtkSMRemoteObjectUpdateUndoElement();
@@ -68,7 +101,13 @@ protected:
   // Internal method used to update proxy state based on the state info
   int UpdateState(const vtkSMMessage* state);
 
+  // Internal method used to apply the stored properties of delta over the
+  // current state of the RemoteObject.
+  bool GetFullState(const vtkSMMessage* delta, vtkSMMessage* state);
+
   vtkSMProxyLocator* ProxyLocator;
+  int StateSize;
+  double TimeStamp;
 
 private:
   vtkSMRemoteObjectUpdateUndoElement(const vtkSMRemoteObjectUpdateUndoElement&); // Not implemented.
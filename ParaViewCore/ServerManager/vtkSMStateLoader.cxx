@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkSMStateLoader.h"
 
+#include "vtkCallbackCommand.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVXMLElement.h"
 #include "vtkSmartPointer.h"
@@ -50,6 +51,122 @@ struct vtkSMStateLoaderInternals
   typedef std::vector<vtkSMStateLoaderRegistrationInfo> VectorOfRegInfo;
   typedef std::map<int, VectorOfRegInfo> RegInfoMapType;
   RegInfoMapType RegistrationInformation;
+
+  // Index of the proxy state elements by id, built the first time a proxy
+  // element is looked up during a load.
+  typedef std::map<vtkIdType, vtkPVXMLElement*> ProxyElementMapType;
+  ProxyElementMapType ProxyElements;
+  bool ProxyElementsIndexed;
+
+  // Number of names each proxy is registered under in each group. Kept up to
+  // date with the proxy manager's register/unregister events while a state is
+  // being loaded, so that RegisterProxyInternal() does not need to scan the
+  // whole group for every proxy.
+  typedef std::map<std::pair<std::string, vtkSMProxy*>, int> RegistrationCountType;
+  RegistrationCountType Registrations;
+  bool TrackRegistrations;
+  vtkSmartPointer<vtkCallbackCommand> RegistrationObserver;
+  unsigned long RegisterTag;
+  unsigned long UnRegisterTag;
+
+  vtkSMStateLoaderInternals()
+    {
+    this->KeepOriginalId = false;
+    this->ProxyElementsIndexed = false;
+    this->TrackRegistrations = false;
+    this->RegisterTag = 0;
+    this->UnRegisterTag = 0;
+    }
+
+  // Adds the proxy elements under root in the order
+  // vtkSMStateLoader::LocateProxyElementInternal() would find them, so that
+  // the first match wins when ids are repeated (e.g. in custom proxy
+  // definitions).
+  void IndexProxyElements(vtkPVXMLElement* root)
+    {
+    unsigned int numElems = root->GetNumberOfNestedElements();
+    unsigned int i;
+    for (i=0; i<numElems; i++)
+      {
+      vtkPVXMLElement* currentElement = root->GetNestedElement(i);
+      vtkIdType currentId;
+      if (currentElement->GetName() &&
+        strcmp(currentElement->GetName(), "Proxy") == 0 &&
+        currentElement->GetScalarAttribute("id", &currentId))
+        {
+        this->ProxyElements.insert(
+          ProxyElementMapType::value_type(currentId, currentElement));
+        }
+      }
+    for (i=0; i<numElems; i++)
+      {
+      this->IndexProxyElements(root->GetNestedElement(i));
+      }
+    }
+
+  static void RegistrationCallback(vtkObject*, unsigned long eid,
+    void* clientdata, void* calldata)
+    {
+    vtkSMStateLoaderInternals* self =
+      reinterpret_cast<vtkSMStateLoaderInternals*>(clientdata);
+    vtkSMProxyManager::RegisteredProxyInformation* info =
+      reinterpret_cast<vtkSMProxyManager::RegisteredProxyInformation*>(calldata);
+    if (!info || !info->GroupName ||
+      info->Type != vtkSMProxyManager::RegisteredProxyInformation::PROXY)
+      {
+      return;
+      }
+    RegistrationCountType::key_type key(info->GroupName, info->Proxy);
+    if (eid == vtkCommand::RegisterEvent)
+      {
+      self->Registrations[key]++;
+      }
+    else
+      {
+      RegistrationCountType::iterator iter = self->Registrations.find(key);
+      if (iter != self->Registrations.end() && --iter->second <= 0)
+        {
+        self->Registrations.erase(iter);
+        }
+      }
+    }
+
+  void StartTrackingRegistrations(vtkSMSession* session,
+    vtkSMSessionProxyManager* pxm)
+    {
+    this->Registrations.clear();
+    vtkSMProxyIterator* iter = vtkSMProxyIterator::New();
+    iter->SetSession(session);
+    iter->SetModeToAll();
+    for (iter->Begin(); !iter->IsAtEnd(); iter->Next())
+      {
+      this->Registrations[RegistrationCountType::key_type(
+          iter->GetGroup(), iter->GetProxy())]++;
+      }
+    iter->Delete();
+
+    this->RegistrationObserver = vtkSmartPointer<vtkCallbackCommand>::New();
+    this->RegistrationObserver->SetClientData(this);
+    this->RegistrationObserver->SetCallback(
+      &vtkSMStateLoaderInternals::RegistrationCallback);
+    this->RegisterTag = pxm->AddObserver(vtkCommand::RegisterEvent,
+      this->RegistrationObserver);
+    this->UnRegisterTag = pxm->AddObserver(vtkCommand::UnRegisterEvent,
+      this->RegistrationObserver);
+    this->TrackRegistrations = true;
+    }
+
+  void StopTrackingRegistrations(vtkSMSessionProxyManager* pxm)
+    {
+    if (this->TrackRegistrations)
+      {
+      pxm->RemoveObserver(this->RegisterTag);
+      pxm->RemoveObserver(this->UnRegisterTag);
+      }
+    this->RegistrationObserver = 0;
+    this->TrackRegistrations = false;
+    this->Registrations.clear();
+    }
 };
 
 //---------------------------------------------------------------------------
@@ -171,10 +288,16 @@ void vtkSMStateLoader::RegisterProxyInternal(const char* group,
 {
   assert("Session should be valid" && this->Session);
   vtkSMSessionProxyManager* pxm = this->GetSessionProxyManager();
-  if (pxm->GetProxyName(group, proxy))
+  if (!this->Internal->TrackRegistrations ||
+    this->Internal->Registrations.find(
+      vtkSMStateLoaderInternals::RegistrationCountType::key_type(group, proxy))
+    != this->Internal->Registrations.end())
     {
-    // Don't re-register a proxy in the same group.
-    return;
+    if (pxm->GetProxyName(group, proxy))
+      {
+      // Don't re-register a proxy in the same group.
+      return;
+      }
     }
   pxm->RegisterProxy(group, name, proxy);
 }
@@ -182,8 +305,21 @@ void vtkSMStateLoader::RegisterProxyInternal(const char* group,
 //---------------------------------------------------------------------------
 vtkPVXMLElement* vtkSMStateLoader::LocateProxyElement(vtkTypeUInt32 id)
 {
-  return this->LocateProxyElementInternal(
-    this->ServerManagerStateElement, id);
+  if (!this->ServerManagerStateElement)
+    {
+    return this->LocateProxyElementInternal(0, id);
+    }
+
+  // Searching the tree for every proxy makes loading quadratic in the number
+  // of proxies, so index the whole state once instead.
+  if (!this->Internal->ProxyElementsIndexed)
+    {
+    this->Internal->IndexProxyElements(this->ServerManagerStateElement);
+    this->Internal->ProxyElementsIndexed = true;
+    }
+  vtkSMStateLoaderInternals::ProxyElementMapType::iterator iter =
+    this->Internal->ProxyElements.find(static_cast<vtkIdType>(id));
+  return iter != this->Internal->ProxyElements.end()? iter->second : 0;
 }
 
 //---------------------------------------------------------------------------
@@ -460,15 +596,17 @@ int vtkSMStateLoader::LoadState(vtkPVXMLElement* elem, bool keepOriginalId)
     return 0;
     }
 
+  vtkSMSessionProxyManager* pxm = this->GetSessionProxyManager();
+  this->Internal->StartTrackingRegistrations(this->Session, pxm);
   this->ProxyLocator->SetDeserializer(this);
   int ret = this->LoadStateInternal(elem);
   this->ProxyLocator->SetDeserializer(0);
+  this->Internal->StopTrackingRegistrations(pxm);
 
   // BUG #10650. When animation scene time ranges are read from the state, they
   // often override those that the timekeeper painstakingly computed. Here we
   // explicitly trigger the timekeeper so that the scene re-determines the
   // ranges, unless they are locked of course.
-  vtkSMSessionProxyManager* pxm = this->GetSessionProxyManager();
   vtkSMProxy* timekeeper = pxm->GetProxy("timekeeper", "TimeKeeper");
   if (timekeeper)
     {
@@ -509,6 +647,8 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
     }
 
   this->ServerManagerStateElement = rootElement;
+  this->Internal->ProxyElements.clear();
+  this->Internal->ProxyElementsIndexed = false;
 
   unsigned int numElems = rootElement->GetNumberOfNestedElements();
   unsigned int i;
@@ -568,6 +708,8 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* parent)
 
   // Clear internal data structures.
   this->Internal->RegistrationInformation.clear();
+  this->Internal->ProxyElements.clear();
+  this->Internal->ProxyElementsIndexed = false;
   this->ServerManagerStateElement = 0; 
   return 1;
 }
@@ -30,6 +30,7 @@
 #include "vtkSMProxyManager.h"
 #include "vtkSMDeserializerProtobuf.h"
 #include "vtkSMRemoteObjectUpdateUndoElement.h"
+#include "vtkTimerLog.h"
 
 #include <vtksys/RegularExpression.hxx>
 #include <set>
@@ -67,14 +68,19 @@ public:
       if(elem)
         {
         elem->SetProxyLocator(this->UndoSetProxyLocator.GetPointer());
+
+        // Elements only store the modified properties, the locator needs
+        // the full state.
+        vtkSMMessage state;
         if(useBeforeState)
           {
-          this->UndoSetStateLocator->RegisterState(elem->BeforeState);
+          elem->GetFullBeforeState(&state);
           }
         else
           {
-          this->UndoSetStateLocator->RegisterState(elem->AfterState);
+          elem->GetFullAfterState(&state);
           }
+        this->UndoSetStateLocator->RegisterState(&state);
         }
       }
     }
@@ -126,6 +132,34 @@ public:
       iter++;
       }
     }
+
+  static vtkIdType GetStateSize(vtkUndoSet* undoSet)
+    {
+    vtkIdType size = 0;
+    int max = undoSet->GetNumberOfElements();
+    for (int cc=0; cc < max; ++cc)
+      {
+      vtkSMRemoteObjectUpdateUndoElement* elem =
+          vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(
+              undoSet->GetElement(cc));
+      if(elem)
+        {
+        size += elem->GetStateSize();
+        }
+      }
+    return size;
+    }
+
+  static vtkSMRemoteObjectUpdateUndoElement* GetSingleUpdate(
+    vtkUndoSet* undoSet)
+    {
+    if(!undoSet || undoSet->GetNumberOfElements() != 1)
+      {
+      return NULL;
+      }
+    return vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(
+      undoSet->GetElement(0));
+    }
 };
 //*****************************************************************************
 vtkStandardNewMacro(vtkSMUndoStack);
@@ -133,6 +167,8 @@ vtkStandardNewMacro(vtkSMUndoStack);
 vtkSMUndoStack::vtkSMUndoStack()
 {
   this->Internal = new vtkInternal();
+  this->MergeTimeWindow = 0.5;
+  this->MaximumStateSize = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -144,10 +180,77 @@ vtkSMUndoStack::~vtkSMUndoStack()
 //-----------------------------------------------------------------------------
 void vtkSMUndoStack::Push(const char* label, vtkUndoSet* changeSet)
 {
+  if (this->MergeWithTopUndoSet(label, changeSet))
+    {
+    this->EnforceMaximumStateSize();
+    this->Modified();
+    return;
+    }
+
   this->Superclass::Push(label, changeSet);
+  this->EnforceMaximumStateSize();
   this->InvokeEvent(PushUndoSetEvent, changeSet);
 }
 
+//-----------------------------------------------------------------------------
+bool vtkSMUndoStack::MergeWithTopUndoSet(const char* label,
+                                         vtkUndoSet* changeSet)
+{
+  vtkUndoStackInternal* stack = this->Superclass::Internal;
+  if (this->MergeTimeWindow <= 0.0 || stack->UndoStack.empty() ||
+      !stack->RedoStack.empty())
+    {
+    return false;
+    }
+
+  vtkUndoStackInternal::Element& top = stack->UndoStack.back();
+  vtkSMRemoteObjectUpdateUndoElement* topElem =
+    vtkInternal::GetSingleUpdate(top.UndoSet);
+  vtkSMRemoteObjectUpdateUndoElement* newElem =
+    vtkInternal::GetSingleUpdate(changeSet);
+  if (!topElem || !newElem || top.Label != (label ? label : "") ||
+      newElem->GetTimeStamp() - topElem->GetTimeStamp() >
+      this->MergeTimeWindow ||
+      !topElem->HasSameModifiedProperties(newElem))
+    {
+    return false;
+    }
+
+  return topElem->Merge(newElem);
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkSMUndoStack::GetUndoStackStateSize()
+{
+  vtkIdType size = 0;
+  vtkUndoStackInternal* stack = this->Superclass::Internal;
+  for (size_t cc=0; cc < stack->UndoStack.size(); ++cc)
+    {
+    size += vtkInternal::GetStateSize(stack->UndoStack[cc].UndoSet);
+    }
+  return size;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSMUndoStack::EnforceMaximumStateSize()
+{
+  if (this->MaximumStateSize <= 0)
+    {
+    return;
+    }
+
+  vtkUndoStackInternal* stack = this->Superclass::Internal;
+  vtkIdType size = this->GetUndoStackStateSize();
+  while (size > this->MaximumStateSize && stack->UndoStack.size() > 1)
+    {
+    size -= vtkInternal::GetStateSize(stack->UndoStack.front().UndoSet);
+    stack->UndoStack.erase(stack->UndoStack.begin());
+    // Same notification as the StackDepth limit so the state locators
+    // expire the states of the removed set.
+    this->InvokeEvent(vtkUndoStack::UndoSetRemovedEvent);
+    }
+}
+
 //-----------------------------------------------------------------------------
 int vtkSMUndoStack::Undo()
 {
@@ -203,4 +306,6 @@ void vtkSMUndoStack::FillWithRemoteObjects( vtkUndoSet *undoSet,
 void vtkSMUndoStack::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "MergeTimeWindow: " << this->MergeTimeWindow << endl;
+  os << indent << "MaximumStateSize: " << this->MaximumStateSize << endl;
 }
@@ -27,6 +27,12 @@
 // This class also provides API to push any vtkUndoSet instance on to a 
 // server. GUI can use this to push its own changes that is undoable across
 // connections.
+//
+// Consecutive pushes that update the same properties of the same object
+// within MergeTimeWindow are merged into the set on top of the undo stack,
+// so that interactive changes such as a slider drag are undone in one step.
+// When MaximumStateSize is set, the oldest sets are discarded as long as the
+// states they hold exceed that size.
 // 
 // .SECTION See Also
 // vtkSMUndoStackBuilder
@@ -70,6 +76,24 @@ public:
   // \returns the status of the operation.
   virtual int Redo();
 
+  // Description:
+  // Pushes that arrive less than this many seconds after the previous one
+  // are merged into it when both only update the same properties of the same
+  // object. 0 disables merging. Default is 0.5.
+  vtkSetClampMacro(MergeTimeWindow, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(MergeTimeWindow, double);
+
+  // Description:
+  // Maximum size in bytes of the states kept by the undo stack. Oldest sets
+  // are removed first, the most recent one is always kept. 0, the default,
+  // means no limit, only StackDepth applies.
+  vtkSetClampMacro(MaximumStateSize, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(MaximumStateSize, vtkIdType);
+
+  // Description:
+  // Size in bytes of the states held by the undo stack.
+  vtkIdType GetUndoStackStateSize();
+
 //BTX
 
   enum EventIds
@@ -92,6 +116,19 @@ protected:
   // is supposed to happen.
   void FillWithRemoteObjects( vtkUndoSet *undoSet, vtkCollection *collection);
 
+  // Description:
+  // Merge changeSet into the set on top of the undo stack if both are a
+  // single update of the same properties within MergeTimeWindow.
+  // Return true if changeSet was merged.
+  bool MergeWithTopUndoSet(const char* label, vtkUndoSet* changeSet);
+
+  // Description:
+  // Remove the oldest undo sets until MaximumStateSize is honored.
+  void EnforceMaximumStateSize();
+
+  double MergeTimeWindow;
+  vtkIdType MaximumStateSize;
+
 private:
   vtkSMUndoStack(const vtkSMUndoStack&); // Not implemented.
   void operator=(const vtkSMUndoStack&); // Not implemented.
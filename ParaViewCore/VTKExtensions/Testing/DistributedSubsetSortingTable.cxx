@@ -28,6 +28,7 @@
 #include "vtkAttributeDataToTableFilter.h"
 #include "vtkTable.h"
 #include "vtkFloatArray.h"
+#include "vtkDoubleArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 /*
 ** This test only builds if MPI is in use
@@ -36,6 +37,130 @@
 
 #include "vtkProcess.h"
 
+#include <algorithm>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Returns on process 0 the rows of the block the sorting filter produced on
+// any process, or an empty table.
+vtkTable* GatherBlock(vtkMultiProcessController* controller,
+                      vtkSortedTableStreamer* sortFilter)
+{
+  int me = controller->GetLocalProcessId();
+  vtkTable* block = vtkTable::New();
+  if(me != 0)
+    {
+    controller->Send(sortFilter->GetOutput(), 0, 4321);
+    return block;
+    }
+  block->ShallowCopy(sortFilter->GetOutput());
+  for(int pid=1;pid<controller->GetNumberOfProcesses();pid++)
+    {
+    vtkTable* remote = vtkTable::New();
+    controller->Receive(remote, pid, 4321);
+    if(remote->GetNumberOfRows() > 0)
+      {
+      block->ShallowCopy(remote);
+      }
+    remote->Delete();
+    }
+  return block;
+}
+
+// ----------------------------------------------------------------------------
+// Sorts many duplicated values, none of them on the last process, with the
+// sample sort and with the default histogram based search. On process 0,
+// returns whether every block holds the same values with both, and the ids of
+// input rows with these values, every input row once.
+bool SampleSortWithEmptyProcess(vtkMultiProcessController* controller)
+{
+  int me = controller->GetLocalProcessId();
+  int nbProc = controller->GetNumberOfProcesses();
+  const vtkIdType localSize = 60000;
+  const vtkIdType size = localSize * (nbProc - 1);
+  const vtkIdType blockSize = 10000;
+
+  vtkDoubleArray* dataToSort = vtkDoubleArray::New();
+  dataToSort->SetName("data");
+  vtkDoubleArray* ids = vtkDoubleArray::New();
+  ids->SetName("id");
+  if(me != nbProc - 1)
+    {
+    dataToSort->SetNumberOfTuples(localSize);
+    ids->SetNumberOfTuples(localSize);
+    for(vtkIdType i=0;i<localSize;i++)
+      {
+      vtkIdType id = me * localSize + i;
+      dataToSort->SetValue(i, (id * 7919) % 1000);
+      ids->SetValue(i, id);
+      }
+    }
+  vtkTable* input = vtkTable::New();
+  input->AddColumn(dataToSort);
+  input->AddColumn(ids);
+  dataToSort->Delete();
+  ids->Delete();
+
+  vtkSortedTableStreamer* sortFilters[2];
+  for(int sampleSort=0;sampleSort<2;sampleSort++)
+    {
+    sortFilters[sampleSort] = vtkSortedTableStreamer::New();
+    sortFilters[sampleSort]->SetInputData(input);
+    sortFilters[sampleSort]->SetColumnNameToSort("data");
+    sortFilters[sampleSort]->SetSelectedComponent(0);
+    sortFilters[sampleSort]->SetBlockSize(blockSize);
+    sortFilters[sampleSort]->SetSampleSort(sampleSort);
+    }
+
+  bool ok = true;
+  std::vector<bool> seen(size, false);
+  for(vtkIdType block=0;block*blockSize<size;block++)
+    {
+    vtkTable* blocks[2];
+    for(int sampleSort=0;sampleSort<2;sampleSort++)
+      {
+      sortFilters[sampleSort]->SetBlock(block);
+      sortFilters[sampleSort]->Update();
+      blocks[sampleSort] = GatherBlock(controller, sortFilters[sampleSort]);
+      }
+    if(me == 0 && ok)
+      {
+      vtkIdType numRows = std::min(blockSize, size - block * blockSize);
+      vtkDoubleArray* expected =
+          vtkDoubleArray::SafeDownCast(blocks[0]->GetColumnByName("data"));
+      vtkDoubleArray* data =
+          vtkDoubleArray::SafeDownCast(blocks[1]->GetColumnByName("data"));
+      vtkDoubleArray* sortedIds =
+          vtkDoubleArray::SafeDownCast(blocks[1]->GetColumnByName("id"));
+      ok = expected && data && sortedIds &&
+           expected->GetNumberOfTuples() == numRows &&
+           data->GetNumberOfTuples() == numRows;
+      for(vtkIdType r=0;ok && r<numRows;r++)
+        {
+        vtkIdType id = static_cast<vtkIdType>(sortedIds->GetValue(r));
+        ok = data->GetValue(r) == expected->GetValue(r) &&
+             id >= 0 && id < size && !seen[id] &&
+             data->GetValue(r) == (id * 7919) % 1000;
+        if(ok)
+          {
+          seen[id] = true;
+          }
+        }
+      if(!ok)
+        {
+        cout << "Block " << block << " of the sample sort differs." << endl;
+        }
+      }
+    blocks[0]->Delete();
+    blocks[1]->Delete();
+    }
+
+  sortFilters[0]->Delete();
+  sortFilters[1]->Delete();
+  input->Delete();
+  return ok && std::find(seen.begin(), seen.end(), false) == seen.end();
+}
+
 class MyProcess : public vtkProcess
 {
 public:
@@ -128,6 +253,14 @@ void MyProcess::Execute()
       }
     }
 
+  bool sampleSortOk = SampleSortWithEmptyProcess(this->Controller);
+  if(me == 0)
+    {
+    cout << "Sample sort with an empty process: "
+         << (sampleSortOk ? "OK" : "FAILED") << endl;
+    this->ReturnValue = this->ReturnValue && sampleSortOk;
+    }
+
   // CLEAN UP
   wavelet->Delete();
   ps->Delete();
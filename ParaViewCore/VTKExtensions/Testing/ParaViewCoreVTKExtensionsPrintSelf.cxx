@@ -132,6 +132,7 @@
 #include "vtkPVLODActor.h"
 #include "vtkPVLODVolume.h"
 #include "vtkPVMergeTables.h"
+#include "vtkPVMultiThreader.h"
 #include "vtkPVNullSource.h"
 #include "vtkPVPlane.h"
 #include "vtkPVPostFilter.h"
@@ -337,6 +338,7 @@ int main(int , char *[])
   PRINT_SELF(vtkPVLODActor);
   PRINT_SELF(vtkPVLODVolume);
   PRINT_SELF(vtkPVMergeTables);
+  PRINT_SELF(vtkPVMultiThreader);
   PRINT_SELF(vtkPVNullSource);
   PRINT_SELF(vtkPVPlane);
   PRINT_SELF(vtkPVPostFilter);
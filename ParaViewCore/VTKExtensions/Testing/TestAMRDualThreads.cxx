@@ -0,0 +1,270 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestAMRDualThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the AMR dual contour and clip filters produce the same
+// geometry when the blocks are processed by several threads as when they
+// are processed one at a time. Points are numbered differently, so cells
+// are compared by the coordinates of their points. The contour must also be
+// the same when the ghost values exchanged between processes are received
+// while the other blocks are contoured. When built with MPI and run on
+// several processes, each process compares its own output.
+
+#include "vtkBoundingBox.h"
+#include "vtkCommunicator.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataSet.h"
+#include "vtkDummyController.h"
+#include "vtkIdList.h"
+#include "vtkMultiProcessController.h"
+#include "vtkPVAMRDualClip.h"
+#include "vtkPVAMRDualContour.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpyPlotReader.h"
+#include "vtkTestUtilities.h"
+#include "vtkToolkits.h"
+
+#ifdef VTK_USE_MPI
+# include "vtkMPIController.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+typedef std::vector<long long> CellKey;
+
+// ----------------------------------------------------------------------------
+// Each cell becomes its type followed by the sorted, quantized coordinates of
+// its points. The keys of all the leaves are sorted.
+void CollectCells(vtkDataObject* dobj, double tolerance,
+  std::vector<CellKey>& cells, vtkIdType& numPoints)
+{
+  cells.clear();
+  numPoints = 0;
+  vtkCompositeDataSet* cds = vtkCompositeDataSet::SafeDownCast(dobj);
+  if (!cds)
+    {
+    return;
+    }
+  vtkIdList* ids = vtkIdList::New();
+  vtkCompositeDataIterator* iter = cds->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    if (!ds)
+      {
+      continue;
+      }
+    numPoints += ds->GetNumberOfPoints();
+    for (vtkIdType c = 0; c < ds->GetNumberOfCells(); ++c)
+      {
+      ds->GetCellPoints(c, ids);
+      std::vector<CellKey> pts(ids->GetNumberOfIds());
+      for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+        {
+        double* x = ds->GetPoint(ids->GetId(i));
+        for (int q = 0; q < 3; ++q)
+          {
+          pts[i].push_back(static_cast<long long>(
+              floor(x[q] / tolerance + 0.5)));
+          }
+        }
+      std::sort(pts.begin(), pts.end());
+      CellKey key(1, ds->GetCellType(c));
+      for (size_t i = 0; i < pts.size(); ++i)
+        {
+        key.insert(key.end(), pts[i].begin(), pts[i].end());
+        }
+      cells.push_back(key);
+      }
+    }
+  iter->Delete();
+  ids->Delete();
+  std::sort(cells.begin(), cells.end());
+}
+
+// ----------------------------------------------------------------------------
+// Points are stored in single precision and a point shared by two blocks may
+// be computed from either side, so coordinates are compared up to a small
+// fraction of the size of the output.
+double GetTolerance(vtkDataObject* dobj)
+{
+  vtkBoundingBox bbox;
+  vtkCompositeDataSet* cds = vtkCompositeDataSet::SafeDownCast(dobj);
+  if (cds)
+    {
+    vtkCompositeDataIterator* iter = cds->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      if (ds && ds->GetNumberOfPoints())
+        {
+        bbox.AddBounds(ds->GetBounds());
+        }
+      }
+    iter->Delete();
+    }
+  double length = bbox.IsValid() ? bbox.GetDiagonalLength() : 1.0;
+  return (length > 0.0 ? length : 1.0) * 1e-5;
+}
+
+// ----------------------------------------------------------------------------
+// Return true if both outputs have the same points and cells.
+bool CompareOutputs(vtkDataObject* serial, vtkDataObject* threaded,
+  const char* name, int& numCells, const char* with = "with threads",
+  const char* without = "without")
+{
+  double tolerance = GetTolerance(serial);
+  std::vector<CellKey> serialCells;
+  std::vector<CellKey> threadedCells;
+  vtkIdType serialPoints;
+  vtkIdType threadedPoints;
+  CollectCells(serial, tolerance, serialCells, serialPoints);
+  CollectCells(threaded, tolerance, threadedCells, threadedPoints);
+
+  numCells += static_cast<int>(serialCells.size());
+  if (serialPoints != threadedPoints)
+    {
+    cout << name << ": " << threadedPoints << " points " << with << ", "
+         << serialPoints << " " << without << "." << endl;
+    return false;
+    }
+  if (serialCells != threadedCells)
+    {
+    cout << name << ": " << threadedCells.size() << " cells " << with
+         << ", " << serialCells.size() << " " << without
+         << ", or they differ." << endl;
+    return false;
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> RunContour(vtkDataObject* input,
+  const char* arrayName, int mergePoints, int numThreads, int deferred = 0)
+{
+  vtkSmartPointer<vtkPVAMRDualContour> contour =
+    vtkSmartPointer<vtkPVAMRDualContour>::New();
+  contour->SetInputData(input);
+  contour->SetVolumeFractionSurfaceValue(0.1);
+  contour->SetEnableMergePoints(mergePoints);
+  contour->SetEnableDegenerateCells(1);
+  contour->SetEnableMultiProcessCommunication(1);
+  contour->SetEnableDeferredGhostCopy(deferred);
+  contour->SetNumberOfThreads(numThreads);
+  contour->AddInputCellArrayToProcess(arrayName);
+  contour->Update();
+
+  vtkSmartPointer<vtkDataObject> output;
+  output.TakeReference(contour->GetOutputDataObject(0)->NewInstance());
+  output->ShallowCopy(contour->GetOutputDataObject(0));
+  return output;
+}
+
+// ----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> RunClip(vtkDataObject* input,
+  const char* arrayName, int numThreads)
+{
+  vtkSmartPointer<vtkPVAMRDualClip> clip =
+    vtkSmartPointer<vtkPVAMRDualClip>::New();
+  clip->SetInputData(input);
+  clip->SetVolumeFractionSurfaceValue(0.1);
+  clip->SetEnableMergePoints(0);
+  clip->SetEnableDegenerateCells(1);
+  clip->SetEnableMultiProcessCommunication(1);
+  clip->SetNumberOfThreads(numThreads);
+  clip->AddInputCellArrayToProcess(arrayName);
+  clip->Update();
+
+  vtkSmartPointer<vtkDataObject> output;
+  output.TakeReference(clip->GetOutputDataObject(0)->NewInstance());
+  output->ShallowCopy(clip->GetOutputDataObject(0));
+  return output;
+}
+
+// ----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+#ifdef VTK_USE_MPI
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+#else
+  vtkDummyController* controller = vtkDummyController::New();
+#endif
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int ok = 1;
+  int numCells = 0;
+  const char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/SPCTH/Dave_Karelitz_Small/spcth.0");
+  bool hasData = (fname != NULL);
+  if (hasData)
+    {
+    const char* arrayName = "Material volume fraction - 3";
+    vtkSmartPointer<vtkSpyPlotReader> reader =
+      vtkSmartPointer<vtkSpyPlotReader>::New();
+    reader->SetFileName(fname);
+    reader->SetGlobalController(controller);
+    reader->MergeXYZComponentsOn();
+    reader->DownConvertVolumeFractionOn();
+    reader->DistributeFilesOn();
+    reader->SetCellArrayStatus(arrayName, 1);
+    reader->Update();
+    delete [] fname;
+
+    vtkDataObject* input = reader->GetOutputDataObject(0);
+    for (int merge = 0; merge < 2; ++merge)
+      {
+      const char* name = merge ? "Contour with merged points" : "Contour";
+      vtkSmartPointer<vtkDataObject> serial =
+        RunContour(input, arrayName, merge, 1);
+      vtkSmartPointer<vtkDataObject> threaded =
+        RunContour(input, arrayName, merge, 4);
+      ok = CompareOutputs(serial, threaded, name, numCells) && ok;
+
+      // With several processes, the ghost values exchanged between them
+      // arrive while the blocks that do not need them are processed.
+      int ignored = 0;
+      vtkSmartPointer<vtkDataObject> deferred =
+        RunContour(input, arrayName, merge, 1, 1);
+      ok = CompareOutputs(serial, deferred, name, ignored,
+        "with deferred ghost copy", "with blocking ghost copy") && ok;
+      deferred = RunContour(input, arrayName, merge, 4, 1);
+      ok = CompareOutputs(threaded, deferred, name, ignored,
+        "with threads and deferred ghost copy",
+        "with threads and blocking ghost copy") && ok;
+      }
+
+    vtkSmartPointer<vtkDataObject> serial = RunClip(input, arrayName, 1);
+    vtkSmartPointer<vtkDataObject> threaded = RunClip(input, arrayName, 4);
+    ok = CompareOutputs(serial, threaded, "Clip", numCells) && ok;
+    }
+
+  // Some processes may have no data, but not all of them.
+  int globalOk = ok;
+  int globalNumCells = numCells;
+  controller->AllReduce(&ok, &globalOk, 1, vtkCommunicator::MIN_OP);
+  controller->AllReduce(&numCells, &globalNumCells, 1, vtkCommunicator::SUM_OP);
+  if (hasData && globalNumCells == 0)
+    {
+    cout << "The serial outputs are empty." << endl;
+    globalOk = 0;
+    }
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  controller->Finalize();
+  controller->Delete();
+  return globalOk ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExtractHistogramThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the histograms vtkExtractHistogram bins on several threads, and
+// those it merges from its cached histogram when only the bin count or the
+// values of the input change, are the same as the histograms binned by a new
+// filter on a single thread.
+
+#include "vtkDoubleArray.h"
+#include "vtkExtractHistogram.h"
+#include "vtkIntArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTable.h"
+
+// More tuples than are binned by a single thread.
+#define NUMBER_OF_TUPLES 200000
+
+// ----------------------------------------------------------------------------
+// Fills f with many duplicated values, spread over a range that grows with
+// scale. Different offsets give the same values in another order.
+void FillValues(vtkDoubleArray* f, int offset, double scale)
+{
+  for (vtkIdType i = 0; i < f->GetNumberOfTuples(); ++i)
+    {
+    f->SetValue(i, scale * (((i + offset) * 7919) % 1000 + 0.5));
+    }
+  f->Modified();
+}
+
+// ----------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> CreateInput(vtkDoubleArray* f)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetNumberOfPoints(f->GetNumberOfTuples());
+  for (vtkIdType i = 0; i < f->GetNumberOfTuples(); ++i)
+    {
+    points->SetPoint(i, 0.0, 0.0, 0.0);
+    }
+  vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+  pd->SetPoints(points);
+  pd->GetPointData()->AddArray(f);
+  return pd;
+}
+
+// ----------------------------------------------------------------------------
+vtkSmartPointer<vtkExtractHistogram> NewHistogram(vtkPolyData* input,
+  int binCount)
+{
+  vtkSmartPointer<vtkExtractHistogram> histogram =
+    vtkSmartPointer<vtkExtractHistogram>::New();
+  histogram->SetInputData(input);
+  histogram->SetInputArrayToProcess(0, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "f");
+  histogram->SetComponent(0);
+  histogram->SetBinCount(binCount);
+  return histogram;
+}
+
+// ----------------------------------------------------------------------------
+// The output of histogram must be the one of a new filter binning on a
+// single thread.
+bool Compare(vtkExtractHistogram* histogram, vtkPolyData* input,
+  const char* what)
+{
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(1);
+  vtkSmartPointer<vtkExtractHistogram> serial =
+    NewHistogram(input, histogram->GetBinCount());
+  serial->Update();
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(0);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  histogram->Update();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(0);
+
+  vtkTable* expected = serial->GetOutput();
+  vtkTable* output = histogram->GetOutput();
+  vtkIntArray* expectedValues = vtkIntArray::SafeDownCast(
+    expected->GetColumnByName("bin_values"));
+  vtkIntArray* values = vtkIntArray::SafeDownCast(
+    output->GetColumnByName("bin_values"));
+  vtkDoubleArray* expectedExtents = vtkDoubleArray::SafeDownCast(
+    expected->GetColumnByName("bin_extents"));
+  vtkDoubleArray* extents = vtkDoubleArray::SafeDownCast(
+    output->GetColumnByName("bin_extents"));
+  int binCount = histogram->GetBinCount();
+  if (!expectedValues || !values || !expectedExtents || !extents ||
+    values->GetNumberOfTuples() != binCount ||
+    expectedValues->GetNumberOfTuples() != binCount)
+    {
+    cout << what << ": no histogram of " << binCount << " bins." << endl;
+    return false;
+    }
+
+  vtkIdType total = 0;
+  for (int i = 0; i < binCount; ++i)
+    {
+    if (values->GetValue(i) != expectedValues->GetValue(i) ||
+      extents->GetValue(i) != expectedExtents->GetValue(i))
+      {
+      cout << what << ": bin " << i << " of " << binCount << " holds "
+           << values->GetValue(i) << " values at " << extents->GetValue(i)
+           << " instead of " << expectedValues->GetValue(i) << " at "
+           << expectedExtents->GetValue(i) << "." << endl;
+      return false;
+      }
+    total += values->GetValue(i);
+    }
+  if (total != NUMBER_OF_TUPLES)
+    {
+    cout << what << ": " << total << " values were binned instead of "
+         << NUMBER_OF_TUPLES << "." << endl;
+    return false;
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  int ok = 1;
+
+  vtkSmartPointer<vtkDoubleArray> f = vtkSmartPointer<vtkDoubleArray>::New();
+  f->SetName("f");
+  f->SetNumberOfTuples(NUMBER_OF_TUPLES);
+  FillValues(f, 0, 1.0);
+  vtkSmartPointer<vtkPolyData> input = CreateInput(f);
+  vtkSmartPointer<vtkExtractHistogram> histogram = NewHistogram(input, 10);
+  ok = Compare(histogram, input, "First histogram") && ok;
+
+  // Bin counts dividing the cached resolution are merged from the cached
+  // bins, the others bin the data again.
+  const int binCounts[] = { 7, 256, 100, 13, 10, 3 };
+  for (int b = 0; b < 6; ++b)
+    {
+    histogram->SetBinCount(binCounts[b]);
+    ok = Compare(histogram, input, "New bin count") && ok;
+    }
+
+  // New values in the same range are binned with the previous range, values
+  // in another range are binned again.
+  FillValues(f, 1, 1.0);
+  input->Modified();
+  ok = Compare(histogram, input, "Same range") && ok;
+  FillValues(f, 0, 1.5);
+  input->Modified();
+  ok = Compare(histogram, input, "New range") && ok;
+
+  return ok ? 0 : 1;
+}
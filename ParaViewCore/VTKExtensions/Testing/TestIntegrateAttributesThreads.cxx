@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestIntegrateAttributesThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkIntegrateAttributes gives the same results on several
+// threads as on one, and that the volume and integrals of a linear field
+// over a box match their exact values.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkIntegrateAttributes.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+// ----------------------------------------------------------------------------
+// A box of 39^3 voxels, more than are integrated serially, with a linear
+// point field and a constant cell field.
+vtkSmartPointer<vtkImageData> CreateBox()
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, 39, 0, 39, 0, 39);
+  image->SetSpacing(0.1, 0.1, 0.1);
+
+  vtkSmartPointer<vtkDoubleArray> f = vtkSmartPointer<vtkDoubleArray>::New();
+  f->SetName("f");
+  f->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    f->SetValue(i, x[0] + 2.0 * x[1] + 3.0 * x[2]);
+    }
+  image->GetPointData()->AddArray(f);
+
+  vtkSmartPointer<vtkDoubleArray> c = vtkSmartPointer<vtkDoubleArray>::New();
+  c->SetName("c");
+  c->SetNumberOfTuples(image->GetNumberOfCells());
+  c->FillComponent(0, 1.0);
+  image->GetCellData()->AddArray(c);
+  return image;
+}
+
+// ----------------------------------------------------------------------------
+vtkSmartPointer<vtkUnstructuredGrid> Integrate(vtkDataObject* input,
+  int numThreads)
+{
+  vtkSmartPointer<vtkIntegrateAttributes> integrate =
+    vtkSmartPointer<vtkIntegrateAttributes>::New();
+  integrate->SetController(NULL);
+  integrate->SetInputData(input);
+  integrate->SetNumberOfThreads(numThreads);
+  integrate->Update();
+
+  vtkSmartPointer<vtkUnstructuredGrid> output =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  output->ShallowCopy(integrate->GetOutput());
+  return output;
+}
+
+// ----------------------------------------------------------------------------
+bool CheckValue(vtkDataSetAttributes* attributes, const char* name,
+  double expected, double tolerance, const char* what)
+{
+  vtkDataArray* array = attributes->GetArray(name);
+  if (!array || array->GetNumberOfTuples() != 1)
+    {
+    cout << what << ": no " << name << "." << endl;
+    return false;
+    }
+  double value = array->GetComponent(0, 0);
+  if (fabs(value - expected) > tolerance * (1.0 + fabs(expected)))
+    {
+    cout << what << ": " << name << " is " << value << " instead of "
+         << expected << "." << endl;
+    return false;
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// Every array of the threaded output must match the serial one.
+bool CompareAttributes(vtkDataSetAttributes* serial,
+  vtkDataSetAttributes* threaded, const char* what)
+{
+  bool ok = true;
+  for (int a = 0; a < serial->GetNumberOfArrays(); ++a)
+    {
+    vtkDataArray* array = serial->GetArray(a);
+    if (array && array->GetName())
+      {
+      ok = CheckValue(threaded, array->GetName(), array->GetComponent(0, 0),
+        1e-12, what) && ok;
+      }
+    }
+  return ok;
+}
+
+// ----------------------------------------------------------------------------
+bool Compare(vtkDataObject* input, const char* what)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> serial = Integrate(input, 1);
+  vtkSmartPointer<vtkUnstructuredGrid> threaded = Integrate(input, 4);
+  bool ok = CompareAttributes(serial->GetPointData(),
+    threaded->GetPointData(), what);
+  ok = CompareAttributes(serial->GetCellData(),
+    threaded->GetCellData(), what) && ok;
+  return ok;
+}
+
+// ----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  int ok = 1;
+
+  vtkSmartPointer<vtkImageData> box = CreateBox();
+  ok = Compare(box, "Box") && ok;
+
+  // The box is [0, 3.9]^3 and f is linear, so its integral is the volume
+  // times f at the center.
+  double volume = 3.9 * 3.9 * 3.9;
+  for (int numThreads = 1; numThreads <= 4; numThreads += 3)
+    {
+    vtkSmartPointer<vtkUnstructuredGrid> result = Integrate(box, numThreads);
+    const char* what = numThreads == 1 ? "Serial box" : "Threaded box";
+    ok = CheckValue(result->GetCellData(), "Volume", volume, 1e-12, what) && ok;
+    ok = CheckValue(result->GetCellData(), "c", volume, 1e-12, what) && ok;
+    ok = CheckValue(result->GetPointData(), "f", volume * 6.0 * 1.95, 1e-12,
+      what) && ok;
+    }
+
+  // Triangles
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(100);
+  sphere->Update();
+  ok = Compare(sphere->GetOutput(), "Sphere") && ok;
+
+  return ok ? 0 : 1;
+}
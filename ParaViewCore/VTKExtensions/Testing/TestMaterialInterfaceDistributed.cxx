@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMaterialInterfaceDistributed.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the material interface filter finds the same fragments, with
+// the same ids and volumes, when the fragments split between processes are
+// resolved by neighbor exchanges as when they are resolved on process 0.
+
+#include "vtkCommunicator.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkFieldData.h"
+#include "vtkMaterialInterfaceFilter.h"
+#include "vtkMPIController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpyPlotReader.h"
+#include "vtkTestUtilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+typedef std::vector<std::pair<int, double> > FragmentList;
+
+// ----------------------------------------------------------------------------
+bool SameVolume(double a, double b)
+{
+  return fabs(a - b) <= 1e-8 * (fabs(a) + fabs(b));
+}
+
+// ----------------------------------------------------------------------------
+// The id and volume of the fragments this process holds in output 0.
+void CollectLocalFragments(vtkDataObject* dobj, FragmentList& fragments)
+{
+  fragments.clear();
+  vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(dobj);
+  if (!mb)
+    {
+    return;
+    }
+  vtkCompositeDataIterator* iter = mb->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(iter->GetCurrentDataObject());
+    if (!pd)
+      {
+      continue;
+      }
+    vtkDataArray* id = pd->GetFieldData()->GetArray("Id");
+    vtkDataArray* volume = pd->GetFieldData()->GetArray("Volume");
+    if (id && volume)
+      {
+      fragments.push_back(std::make_pair(
+          static_cast<int>(id->GetTuple1(0)), volume->GetTuple1(0)));
+      }
+    }
+  iter->Delete();
+  std::sort(fragments.begin(), fragments.end());
+}
+
+// ----------------------------------------------------------------------------
+// The id and volume of each point of output 1, in order. Only process 0
+// fills it.
+void CollectFragmentCenters(vtkDataObject* dobj, FragmentList& fragments)
+{
+  fragments.clear();
+  vtkMultiBlockDataSet* mb = vtkMultiBlockDataSet::SafeDownCast(dobj);
+  if (!mb)
+    {
+    return;
+    }
+  for (unsigned int b = 0; b < mb->GetNumberOfBlocks(); ++b)
+    {
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(mb->GetBlock(b));
+    if (!pd)
+      {
+      continue;
+      }
+    vtkDataArray* id = pd->GetPointData()->GetArray("Id");
+    vtkDataArray* volume = pd->GetPointData()->GetArray("Volume");
+    if (!id || !volume)
+      {
+      continue;
+      }
+    for (vtkIdType i = 0; i < pd->GetNumberOfPoints(); ++i)
+      {
+      fragments.push_back(std::make_pair(
+          static_cast<int>(id->GetTuple1(i)), volume->GetTuple1(i)));
+      }
+    }
+}
+
+// ----------------------------------------------------------------------------
+bool CompareFragments(const FragmentList& central,
+  const FragmentList& distributed, const char* name)
+{
+  if (central.size() != distributed.size())
+    {
+    cout << name << ": " << distributed.size() << " fragments when "
+         << "distributed, " << central.size() << " when centralized." << endl;
+    return false;
+    }
+  for (size_t i = 0; i < central.size(); ++i)
+    {
+    if (central[i].first != distributed[i].first ||
+      !SameVolume(central[i].second, distributed[i].second))
+      {
+      cout << name << ": fragment " << i << " is " << distributed[i].first
+           << " (" << distributed[i].second << ") when distributed, "
+           << central[i].first << " (" << central[i].second
+           << ") when centralized." << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+void RunFilter(vtkDataObject* input, const char* arrayName,
+  int distributed, FragmentList& local, FragmentList& centers)
+{
+  vtkSmartPointer<vtkMaterialInterfaceFilter> filter =
+    vtkSmartPointer<vtkMaterialInterfaceFilter>::New();
+  filter->SetInputData(input);
+  filter->SelectMaterialArray(arrayName);
+  filter->SetDistributedResolution(distributed);
+  filter->Update();
+
+  CollectLocalFragments(filter->GetOutputDataObject(0), local);
+  CollectFragmentCenters(filter->GetOutputDataObject(1), centers);
+}
+
+// ----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int ok = 1;
+  int numFragments = 0;
+  const char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/SPCTH/Dave_Karelitz_Small/spcth.0");
+  bool hasData = (fname != NULL);
+  if (hasData)
+    {
+    const char* arrayName = "Material volume fraction - 3";
+    vtkSmartPointer<vtkSpyPlotReader> reader =
+      vtkSmartPointer<vtkSpyPlotReader>::New();
+    reader->SetFileName(fname);
+    reader->SetGlobalController(controller);
+    reader->MergeXYZComponentsOn();
+    reader->DownConvertVolumeFractionOn();
+    reader->DistributeFilesOn();
+    reader->SetCellArrayStatus(arrayName, 1);
+    reader->Update();
+    delete [] fname;
+
+    vtkDataObject* input = reader->GetOutputDataObject(0);
+    FragmentList centralLocal;
+    FragmentList centralCenters;
+    FragmentList distributedLocal;
+    FragmentList distributedCenters;
+    RunFilter(input, arrayName, 0, centralLocal, centralCenters);
+    RunFilter(input, arrayName, 1, distributedLocal, distributedCenters);
+
+    numFragments = static_cast<int>(centralCenters.size());
+    ok = CompareFragments(centralLocal, distributedLocal,
+      "Local fragments") && ok;
+    ok = CompareFragments(centralCenters, distributedCenters,
+      "Fragment centers") && ok;
+    }
+
+  int globalOk = ok;
+  int globalNumFragments = numFragments;
+  controller->AllReduce(&ok, &globalOk, 1, vtkCommunicator::MIN_OP);
+  controller->AllReduce(&numFragments, &globalNumFragments, 1,
+    vtkCommunicator::SUM_OP);
+  if (hasData && globalNumFragments == 0)
+    {
+    cout << "No fragment was found." << endl;
+    globalOk = 0;
+    }
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  controller->Finalize();
+  controller->Delete();
+  return globalOk ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPVArrayCalculatorCompiled.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the compiled evaluation of vtkPVArrayCalculator gives the same
+// results as vtkFunctionParser, including the values replaced on invalid
+// operations such as a division by zero or a fractional power of a negative
+// value.
+
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkPointData.h"
+#include "vtkPVArrayCalculator.h"
+#include "vtkSmartPointer.h"
+
+#include <cmath>
+
+// ----------------------------------------------------------------------------
+// Two scalars and two vectors, with zeros and negative values. The image is
+// larger than the chunks evaluated at once.
+vtkSmartPointer<vtkImageData> CreateInput()
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetExtent(0, 15, 0, 15, 0, 7);
+  vtkIdType numPoints = image->GetNumberOfPoints();
+
+  const double exponents[] = { 0.5, 2.0, -1.0, 3.0, 0.0, -0.5, 1.5 };
+  vtkSmartPointer<vtkDoubleArray> s = vtkSmartPointer<vtkDoubleArray>::New();
+  vtkSmartPointer<vtkDoubleArray> t = vtkSmartPointer<vtkDoubleArray>::New();
+  vtkSmartPointer<vtkDoubleArray> v = vtkSmartPointer<vtkDoubleArray>::New();
+  vtkSmartPointer<vtkDoubleArray> w = vtkSmartPointer<vtkDoubleArray>::New();
+  s->SetName("s");
+  t->SetName("t");
+  v->SetName("v");
+  w->SetName("w");
+  v->SetNumberOfComponents(3);
+  w->SetNumberOfComponents(3);
+  s->SetNumberOfTuples(numPoints);
+  t->SetNumberOfTuples(numPoints);
+  v->SetNumberOfTuples(numPoints);
+  w->SetNumberOfTuples(numPoints);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    s->SetValue(i, static_cast<double>(i % 9) * 0.5 - 2.0);
+    t->SetValue(i, exponents[i % 7]);
+    double x = static_cast<double>(i % 5) - 2.0;
+    v->SetTuple3(i, x, 0.5 * x, 1.0);
+    w->SetTuple3(i, 1.0, -x, 0.25 * static_cast<double>(i % 3));
+    }
+  image->GetPointData()->AddArray(s);
+  image->GetPointData()->AddArray(t);
+  image->GetPointData()->AddArray(v);
+  image->GetPointData()->AddArray(w);
+  return image;
+}
+
+// ----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray> Evaluate(vtkImageData* input,
+  const char* function, int compiled)
+{
+  vtkSmartPointer<vtkPVArrayCalculator> calc =
+    vtkSmartPointer<vtkPVArrayCalculator>::New();
+  calc->SetInputData(input);
+  calc->SetAttributeModeToUsePointData();
+  calc->SetFunction(function);
+  calc->SetResultArrayName("Result");
+  calc->ReplaceInvalidValuesOn();
+  calc->SetReplacementValue(7.5);
+  calc->SetCompiledEvaluation(compiled);
+  calc->Update();
+
+  vtkDataSet* output = vtkDataSet::SafeDownCast(calc->GetOutputDataObject(0));
+  vtkSmartPointer<vtkDataArray> result =
+    output ? output->GetPointData()->GetArray("Result") : NULL;
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+bool SameValue(double a, double b)
+{
+  if (a != a || b != b)
+    {
+    return a != a && b != b;
+    }
+  return fabs(a - b) <= 1e-10 * (1.0 + fabs(a));
+}
+
+// ----------------------------------------------------------------------------
+bool Compare(vtkDataArray* parsed, vtkDataArray* compiled,
+  const char* function)
+{
+  if (!parsed || !compiled)
+    {
+    cout << function << ": no result." << endl;
+    return false;
+    }
+  if (parsed->GetNumberOfTuples() != compiled->GetNumberOfTuples() ||
+    parsed->GetNumberOfComponents() != compiled->GetNumberOfComponents())
+    {
+    cout << function << ": " << compiled->GetNumberOfTuples() << "x"
+         << compiled->GetNumberOfComponents() << " values when compiled, "
+         << parsed->GetNumberOfTuples() << "x"
+         << parsed->GetNumberOfComponents() << " when parsed." << endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < parsed->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < parsed->GetNumberOfComponents(); ++c)
+      {
+      double a = parsed->GetComponent(i, c);
+      double b = compiled->GetComponent(i, c);
+      if (!SameValue(a, b))
+        {
+        cout << function << ": value " << i << "," << c << " is " << b
+             << " when compiled, " << a << " when parsed." << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  const char* functions[] = {
+    // Powers, of negative values too
+    "s^t", "s^2", "abs(s)^t", "s^(-1)", "(s+t)^0.5",
+    // Divisions, by zero too
+    "s/t", "1/s", "t/(s-s)",
+    // Vectors
+    "v/s", "s*v", "v*s+w", "v.w", "cross(v,w)", "mag(v)", "norm(v)",
+    "norm(v-v)", "-v+w*2",
+    // Other invalid operations and functions
+    "sqrt(s)", "ln(s)", "log10(t)", "asin(s)", "min(s,t)*max(s,t)",
+    "if(s>0,v,w)", "exp(t)-floor(s)+ceil(t)"
+  };
+  const int numFunctions = sizeof(functions) / sizeof(functions[0]);
+
+  vtkSmartPointer<vtkImageData> input = CreateInput();
+  int ok = 1;
+  for (int f = 0; f < numFunctions; ++f)
+    {
+    vtkSmartPointer<vtkDataArray> parsed = Evaluate(input, functions[f], 0);
+    vtkSmartPointer<vtkDataArray> compiled = Evaluate(input, functions[f], 1);
+    ok = Compare(parsed, compiled, functions[f]) && ok;
+    }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,310 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSciVizStatisticsPrepareTable.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the tables vtkSciVizStatistics prepares for its statistics engines:
+// the full table and the sampled training table must hold the values of the
+// selected arrays at the right rows, one column per component, and filling
+// the columns with several threads must give the same tables as one thread.
+
+#include "vtkFieldData.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkSciVizStatistics.h"
+#include "vtkSmartPointer.h"
+#include "vtkStdString.h"
+#include "vtkStringArray.h"
+#include "vtkTable.h"
+#include "vtkVariant.h"
+
+#include <vtksys/ios/sstream>
+
+// ----------------------------------------------------------------------------
+// Gives access to the protected methods preparing the tables.
+class vtkTestSciVizStatistics : public vtkSciVizStatistics
+{
+public:
+  static vtkTestSciVizStatistics* New();
+  vtkTypeMacro(vtkTestSciVizStatistics, vtkSciVizStatistics);
+
+  int PrepareFull(vtkTable* table, vtkFieldData* fd)
+    {
+    return this->PrepareFullDataTable(table, fd);
+    }
+  int PrepareTraining(vtkTable* table, vtkFieldData* fd, vtkIdType num)
+    {
+    return this->PrepareTrainingTable(table, fd, num);
+    }
+  vtkIdType GetNumberForTraining(vtkIdType num)
+    {
+    return this->GetNumberOfObservationsForTraining(num);
+    }
+  vtkIdType GetNumberForTraining(vtkTable* observations)
+    {
+    return this->GetNumberOfObservationsForTraining(observations);
+    }
+
+protected:
+  virtual int LearnAndDerive(vtkMultiBlockDataSet*, vtkTable*) { return 1; }
+  virtual int AssessData(vtkTable*, vtkDataObject*, vtkMultiBlockDataSet*)
+    { return 1; }
+};
+vtkStandardNewMacro(vtkTestSciVizStatistics);
+
+// ----------------------------------------------------------------------------
+// The value of component c of tuple i of each array, as a string.
+vtkStdString ExpectedValue(const char* array, vtkIdType i, int c)
+{
+  vtksys_ios::ostringstream os;
+  vtkStdString name = array;
+  if (name == "s" || name == "id")
+    {
+    os << i;
+    }
+  else if (name == "v")
+    {
+    os << (c + 1) * i;
+    }
+  else if (name == "n")
+    {
+    os << (c ? -i : i);
+    }
+  else
+    {
+    os << (c ? "b" : "a") << i;
+    }
+  return os.str();
+}
+
+// ----------------------------------------------------------------------------
+// The values of tuple i of the selected arrays are given by ExpectedValue().
+// The last array is not selected.
+vtkSmartPointer<vtkFieldData> CreateFieldData(vtkIdType numTuples)
+{
+  vtkSmartPointer<vtkFloatArray> s = vtkSmartPointer<vtkFloatArray>::New();
+  s->SetName("s");
+  s->SetNumberOfTuples(numTuples);
+  vtkSmartPointer<vtkIdTypeArray> id = vtkSmartPointer<vtkIdTypeArray>::New();
+  id->SetName("id");
+  id->SetNumberOfTuples(numTuples);
+  vtkSmartPointer<vtkFloatArray> v = vtkSmartPointer<vtkFloatArray>::New();
+  v->SetName("v");
+  v->SetNumberOfComponents(3);
+  v->SetNumberOfTuples(numTuples);
+  vtkSmartPointer<vtkIntArray> n = vtkSmartPointer<vtkIntArray>::New();
+  n->SetName("n");
+  n->SetNumberOfComponents(2);
+  n->SetComponentName(0, "plus");
+  n->SetComponentName(1, "minus");
+  n->SetNumberOfTuples(numTuples);
+  vtkSmartPointer<vtkStringArray> str = vtkSmartPointer<vtkStringArray>::New();
+  str->SetName("str");
+  str->SetNumberOfComponents(2);
+  str->SetNumberOfTuples(numTuples);
+  vtkSmartPointer<vtkIntArray> unused = vtkSmartPointer<vtkIntArray>::New();
+  unused->SetName("unused");
+  unused->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    s->SetValue(i, i);
+    id->SetValue(i, i);
+    v->SetTuple3(i, i, 2 * i, 3 * i);
+    n->SetTuple2(i, i, -i);
+    str->SetValue(2 * i, ExpectedValue("str", i, 0));
+    str->SetValue(2 * i + 1, ExpectedValue("str", i, 1));
+    unused->SetValue(i, 0);
+    }
+
+  vtkSmartPointer<vtkFieldData> fd = vtkSmartPointer<vtkFieldData>::New();
+  fd->AddArray(s);
+  fd->AddArray(id);
+  fd->AddArray(v);
+  fd->AddArray(n);
+  fd->AddArray(str);
+  fd->AddArray(unused);
+  return fd;
+}
+
+// ----------------------------------------------------------------------------
+// Checks the columns of table and that its rows are increasing input tuples.
+bool CheckTable(vtkTable* table, vtkIdType numRows, vtkIdType numTuples,
+  const char* what)
+{
+  const char* names[] = { "s", "id", "v_0", "v_1", "v_2", "n_plus",
+    "n_minus", "str_0", "str_1" };
+  const char* arrays[] = { "s", "id", "v", "v", "v", "n", "n", "str", "str" };
+  const int components[] = { 0, 0, 0, 1, 2, 0, 1, 0, 1 };
+  const int numColumns = 9;
+  if (table->GetNumberOfColumns() != numColumns ||
+    table->GetNumberOfRows() != numRows)
+    {
+    cout << what << ": " << table->GetNumberOfColumns() << " columns and "
+         << table->GetNumberOfRows() << " rows instead of " << numColumns
+         << " and " << numRows << "." << endl;
+    return false;
+    }
+
+  vtkAbstractArray* idColumn = table->GetColumnByName("id");
+  if (!idColumn)
+    {
+    cout << what << ": no id column." << endl;
+    return false;
+    }
+  vtkIdType previous = -1;
+  for (vtkIdType r = 0; r < numRows; ++r)
+    {
+    vtkIdType i = idColumn->GetVariantValue(r).ToTypeInt64();
+    if (i <= previous || i >= numTuples)
+      {
+      cout << what << ": row " << r << " is tuple " << i << " after "
+           << previous << "." << endl;
+      return false;
+      }
+    previous = i;
+    for (int c = 0; c < numColumns; ++c)
+      {
+      vtkAbstractArray* column = table->GetColumnByName(names[c]);
+      if (!column || column->GetNumberOfComponents() != 1)
+        {
+        cout << what << ": no scalar column " << names[c] << "." << endl;
+        return false;
+        }
+      vtkStdString value = column->GetVariantValue(r).ToString();
+      vtkStdString expected = ExpectedValue(arrays[c], i, components[c]);
+      if (value != expected)
+        {
+        cout << what << ": " << names[c] << " is " << value << " at row " << r
+             << " instead of " << expected << "." << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+bool SameTables(vtkTable* a, vtkTable* b, const char* what)
+{
+  if (a->GetNumberOfColumns() != b->GetNumberOfColumns() ||
+    a->GetNumberOfRows() != b->GetNumberOfRows())
+    {
+    cout << what << ": the tables have different sizes." << endl;
+    return false;
+    }
+  for (vtkIdType c = 0; c < a->GetNumberOfColumns(); ++c)
+    {
+    for (vtkIdType r = 0; r < a->GetNumberOfRows(); ++r)
+      {
+      if (a->GetValue(r, c) != b->GetValue(r, c))
+        {
+        cout << what << ": the value of row " << r << " of "
+             << a->GetColumnName(c) << " differs." << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  int ok = 1;
+  vtkSmartPointer<vtkTestSciVizStatistics> stats =
+    vtkSmartPointer<vtkTestSciVizStatistics>::New();
+  stats->EnableAttributeArray("s");
+  stats->EnableAttributeArray("id");
+  stats->EnableAttributeArray("v");
+  stats->EnableAttributeArray("n");
+  stats->EnableAttributeArray("str");
+  stats->EnableAttributeArray("missing");
+
+  // Size of the training sample.
+  stats->SetTrainingFraction(0.1);
+  if (stats->GetNumberForTraining(50) != 50 ||
+    stats->GetNumberForTraining(500) != 100 ||
+    stats->GetNumberForTraining(250000) != 25000)
+    {
+    cout << "Wrong number of observations for training." << endl;
+    ok = 0;
+    }
+  vtkSmartPointer<vtkTable> observations = vtkSmartPointer<vtkTable>::New();
+  vtkSmartPointer<vtkIntArray> column = vtkSmartPointer<vtkIntArray>::New();
+  column->SetName("observations");
+  column->SetNumberOfTuples(500);
+  observations->AddColumn(column);
+  if (stats->GetNumberForTraining(observations) != 100)
+    {
+    cout << "Wrong number of observations for training a table." << endl;
+    ok = 0;
+    }
+
+  // More tuples than are gathered by a single thread.
+  const vtkIdType numTuples = 250000;
+  vtkSmartPointer<vtkFieldData> fd = CreateFieldData(numTuples);
+
+  // The full table references the scalar arrays.
+  vtkSmartPointer<vtkTable> full = vtkSmartPointer<vtkTable>::New();
+  if (stats->PrepareFull(full, fd) != 1)
+    {
+    cout << "The full table was not prepared." << endl;
+    ok = 0;
+    }
+  ok = CheckTable(full, numTuples, numTuples, "Full table") && ok;
+  if (full->GetColumnByName("s") != fd->GetAbstractArray("s"))
+    {
+    cout << "The scalar array s was copied." << endl;
+    ok = 0;
+    }
+
+  // Training tables, small and large enough to use several threads. The rows
+  // sampled with the same seed must not depend on the number of threads.
+  stats->SetTrainingFraction(0.6);
+  vtkIdType sizes[] = { 100, stats->GetNumberForTraining(numTuples),
+    numTuples };
+  for (int s = 0; s < 3; ++s)
+    {
+    vtkMultiThreader::SetGlobalMaximumNumberOfThreads(1);
+    vtkMath::RandomSeed(4321);
+    vtkSmartPointer<vtkTable> serial = vtkSmartPointer<vtkTable>::New();
+    stats->PrepareTraining(serial, fd, sizes[s]);
+    ok = CheckTable(serial, sizes[s], numTuples, "Serial training table") &&
+      ok;
+
+    vtkMultiThreader::SetGlobalMaximumNumberOfThreads(0);
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+    vtkMath::RandomSeed(4321);
+    vtkSmartPointer<vtkTable> threaded = vtkSmartPointer<vtkTable>::New();
+    stats->PrepareTraining(threaded, fd, sizes[s]);
+    ok = CheckTable(threaded, sizes[s], numTuples,
+      "Threaded training table") && ok;
+    ok = SameTables(serial, threaded, "Training tables") && ok;
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(0);
+    }
+
+  // Nothing to do without any of the selected arrays.
+  stats->ClearAttributeArrays();
+  stats->EnableAttributeArray("missing");
+  vtkSmartPointer<vtkTable> none = vtkSmartPointer<vtkTable>::New();
+  if (stats->PrepareFull(none, fd) != -1 || none->GetNumberOfColumns() != 0)
+    {
+    cout << "A table was prepared without any selected array." << endl;
+    ok = 0;
+    }
+
+  return ok ? 0 : 1;
+}
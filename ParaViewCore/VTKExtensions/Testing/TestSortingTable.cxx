@@ -19,11 +19,15 @@
 #include "vtkSortedTableStreamer.h"
 #include "vtkTable.h"
 #include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkStringArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkSmartPointer.h"
 #include "vtkMultiProcessController.h"
 #include "vtkDummyController.h"
 
+#include <algorithm>
+#include <vector>
 #include <float.h>
 // ----------------------------------------------------------------------------
 void fillArray(vtkDoubleArray* array, double* dataPointer, int dataSize, const char* name)
@@ -156,6 +160,241 @@ int sortMagnitudeOnUnsignedCharVector()
   return EXIT_SUCCESS;
 }
 
+// ----------------------------------------------------------------------------
+// Search another column of a table sorted on values with duplicates, and
+// check each result against the rows of the sorted output.
+int findRowWithSimilarValues(bool invert, bool debug)
+{
+  const int size = 10;
+  double dataArray[size] = { 0,1,2,1,3,1,3,1,2,100000 };
+  double idArray[size];
+  for(int i=0;i<size;i++)
+    {
+    idArray[i] = i;
+    }
+
+  vtkSmartPointer<vtkDoubleArray> dataToSort = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(dataToSort.GetPointer(), dataArray, size, "data");
+  vtkSmartPointer<vtkDoubleArray> ids = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(ids.GetPointer(), idArray, size, "id");
+
+  vtkSmartPointer<vtkTable> input = vtkSmartPointer<vtkTable>::New();
+  input->AddColumn(dataToSort);
+  input->AddColumn(ids);
+  vtkSmartPointer<vtkSortedTableStreamer> sortingfilter = vtkSmartPointer<vtkSortedTableStreamer>::New();
+
+  sortingfilter->SetInputData(input.GetPointer());
+  sortingfilter->SetSelectedComponent(0);
+  sortingfilter->SetColumnNameToSort("data");
+  sortingfilter->SetInvertOrder(invert ? 1 : 0);
+
+  sortingfilter->SetBlock(0);
+  sortingfilter->SetBlockSize(1024);
+  sortingfilter->Update();
+
+  vtkDoubleArray* sortedIds = vtkDoubleArray::SafeDownCast(
+    sortingfilter->GetOutput()->GetColumnByName("id"));
+  if(!sortedIds || sortedIds->GetNumberOfTuples() != size)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Single ids, then ranges of ids, from each start row
+  for(int width=0;width<3;width++)
+    {
+    for(int low=0;low+width<size;low++)
+      {
+      for(int startRow=0;startRow<size;startRow++)
+        {
+        vtkIdType expected = -1;
+        for(int i=startRow;i<size && expected<0;i++)
+          {
+          double id = sortedIds->GetValue(i);
+          if(id >= low && id <= low+width)
+            {
+            expected = i;
+            }
+          }
+        vtkIdType row = sortingfilter->FindRow("id", 0, low, low+width, startRow);
+        if(debug) cout << "Row of ids [" << low << ", " << low+width << "] from "
+                       << startRow << ": " << row << " expected " << expected << endl;
+        if(row != expected)
+          {
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
+// ----------------------------------------------------------------------------
+// Hidden columns are left out of the output, except the sorted one, and
+// listed with the others in the vtkColumnNames field data array.
+int sortWithHiddenColumns(bool debug)
+{
+  const int size = 10;
+  double dataArray[size] =   { 0,1,2,1,3,1,3,1,2,100000 };
+  double sortedArray[size] = { 0,1,1,1,1,2,2,3,3,100000 };
+  double idArray[size];
+  for(int i=0;i<size;i++)
+    {
+    idArray[i] = i;
+    }
+
+  vtkSmartPointer<vtkDoubleArray> dataToSort = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(dataToSort.GetPointer(), dataArray, size, "data");
+  vtkSmartPointer<vtkDoubleArray> ids = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(ids.GetPointer(), idArray, size, "id");
+  vtkSmartPointer<vtkDoubleArray> hidden = vtkSmartPointer<vtkDoubleArray>::New();
+  fillArray(hidden.GetPointer(), idArray, size, "hidden");
+
+  vtkSmartPointer<vtkTable> input = vtkSmartPointer<vtkTable>::New();
+  input->AddColumn(dataToSort);
+  input->AddColumn(ids);
+  input->AddColumn(hidden);
+  vtkSmartPointer<vtkSortedTableStreamer> sortingfilter = vtkSmartPointer<vtkSortedTableStreamer>::New();
+
+  sortingfilter->SetInputData(input.GetPointer());
+  sortingfilter->SetSelectedComponent(0);
+  sortingfilter->SetColumnNameToSort("data");
+  sortingfilter->SetBlock(0);
+  sortingfilter->SetBlockSize(1024);
+  sortingfilter->Update();
+
+  vtkSmartPointer<vtkTable> visible = vtkSmartPointer<vtkTable>::New();
+  visible->ShallowCopy(sortingfilter->GetOutput());
+
+  sortingfilter->AddHiddenColumn("hidden");
+  sortingfilter->AddHiddenColumn("data");
+  sortingfilter->Update();
+  vtkTable* output = sortingfilter->GetOutput();
+  if(debug) cout << "Columns with hidden ones: " << output->GetNumberOfColumns() << endl;
+  if(output->GetColumnByName("hidden") ||
+     !compareArray(output, "data", sortedArray, size, debug))
+    {
+    return EXIT_FAILURE;
+    }
+  vtkDoubleArray* visibleIds =
+    vtkDoubleArray::SafeDownCast(visible->GetColumnByName("id"));
+  if(!visibleIds ||
+     !compareArray(output, "id", visibleIds->GetPointer(0), size, debug))
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkStringArray* names = vtkStringArray::SafeDownCast(
+    output->GetFieldData()->GetAbstractArray("vtkColumnNames"));
+  if(!names || names->GetNumberOfTuples() < 3 ||
+     names->GetValue(0) != "data" || names->GetValue(1) != "id" ||
+     names->GetValue(2) != "hidden")
+    {
+    return EXIT_FAILURE;
+    }
+
+  // All the columns are delivered again once none are hidden.
+  sortingfilter->RemoveAllHiddenColumns();
+  sortingfilter->Update();
+  output = sortingfilter->GetOutput();
+  if(!output->GetColumnByName("hidden") ||
+     output->GetFieldData()->GetAbstractArray("vtkColumnNames"))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+// ----------------------------------------------------------------------------
+// Sort a table with many duplicated values with the sample sort and with the
+// default histogram based search, block by block. The sorted values must be
+// the same, and each row must hold the id of an input row with that value,
+// every input row once.
+int sampleSortAgainstDefaultSort(vtkIdType size, bool invert, bool debug)
+{
+  vtkSmartPointer<vtkDoubleArray> dataToSort = vtkSmartPointer<vtkDoubleArray>::New();
+  dataToSort->SetName("data");
+  dataToSort->SetNumberOfTuples(size);
+  vtkSmartPointer<vtkDoubleArray> ids = vtkSmartPointer<vtkDoubleArray>::New();
+  ids->SetName("id");
+  ids->SetNumberOfTuples(size);
+  for(vtkIdType i=0;i<size;i++)
+    {
+    dataToSort->SetValue(i, (i * 7919) % 1000);
+    ids->SetValue(i, i);
+    }
+
+  vtkSmartPointer<vtkTable> input = vtkSmartPointer<vtkTable>::New();
+  input->AddColumn(dataToSort);
+  input->AddColumn(ids);
+
+  const vtkIdType blockSize = 10000;
+  vtkSmartPointer<vtkSortedTableStreamer> sortingfilters[2];
+  for(int sampleSort=0;sampleSort<2;sampleSort++)
+    {
+    vtkSortedTableStreamer* sortingfilter = vtkSortedTableStreamer::New();
+    sortingfilter->SetInputData(input.GetPointer());
+    sortingfilter->SetSelectedComponent(0);
+    sortingfilter->SetColumnNameToSort("data");
+    sortingfilter->SetInvertOrder(invert ? 1 : 0);
+    sortingfilter->SetBlockSize(blockSize);
+    sortingfilter->SetSampleSort(sampleSort);
+    sortingfilters[sampleSort].TakeReference(sortingfilter);
+    }
+
+  std::vector<bool> seen(size, false);
+  vtkIdType numBlocks = (size + blockSize - 1) / blockSize;
+  for(vtkIdType block=0;block<numBlocks || block==0;block++)
+    {
+    for(int sampleSort=0;sampleSort<2;sampleSort++)
+      {
+      sortingfilters[sampleSort]->SetBlock(block);
+      sortingfilters[sampleSort]->Update();
+      }
+    vtkTable* expected = sortingfilters[0]->GetOutput();
+    vtkTable* output = sortingfilters[1]->GetOutput();
+    vtkIdType numRows = std::min(blockSize, size - block * blockSize);
+    if(debug) cout << "Block " << block << ": " << output->GetNumberOfRows()
+                   << " rows, expected " << numRows << endl;
+    if(expected->GetNumberOfRows() != numRows ||
+       output->GetNumberOfRows() != numRows)
+      {
+      return EXIT_FAILURE;
+      }
+    if(numRows == 0)
+      {
+      continue;
+      }
+
+    vtkDoubleArray* expectedData =
+      vtkDoubleArray::SafeDownCast(expected->GetColumnByName("data"));
+    vtkDoubleArray* sortedIds =
+      vtkDoubleArray::SafeDownCast(output->GetColumnByName("id"));
+    if(!expectedData || !sortedIds ||
+       !compareArray(output, "data", expectedData->GetPointer(0),
+                     static_cast<int>(numRows), false))
+      {
+      return EXIT_FAILURE;
+      }
+    for(vtkIdType r=0;r<numRows;r++)
+      {
+      vtkIdType id = static_cast<vtkIdType>(sortedIds->GetValue(r));
+      if(id < 0 || id >= size || seen[id] ||
+         dataToSort->GetValue(id) != expectedData->GetValue(r))
+        {
+        if(debug) cout << "Row " << r << " of block " << block
+                       << " holds input row " << id << endl;
+        return EXIT_FAILURE;
+        }
+      seen[id] = true;
+      }
+    }
+
+  return std::find(seen.begin(), seen.end(), false) == seen.end() ?
+    EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 // ----------------------------------------------------------------------------
 int main(int vtkNotUsed(argc), char **vtkNotUsed(argv))
 {
@@ -179,6 +418,32 @@ int main(int vtkNotUsed(argc), char **vtkNotUsed(argv))
            ? "FAILED" :  "SUCCESS")
        << endl;
   // --------------------------------------------------------------------------
+  cout << "Testing row search with similar values: "
+       << ((result += findRowWithSimilarValues(false, debug)) ? "FAILED" :  "SUCCESS")
+       << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing row search with similar values in inverted order: "
+       << ((result += findRowWithSimilarValues(true, debug)) ? "FAILED" :  "SUCCESS")
+       << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing sorting with hidden columns: "
+       << ((result += sortWithHiddenColumns(debug)) ? "FAILED" :  "SUCCESS")
+       << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing sample sort against the default sort: "
+       << ((result += sampleSortAgainstDefaultSort(150000, false, debug))
+           ? "FAILED" :  "SUCCESS")
+       << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing sample sort against the default sort in inverted order: "
+       << ((result += sampleSortAgainstDefaultSort(150000, true, debug))
+           ? "FAILED" :  "SUCCESS")
+       << endl;
+  // --------------------------------------------------------------------------
+  cout << "Testing sample sort of an empty table: "
+       << ((result += sampleSortAgainstDefaultSort(0, false, debug))
+           ? "FAILED" :  "SUCCESS")
+       << endl;
   // --------------------------------------------------------------------------
 
   // Delete Fake MPI controller
@@ -23,6 +23,8 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkTimerLog.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
 // PV interface
@@ -48,6 +50,7 @@
 #include "vtkUnsignedCharArray.h"
 #include <math.h>
 #include <ctime>
+#include <sstream>
 
 
 vtkStandardNewMacro(vtkAMRDualClip);
@@ -1353,6 +1356,8 @@ vtkAMRDualClip::vtkAMRDualClip()
   this->EnableDegenerateCells = 1;
   this->EnableMultiProcessCommunication = 0;
   this->EnableMergePoints = 0;
+  this->NumberOfThreads = 1;
+  this->EnableProfiling = 0;
 
   this->Controller = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
@@ -1390,6 +1395,12 @@ void vtkAMRDualClip::PrintSelf(ostream& os, vtkIndent indent)
      << this->EnableDegenerateCells << endl;
   os << indent << "EnableMergePoints: " << this->EnableMergePoints << endl;
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
+  os << indent << "EnableProfiling: " << this->EnableProfiling << endl;
+  if (this->EnableProfiling)
+    {
+    os << indent << "ProfileReport: " << endl << this->ProfileReport;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -1468,6 +1479,7 @@ int vtkAMRDualClip::RequestData(
     }
   const char *arrayNameToProcess = inArrayInfo->Get(vtkDataObject::FIELD_NAME());
 
+  this->ProfileReport.clear();
   vtkMultiBlockDataSet* out =
     this->DoRequestData(hbdsInput, arrayNameToProcess);
 
@@ -1512,6 +1524,8 @@ vtkAMRDualClip::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
     this->Helper->SetController(NULL);
     }
 
+  // This includes the exchange of ghost values between processes.
+  double start = this->StartStage("vtkAMRDualClip::Initialize");
   // @TODO: Check if this is the right thing to do.
   this->Helper->Initialize(hbdsInput, arrayNameToProcess);
 
@@ -1520,6 +1534,7 @@ vtkAMRDualClip::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
     {
     this->DistributeLevelMasks();
     }
+  this->EndStage("vtkAMRDualClip::Initialize", start);
 
   vtkUnstructuredGrid* mesh = vtkUnstructuredGrid::New();
   this->Points = vtkPoints::New();
@@ -1537,23 +1552,57 @@ vtkAMRDualClip::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
   mesh->GetPointData()->AddArray(this->LevelMaskPointArray);
 
   this->Mesh = mesh;
-  this->InitializeCopyAttributes(hbdsInput, this->Mesh);
 
-  // Loop through blocks
-  int numLevels = hbdsInput->GetNumberOfLevels();
-  int numBlocks;
-  int blockId;
-
-  // Add each block.
-  for (int level = 0; level < numLevels; ++level)
+  start = this->StartStage("vtkAMRDualClip::ProcessBlocks");
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  if (this->NumberOfThreads > 0)
     {
-    numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
-    for (blockId = 0; blockId < numBlocks; ++blockId)
+    threader->SetNumberOfThreads(this->NumberOfThreads);
+    }
+  int numThreads = threader->GetNumberOfThreads();
+  int maxThreads = vtkMultiThreader::GetGlobalMaximumNumberOfThreads();
+  if (maxThreads > 0 && numThreads > maxThreads)
+    {
+    numThreads = maxThreads;
+    }
+  if (numThreads > 1 && !this->EnableMergePoints)
+    {
+    threader->SetNumberOfThreads(numThreads);
+    this->ProcessBlocksThreaded(hbdsInput, threader, arrayNameToProcess);
+    }
+  else
+    {
+    numThreads = 1;
+    this->InitializeCopyAttributes(hbdsInput, this->Mesh);
+
+    // Loop through blocks
+    int numLevels = hbdsInput->GetNumberOfLevels();
+    int numBlocks;
+    int blockId;
+
+    // Add each block.
+    for (int level = 0; level < numLevels; ++level)
       {
-      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
-      this->ProcessBlock(block, blockId, arrayNameToProcess);
+      numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+      for (blockId = 0; blockId < numBlocks; ++blockId)
+        {
+        vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+        this->ProcessBlock(block, blockId, arrayNameToProcess);
+        }
       }
     }
+  threader->Delete();
+  this->EndStage("vtkAMRDualClip::ProcessBlocks", start);
+
+  if (this->EnableProfiling)
+    {
+    std::ostringstream os;
+    os << "  " << arrayNameToProcess << ": "
+       << this->Points->GetNumberOfPoints() << " points, "
+       << this->Cells->GetNumberOfCells() << " cells, "
+       << numThreads << " threads" << endl;
+    this->ProfileReport += os.str();
+    }
 
   this->BlockIdCellArray->Delete();
   this->BlockIdCellArray = 0;
@@ -1593,6 +1642,175 @@ void vtkDualGridContourCastCornerValues(
   values[7] = (double)(ptr[offsets[7]]);
 }
 
+//----------------------------------------------------------------------------
+double vtkAMRDualClip::StartStage(const char* stage)
+{
+  if (!this->EnableProfiling)
+    {
+    return 0.0;
+    }
+  vtkTimerLog::MarkStartEvent(stage);
+  return vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRDualClip::EndStage(const char* stage, double start)
+{
+  if (!this->EnableProfiling)
+    {
+    return;
+    }
+  vtkTimerLog::MarkEndEvent(stage);
+  std::ostringstream os;
+  os << "  " << stage << ": "
+     << vtkTimerLog::GetUniversalTime() - start << " s" << endl;
+  this->ProfileReport += os.str();
+}
+
+//----------------------------------------------------------------------------
+// The blocks the threads work on, and the filters that do it.
+struct vtkAMRDualClipThreadData
+{
+  vtkAMRDualClip** Workers;
+  const char* ArrayName;
+  std::vector<vtkAMRDualGridHelperBlock*> Blocks;
+  std::vector<int> BlockIds;
+};
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkAMRDualClipThreadedExecute(void *arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkAMRDualClipThreadData* data =
+    static_cast<vtkAMRDualClipThreadData*>(info->UserData);
+  vtkAMRDualClip* worker = data->Workers[info->ThreadID];
+
+  size_t numBlocks = data->Blocks.size();
+  for (size_t ii = info->ThreadID; ii < numBlocks; ii += info->NumberOfThreads)
+    {
+    worker->ProcessBlock(data->Blocks[ii], data->BlockIds[ii], data->ArrayName);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Without merging each thread has its own locator and the blocks are
+// independent, so they are all handed out at once.
+void vtkAMRDualClip::ProcessBlocksThreaded(
+  vtkNonOverlappingAMR* hbdsInput,
+  vtkMultiThreader* threader,
+  const char* arrayNameToProcess)
+{
+  int numWorkers = threader->GetNumberOfThreads();
+  std::vector<vtkAMRDualClip*> workers(numWorkers);
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    vtkAMRDualClip* worker = vtkAMRDualClip::New();
+    worker->SetController(NULL);
+    worker->IsoValue = this->IsoValue;
+    worker->EnableInternalDecimation = this->EnableInternalDecimation;
+    worker->EnableDegenerateCells = this->EnableDegenerateCells;
+    worker->EnableMergePoints = 0;
+    worker->Helper = this->Helper;
+    worker->Mesh = vtkUnstructuredGrid::New();
+    worker->Points = vtkPoints::New();
+    worker->Cells = vtkCellArray::New();
+    worker->Mesh->SetPoints(worker->Points);
+    worker->BlockIdCellArray = vtkIntArray::New();
+    worker->LevelMaskPointArray = vtkUnsignedCharArray::New();
+    worker->InitializeCopyAttributes(hbdsInput, worker->Mesh);
+    workers[ii] = worker;
+    }
+
+  vtkAMRDualClipThreadData data;
+  data.Workers = &workers[0];
+  data.ArrayName = arrayNameToProcess;
+  int numLevels = hbdsInput->GetNumberOfLevels();
+  for (int level = 0; level < numLevels; ++level)
+    {
+    int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+    for (int blockId = 0; blockId < numBlocks; ++blockId)
+      {
+      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+      if (block->Image)
+        {
+        data.Blocks.push_back(block);
+        data.BlockIds.push_back(blockId);
+        }
+      }
+    }
+  threader->SetSingleMethod(vtkAMRDualClipThreadedExecute, &data);
+  threader->SingleMethodExecute();
+
+  this->MergeThreadMeshes(&workers[0], numWorkers);
+
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    vtkAMRDualClip* worker = workers[ii];
+    worker->Helper = 0;
+    worker->BlockIdCellArray->Delete();
+    worker->BlockIdCellArray = 0;
+    worker->LevelMaskPointArray->Delete();
+    worker->LevelMaskPointArray = 0;
+    worker->Mesh->Delete();
+    worker->Mesh = 0;
+    worker->Points->Delete();
+    worker->Points = 0;
+    worker->Cells->Delete();
+    worker->Cells = 0;
+    worker->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Append the meshes of the threads, offsetting their point ids.
+void vtkAMRDualClip::MergeThreadMeshes(
+  vtkAMRDualClip** workers, int numWorkers)
+{
+  vtkIdType numPoints = 0;
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    numPoints += workers[ii]->Points->GetNumberOfPoints();
+    }
+
+  vtkPointData* outPD = this->Mesh->GetPointData();
+  outPD->CopyAllocate(workers[0]->Mesh->GetPointData(), numPoints);
+  this->Points->SetNumberOfPoints(numPoints);
+  vtkIdType pointOffset = 0;
+  std::vector<vtkIdType> ids;
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    vtkAMRDualClip* worker = workers[ii];
+    vtkPointData* pd = worker->Mesh->GetPointData();
+    vtkIdType num = worker->Points->GetNumberOfPoints();
+    for (vtkIdType id = 0; id < num; ++id)
+      {
+      this->Points->SetPoint(pointOffset + id, worker->Points->GetPoint(id));
+      outPD->CopyData(pd, id, pointOffset + id);
+      this->LevelMaskPointArray->InsertNextValue(
+        worker->LevelMaskPointArray->GetValue(id));
+      }
+
+    vtkIdType numPts;
+    vtkIdType* pts;
+    vtkIdType cellId = 0;
+    worker->Cells->InitTraversal();
+    while (worker->Cells->GetNextCell(numPts, pts))
+      {
+      ids.resize(numPts);
+      for (vtkIdType jj = 0; jj < numPts; ++jj)
+        {
+        ids[jj] = pts[jj] + pointOffset;
+        }
+      this->Cells->InsertNextCell(numPts, &ids[0]);
+      this->BlockIdCellArray->InsertNextValue(
+        worker->BlockIdCellArray->GetValue(cellId++));
+      }
+    pointOffset += num;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkAMRDualClip::ShareBlockLocatorWithNeighbors(
   vtkAMRDualGridHelperBlock* block)
@@ -19,11 +19,16 @@
 // transitions are handled correctly, and second is that interal
 // cells are decimated.  I use a variation of degenerate points/cells
 // used for level transitions.
+//
+// When points are not merged between blocks, the blocks of each process can
+// be clipped by several threads.
 
 #ifndef __vtkAMRDualClip_h
 #define __vtkAMRDualClip_h
 
 #include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkMultiThreader.h" // for VTK_MAX_THREADS
+#include <string> // for ProfileReport
 
 class vtkDataSet;
 class vtkImageData;
@@ -79,6 +84,27 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController *);
 
+  // Description:
+  // Number of threads used to process the blocks of each process. When 0
+  // the vtkMultiThreader default is used. In either case the global maximum
+  // set on vtkMultiThreader is respected. The default of 1 keeps the points
+  // and cells in block order, threads append them in another order. Blocks
+  // are always processed one at a time when EnableMergePoints is on, because
+  // the level masks shared between neighbors are computed on demand.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+  // Description:
+  // When on, the time taken by each stage of the filter is measured.
+  // The stages are marked in the vtkTimerLog and summarized, along with
+  // the number of points and cells, in the profile report.
+  vtkSetMacro(EnableProfiling,int);
+  vtkGetMacro(EnableProfiling,int);
+  vtkBooleanMacro(EnableProfiling,int);
+
+  // Description:
+  // The report of the last execution when EnableProfiling is on.
+  const char *GetProfileReport() { return this->ProfileReport.c_str(); }
 
 protected:
   vtkAMRDualClip();
@@ -91,6 +117,9 @@ protected:
   int EnableDegenerateCells;
   int EnableMultiProcessCommunication;
   int EnableMergePoints;
+  int NumberOfThreads;
+  int EnableProfiling;
+  std::string ProfileReport;
 
   // Needed for copying cell data to point data.
   vtkUnstructuredGrid* Mesh;
@@ -115,6 +144,22 @@ protected:
   void ProcessBlock(vtkAMRDualGridHelperBlock* block, int blockId,
                     const char* arrayName);
 
+  // Description:
+  // Process all of the blocks with several threads, each with its own copy
+  // of this filter producing its own mesh. The meshes are then appended to
+  // this one. Only used when points are not merged.
+  void ProcessBlocksThreaded(vtkNonOverlappingAMR* input,
+                             vtkMultiThreader* threader,
+                             const char* arrayName);
+  void MergeThreadMeshes(vtkAMRDualClip** workers, int numWorkers);
+  friend VTK_THREAD_RETURN_TYPE vtkAMRDualClipThreadedExecute(void *arg);
+
+  // Description:
+  // Bracket a stage of the execution when profiling. StartStage returns
+  // the time to pass to EndStage, which adds a line to the report.
+  double StartStage(const char* stage);
+  void EndStage(const char* stage, double start);
+
   void ProcessDualCell(
     vtkAMRDualGridHelperBlock* block, int blockId,
     int x, int y, int z,
@@ -22,6 +22,9 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkCriticalSection.h"
+#include "vtkTimerLog.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
 // PV interface
@@ -33,6 +36,7 @@
 #include "vtkCellData.h"
 #include "vtkPointData.h"
 #include "vtkFloatArray.h"
+#include "vtkIntArray.h"
 #include "vtkPolyData.h"
 #include "vtkImageData.h"
 #include "vtkUniformGrid.h"
@@ -46,6 +50,7 @@
 #include "vtkUnsignedCharArray.h"
 #include <math.h>
 #include <ctime>
+#include <sstream>
 
 
 vtkStandardNewMacro(vtkAMRDualContour);
@@ -383,15 +388,21 @@ vtkIdType* vtkAMRDualContourEdgeLocator::GetCornerPointer(
 }
 
 
+//----------------------------------------------------------------------------
+// Threads may ask for the locator of the same neighbor at the same time.
+static vtkSimpleCriticalSection vtkAMRDualContourLocatorLock;
+
 //----------------------------------------------------------------------------
 vtkAMRDualContourEdgeLocator* vtkAMRDualContourGetBlockLocator(
   vtkAMRDualGridHelperBlock* block)
 {
+  vtkAMRDualContourLocatorLock.Lock();
   if (block->UserData == 0)
     {
     vtkImageData* image = block->Image;
     if (image == 0)
       { // Remote blocks are only to setup local block bit flags.
+      vtkAMRDualContourLocatorLock.Unlock();
       return 0;
       }
     int     extent[6];
@@ -405,8 +416,10 @@ vtkAMRDualContourEdgeLocator* vtkAMRDualContourGetBlockLocator(
     block->UserData = (void*)(locator); // Block owns it now.
     locator->Initialize(extent[1]-extent[0], extent[3]-extent[2], extent[5]-extent[4]);
     locator->CopyRegionLevelDifferences(block);
+    vtkAMRDualContourLocatorLock.Unlock();
     return locator;
     }
+  vtkAMRDualContourLocatorLock.Unlock();
   return (vtkAMRDualContourEdgeLocator*)(block->UserData);
 }
 
@@ -532,12 +545,17 @@ vtkAMRDualContour::vtkAMRDualContour()
 {
   this->IsoValue = 100.0;
   this->SkipGhostCopy = 0;
+  this->EnableDeferredGhostCopy = 0;
 
   this->EnableDegenerateCells = 1;
   this->EnableCapping = 1;
   this->EnableMultiProcessCommunication = 1;
   this->EnableMergePoints = 1;
   this->TriangulateCap = 1;
+  this->NumberOfThreads = 1;
+  this->EnableProfiling = 0;
+  this->IdStride = 1;
+  this->IdOffset = 0;
 
   this->Controller = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
@@ -577,6 +595,14 @@ void vtkAMRDualContour::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "EnableMergePoints: " << this->EnableMergePoints << endl;
   os << indent << "TriangulateCap: " << this->TriangulateCap << endl;
   os << indent << "SkipGhostCopy: " << this->SkipGhostCopy << endl;
+  os << indent << "EnableDeferredGhostCopy: "
+     << this->EnableDeferredGhostCopy << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
+  os << indent << "EnableProfiling: " << this->EnableProfiling << endl;
+  if (this->EnableProfiling)
+    {
+    os << indent << "ProfileReport: " << endl << this->ProfileReport;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -655,6 +681,7 @@ int vtkAMRDualContour::RequestData(
     }
   const char *arrayNameToProcess = inArrayInfo->Get(vtkDataObject::FIELD_NAME());
 
+  this->ProfileReport.clear();
   vtkMultiBlockDataSet* out =
     this->DoRequestData(hbdsInput, arrayNameToProcess);
 
@@ -690,6 +717,9 @@ vtkAMRDualContour::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
   this->Helper = vtkAMRDualGridHelper::New();
   this->Helper->SetEnableDegenerateCells(this->EnableDegenerateCells);
   this->Helper->SetSkipGhostCopy(this->SkipGhostCopy);
+  // Blocks that need no remote ghost values can be processed while the
+  // exchange is in flight.
+  this->Helper->SetEnableDeferredGhostCopy(this->EnableDeferredGhostCopy);
   if (this->EnableMultiProcessCommunication)
     {
     this->Helper->SetController(this->Controller);
@@ -699,8 +729,11 @@ vtkAMRDualContour::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
     this->Helper->SetController(NULL);
     }
 
+  // This includes the exchange of ghost values between processes.
+  double start = this->StartStage("vtkAMRDualContour::Initialize");
   // @TODO: Check if this is the right thing to do.
   this->Helper->Initialize(hbdsInput, arrayNameToProcess);
+  this->EndStage("vtkAMRDualContour::Initialize", start);
 
   this->Mesh = vtkPolyData::New();
   this->Points = vtkPoints::New();
@@ -709,28 +742,80 @@ vtkAMRDualContour::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
   this->Mesh->SetPolys(this->Faces);
   mpds->SetPiece(0, this->Mesh);
 
-  this->InitializeCopyAttributes(hbdsInput, this->Mesh);
-
   // For debugging.
   this->BlockIdCellArray = vtkIntArray::New();
   this->BlockIdCellArray->SetName("BlockIds");
   this->Mesh->GetCellData()->AddArray(this->BlockIdCellArray);
 
-  // Loop through blocks
-  int numLevels = hbdsInput->GetNumberOfLevels();
-
-  // Add each block.
-  for (int level = 0; level < numLevels; ++level)
+  start = this->StartStage("vtkAMRDualContour::ProcessBlocks");
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  if (this->NumberOfThreads > 0)
+    {
+    threader->SetNumberOfThreads(this->NumberOfThreads);
+    }
+  int numThreads = threader->GetNumberOfThreads();
+  int maxThreads = vtkMultiThreader::GetGlobalMaximumNumberOfThreads();
+  if (maxThreads > 0 && numThreads > maxThreads)
+    {
+    numThreads = maxThreads;
+    }
+  if (numThreads > 1)
+    {
+    threader->SetNumberOfThreads(numThreads);
+    this->ProcessBlocksThreaded(hbdsInput, threader, arrayNameToProcess);
+    }
+  else
     {
-    int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
-    for (int blockId = 0; blockId < numBlocks; ++blockId)
+    numThreads = 1;
+    this->InitializeCopyAttributes(hbdsInput, this->Mesh);
+
+    // Loop through blocks
+    int numLevels = hbdsInput->GetNumberOfLevels();
+
+    // Add each block.  Locators are shared with higher levels so levels
+    // are kept in order, but within a level blocks still waiting for ghost
+    // values are left for last.
+    // Finishing the copy of one block may complete others, so the blocks
+    // are sorted once.
+    for (int level = 0; level < numLevels; ++level)
       {
-      vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
-      this->ProcessBlock(block, blockId, arrayNameToProcess);
+      int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+      std::vector<int> waitingBlocks(numBlocks);
+      for (int blockId = 0; blockId < numBlocks; ++blockId)
+        {
+        vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+        waitingBlocks[blockId] =
+          this->Helper->IsBlockWaitingForGhostCopy(block) ? 1 : 0;
+        if ( ! waitingBlocks[blockId])
+          {
+          this->ProcessBlock(block, blockId, arrayNameToProcess);
+          }
+        }
+      for (int blockId = 0; blockId < numBlocks; ++blockId)
+        {
+        vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+        if (waitingBlocks[blockId])
+          {
+          this->Helper->FinishBlockGhostCopy(block);
+          this->ProcessBlock(block, blockId, arrayNameToProcess);
+          }
+        }
       }
     }
+  this->Helper->FinishGhostCopy();
+  threader->Delete();
+  this->EndStage("vtkAMRDualContour::ProcessBlocks", start);
 
   this->FinalizeCopyAttributes(this->Mesh);
+  if (this->EnableProfiling)
+    {
+    std::ostringstream os;
+    os << "  " << arrayNameToProcess << ": "
+       << this->Points->GetNumberOfPoints() << " points, "
+       << this->Faces->GetNumberOfCells() << " faces, "
+       << numThreads << " threads" << endl;
+    this->ProfileReport += os.str();
+    }
   this->BlockIdCellArray->Delete();
   this->BlockIdCellArray = 0;
 
@@ -748,6 +833,255 @@ vtkAMRDualContour::DoRequestData(vtkNonOverlappingAMR* hbdsInput,
   return mbdsOutput0;
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkAMRDualContour::InsertPoint(const double pt[3])
+{
+  return this->Points->InsertNextPoint(pt) * this->IdStride + this->IdOffset;
+}
+
+//----------------------------------------------------------------------------
+double vtkAMRDualContour::StartStage(const char* stage)
+{
+  if (!this->EnableProfiling)
+    {
+    return 0.0;
+    }
+  vtkTimerLog::MarkStartEvent(stage);
+  return vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRDualContour::EndStage(const char* stage, double start)
+{
+  if (!this->EnableProfiling)
+    {
+    return;
+    }
+  vtkTimerLog::MarkEndEvent(stage);
+  std::ostringstream os;
+  os << "  " << stage << ": "
+     << vtkTimerLog::GetUniversalTime() - start << " s" << endl;
+  this->ProfileReport += os.str();
+}
+
+//----------------------------------------------------------------------------
+// The blocks a pass of the threads works on, and the filters that do it.
+struct vtkAMRDualContourThreadData
+{
+  vtkAMRDualContour** Workers;
+  const char* ArrayName;
+  std::vector<vtkAMRDualGridHelperBlock*> Blocks;
+  std::vector<int> BlockIds;
+};
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkAMRDualContourThreadedExecute(void *arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkAMRDualContourThreadData* data =
+    static_cast<vtkAMRDualContourThreadData*>(info->UserData);
+  vtkAMRDualContour* worker = data->Workers[info->ThreadID];
+
+  size_t numBlocks = data->Blocks.size();
+  for (size_t ii = info->ThreadID; ii < numBlocks; ii += info->NumberOfThreads)
+    {
+    worker->ProcessBlock(data->Blocks[ii], data->BlockIds[ii], data->ArrayName);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// When points are merged, a block shares its locator with its unprocessed
+// neighbors in the same and higher levels. To keep two threads from working
+// on the same locator, levels are processed in order and the blocks of a
+// level are split into eight groups by the parity of their grid index.
+// Blocks in a group do not touch each other, and no block of a higher level
+// touches two of them.
+void vtkAMRDualContour::ProcessBlocksThreaded(
+  vtkNonOverlappingAMR* hbdsInput,
+  vtkMultiThreader* threader,
+  const char* arrayNameToProcess)
+{
+  int numWorkers = threader->GetNumberOfThreads();
+  std::vector<vtkAMRDualContour*> workers(numWorkers);
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    vtkAMRDualContour* worker = vtkAMRDualContour::New();
+    worker->SetController(NULL);
+    worker->IsoValue = this->IsoValue;
+    worker->EnableDegenerateCells = this->EnableDegenerateCells;
+    worker->EnableCapping = this->EnableCapping;
+    worker->EnableMergePoints = this->EnableMergePoints;
+    worker->TriangulateCap = this->TriangulateCap;
+    worker->Helper = this->Helper;
+    worker->IdStride = numWorkers;
+    worker->IdOffset = ii;
+    worker->Mesh = vtkPolyData::New();
+    worker->Points = vtkPoints::New();
+    worker->Faces = vtkCellArray::New();
+    worker->Mesh->SetPoints(worker->Points);
+    worker->Mesh->SetPolys(worker->Faces);
+    worker->BlockIdCellArray = vtkIntArray::New();
+    worker->InitializeCopyAttributes(hbdsInput, worker->Mesh);
+    workers[ii] = worker;
+    }
+
+  vtkAMRDualContourThreadData data;
+  data.Workers = &workers[0];
+  data.ArrayName = arrayNameToProcess;
+  threader->SetSingleMethod(vtkAMRDualContourThreadedExecute, &data);
+
+  int numLevels = hbdsInput->GetNumberOfLevels();
+  if ( ! this->EnableMergePoints)
+    {
+    // Without merging, the blocks are independent.  Those that need no
+    // remote ghost values go first, while the exchange is in flight.
+    vtkAMRDualContourThreadData waiting;
+    waiting.Workers = data.Workers;
+    waiting.ArrayName = data.ArrayName;
+    for (int level = 0; level < numLevels; ++level)
+      {
+      int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+      for (int blockId = 0; blockId < numBlocks; ++blockId)
+        {
+        vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+        if (block->Image == 0)
+          {
+          continue;
+          }
+        vtkAMRDualContourThreadData& list =
+          this->Helper->IsBlockWaitingForGhostCopy(block) ? waiting : data;
+        list.Blocks.push_back(block);
+        list.BlockIds.push_back(blockId);
+        }
+      }
+    threader->SingleMethodExecute();
+    this->Helper->FinishGhostCopy();
+    if (!waiting.Blocks.empty())
+      {
+      threader->SetSingleMethod(vtkAMRDualContourThreadedExecute, &waiting);
+      threader->SingleMethodExecute();
+      }
+    }
+  else
+    {
+    // As in the serial loop, the blocks of a level that need no remote
+    // ghost values are contoured first, while the exchange is in flight.
+    // The ghost copy of the other blocks is then finished group by group,
+    // right before the threads contour them.  Threads do not communicate.
+    for (int level = 0; level < numLevels; ++level)
+      {
+      int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+      // Finishing the copy of one block may complete others, so the
+      // blocks are sorted once.
+      std::vector<int> waitingBlocks(numBlocks);
+      for (int blockId = 0; blockId < numBlocks; ++blockId)
+        {
+        waitingBlocks[blockId] = this->Helper->IsBlockWaitingForGhostCopy(
+          this->Helper->GetBlock(level, blockId)) ? 1 : 0;
+        }
+      for (int waiting = 0; waiting < 2; ++waiting)
+        {
+        for (int group = 0; group < 8; ++group)
+          {
+          for (int blockId = 0; blockId < numBlocks; ++blockId)
+            {
+            vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
+            int parity = (block->GridIndex[0] & 1)
+              | ((block->GridIndex[1] & 1) << 1)
+              | ((block->GridIndex[2] & 1) << 2);
+            if (block->Image && parity == group &&
+              waitingBlocks[blockId] == waiting)
+              {
+              data.Blocks.push_back(block);
+              data.BlockIds.push_back(blockId);
+              }
+            }
+          for (size_t ii = 0; waiting && ii < data.Blocks.size(); ++ii)
+            {
+            this->Helper->FinishBlockGhostCopy(data.Blocks[ii]);
+            }
+          if (!data.Blocks.empty())
+            {
+            threader->SingleMethodExecute();
+            data.Blocks.clear();
+            data.BlockIds.clear();
+            }
+          }
+        }
+      }
+    }
+
+  this->MergeThreadMeshes(&workers[0], numWorkers);
+
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    vtkAMRDualContour* worker = workers[ii];
+    worker->Helper = 0;
+    worker->BlockIdCellArray->Delete();
+    worker->BlockIdCellArray = 0;
+    worker->Mesh->Delete();
+    worker->Mesh = 0;
+    worker->Points->Delete();
+    worker->Points = 0;
+    worker->Faces->Delete();
+    worker->Faces = 0;
+    worker->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Concatenate the meshes of the threads, translating the interleaved point
+// ids into ids in the combined mesh.
+void vtkAMRDualContour::MergeThreadMeshes(
+  vtkAMRDualContour** workers, int numWorkers)
+{
+  std::vector<vtkIdType> pointOffsets(numWorkers);
+  vtkIdType numPoints = 0;
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    pointOffsets[ii] = numPoints;
+    numPoints += workers[ii]->Points->GetNumberOfPoints();
+    }
+
+  vtkPointData* outPD = this->Mesh->GetPointData();
+  outPD->CopyAllocate(workers[0]->Mesh->GetPointData(), numPoints);
+  this->Points->SetNumberOfPoints(numPoints);
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    vtkPoints* points = workers[ii]->Points;
+    vtkPointData* pd = workers[ii]->Mesh->GetPointData();
+    vtkIdType num = points->GetNumberOfPoints();
+    for (vtkIdType id = 0; id < num; ++id)
+      {
+      this->Points->SetPoint(pointOffsets[ii] + id, points->GetPoint(id));
+      outPD->CopyData(pd, id, pointOffsets[ii] + id);
+      }
+    }
+
+  std::vector<vtkIdType> ids;
+  for (int ii = 0; ii < numWorkers; ++ii)
+    {
+    vtkCellArray* faces = workers[ii]->Faces;
+    vtkIntArray* blockIds = workers[ii]->BlockIdCellArray;
+    vtkIdType numPts;
+    vtkIdType* pts;
+    vtkIdType cellId = 0;
+    faces->InitTraversal();
+    while (faces->GetNextCell(numPts, pts))
+      {
+      ids.resize(numPts);
+      for (vtkIdType jj = 0; jj < numPts; ++jj)
+        {
+        ids[jj] = pointOffsets[pts[jj] % numWorkers] + pts[jj] / numWorkers;
+        }
+      this->Faces->InsertNextCell(numPts, &ids[0]);
+      this->BlockIdCellArray->InsertNextValue(blockIds->GetValue(cellId++));
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(
   vtkAMRDualGridHelperBlock* block)
@@ -1257,7 +1591,7 @@ void vtkAMRDualContour::ProcessDualCell(
         pt[0] = cornerPoints[pt1Idx] + k*(cornerPoints[pt2Idx]-cornerPoints[pt1Idx]);
         pt[1] = cornerPoints[pt1Idx|1] + k*(cornerPoints[pt2Idx|1]-cornerPoints[pt1Idx|1]);
         pt[2] = cornerPoints[pt1Idx|2] + k*(cornerPoints[pt2Idx|2]-cornerPoints[pt1Idx|2]);
-        *ptIdPtr = this->Points->InsertNextPoint(pt);
+        *ptIdPtr = this->InsertPoint(pt);
         // Interpolate attributes
         // Find the offsets of the two attributes to interpolate
         vtkIdType offset0 = cornerOffsets[vtkAMRDualIsoEdgeToVTKPointsTable[*edge][0]];
@@ -1378,7 +1712,7 @@ void vtkAMRDualContour::CapCell(
           ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = this->InsertPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
                                  this->Mesh, *ptIdPtr);
             }
@@ -1410,7 +1744,7 @@ void vtkAMRDualContour::CapCell(
           ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = this->InsertPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
                                  this->Mesh, *ptIdPtr);
             }
@@ -1443,7 +1777,7 @@ void vtkAMRDualContour::CapCell(
           ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = this->InsertPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
                                  this->Mesh, *ptIdPtr);
             }
@@ -1476,7 +1810,7 @@ void vtkAMRDualContour::CapCell(
           ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = this->InsertPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
                                  this->Mesh, *ptIdPtr);
             }
@@ -1510,7 +1844,7 @@ void vtkAMRDualContour::CapCell(
           ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = this->InsertPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
                                  this->Mesh, *ptIdPtr);
             }
@@ -1543,7 +1877,7 @@ void vtkAMRDualContour::CapCell(
           ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = this->InsertPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
                                  this->Mesh, *ptIdPtr);
             }
@@ -1613,6 +1947,7 @@ void vtkAMRDualContour::InterpolateAttributes(
   vtkDataSet* uGrid, vtkIdType offset0, vtkIdType offset1, double k,
   vtkDataSet* mesh, vtkIdType outId)
 {
+  outId = this->GetLocalPointId(outId);
   mesh->GetPointData()->InterpolateEdge(uGrid->GetCellData(),outId,offset0,offset1,k);
 }
 
@@ -1622,5 +1957,6 @@ void vtkAMRDualContour::CopyAttributes(
   vtkDataSet* uGrid, vtkIdType inId,
   vtkDataSet* mesh,  vtkIdType outId)
 {
+  outId = this->GetLocalPointId(outId);
   mesh->GetPointData()->CopyData(uGrid->GetCellData(),inId, outId);
 }
@@ -19,14 +19,19 @@
 // a particle index as part of the cell data of the output.  It computes
 // the volume of each particle from the volume fraction.
 
+// Blocks can be processed by several threads. Blocks that touch are never
+// processed at the same time, so the locators that merge points between
+// blocks are still shared. The exchange of ghost values between processes is
+// done before the threads start and is not affected.
+
 // This will turn on validation and debug i/o of the filter.
 //#define vtkAMRDualContourDEBUG
-//#define vtkAMRDualContourPROFILE
 
 #ifndef __vtkAMRDualContour_h
 #define __vtkAMRDualContour_h
 
 #include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkMultiThreader.h" // for VTK_MAX_THREADS
 #include <vector>
 #include <string>
 
@@ -97,9 +102,39 @@ public:
   vtkGetMacro(SkipGhostCopy,int);
   vtkBooleanMacro(SkipGhostCopy,int);
 
+  // Description:
+  // When on, the ghost values exchanged between processes are received while
+  // the blocks that do not need them are contoured, and blocks on process
+  // boundaries are contoured last within each level. This only has an effect
+  // with asynchronous MPI communication. Off by default, in which case the
+  // exchange completes before any block is contoured.
+  vtkSetMacro(EnableDeferredGhostCopy,int);
+  vtkGetMacro(EnableDeferredGhostCopy,int);
+  vtkBooleanMacro(EnableDeferredGhostCopy,int);
+
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController *);
 
+  // Description:
+  // Number of threads used to process the blocks of each process. When 0
+  // the vtkMultiThreader default is used. In either case the global maximum
+  // set on vtkMultiThreader is respected. The default of 1 keeps the points
+  // and cells in block order, threads append them in another order.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+  // Description:
+  // When on, the time taken by each stage of the filter is measured.
+  // The stages are marked in the vtkTimerLog and summarized, along with
+  // the number of blocks, points and faces, in the profile report.
+  vtkSetMacro(EnableProfiling,int);
+  vtkGetMacro(EnableProfiling,int);
+  vtkBooleanMacro(EnableProfiling,int);
+
+  // Description:
+  // The report of the last execution when EnableProfiling is on.
+  const char *GetProfileReport() { return this->ProfileReport.c_str(); }
+
 protected:
   vtkAMRDualContour();
   virtual ~vtkAMRDualContour();
@@ -113,6 +148,10 @@ protected:
   int EnableMergePoints;
   int TriangulateCap;
   int SkipGhostCopy;
+  int EnableDeferredGhostCopy;
+  int NumberOfThreads;
+  int EnableProfiling;
+  std::string ProfileReport;
 
   //BTX
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
@@ -132,6 +171,33 @@ protected:
   void ProcessBlock(vtkAMRDualGridHelperBlock* block, int blockId,
                     const char* arrayName);
 
+  // Description:
+  // Process all of the blocks with several threads, each with its own copy
+  // of this filter producing its own mesh. The meshes are then merged into
+  // this one.
+  void ProcessBlocksThreaded(vtkNonOverlappingAMR* input,
+                             vtkMultiThreader* threader,
+                             const char* arrayName);
+  void MergeThreadMeshes(vtkAMRDualContour** workers, int numWorkers);
+  friend VTK_THREAD_RETURN_TYPE vtkAMRDualContourThreadedExecute(void *arg);
+
+  // Description:
+  // Points made by the threads are numbered so that the ids they share
+  // through the locators do not collide. The id of a point is its index in
+  // the thread's mesh times IdStride plus IdOffset. Both are 1 and 0 when
+  // there is no threading.
+  vtkIdType InsertPoint(const double pt[3]);
+  vtkIdType GetLocalPointId(vtkIdType id)
+    { return id / this->IdStride; }
+  int IdStride;
+  int IdOffset;
+
+  // Description:
+  // Bracket a stage of the execution when profiling. StartStage returns
+  // the time to pass to EndStage, which adds a line to the report.
+  double StartStage(const char* stage);
+  void EndStage(const char* stage, double start);
+
 
   void ProcessDualCell(
     vtkAMRDualGridHelperBlock* block, int blockId,
@@ -33,6 +33,7 @@
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
 #include "list"
+#include "set"
 #include "vector"
 
 #include "vtksys/SystemTools.hxx"
@@ -406,6 +407,7 @@ vtkAMRDualGridHelperBlock::vtkAMRDualGridHelperBlock()
   //  }
   this->Image = 0;
   this->CopyFlag = 0;
+  this->PendingGhostCopies = 0;
 
   for (int x = 0; x < 3; ++x)
     {
@@ -728,6 +730,9 @@ vtkAMRDualGridHelper::vtkAMRDualGridHelper()
   this->ArrayName = 0;
   this->EnableDegenerateCells = 1;
   this->EnableAsynchronousCommunication = 1;
+  this->EnableDeferredGhostCopy = 0;
+  this->PendingSends = 0;
+  this->PendingReceives = 0;
   this->NumberOfBlocksInThisProcess = 0;
   for (ii = 0; ii < 3; ++ii)
     {
@@ -752,6 +757,9 @@ vtkAMRDualGridHelper::~vtkAMRDualGridHelper()
   int ii;
   int numberOfLevels = (int)(this->Levels.size());
 
+  // Buffers of outstanding messages must outlive the communication.
+  this->FinishGhostCopy();
+
   this->SetArrayName(0);
 
   for (ii = 0; ii < numberOfLevels; ++ii)
@@ -778,6 +786,8 @@ void vtkAMRDualGridHelper::PrintSelf(ostream& os, vtkIndent indent)
      << this->EnableDegenerateCells << endl;
   os << indent << "EnableAsynchronousCommunication: "
      << this->EnableAsynchronousCommunication << endl;
+  os << indent << "EnableDeferredGhostCopy: "
+     << this->EnableDeferredGhostCopy << endl;
   os << indent << "Controller: " << this->Controller << endl;
 }
 
@@ -1852,6 +1862,9 @@ void vtkAMRDualGridHelper::UnmarshalDegenerateRegionMessage(
 // step of initialization.
 void vtkAMRDualGridHelper::ProcessRegionRemoteCopyQueue(bool hackLevelFlag)
 {
+  // The queue may still be in use by a deferred exchange.
+  this->FinishGhostCopy();
+
   if (this->SkipGhostCopy)
     {
     return;
@@ -2078,6 +2091,129 @@ void vtkAMRDualGridHelper::FinishDegenerateRegionsCommMPIAsynchronous(
 
 #endif // VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
 
+//-----------------------------------------------------------------------------
+// Posts the receives and sends of the ghost exchange without waiting for
+// them.  Every local block counts the messages it is waiting for.
+void vtkAMRDualGridHelper::StartDeferredGhostCopy()
+{
+  if (this->SkipGhostCopy)
+    {
+    return;
+    }
+
+#ifdef VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+  if (   this->EnableAsynchronousCommunication
+      && this->Controller->IsA("vtkMPIController") )
+    {
+    int numProcs = this->Controller->GetNumberOfProcesses();
+    int myProc = this->Controller->GetLocalProcessId();
+
+    this->PendingSends = new vtkAMRDualGridHelperCommRequestList;
+    this->PendingReceives = new vtkAMRDualGridHelperCommRequestList;
+
+    for (int sendProc = 0; sendProc < numProcs; sendProc++)
+      {
+      if (sendProc == myProc) continue;
+      this->ReceiveDegenerateRegionsFromQueueMPIAsynchronous(
+                                             sendProc, *this->PendingReceives);
+      }
+    vtkAMRDualGridHelperCommRequestList::iterator request;
+    for (request = this->PendingReceives->begin();
+         request != this->PendingReceives->end(); request++)
+      {
+      this->AddPendingGhostCopies(request->SendProcess, 1);
+      }
+
+    for (int recvProc = 0; recvProc < numProcs; recvProc++)
+      {
+      if (recvProc == myProc) continue;
+      this->SendDegenerateRegionsFromQueueMPIAsynchronous(
+                                                recvProc, *this->PendingSends);
+      }
+    return;
+    }
+#endif //VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+
+  this->ProcessRegionRemoteCopyQueueSynchronous(false);
+}
+
+//-----------------------------------------------------------------------------
+// Adds delta to the pending count of each local block receiving regions
+// from srcProc.  A block counts a message once however many regions it holds.
+void vtkAMRDualGridHelper::AddPendingGhostCopies(int srcProc, int delta)
+{
+  int myProc = this->Controller->GetLocalProcessId();
+  std::set<vtkAMRDualGridHelperBlock*> blocks;
+
+  std::vector<vtkAMRDualGridHelperDegenerateRegion>::iterator region;
+  for (region = this->DegenerateRegionQueue.begin();
+       region != this->DegenerateRegionQueue.end(); region++)
+    {
+    if (   (region->ReceivingBlock->ProcessId == myProc)
+        && (region->SourceBlock->ProcessId == srcProc) )
+      {
+      blocks.insert(region->ReceivingBlock);
+      }
+    }
+
+  std::set<vtkAMRDualGridHelperBlock*>::iterator block;
+  for (block = blocks.begin(); block != blocks.end(); block++)
+    {
+    (*block)->PendingGhostCopies += delta;
+    }
+}
+
+//-----------------------------------------------------------------------------
+int vtkAMRDualGridHelper::IsBlockWaitingForGhostCopy(
+                                             vtkAMRDualGridHelperBlock* block)
+{
+  return block->PendingGhostCopies > 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkAMRDualGridHelper::FinishBlockGhostCopy(
+                                             vtkAMRDualGridHelperBlock* block)
+{
+#ifdef VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+  // Messages are taken in the order they arrive, so others may be copied
+  // before the ones this block needs.
+  while (   block->PendingGhostCopies > 0
+         && this->PendingReceives && !this->PendingReceives->empty() )
+    {
+    vtkAMRDualGridHelperCommRequest request = this->PendingReceives->WaitAny();
+    this->UnmarshalDegenerateRegionMessage(request.Buffer->GetPointer(0),
+                                           request.SendProcess, false);
+    this->AddPendingGhostCopies(request.SendProcess, -1);
+    }
+#else
+  (void)block;
+#endif //VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+}
+
+//-----------------------------------------------------------------------------
+void vtkAMRDualGridHelper::FinishGhostCopy()
+{
+#ifdef VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+  if (this->PendingReceives == 0)
+    {
+    return;
+    }
+  while (!this->PendingReceives->empty())
+    {
+    vtkAMRDualGridHelperCommRequest request = this->PendingReceives->WaitAny();
+    this->UnmarshalDegenerateRegionMessage(request.Buffer->GetPointer(0),
+                                           request.SendProcess, false);
+    this->AddPendingGhostCopies(request.SendProcess, -1);
+    }
+  this->PendingSends->WaitAll();
+
+  delete this->PendingSends;
+  this->PendingSends = 0;
+  delete this->PendingReceives;
+  this->PendingReceives = 0;
+#endif //VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+}
+
 
 // We need to know:
 // The number of levels (to make the level structures)
@@ -2145,7 +2281,14 @@ int vtkAMRDualGridHelper::Initialize(vtkNonOverlappingAMR* input,
   this->AssignSharedRegions();
 
   // Copy regions on level boundaries between processes.
-  this->ProcessRegionRemoteCopyQueue(false);
+  if (this->EnableDeferredGhostCopy)
+    {
+    this->StartDeferredGhostCopy();
+    }
+  else
+    {
+    this->ProcessRegionRemoteCopyQueue(false);
+    }
 
   // Setup faces for seeding connectivity between blocks.
   //this->CreateFaces();
@@ -2154,6 +2297,7 @@ int vtkAMRDualGridHelper::Initialize(vtkNonOverlappingAMR* input,
 }
 void vtkAMRDualGridHelper::ClearRegionRemoteCopyQueue()
 {
+  this->FinishGhostCopy();
   this->DegenerateRegionQueue.clear();
 }
 void vtkAMRDualGridHelper::ShareBlocks()
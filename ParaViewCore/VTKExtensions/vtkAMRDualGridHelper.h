@@ -69,6 +69,17 @@ public:
   vtkSetMacro(EnableAsynchronousCommunication, int);
   vtkBooleanMacro(EnableAsynchronousCommunication, int);
 
+  // Description:
+  // When this option is on and communication is asynchronous, Initialize()
+  // only starts the exchange of ghost values between processes.  Blocks that
+  // do not need remote ghost values can be processed while the messages are
+  // in flight.  Call FinishBlockGhostCopy() before processing a block and
+  // FinishGhostCopy() when done.  Without asynchronous communication the
+  // exchange completes in Initialize() as before.  This is off by default.
+  vtkGetMacro(EnableDeferredGhostCopy, int);
+  vtkSetMacro(EnableDeferredGhostCopy, int);
+  vtkBooleanMacro(EnableDeferredGhostCopy, int);
+
   // Description:
   // The controller to use for communication.
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
@@ -84,6 +95,16 @@ public:
   vtkAMRDualGridHelperBlock* GetBlock(int level, int blockIdx);
   vtkAMRDualGridHelperBlock* GetBlock(int level, int xGrid, int yGrid, int zGrid);
 
+  // Description:
+  // Complete a deferred ghost exchange.  FinishBlockGhostCopy() returns once
+  // all the remote ghost values of the block have been copied into it,
+  // processing any other messages that arrive first.  FinishGhostCopy()
+  // completes all outstanding communication.  Both return immediately when
+  // nothing is pending.
+  int  IsBlockWaitingForGhostCopy(vtkAMRDualGridHelperBlock* block);
+  void FinishBlockGhostCopy(vtkAMRDualGridHelperBlock* block);
+  void FinishGhostCopy();
+
 
   // Description:
   // I am generalizing the code that copies lowres blocks to highres ghost regions.
@@ -189,6 +210,12 @@ private:
                               vtkAMRDualGridHelperCommRequestList &sendList,
                               vtkAMRDualGridHelperCommRequestList &receiveList);
 
+  // Outstanding communication of a deferred ghost exchange.
+  void StartDeferredGhostCopy();
+  void AddPendingGhostCopies(int srcProc, int delta);
+  vtkAMRDualGridHelperCommRequestList *PendingSends;
+  vtkAMRDualGridHelperCommRequestList *PendingReceives;
+
   // Degenerate regions that span processes.  We keep them in a queue
   // to communicate and process all at once.
   std::vector<vtkAMRDualGridHelperDegenerateRegion> DegenerateRegionQueue;
@@ -207,6 +234,7 @@ private:
   int SkipGhostCopy;
 
   int EnableAsynchronousCommunication;
+  int EnableDeferredGhostCopy;
 
 private:
   vtkAMRDualGridHelper(const vtkAMRDualGridHelper&);  // Not implemented.
@@ -262,6 +290,10 @@ public:
   // We need to modify the ghost layers of level interfaces.
   unsigned char CopyFlag;
 
+  // The number of messages from other processes that still have to be
+  // copied into the ghost layers of this block (deferred ghost copy).
+  int PendingGhostCopies;
+
   // We have to assign cells shared between blocks so only one
   // block will process them.  Faces, edges and corners have to be
   // considered separately (Extent does not work).
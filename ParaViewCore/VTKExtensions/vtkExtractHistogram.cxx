@@ -28,13 +28,16 @@
 #include "vtkObjectFactory.h"
 #include "vtkOnePieceExtentTranslator.h"
 #include "vtkPointData.h"
+#include "vtkPVMultiThreader.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
 
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <string>
+#include <vtksys/ios/sstream>
 
 struct vtkEHInternals
 {
@@ -48,6 +51,14 @@ struct vtkEHInternals
   typedef std::map<std::string, ArrayValuesType> ArrayMapType;
   ArrayMapType ArrayValues;
   int FieldAssociation;
+
+  // Histogram of the last execution, at a resolution that is a multiple of
+  // the bin count, and what it was computed from.
+  std::vector<vtkIdType> FineHistogram;
+  double FineRange[2];
+  bool FineHistogramFound;
+  std::string HistogramKey;
+  std::string RangeKey;
 };
 
 vtkStandardNewMacro(vtkExtractHistogram);
@@ -270,6 +281,134 @@ inline int vtkExtractHistogramClamp(int value, int min, int max)
   return value;
 }
 
+namespace
+{
+  // Arrays with less tuples are binned by a single thread
+  const vtkIdType VTK_EH_MIN_THREADED_SIZE = 100000;
+
+  // Resolution of the cached histogram, 2^8 * 3^2 * 5^2 * 7: a multiple of
+  // every bin count up to 10 and of most usual ones (12, 16, 20, 25, 32, 50,
+  // 64, 100, 128, 256...). Other bin counts bin the data again.
+  const int VTK_EH_FINE_BIN_COUNT = 403200;
+
+  struct vtkEHBinningData
+    {
+    vtkDataArray* Array;
+    int Component;
+    double Min;
+    double Delta;
+    int NumberOfBins;
+    std::vector<std::vector<vtkIdType> > Bins; // one histogram per thread
+    std::vector<double> Ranges;                // one range per thread
+    };
+
+  template <class T>
+  void vtkEHBinValues(const T* data, vtkEHBinningData* bd, vtkIdType begin,
+    vtkIdType end, vtkIdType* bins, double* range)
+    {
+    const int numComps = bd->Array->GetNumberOfComponents();
+    const T* ptr = data + begin * numComps + bd->Component;
+    double rmin = range[0];
+    double rmax = range[1];
+    for (vtkIdType i = begin; i < end; ++i, ptr += numComps)
+      {
+      const double value = static_cast<double>(*ptr);
+      rmin = value < rmin ? value : rmin;
+      rmax = value > rmax ? value : rmax;
+      int index = static_cast<int>((value - bd->Min) / bd->Delta);
+      // If the value is equal to max, include it in the last bin.
+      index = ::vtkExtractHistogramClamp(index, 0, bd->NumberOfBins - 1);
+      bins[index]++;
+      }
+    range[0] = rmin;
+    range[1] = rmax;
+    }
+
+  void vtkEHBinSlice(vtkEHBinningData* bd, int threadId, int numThreads)
+    {
+    vtkIdType numTuples = bd->Array->GetNumberOfTuples();
+    vtkIdType begin = (numTuples * threadId) / numThreads;
+    vtkIdType end = (numTuples * (threadId + 1)) / numThreads;
+    vtkIdType* bins = &bd->Bins[threadId][0];
+    double* range = &bd->Ranges[2 * threadId];
+    switch (bd->Array->GetDataType())
+      {
+      vtkTemplateMacro(vtkEHBinValues(
+          static_cast<VTK_TT*>(bd->Array->GetVoidPointer(0)), bd, begin, end,
+          bins, range));
+      default:
+        // GetComponent() is not thread safe, such arrays use a single thread
+        for (vtkIdType i = begin; i < end; ++i)
+          {
+          const double value = bd->Array->GetComponent(i, bd->Component);
+          range[0] = value < range[0] ? value : range[0];
+          range[1] = value > range[1] ? value : range[1];
+          int index = static_cast<int>((value - bd->Min) / bd->Delta);
+          index = ::vtkExtractHistogramClamp(index, 0, bd->NumberOfBins - 1);
+          bins[index]++;
+          }
+      }
+    }
+
+  VTK_THREAD_RETURN_TYPE vtkEHBinThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkEHBinSlice(static_cast<vtkEHBinningData*>(info->UserData),
+      info->ThreadID, info->NumberOfThreads);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  bool vtkEHIsThreadSafeType(int dataType)
+    {
+    switch (dataType)
+      {
+      vtkTemplateMacro(return true);
+      }
+    return false;
+    }
+
+  // Adds the values of the component of the array to the bins, and extends
+  // range to include them.
+  void vtkEHBinArray(vtkDataArray* array, int component, double min,
+    double max, std::vector<vtkIdType>& bins, double range[2])
+    {
+    vtkEHBinningData bd;
+    bd.Array = array;
+    bd.Component = component;
+    bd.Min = min;
+    bd.NumberOfBins = static_cast<int>(bins.size());
+    bd.Delta = (max - min) / bd.NumberOfBins;
+
+    vtkPVMultiThreader* threader = vtkPVMultiThreader::New();
+    int numThreads = vtkEHIsThreadSafeType(array->GetDataType()) ?
+      threader->GetNumberOfThreadsFor(array->GetNumberOfTuples(),
+        VTK_EH_MIN_THREADED_SIZE) : 1;
+
+    bd.Bins.resize(numThreads);
+    bd.Ranges.resize(2 * numThreads);
+    for (int i = 0; i < numThreads; ++i)
+      {
+      bd.Bins[i].assign(bins.size(), 0);
+      bd.Ranges[2 * i] = range[0];
+      bd.Ranges[2 * i + 1] = range[1];
+      }
+    threader->Execute(numThreads, vtkEHBinThread, &bd);
+    threader->Delete();
+
+    for (int i = 0; i < numThreads; ++i)
+      {
+      const std::vector<vtkIdType>& threadBins = bd.Bins[i];
+      for (size_t j = 0; j < bins.size(); ++j)
+        {
+        bins[j] += threadBins[j];
+        }
+      range[0] = std::min(range[0], bd.Ranges[2 * i]);
+      range[1] = std::max(range[1], bd.Ranges[2 * i + 1]);
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkExtractHistogram::BinAnArray(vtkDataArray *data_array,
                                      vtkIntArray *bin_values,
@@ -327,6 +466,164 @@ void vtkExtractHistogram::BinAnArray(vtkDataArray *data_array,
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkExtractHistogram::ReduceRange(double vtkNotUsed(range)[2])
+{
+}
+
+//-----------------------------------------------------------------------------
+bool vtkExtractHistogram::ReduceCacheValidity(bool valid)
+{
+  return valid;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkExtractHistogram::ComputeHistogram(vtkInformationVector** inputVector,
+                                           vtkDoubleArray* bin_extents,
+                                           vtkIntArray* bin_values)
+{
+  vtkEHInternals* internal = this->Internal;
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkDataObject *input = inInfo->Get(vtkDataObject::DATA_OBJECT());
+
+  // What the range depends on, besides the data
+  vtksys_ios::ostringstream rangeKey;
+  vtkInformation* arrayInfo = this->GetInputArrayInformation(0);
+  if (arrayInfo->Has(vtkDataObject::FIELD_NAME()))
+    {
+    rangeKey << arrayInfo->Get(vtkDataObject::FIELD_NAME());
+    }
+  if (arrayInfo->Has(vtkDataObject::FIELD_ATTRIBUTE_TYPE()))
+    {
+    rangeKey << " " << arrayInfo->Get(vtkDataObject::FIELD_ATTRIBUTE_TYPE());
+    }
+  rangeKey << " " << this->GetInputFieldAssociation() << " " << this->Component
+           << " " << this->UseCustomBinRanges << " "
+           << this->CustomBinRanges[0] << " " << this->CustomBinRanges[1];
+  vtksys_ios::ostringstream histogramKey;
+  histogramKey << rangeKey.str() << " " << input << " " << input->GetMTime()
+               << " " << input->GetUpdateTime();
+
+  // A new bin count, on the same data, only needs to merge bins.
+  size_t fineCount = internal->FineHistogram.size();
+  bool reuse = internal->HistogramKey == histogramKey.str() &&
+    fineCount > 0 && fineCount % this->BinCount == 0;
+  if (!this->ReduceCacheValidity(reuse))
+    {
+    int numBins = (VTK_EH_FINE_BIN_COUNT % this->BinCount == 0) ?
+      VTK_EH_FINE_BIN_COUNT : this->BinCount;
+    std::vector<vtkIdType> bins(numBins, 0);
+    double min = 0.0;
+    double max = 1.0;
+    bool found = true;
+
+    // Bin with the range of the previous execution while computing the
+    // actual range, instead of reading the data once more to compute it.
+    bool provisional = !this->UseCustomBinRanges &&
+      internal->RangeKey == rangeKey.str();
+    if (this->ReduceCacheValidity(provisional))
+      {
+      min = internal->FineRange[0];
+      max = internal->FineRange[1];
+      }
+    else
+      {
+      found = this->InitializeBinExtents(inputVector, bin_extents, min, max);
+      }
+
+    double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+    bool binned = false;
+    std::vector<vtkDataArray*> arrays;
+    vtkCompositeDataSet *cdin = vtkCompositeDataSet::SafeDownCast(input);
+    if (cdin)
+      {
+      vtkCompositeDataIterator *cdit = cdin->NewIterator();
+      for (cdit->InitTraversal(); !cdit->IsDoneWithTraversal();
+        cdit->GoToNextItem())
+        {
+        arrays.push_back(
+          this->GetInputArrayToProcess(0, cdit->GetCurrentDataObject()));
+        }
+      cdit->Delete();
+      }
+    else
+      {
+      arrays.push_back(this->GetInputArrayToProcess(0, inputVector));
+      }
+    for (size_t i = 0; i < arrays.size(); ++i)
+      {
+      // If the requested component is out-of-range for the input,
+      // the bin_values will be 0, so no need to do any actual counting.
+      if (arrays[i] && this->Component >= 0 &&
+        this->Component < arrays[i]->GetNumberOfComponents())
+        {
+        vtkEHBinArray(arrays[i], this->Component, min, max, bins, range);
+        binned = true;
+        }
+      this->UpdateProgress(0.10 + 0.90 * (i + 1) / arrays.size());
+      }
+    if (provisional && !binned)
+      {
+      vtkErrorMacro("Failed to locate array to process.");
+      found = false;
+      }
+
+    if (!this->UseCustomBinRanges)
+      {
+      this->ReduceRange(range);
+      if (range[0] > range[1])
+        {
+        // No values were binned anywhere
+        range[0] = 0;
+        range[1] = 1;
+        }
+      if (range[0] == range[1])
+        {
+        // Give it some width.
+        range[1] = range[0] + 1;
+        }
+      if (range[0] != min || range[1] != max)
+        {
+        // The range differs from the one used to bin, bin again.
+        min = range[0];
+        max = range[1];
+        std::fill(bins.begin(), bins.end(), 0);
+        for (size_t i = 0; i < arrays.size(); ++i)
+          {
+          if (arrays[i] && this->Component >= 0 &&
+            this->Component < arrays[i]->GetNumberOfComponents())
+            {
+            vtkEHBinArray(arrays[i], this->Component, min, max, bins, range);
+            }
+          }
+        }
+      }
+
+    internal->FineHistogram.swap(bins);
+    internal->FineRange[0] = min;
+    internal->FineRange[1] = max;
+    internal->FineHistogramFound = found;
+    internal->HistogramKey = histogramKey.str();
+    internal->RangeKey = rangeKey.str();
+    }
+
+  // Merge the fine bins into BinCount bins
+  fineCount = internal->FineHistogram.size();
+  size_t factor = fineCount / this->BinCount;
+  for (int i = 0; i < this->BinCount; ++i)
+    {
+    vtkIdType count = 0;
+    for (size_t j = i * factor; j < (i + 1) * factor; ++j)
+      {
+      count += internal->FineHistogram[j];
+      }
+    bin_values->SetValue(i, static_cast<int>(count));
+    }
+  this->FillBinExtents(bin_extents, internal->FineRange[0],
+    internal->FineRange[1]);
+  return internal->FineHistogramFound;
+}
+
 //-----------------------------------------------------------------------------
 int vtkExtractHistogram::RequestData(vtkInformation* /*request*/,
                                      vtkInformationVector** inputVector,
@@ -363,6 +660,16 @@ int vtkExtractHistogram::RequestData(vtkInformation* /*request*/,
   bin_values->SetName("bin_values");
   bin_values->FillComponent(0, 0.0);
 
+  if (!this->CalculateAverages)
+    {
+    if (this->ComputeHistogram(inputVector, bin_extents, bin_values))
+      {
+      output_data->GetRowData()->AddArray(bin_extents);
+      output_data->GetRowData()->AddArray(bin_values);
+      }
+    return 1;
+    }
+
   // Initializes the bin_extents array.
   double min, max;
   if (!this->InitializeBinExtents(inputVector, bin_extents, min, max))
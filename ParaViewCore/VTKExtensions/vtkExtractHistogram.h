@@ -33,6 +33,14 @@ struct vtkEHInternals;
 // will have contain a vtkDoubleArray named "bin_extents" which contains
 // the boundaries between each histogram bin, and a vtkUnsignedLongArray
 // named "bin_values" which will contain the value for each bin.
+//
+// Unless averages are requested, values are binned by several threads, each
+// one filling its own histogram. The histogram is kept at a resolution that
+// is a multiple of most bin counts, so that changing BinCount only merges
+// bins instead of reading the data again. When the input changes, the range
+// of the previous execution is used to bin the data while its actual range
+// is computed, the data is binned again only if the range turns out to be
+// different.
 
 class VTK_EXPORT vtkExtractHistogram : public vtkTableAlgorithm
 {
@@ -99,6 +107,22 @@ protected:
 
   void FillBinExtents(vtkDoubleArray* bin_extents, double min, double max);
 
+  // Description:
+  // Threaded computation of the histogram, used when no averages are
+  // requested. Returns false when the array to process was not found.
+  bool ComputeHistogram(vtkInformationVector** inputVector,
+    vtkDoubleArray* bin_extents, vtkIntArray* bin_values);
+
+  // Description:
+  // Reduces the range of the values binned by all the processes. The range
+  // is left as is by default.
+  virtual void ReduceRange(double range[2]);
+
+  // Description:
+  // Returns true when the cached histogram or range can be used by all the
+  // processes, given whether it can be used by this one.
+  virtual bool ReduceCacheValidity(bool valid);
+
   double CustomBinRanges[2];
   bool UseCustomBinRanges;
   int Component;
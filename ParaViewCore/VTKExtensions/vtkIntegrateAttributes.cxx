@@ -21,6 +21,7 @@
 #include "vtkCompositeDataSet.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -28,11 +29,15 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
-#include "vtkPointData.h"
 #include "vtkPolygon.h"
+#include "vtkPVMultiThreader.h"
 #include "vtkTriangle.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <vector>
+
+// Blocks with fewer cells are integrated by the calling thread only.
+#define VTK_IA_MIN_THREADED_CELLS 10000
 
 vtkStandardNewMacro(vtkIntegrateAttributes);
 
@@ -45,18 +50,274 @@ public:
       { this->vtkDataSetAttributes::FieldList::SetFieldIndex(i, index); }
 };
 
+namespace
+{
+  //---------------------------------------------------------------------------
+  // Neumaier's variant of Kahan summation. The compensation keeps the low
+  // order bits that are lost when a small term is added to a large sum.
+  class vtkCompensatedSum
+  {
+  public:
+    vtkCompensatedSum() : Sum(0.0), Compensation(0.0) { }
+
+    void Add(double value)
+      {
+      double t = this->Sum + value;
+      if (fabs(this->Sum) >= fabs(value))
+        {
+        this->Compensation += (this->Sum - t) + value;
+        }
+      else
+        {
+        this->Compensation += (value - t) + this->Sum;
+        }
+      this->Sum = t;
+      }
+
+    void Add(const vtkCompensatedSum& other)
+      {
+      this->Add(other.Sum);
+      this->Add(other.Compensation);
+      }
+
+    double GetValue() const { return this->Sum + this->Compensation; }
+
+  private:
+    double Sum;
+    double Compensation;
+  };
+
+  //---------------------------------------------------------------------------
+  // An input array integrated into the output array components starting at
+  // Offset. Pointer is only set when the values can be read directly, which
+  // is required to read the array from several threads.
+  struct vtkIAField
+  {
+    vtkDataArray* Array;
+    void* Pointer;
+    int DataType;
+    int NumberOfComponents;
+    int Offset;
+  };
+
+  //---------------------------------------------------------------------------
+  bool vtkIAIsThreadSafeType(int dataType)
+  {
+    switch (dataType)
+      {
+      vtkTemplateMacro(return true);
+      }
+    return false;
+  }
+
+  //---------------------------------------------------------------------------
+  void vtkIAInitializeField(vtkIAField& field, vtkDataArray* array, int offset)
+  {
+    field.Array = array;
+    field.DataType = array->GetDataType();
+    field.NumberOfComponents = array->GetNumberOfComponents();
+    field.Offset = offset;
+    field.Pointer = vtkIAIsThreadSafeType(field.DataType)?
+      array->GetVoidPointer(0) : NULL;
+  }
+
+  //---------------------------------------------------------------------------
+  inline double vtkIAGetValue(const vtkIAField& field, vtkIdType id, int comp)
+  {
+    if (field.Pointer)
+      {
+      vtkIdType index = id*field.NumberOfComponents + comp;
+      switch (field.DataType)
+        {
+        vtkTemplateMacro(
+          return static_cast<double>(
+            static_cast<VTK_TT*>(field.Pointer)[index]));
+        }
+      }
+    return field.Array->GetComponent(id, comp);
+  }
+
+  //---------------------------------------------------------------------------
+  // Total number of components of the arrays, which is the number of
+  // accumulators needed to integrate them.
+  int vtkIANumberOfComponents(vtkDataSetAttributes* da)
+  {
+    int total = 0;
+    for (int i = 0; i < da->GetNumberOfArrays(); ++i)
+      {
+      total += da->GetArray(i)->GetNumberOfComponents();
+      }
+    return total;
+  }
+
+  //---------------------------------------------------------------------------
+  void IntegrateData1(const std::vector<vtkIAField>& fields,
+    std::vector<vtkCompensatedSum>& sums, vtkIdType pt1Id, double k)
+  {
+    for (size_t i = 0; i < fields.size(); ++i)
+      {
+      const vtkIAField& field = fields[i];
+      for (int j = 0; j < field.NumberOfComponents; ++j)
+        {
+        double dv = vtkIAGetValue(field, pt1Id, j);
+        sums[field.Offset + j].Add(dv*k);
+        }
+      }
+  }
+
+  //---------------------------------------------------------------------------
+  void IntegrateData2(const std::vector<vtkIAField>& fields,
+    std::vector<vtkCompensatedSum>& sums, vtkIdType pt1Id, vtkIdType pt2Id,
+    double k)
+  {
+    for (size_t i = 0; i < fields.size(); ++i)
+      {
+      const vtkIAField& field = fields[i];
+      for (int j = 0; j < field.NumberOfComponents; ++j)
+        {
+        double dv = 0.5*(vtkIAGetValue(field, pt1Id, j) +
+                         vtkIAGetValue(field, pt2Id, j));
+        sums[field.Offset + j].Add(dv*k);
+        }
+      }
+  }
+
+  //---------------------------------------------------------------------------
+  void IntegrateData3(const std::vector<vtkIAField>& fields,
+    std::vector<vtkCompensatedSum>& sums, vtkIdType pt1Id, vtkIdType pt2Id,
+    vtkIdType pt3Id, double k)
+  {
+    for (size_t i = 0; i < fields.size(); ++i)
+      {
+      const vtkIAField& field = fields[i];
+      for (int j = 0; j < field.NumberOfComponents; ++j)
+        {
+        double dv = (vtkIAGetValue(field, pt1Id, j) +
+                     vtkIAGetValue(field, pt2Id, j) +
+                     vtkIAGetValue(field, pt3Id, j))/3.0;
+        sums[field.Offset + j].Add(dv*k);
+        }
+      }
+  }
+
+  //---------------------------------------------------------------------------
+  void IntegrateData4(const std::vector<vtkIAField>& fields,
+    std::vector<vtkCompensatedSum>& sums, vtkIdType pt1Id, vtkIdType pt2Id,
+    vtkIdType pt3Id, vtkIdType pt4Id, double k)
+  {
+    for (size_t i = 0; i < fields.size(); ++i)
+      {
+      const vtkIAField& field = fields[i];
+      for (int j = 0; j < field.NumberOfComponents; ++j)
+        {
+        double dv = (vtkIAGetValue(field, pt1Id, j) +
+                     vtkIAGetValue(field, pt2Id, j) +
+                     vtkIAGetValue(field, pt3Id, j) +
+                     vtkIAGetValue(field, pt4Id, j)) * 0.25;
+        sums[field.Offset + j].Add(dv*k);
+        }
+      }
+  }
+}
+
+//-----------------------------------------------------------------------------
+class vtkIntegrateAttributes::vtkIntegrationSums
+{
+public:
+  vtkIntegrationSums() :
+    Dimension(0), PointFields(NULL), CellFields(NULL), GhostField(NULL) { }
+
+  int Dimension;
+  vtkCompensatedSum Sum;
+  vtkCompensatedSum SumCenter[3];
+  // Indexed by the component offset of the output arrays.
+  std::vector<vtkCompensatedSum> PointSums;
+  std::vector<vtkCompensatedSum> CellSums;
+
+  // Input arrays of the block being integrated.
+  const std::vector<vtkIAField>* PointFields;
+  const std::vector<vtkIAField>* CellFields;
+  const vtkIAField* GhostField;
+
+  void Reset(int dim)
+    {
+    this->Dimension = dim;
+    this->Sum = vtkCompensatedSum();
+    for (int i = 0; i < 3; ++i)
+      {
+      this->SumCenter[i] = vtkCompensatedSum();
+      }
+    this->PointSums.assign(this->PointSums.size(), vtkCompensatedSum());
+    this->CellSums.assign(this->CellSums.size(), vtkCompensatedSum());
+    }
+
+  // Higher dimension prevails: returns true if cells of dimension dim
+  // must be integrated, throwing out results from a lower dimension.
+  bool CompareDimension(int dim)
+    {
+    if (this->Dimension < dim)
+      {
+      this->Reset(dim);
+      return true;
+      }
+    return (this->Dimension == dim);
+    }
+
+  void Merge(const vtkIntegrationSums& other)
+    {
+    if (!this->CompareDimension(other.Dimension))
+      {
+      return;
+      }
+    this->Sum.Add(other.Sum);
+    for (int i = 0; i < 3; ++i)
+      {
+      this->SumCenter[i].Add(other.SumCenter[i]);
+      }
+    for (size_t i = 0; i < this->PointSums.size(); ++i)
+      {
+      this->PointSums[i].Add(other.PointSums[i]);
+      }
+    for (size_t i = 0; i < this->CellSums.size(); ++i)
+      {
+      this->CellSums[i].Add(other.CellSums[i]);
+      }
+    }
+};
+
+//-----------------------------------------------------------------------------
+struct vtkIntegrateAttributes::vtkThreadData
+{
+  vtkIntegrateAttributes* Self;
+  vtkDataSet* Input;
+  std::vector<vtkIntegrateAttributes::vtkIntegrationSums>* Sums;
+};
+
+//-----------------------------------------------------------------------------
+// Each thread integrates a contiguous range of cells into its own sums.
+VTK_THREAD_RETURN_TYPE vtkIntegrateAttributesThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkIntegrateAttributes::vtkThreadData* data =
+    static_cast<vtkIntegrateAttributes::vtkThreadData*>(info->UserData);
+  vtkIdType numCells = data->Input->GetNumberOfCells();
+  vtkIdType numThreads = info->NumberOfThreads;
+  vtkIdType threadId = info->ThreadID;
+  vtkIdType begin = (numCells * threadId) / numThreads;
+  vtkIdType end = (numCells * (threadId + 1)) / numThreads;
+  data->Self->IntegrateCells(data->Input, begin, end,
+                             (*data->Sums)[info->ThreadID]);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //-----------------------------------------------------------------------------
 vtkIntegrateAttributes::vtkIntegrateAttributes()
 {
   this->IntegrationDimension = 0;
-  this->Sum = 0.0;
-  this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
+  this->NumberOfThreads = 0;
   this->Controller = 0;
 
-  this->PointFieldList = 0;
-  this->CellFieldList = 0;
-  this->FieldListIndex = 0;
-
   SetController(vtkMultiProcessController::GetGlobalController());
 }
 
@@ -104,50 +365,125 @@ int vtkIntegrateAttributes::FillInputPortInformation(int port,
   return 1;
 }
 
-//-----------------------------------------------------------------------------
-int vtkIntegrateAttributes::CompareIntegrationDimension(vtkDataSet* output,
-                                                        int dim)
-{
-  // higher dimension prevails
-  if (this->IntegrationDimension < dim)
-    { // Throw out results from lower dimension.
-    this->Sum = 0;
-    this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
-    this->ZeroAttributes(output->GetPointData());
-    this->ZeroAttributes(output->GetCellData());
-    this->IntegrationDimension = dim;
-    return 1;
-    }
-  // Skip this cell if we are inetrgrting a higher dimension.
-  return (this->IntegrationDimension == dim);
-}
-
 //----------------------------------------------------------------------------
 void vtkIntegrateAttributes::ExecuteBlock(
-  vtkDataSet* input, vtkUnstructuredGrid* output,
-  int fieldset_index,
+  vtkDataSet* input, int fieldset_index,
   vtkIntegrateAttributes::vtkFieldList& pdList,
-  vtkIntegrateAttributes::vtkFieldList& cdList)
+  vtkIntegrateAttributes::vtkFieldList& cdList,
+  vtkUnstructuredGrid* output,
+  vtkIntegrationSums& sums)
 {
+  // Bind the input arrays to the accumulators of the output arrays.
+  bool threadSafe = true;
+  std::vector<vtkIAField> fields[2];
+  vtkIntegrateAttributes::vtkFieldList* lists[2] = { &pdList, &cdList };
+  vtkDataSetAttributes* inDA[2] = { input->GetPointData(),
+                                    input->GetCellData() };
+  vtkDataSetAttributes* outDA[2] = { output->GetPointData(),
+                                     output->GetCellData() };
+  for (int a = 0; a < 2; ++a)
+    {
+    std::vector<int> offsets(outDA[a]->GetNumberOfArrays(), 0);
+    for (int i = 1; i < outDA[a]->GetNumberOfArrays(); ++i)
+      {
+      offsets[i] = offsets[i-1] +
+        outDA[a]->GetArray(i-1)->GetNumberOfComponents();
+      }
+    vtkIntegrateAttributes::vtkFieldList& fieldList = *lists[a];
+    for (int i = 0; i < fieldList.GetNumberOfFields(); ++i)
+      {
+      if (fieldList.GetFieldIndex(i) < 0)
+        {
+        continue;
+        }
+      vtkDataArray* inArray =
+        inDA[a]->GetArray(fieldList.GetDSAIndex(fieldset_index, i));
+      if (!inArray)
+        {
+        continue;
+        }
+      vtkIAField field;
+      vtkIAInitializeField(field, inArray,
+                           offsets[fieldList.GetFieldIndex(i)]);
+      threadSafe = threadSafe && field.Pointer;
+      fields[a].push_back(field);
+      }
+    }
+
+  vtkIAField ghostField;
   vtkDataArray* ghostLevelArray =
     input->GetCellData()->GetArray("vtkGhostLevels");
+  if (ghostLevelArray)
+    {
+    vtkIAInitializeField(ghostField, ghostLevelArray, 0);
+    threadSafe = threadSafe && ghostField.Pointer;
+    }
 
-  // This is sort of a hack since it's incredibly painful to change all the
-  // signatures to take the pdList, cdList and fieldset_index.
-  this->PointFieldList = &pdList;
-  this->CellFieldList = &cdList;
-  this->FieldListIndex = fieldset_index;
+  sums.PointFields = &fields[0];
+  sums.CellFields = &fields[1];
+  sums.GhostField = ghostLevelArray? &ghostField : NULL;
 
-  vtkIdList* cellPtIds = vtkIdList::New();
   vtkIdType numCells = input->GetNumberOfCells();
-  vtkIdType cellId;
+  if (numCells > 0)
+    {
+    // Builds the cell links of poly data so that cells can then be
+    // accessed from several threads.
+    input->GetCellType(0);
+    }
+
+  vtkPVMultiThreader* threader = vtkPVMultiThreader::New();
+  if (this->NumberOfThreads > 0)
+    {
+    threader->SetNumberOfThreads(this->NumberOfThreads);
+    }
+  int numThreads = threadSafe ?
+    threader->GetNumberOfThreadsFor(numCells, VTK_IA_MIN_THREADED_CELLS) : 1;
+
+  if (numThreads > 1)
+    {
+    // Each thread starts from the dimension integrated so far so that lower
+    // dimension cells are still skipped.
+    std::vector<vtkIntegrationSums> threadSums(numThreads, sums);
+    for (int i = 0; i < numThreads; ++i)
+      {
+      threadSums[i].Reset(sums.Dimension);
+      }
+    vtkIntegrateAttributes::vtkThreadData data;
+    data.Self = this;
+    data.Input = input;
+    data.Sums = &threadSums;
+    threader->Execute(numThreads, vtkIntegrateAttributesThread, &data);
+    for (int i = 0; i < numThreads; ++i)
+      {
+      sums.Merge(threadSums[i]);
+      }
+    }
+  else
+    {
+    this->IntegrateCells(input, 0, numCells, sums);
+    }
+  threader->Delete();
+
+  sums.PointFields = NULL;
+  sums.CellFields = NULL;
+  sums.GhostField = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkIntegrateAttributes::IntegrateCells(vtkDataSet* input,
+                                            vtkIdType begin, vtkIdType end,
+                                            vtkIntegrationSums& sums)
+{
+  vtkIdList* cellPtIds = vtkIdList::New();
+  vtkGenericCell* cell = 0; // needed for cells that are triangulated
   vtkPoints *cellPoints = 0; // needed if we need to split 3D cells
+  vtkIdType cellId;
   int cellType;
-  for (cellId = 0; cellId < numCells; ++cellId)
+  for (cellId = begin; cellId < end; ++cellId)
     {
     cellType = input->GetCellType(cellId);
     // Make sure we are not integrating ghost cells.
-    if (ghostLevelArray && ghostLevelArray->GetComponent(cellId,0) > 0.0)
+    if (sums.GhostField && vtkIAGetValue(*sums.GhostField, cellId, 0) > 0.0)
       {
       continue;
       }
@@ -163,20 +499,20 @@ void vtkIntegrateAttributes::ExecuteBlock(
       case VTK_POLY_LINE:
       case VTK_LINE:
       {
-      if (this->CompareIntegrationDimension(output, 1))
+      if (sums.CompareDimension(1))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePolyLine(input, output, cellId, cellPtIds);
+        this->IntegratePolyLine(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_TRIANGLE:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (sums.CompareDimension(2))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateTriangle(input,output,cellId,cellPtIds->GetId(0),
+        this->IntegrateTriangle(input,sums,cellId,cellPtIds->GetId(0),
                                 cellPtIds->GetId(1),cellPtIds->GetId(2));
         }
       }
@@ -184,63 +520,63 @@ void vtkIntegrateAttributes::ExecuteBlock(
 
       case VTK_TRIANGLE_STRIP:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (sums.CompareDimension(2))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateTriangleStrip(input, output, cellId, cellPtIds);
+        this->IntegrateTriangleStrip(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_POLYGON:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (sums.CompareDimension(2))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePolygon(input, output, cellId, cellPtIds);
+        this->IntegratePolygon(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_PIXEL:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (sums.CompareDimension(2))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegratePixel(input, output, cellId, cellPtIds);
+        this->IntegratePixel(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_QUAD:
       {
-      if (this->CompareIntegrationDimension(output, 2))
+      if (sums.CompareDimension(2))
         {
         vtkIdType pt1Id, pt2Id, pt3Id;
         input->GetCellPoints(cellId, cellPtIds);
         pt1Id = cellPtIds->GetId(0);
         pt2Id = cellPtIds->GetId(1);
         pt3Id = cellPtIds->GetId(2);
-        this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+        this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
         pt2Id = cellPtIds->GetId(3);
-        this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+        this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
         }
       }
       break;
 
       case VTK_VOXEL:
       {
-      if (this->CompareIntegrationDimension(output, 3))
+      if (sums.CompareDimension(3))
         {
         input->GetCellPoints(cellId, cellPtIds);
-        this->IntegrateVoxel(input, output, cellId, cellPtIds);
+        this->IntegrateVoxel(input, sums, cellId, cellPtIds);
         }
       }
       break;
 
       case VTK_TETRA:
       {
-      if (this->CompareIntegrationDimension(output, 3))
+      if (sums.CompareDimension(3))
         {
         vtkIdType pt1Id, pt2Id, pt3Id, pt4Id;
         input->GetCellPoints(cellId, cellPtIds);
@@ -248,7 +584,7 @@ void vtkIntegrateAttributes::ExecuteBlock(
         pt2Id = cellPtIds->GetId(1);
         pt3Id = cellPtIds->GetId(2);
         pt4Id = cellPtIds->GetId(3);
-        this->IntegrateTetrahedron(input, output, cellId, pt1Id, pt2Id,
+        this->IntegrateTetrahedron(input, sums, cellId, pt1Id, pt2Id,
                                    pt3Id, pt4Id);
         }
       }
@@ -256,14 +592,19 @@ void vtkIntegrateAttributes::ExecuteBlock(
 
       default:
       {
-      // We need to explicitly get the cell
-      vtkCell *cell = input->GetCell(cellId);
+      // We need to explicitly get the cell. A generic cell is used since
+      // input->GetCell(cellId) is not safe to call from several threads.
+      if (!cell)
+        {
+        cell = vtkGenericCell::New();
+        }
+      input->GetCell(cellId, cell);
       int cellDim = cell->GetCellDimension();
       if (cellDim == 0)
         {
         continue;
         }
-      if (!this->CompareIntegrationDimension(output, cellDim))
+      if (!sums.CompareDimension(cellDim))
         {
         continue;
         }
@@ -279,13 +620,13 @@ void vtkIntegrateAttributes::ExecuteBlock(
       switch (cellDim)
         {
         case 1:
-          this->IntegrateGeneral1DCell(input, output, cellId, cellPtIds);
+          this->IntegrateGeneral1DCell(input, sums, cellId, cellPtIds);
           break;
         case 2:
-          this->IntegrateGeneral2DCell(input, output, cellId, cellPtIds);
+          this->IntegrateGeneral2DCell(input, sums, cellId, cellPtIds);
           break;
         case 3:
-          this->IntegrateGeneral3DCell(input, output, cellId, cellPtIds);
+          this->IntegrateGeneral3DCell(input, sums, cellId, cellPtIds);
           break;
         default:
           vtkWarningMacro("Unsupported Cell Dimension = "
@@ -295,14 +636,14 @@ void vtkIntegrateAttributes::ExecuteBlock(
       }
     }
   cellPtIds->Delete();
+  if (cell)
+    {
+    cell->Delete();
+    }
   if (cellPoints)
     {
     cellPoints->Delete();
     }
-
-  this->PointFieldList = NULL;
-  this->CellFieldList = NULL;
-  this->FieldListIndex = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -310,10 +651,9 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
                                         vtkInformationVector** inputVector,
                                         vtkInformationVector* outputVector)
 {
-  // Integration of imaginary attribute with constant value 1.
-  this->Sum = 0;
-  // For computation of point/vertext location.
-  this->SumCenter[0] = this->SumCenter[1] = this->SumCenter[2] = 0.0;
+  // Integration of imaginary attribute with constant value 1 and
+  // of the point/vertex location, along with the attributes.
+  vtkIntegrationSums sums;
 
   this->IntegrationDimension = 0;
 
@@ -398,6 +738,8 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     // Now initialize the output for the intersected set of arrays.
     this->AllocateAttributes(pdList, output->GetPointData());
     this->AllocateAttributes(cdList, output->GetCellData());
+    sums.PointSums.resize(vtkIANumberOfComponents(output->GetPointData()));
+    sums.CellSums.resize(vtkIANumberOfComponents(output->GetCellData()));
 
     index = 0;
     // Now execute for each block.
@@ -408,7 +750,7 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
       vtkDataSet* ds = vtkDataSet::SafeDownCast(dobj);
       if (ds && ds->GetNumberOfPoints() > 0)
         {
-        this->ExecuteBlock(ds, output, index, pdList, cdList);
+        this->ExecuteBlock(ds, index, pdList, cdList, output, sums);
         index++;
         }
       }
@@ -425,7 +767,9 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     cdList.InitializeFieldList(dsInput->GetCellData());
     this->AllocateAttributes(pdList, output->GetPointData());
     this->AllocateAttributes(cdList, output->GetCellData());
-    this->ExecuteBlock(dsInput, output, 0, pdList, cdList);
+    sums.PointSums.resize(vtkIANumberOfComponents(output->GetPointData()));
+    sums.CellSums.resize(vtkIANumberOfComponents(output->GetCellData()));
+    this->ExecuteBlock(dsInput, 0, pdList, cdList, output, sums);
     }
   else
     {
@@ -437,36 +781,69 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
     return 0;
     }
 
-  // Here is the trick:  The satellites need a point and vertex to
-  // marshal the attributes.
-
-  // Generate point and vertex.  Add extra attributes for area too.
-  // Satellites do not need the area attribute, but it does not hurt.
-  double pt[3];
-  vtkPoints* newPoints = vtkPoints::New();
-  newPoints->SetNumberOfPoints(1);
-  // Get rid of the weight factors.
-  if (this->Sum != 0.0)
+  // Combine the results of the processes along a binary tree: at each
+  // step, every process still holding results either receives those of
+  // its partner or sends its own and is done.
+  int myId = 0;
+  int numProcs = 1;
+  if (this->Controller)
     {
-    pt[0] = this->SumCenter[0] / this->Sum;
-    pt[1] = this->SumCenter[1] / this->Sum;
-    pt[2] = this->SumCenter[2] / this->Sum;
+    myId = this->Controller->GetLocalProcessId();
+    numProcs = this->Controller->GetNumberOfProcesses();
     }
-  else
+  for (int step = 1; step < numProcs; step *= 2)
     {
-    pt[0] = this->SumCenter[0];
-    pt[1] = this->SumCenter[1];
-    pt[2] = this->SumCenter[2];
+    if (myId % (2*step) != 0)
+      {
+      // Here is the trick:  The satellites need a point and vertex to
+      // marshal the attributes.
+      this->IntegrationDimension = sums.Dimension;
+      this->WriteOutput(sums, output);
+      double msg[5];
+      msg[0] = (double)(sums.Dimension);
+      msg[1] = sums.Sum.GetValue();
+      msg[2] = sums.SumCenter[0].GetValue();
+      msg[3] = sums.SumCenter[1].GetValue();
+      msg[4] = sums.SumCenter[2].GetValue();
+      this->Controller->Send(msg, 5, myId - step,
+                             vtkIntegrateAttributes::IntegrateAttrInfo);
+      this->Controller->Send(output, myId - step,
+                             vtkIntegrateAttributes::IntegrateAttrData);
+      // Done sending.  Reset output so satellites will have empty data.
+      output->Initialize();
+      return 1;
+      }
+    if (myId + step < numProcs)
+      {
+      double msg[5];
+      this->Controller->Receive(msg,
+                                5,
+                                myId + step,
+                                vtkIntegrateAttributes::IntegrateAttrInfo);
+      vtkUnstructuredGrid* tmp = vtkUnstructuredGrid::New();
+      this->Controller->Receive(tmp,
+                                myId + step,
+                                vtkIntegrateAttributes::IntegrateAttrData);
+      if (sums.CompareDimension((int)(msg[0])))
+        {
+        sums.Sum.Add(msg[1]);
+        sums.SumCenter[0].Add(msg[2]);
+        sums.SumCenter[1].Add(msg[3]);
+        sums.SumCenter[2].Add(msg[4]);
+        this->IntegrateSatelliteData(tmp->GetPointData(),
+                                     output->GetPointData(), sums, false);
+        this->IntegrateSatelliteData(tmp->GetCellData(),
+                                     output->GetCellData(), sums, true);
+        }
+      tmp->Delete();
+      tmp = 0;
+      }
     }
-  newPoints->InsertPoint(0, pt);
-  output->SetPoints(newPoints);
-  newPoints->Delete();
-  newPoints = 0;
 
-  output->Allocate(1);
-  vtkIdType vertexPtIds[1];
-  vertexPtIds[0] = 0;
-  output->InsertNextCell(VTK_VERTEX, 1, vertexPtIds);
+  // Now that we have all of the sums from each process, generate the point
+  // and vertex with the global values.
+  this->IntegrationDimension = sums.Dimension;
+  this->WriteOutput(sums, output);
 
   // Create a new cell array for the total length, area or volume.
   vtkDoubleArray* sumArray = vtkDoubleArray::New();
@@ -483,79 +860,67 @@ int vtkIntegrateAttributes::RequestData(vtkInformation*,
       break;
     }
   sumArray->SetNumberOfTuples(1);
-  sumArray->SetValue(0, this->Sum);
+  sumArray->SetValue(0, sums.Sum.GetValue());
   output->GetCellData()->AddArray(sumArray);
   sumArray->Delete();
 
-  if (this->Controller->GetLocalProcessId() > 0)
+  if (output->GetPointData()->GetArray("vtkGhostLevels"))
     {
-    double msg[5];
-    msg[0] = (double)(this->IntegrationDimension);
-    msg[1] = this->Sum;
-    msg[2] = this->SumCenter[0];
-    msg[3] = this->SumCenter[1];
-    msg[4] = this->SumCenter[2];
-    this->Controller->Send(msg, 5, 0, vtkIntegrateAttributes::IntegrateAttrInfo);
-    this->Controller->Send(output, 0, vtkIntegrateAttributes::IntegrateAttrData);
-    // Done sending.  Reset output so satellites will have empty data.
-    output->Initialize();
+    output->GetPointData()->RemoveArray("vtkGhostLevels");
     }
-  else
+  if (output->GetCellData()->GetArray("vtkGhostLevels"))
     {
-    int numProcs = this->Controller->GetNumberOfProcesses();
-    for (int id = 1; id < numProcs; ++id)
-      {
-      double msg[5];
-      this->Controller->Receive(msg,
-                                5,
-                                id,
-                                vtkIntegrateAttributes::IntegrateAttrInfo);
-      vtkUnstructuredGrid* tmp = vtkUnstructuredGrid::New();
-      this->Controller->Receive(tmp,
-                                id,
-                                vtkIntegrateAttributes::IntegrateAttrData);
-      if (this->CompareIntegrationDimension(output, (int)(msg[0])))
-        {
-        this->Sum += msg[1];
-        this->SumCenter[0] += msg[2];
-        this->SumCenter[1] += msg[3];
-        this->SumCenter[2] += msg[4];
-        this->IntegrateSatelliteData(tmp->GetPointData(),
-                                     output->GetPointData());
-        this->IntegrateSatelliteData(tmp->GetCellData(),
-                                     output->GetCellData());
-        }
-      tmp->Delete();
-      tmp = 0;
-      }
+    output->GetCellData()->RemoveArray("vtkGhostLevels");
+    }
 
-    // now that we have all of the sums from each process
-    // set the point location with the global value
-    if (this->Sum != 0.0)
-      {
-      pt[0] = this->SumCenter[0] / this->Sum;
-      pt[1] = this->SumCenter[1] / this->Sum;
-      pt[2] = this->SumCenter[2] / this->Sum;
-      }
-    else
-      {
-      pt[0] = this->SumCenter[0];
-      pt[1] = this->SumCenter[1];
-      pt[2] = this->SumCenter[2];
-      }
-    output->GetPoints()->SetPoint(0, pt);
+  return 1;
+}
 
-    if (output->GetPointData()->GetArray("vtkGhostLevels"))
+//-----------------------------------------------------------------------------
+void vtkIntegrateAttributes::WriteOutput(vtkIntegrationSums& sums,
+                                         vtkUnstructuredGrid* output)
+{
+  // Generate point and vertex.
+  double pt[3];
+  double sum = sums.Sum.GetValue();
+  for (int i = 0; i < 3; ++i)
+    {
+    pt[i] = sums.SumCenter[i].GetValue();
+    // Get rid of the weight factors.
+    if (sum != 0.0)
       {
-      output->GetPointData()->RemoveArray("vtkGhostLevels");
+      pt[i] /= sum;
       }
-    if (output->GetCellData()->GetArray("vtkGhostLevels"))
+    }
+  vtkPoints* newPoints = vtkPoints::New();
+  newPoints->SetNumberOfPoints(1);
+  newPoints->SetPoint(0, pt);
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  output->Allocate(1);
+  vtkIdType vertexPtIds[1];
+  vertexPtIds[0] = 0;
+  output->InsertNextCell(VTK_VERTEX, 1, vertexPtIds);
+
+  // Store the integrated attributes.
+  vtkDataSetAttributes* outDA[2] = { output->GetPointData(),
+                                     output->GetCellData() };
+  std::vector<vtkCompensatedSum>* values[2] = { &sums.PointSums,
+                                                &sums.CellSums };
+  for (int a = 0; a < 2; ++a)
+    {
+    int offset = 0;
+    for (int i = 0; i < outDA[a]->GetNumberOfArrays(); ++i)
       {
-      output->GetCellData()->RemoveArray("vtkGhostLevels");
+      vtkDataArray* outArray = outDA[a]->GetArray(i);
+      int numComponents = outArray->GetNumberOfComponents();
+      for (int j = 0; j < numComponents; ++j, ++offset)
+        {
+        outArray->SetComponent(0, j, (*values[a])[offset].GetValue());
+        }
       }
     }
-
-  return 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -587,175 +952,26 @@ void vtkIntegrateAttributes::AllocateAttributes(
     }
 }
 
-//-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::ZeroAttributes(vtkDataSetAttributes* outda)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* outArray;
-  numArrays = outda->GetNumberOfArrays();
-  for (i = 0; i < numArrays; ++i)
-    {
-    outArray = outda->GetArray(i);
-    numComponents = outArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      outArray->SetComponent(0, j, 0.0);
-      }
-    }
-}
-//-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::IntegrateData1(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
-  vtkIdType pt1Id, double k,
-  vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = fieldList.GetNumberOfFields();
-  double vIn1, dv, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    if (fieldList.GetFieldIndex(i) < 0)
-      {
-      continue;
-      }
-    // We could template for speed.
-    inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
-    numComponents = inArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      vIn1 = inArray->GetComponent(pt1Id, j);
-      vOut = outArray->GetComponent(0, j);
-      dv = vIn1;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-//-----------------------------------------------------------------------------
-void vtkIntegrateAttributes::IntegrateData2(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
-  vtkIdType pt1Id, vtkIdType pt2Id, double k,
-  vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, dv, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    if (fieldList.GetFieldIndex(i) < 0)
-      {
-      continue;
-      }
-    // We could template for speed.
-    inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
-    numComponents = inArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      vIn1 = inArray->GetComponent(pt1Id, j);
-      vIn2 = inArray->GetComponent(pt2Id, j);
-      vOut = outArray->GetComponent(0, j);
-      dv = 0.5*(vIn1+vIn2);
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-//-----------------------------------------------------------------------------
-// Is the extra performance worth duplicating this code with IntergrateData2.
-void vtkIntegrateAttributes::IntegrateData3(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
-  vtkIdType pt1Id, vtkIdType pt2Id,
-  vtkIdType pt3Id, double k,
-  vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, vIn3, dv, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    if (fieldList.GetFieldIndex(i) < 0)
-      {
-      continue;
-      }
-    // We could template for speed.
-    inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
-    numComponents = inArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      vIn1 = inArray->GetComponent(pt1Id, j);
-      vIn2 = inArray->GetComponent(pt2Id, j);
-      vIn3 = inArray->GetComponent(pt3Id, j);
-      vOut = outArray->GetComponent(0, j);
-      dv = (vIn1+vIn2+vIn3)/3.0;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-
-//-----------------------------------------------------------------------------
-// Is the extra performance worth duplicating this code with IntergrateData2.
-void vtkIntegrateAttributes::IntegrateData4(vtkDataSetAttributes* inda,
-  vtkDataSetAttributes* outda,
-  vtkIdType pt1Id, vtkIdType pt2Id,
-  vtkIdType pt3Id, vtkIdType pt4Id,
-  double k,
-  vtkIntegrateAttributes::vtkFieldList& fieldList, int index)
-{
-  int numArrays, i, numComponents, j;
-  vtkDataArray* inArray;
-  vtkDataArray* outArray;
-  numArrays = fieldList.GetNumberOfFields();
-  double vIn1, vIn2, vIn3, vIn4, dv, vOut;
-  for (i = 0; i < numArrays; ++i)
-    {
-    if (fieldList.GetFieldIndex(i) < 0)
-      {
-      continue;
-      }
-    // We could template for speed.
-    inArray = inda->GetArray(fieldList.GetDSAIndex(index, i));
-    outArray = outda->GetArray(fieldList.GetFieldIndex(i));
-    numComponents = inArray->GetNumberOfComponents();
-    for (j = 0; j < numComponents; ++j)
-      {
-      vIn1 = inArray->GetComponent(pt1Id, j);
-      vIn2 = inArray->GetComponent(pt2Id, j);
-      vIn3 = inArray->GetComponent(pt3Id, j);
-      vIn4 = inArray->GetComponent(pt4Id, j);
-      vOut = outArray->GetComponent(0, j);
-      dv = (vIn1+vIn2+vIn3+vIn4) * 0.25;
-      vOut += dv*k;
-      outArray->SetComponent(0, j, vOut);
-      }
-    }
-}
-
 //-----------------------------------------------------------------------------
 // Used to sum arrays from all processes.
 void vtkIntegrateAttributes::IntegrateSatelliteData(vtkDataSetAttributes* inda,
-                                                    vtkDataSetAttributes* outda)
+                                                    vtkDataSetAttributes* outda,
+                                                    vtkIntegrationSums& sums,
+                                                    bool cellData)
 {
   if (inda->GetNumberOfArrays() != outda->GetNumberOfArrays())
     {
     return;
     }
 
+  std::vector<vtkCompensatedSum>& values =
+    cellData? sums.CellSums : sums.PointSums;
   int numArrays, i, numComponents, j;
+  int offset = 0;
   vtkDataArray* inArray;
   vtkDataArray* outArray;
   numArrays = outda->GetNumberOfArrays();
-  double vIn, vOut;
-  for (i = 0; i < numArrays; ++i)
+  for (i = 0; i < numArrays; ++i, offset += numComponents)
     {
     outArray = outda->GetArray(i);
     numComponents = outArray->GetNumberOfComponents();
@@ -766,12 +982,9 @@ void vtkIntegrateAttributes::IntegrateSatelliteData(vtkDataSetAttributes* inda,
       inArray = inda->GetArray(name);
       if (inArray && inArray->GetNumberOfComponents() == numComponents)
         {
-        // We could template for speed.
         for (j = 0; j < numComponents; ++j)
           {
-          vIn = inArray->GetComponent(0, j);
-          vOut = outArray->GetComponent(0, j);
-          outArray->SetComponent(0,j,vOut+vIn);
+          values[offset + j].Add(inArray->GetComponent(0, j));
           }
         }
       }
@@ -780,7 +993,7 @@ void vtkIntegrateAttributes::IntegrateSatelliteData(vtkDataSetAttributes* inda,
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkIntegrationSums& sums,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -799,31 +1012,27 @@ void vtkIntegrateAttributes::IntegratePolyLine(vtkDataSet* input,
 
     // Compute the length of the line.
     length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
-    this->Sum += length;
+    sums.Sum.Add(length);
 
     // Compute the middle, which is really just another attribute.
     mid[0] = (pt1[0]+pt2[0])*0.5;
     mid[1] = (pt1[1]+pt2[1])*0.5;
     mid[2] = (pt1[2]+pt2[2])*0.5;
     // Add weighted to sumCenter.
-    this->SumCenter[0] += mid[0]*length;
-    this->SumCenter[1] += mid[1]*length;
-    this->SumCenter[2] += mid[2]*length;
+    sums.SumCenter[0].Add(mid[0]*length);
+    sums.SumCenter[1].Add(mid[1]*length);
+    sums.SumCenter[2].Add(mid[2]*length);
 
     // Now integrate the rest of the attributes.
-    this->IntegrateData2(input->GetPointData(), output->GetPointData(),
-                         pt1Id, pt2Id, length,
-                         *this->PointFieldList, this->FieldListIndex);
-    this->IntegrateData1(input->GetCellData(), output->GetCellData(),
-                         cellId, length,
-                         *this->CellFieldList, this->FieldListIndex);
+    IntegrateData2(*sums.PointFields, sums.PointSums, pt1Id, pt2Id, length);
+    IntegrateData1(*sums.CellFields, sums.CellSums, cellId, length);
     }
 }
 
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkIntegrationSums& sums,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -852,30 +1061,26 @@ vtkIntegrateAttributes::IntegrateGeneral1DCell(vtkDataSet* input,
 
     // Compute the length of the line.
     length = sqrt(vtkMath::Distance2BetweenPoints(pt1, pt2));
-    this->Sum += length;
+    sums.Sum.Add(length);
 
     // Compute the middle, which is really just another attribute.
     mid[0] = (pt1[0]+pt2[0])*0.5;
     mid[1] = (pt1[1]+pt2[1])*0.5;
     mid[2] = (pt1[2]+pt2[2])*0.5;
     // Add weighted to sumCenter.
-    this->SumCenter[0] += mid[0]*length;
-    this->SumCenter[1] += mid[1]*length;
-    this->SumCenter[2] += mid[2]*length;
+    sums.SumCenter[0].Add(mid[0]*length);
+    sums.SumCenter[1].Add(mid[1]*length);
+    sums.SumCenter[2].Add(mid[2]*length);
 
     // Now integrate the rest of the attributes.
-    this->IntegrateData2(input->GetPointData(), output->GetPointData(),
-                         pt1Id, pt2Id, length,
-                         *this->PointFieldList, this->FieldListIndex);
-    this->IntegrateData1(input->GetCellData(), output->GetCellData(),
-                         cellId, length,
-                         *this->CellFieldList, this->FieldListIndex);
+    IntegrateData2(*sums.PointFields, sums.PointSums, pt1Id, pt2Id, length);
+    IntegrateData1(*sums.CellFields, sums.CellSums, cellId, length);
     }
 }
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateTriangleStrip(vtkDataSet* input,
-                                                    vtkUnstructuredGrid* output,
+                                                    vtkIntegrationSums& sums,
                                                     vtkIdType cellId,
                                                     vtkIdList* ptIds)
 {
@@ -888,14 +1093,14 @@ void vtkIntegrateAttributes::IntegrateTriangleStrip(vtkDataSet* input,
     pt1Id = ptIds->GetId(triIdx);
     pt2Id = ptIds->GetId(triIdx+1);
     pt3Id = ptIds->GetId(triIdx+2);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // Works for convex polygons, and interpoaltion is not correct.
 void vtkIntegrateAttributes::IntegratePolygon(vtkDataSet* input,
-                                              vtkUnstructuredGrid* output,
+                                              vtkIntegrationSums& sums,
                                               vtkIdType cellId,
                                               vtkIdList* ptIds)
 {
@@ -908,14 +1113,14 @@ void vtkIntegrateAttributes::IntegratePolygon(vtkDataSet* input,
     {
     pt2Id = ptIds->GetId(triIdx+1);
     pt3Id = ptIds->GetId(triIdx+2);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // For axis alligned rectangular cells
 void vtkIntegrateAttributes::IntegratePixel(vtkDataSet* input,
-                                            vtkUnstructuredGrid* output,
+                                            vtkIntegrationSums& sums,
                                             vtkIdType cellId,
                                             vtkIdList* cellPtIds)
 {
@@ -941,27 +1146,25 @@ void vtkIntegrateAttributes::IntegratePixel(vtkDataSet* input,
       (pts[0][2] - pts[2][2]);
 
   a = fabs(l*w);
-  this->Sum += a;
+  sums.Sum.Add(a);
   // Compute the middle, which is really just another attribute.
   mid[0] = (pts[0][0]+pts[1][0]+pts[2][0]+pts[3][0])*0.25;
   mid[1] = (pts[0][1]+pts[1][1]+pts[2][1]+pts[3][1])*0.25;
   mid[2] = (pts[0][2]+pts[1][2]+pts[2][2]+pts[3][2])*0.25;
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*a;
-  this->SumCenter[1] += mid[1]*a;
-  this->SumCenter[2] += mid[2]*a;
+  sums.SumCenter[0].Add(mid[0]*a);
+  sums.SumCenter[1].Add(mid[1]*a);
+  sums.SumCenter[2].Add(mid[2]*a);
 
   // Now integrate the rest of the attributes.
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, pt4Id, a,
-                       *this->PointFieldList, this->FieldListIndex);
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, a,
-    *this->CellFieldList, this->FieldListIndex);
+  IntegrateData4(*sums.PointFields, sums.PointSums,
+                 pt1Id, pt2Id, pt3Id, pt4Id, a);
+  IntegrateData1(*sums.CellFields, sums.CellSums, cellId, a);
 }
 
 //-----------------------------------------------------------------------------
 void vtkIntegrateAttributes::IntegrateTriangle(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkIntegrationSums& sums,
                                                vtkIdType cellId,
                                                vtkIdType pt1Id,
                                                vtkIdType pt2Id,
@@ -992,29 +1195,26 @@ void vtkIntegrateAttributes::IntegrateTriangle(vtkDataSet* input,
     {
     return;
     }
-  this->Sum += k;
+  sums.Sum.Add(k);
 
   // Compute the middle, which is really just another attribute.
   mid[0] = (pt1[0]+pt2[0]+pt3[0])/3.0;
   mid[1] = (pt1[1]+pt2[1]+pt3[1])/3.0;
   mid[2] = (pt1[2]+pt2[2]+pt3[2])/3.0;
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*k;
-  this->SumCenter[1] += mid[1]*k;
-  this->SumCenter[2] += mid[2]*k;
+  sums.SumCenter[0].Add(mid[0]*k);
+  sums.SumCenter[1].Add(mid[1]*k);
+  sums.SumCenter[2].Add(mid[2]*k);
 
   // Now integrate the rest of the attributes.
-  this->IntegrateData3(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, k,
-                       *this->PointFieldList, this->FieldListIndex);
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, k,
-    *this->CellFieldList, this->FieldListIndex);
+  IntegrateData3(*sums.PointFields, sums.PointSums, pt1Id, pt2Id, pt3Id, k);
+  IntegrateData1(*sums.CellFields, sums.CellSums, cellId, k);
 }
 
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral2DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkIntegrationSums& sums,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -1037,14 +1237,14 @@ vtkIntegrateAttributes::IntegrateGeneral2DCell(vtkDataSet* input,
     pt1Id = ptIds->GetId(triIdx++);
     pt2Id = ptIds->GetId(triIdx++);
     pt3Id = ptIds->GetId(triIdx++);
-    this->IntegrateTriangle(input, output, cellId, pt1Id, pt2Id, pt3Id);
+    this->IntegrateTriangle(input, sums, cellId, pt1Id, pt2Id, pt3Id);
     }
 }
 
 //-----------------------------------------------------------------------------
 // For Tetrahedral cells
 void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
-                                                  vtkUnstructuredGrid* output,
+                                                  vtkIntegrationSums& sums,
                                                   vtkIdType cellId,
                                                   vtkIdType pt1Id,
                                                   vtkIdType pt2Id,
@@ -1073,28 +1273,26 @@ void vtkIntegrateAttributes::IntegrateTetrahedron(vtkDataSet* input,
   // Calulate the volume of the tet which is 1/6 * the box product
   vtkMath::Cross(a,b,n);
   v = vtkMath::Dot(c, n) / 6.0;
-  this->Sum += v;
+  sums.Sum.Add(v);
 
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*v;
-  this->SumCenter[1] += mid[1]*v;
-  this->SumCenter[2] += mid[2]*v;
+  sums.SumCenter[0].Add(mid[0]*v);
+  sums.SumCenter[1].Add(mid[1]*v);
+  sums.SumCenter[2].Add(mid[2]*v);
 
   // Integrate the attributes on the cell itself
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, v,
-    *this->CellFieldList, this->FieldListIndex);
+  IntegrateData1(*sums.CellFields, sums.CellSums, cellId, v);
 
   // Integrate the attributes associated with the points
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, pt4Id, v,
-                       *this->PointFieldList, this->FieldListIndex);
+  IntegrateData4(*sums.PointFields, sums.PointSums,
+                 pt1Id, pt2Id, pt3Id, pt4Id, v);
 
 }
 
 //-----------------------------------------------------------------------------
 // For axis alligned hexahedral cells
 void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
-                                            vtkUnstructuredGrid* output,
+                                            vtkIntegrationSums& sums,
                                             vtkIdType cellId,
                                             vtkIdList* cellPtIds)
 {
@@ -1118,7 +1316,7 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
   w = pts[2][1] - pts[0][1];
   h = pts[4][2] - pts[0][2];
   v = fabs(l*w*h);
-  this->Sum += v;
+  sums.Sum.Add(v);
 
   // Partially Compute the middle, which is really just another attribute.
   mid[0] = (pts[0][0]+pts[1][0]+pts[2][0]+pts[3][0])*0.125;
@@ -1126,16 +1324,14 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
   mid[2] = (pts[0][2]+pts[1][2]+pts[2][2]+pts[3][2])*0.125;
 
   // Integrate the attributes on the cell itself
-  this->IntegrateData1(input->GetCellData(), output->GetCellData(), cellId, v,
-    *this->CellFieldList, this->FieldListIndex);
+  IntegrateData1(*sums.CellFields, sums.CellSums, cellId, v);
 
   // Integrate the attributes associated with the points on the bottom face
   // note that since IntegrateData4 is going to weigh everything by 1/4
   // we need to pass down 1/2 the volume so they will be weighted by 1/8
 
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, pt4Id, v*0.5,
-                       *this->PointFieldList, this->FieldListIndex);
+  IntegrateData4(*sums.PointFields, sums.PointSums,
+                 pt1Id, pt2Id, pt3Id, pt4Id, v*0.5);
 
   // Now process the top face points
   pt1Id = cellPtIds->GetId(5);
@@ -1151,22 +1347,21 @@ void vtkIntegrateAttributes::IntegrateVoxel(vtkDataSet* input,
 
 
   // Add weighted to sumCenter.
-  this->SumCenter[0] += mid[0]*v;
-  this->SumCenter[1] += mid[1]*v;
-  this->SumCenter[2] += mid[2]*v;
+  sums.SumCenter[0].Add(mid[0]*v);
+  sums.SumCenter[1].Add(mid[1]*v);
+  sums.SumCenter[2].Add(mid[2]*v);
 
   // Integrate the attributes associated with the points on the top face
   // note that since IntegrateData4 is going to weigh everything by 1/4
   // we need to pass down 1/2 the volume so they will be weighted by 1/8
-  this->IntegrateData4(input->GetPointData(), output->GetPointData(),
-                       pt1Id, pt2Id, pt3Id, pt5Id, v*0.5,
-                       *this->PointFieldList, this->FieldListIndex);
+  IntegrateData4(*sums.PointFields, sums.PointSums,
+                 pt1Id, pt2Id, pt3Id, pt5Id, v*0.5);
 }
 
 //-----------------------------------------------------------------------------
 void
 vtkIntegrateAttributes::IntegrateGeneral3DCell(vtkDataSet* input,
-                                               vtkUnstructuredGrid* output,
+                                               vtkIntegrationSums& sums,
                                                vtkIdType cellId,
                                                vtkIdList* ptIds)
 {
@@ -1191,7 +1386,7 @@ vtkIntegrateAttributes::IntegrateGeneral3DCell(vtkDataSet* input,
     pt2Id = ptIds->GetId(tetIdx++);
     pt3Id = ptIds->GetId(tetIdx++);
     pt4Id = ptIds->GetId(tetIdx++);
-    this->IntegrateTetrahedron(input, output, cellId, pt1Id, pt2Id, pt3Id,
+    this->IntegrateTetrahedron(input, sums, cellId, pt1Id, pt2Id, pt3Id,
                                pt4Id);
     }
 }
@@ -1204,6 +1399,6 @@ void vtkIntegrateAttributes::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "IntegrationDimension: "
      << this->IntegrationDimension << endl;
-
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
 
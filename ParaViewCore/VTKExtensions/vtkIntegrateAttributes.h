@@ -21,11 +21,17 @@
 // The output of this filter is a single point and vertex.  The attributes
 // for this point and cell will contain the integration results
 // for the corresponding input attributes.
+//
+// Cells are integrated by several threads, each one with its own
+// accumulators. All sums use compensated summation so that adding up many
+// small contributions does not lose precision. The results of the
+// processes are combined along a binary tree rooted at process 0.
 
 #ifndef __vtkIntegrateAttributes_h
 #define __vtkIntegrateAttributes_h
 
 #include "vtkUnstructuredGridAlgorithm.h"
+#include "vtkMultiThreader.h" // for VTK_MAX_THREADS
 
 class vtkDataSet;
 class vtkIdList;
@@ -43,6 +49,13 @@ public:
 
   void SetController(vtkMultiProcessController *controller);
 
+  // Description:
+  // Number of threads used to integrate the cells. When 0, the default,
+  // the vtkMultiThreader default is used. In either case the global maximum
+  // set on vtkMultiThreader is respected.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 //BTX
 protected:
   vtkIntegrateAttributes();
@@ -60,89 +73,70 @@ protected:
   virtual int FillInputPortInformation(int, vtkInformation*);
 
 
-  int CompareIntegrationDimension(vtkDataSet* output, int dim);
   int IntegrationDimension;
+  int NumberOfThreads;
 
-  // The length, area or volume of the data set.  Computed by Execute;
-  double Sum;
-  // ToCompute the location of the output point.
-  double SumCenter[3];
+  // Accumulators of one thread: the length, area or volume of the data
+  // set, the weighted center and the integrated attributes.
+  class vtkIntegrationSums;
 
   void IntegratePolyLine(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkIntegrationSums& sums,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegratePolygon(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkIntegrationSums& sums,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateTriangleStrip(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkIntegrationSums& sums,
                          vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateTriangle(vtkDataSet* input,
-                         vtkUnstructuredGrid* output,
+                         vtkIntegrationSums& sums,
                          vtkIdType cellId, vtkIdType pt1Id,
                          vtkIdType pt2Id, vtkIdType pt3Id);
   void IntegrateTetrahedron(vtkDataSet* input,
-                            vtkUnstructuredGrid* output,
+                            vtkIntegrationSums& sums,
                             vtkIdType cellId, vtkIdType pt1Id,
                             vtkIdType pt2Id, vtkIdType pt3Id,
                             vtkIdType pt4Id);
   void IntegratePixel(vtkDataSet* input,
-                      vtkUnstructuredGrid* output,
+                      vtkIntegrationSums& sums,
                       vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateVoxel(vtkDataSet* input,
-                      vtkUnstructuredGrid* output,
+                      vtkIntegrationSums& sums,
                       vtkIdType cellId, vtkIdList* cellPtIds);
   void IntegrateGeneral1DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkIntegrationSums& sums,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
   void IntegrateGeneral2DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkIntegrationSums& sums,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
   void IntegrateGeneral3DCell(vtkDataSet* input,
-                              vtkUnstructuredGrid* output,
+                              vtkIntegrationSums& sums,
                               vtkIdType cellId,
                               vtkIdList* cellPtIds);
   void IntegrateSatelliteData(vtkDataSetAttributes* inda,
-                              vtkDataSetAttributes* outda);
-  void ZeroAttributes(vtkDataSetAttributes* outda);
+                              vtkDataSetAttributes* outda,
+                              vtkIntegrationSums& sums, bool cellData);
 
 private:
   vtkIntegrateAttributes(const vtkIntegrateAttributes&);  // Not implemented.
   void operator=(const vtkIntegrateAttributes&);  // Not implemented.
 
   class vtkFieldList;
-  vtkFieldList* CellFieldList;
-  vtkFieldList* PointFieldList;
-  int FieldListIndex;
 
   void AllocateAttributes(
     vtkFieldList& fieldList, vtkDataSetAttributes* outda);
-  void ExecuteBlock(vtkDataSet* input, vtkUnstructuredGrid* output,
-    int fieldset_index, vtkFieldList& pdList, vtkFieldList& cdList);
-
-  void IntegrateData1(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda,
-                      vtkIdType pt1Id, double k,
-                      vtkFieldList& fieldlist,
-                      int fieldlist_index);
-  void IntegrateData2(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda,
-                      vtkIdType pt1Id, vtkIdType pt2Id, double k,
-                      vtkFieldList& fieldlist,
-                      int fieldlist_index);
-  void IntegrateData3(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda, vtkIdType pt1Id,
-                      vtkIdType pt2Id, vtkIdType pt3Id, double k,
-                      vtkFieldList& fieldlist,
-                      int fieldlist_index);
-  void IntegrateData4(vtkDataSetAttributes* inda,
-                      vtkDataSetAttributes* outda, vtkIdType pt1Id,
-                      vtkIdType pt2Id, vtkIdType pt3Id, vtkIdType pt4Id,
-                      double k,
-                      vtkFieldList& fieldlist,
-                      int fieldlist_index);
+  void ExecuteBlock(vtkDataSet* input, int fieldset_index,
+    vtkFieldList& pdList, vtkFieldList& cdList, vtkUnstructuredGrid* output,
+    vtkIntegrationSums& sums);
+  void IntegrateCells(vtkDataSet* input, vtkIdType begin, vtkIdType end,
+    vtkIntegrationSums& sums);
+  void WriteOutput(vtkIntegrationSums& sums, vtkUnstructuredGrid* output);
+  struct vtkThreadData;
+  friend VTK_THREAD_RETURN_TYPE vtkIntegrateAttributesThread(void *arg);
+
 public:
   enum CommunicationIds
    {
@@ -231,6 +231,10 @@ public:
   // You cannot add anymore equivalences after this is called.
   int ResolveEquivalences();
 
+  // Replace the set with ids that were resolved elsewhere. Members
+  // [offset, offset+numIds) are given ids, the rest are set to 0.
+  void SetResolvedIds(int numMembers, int offset, const int* ids, int numIds);
+
   void DeepCopy(vtkMaterialInterfaceEquivalenceSet* in);
 
   // Needed for sending the set over MPI.
@@ -432,6 +436,23 @@ int vtkMaterialInterfaceEquivalenceSet::ResolveEquivalences()
 }
 
 
+//----------------------------------------------------------------------------
+void vtkMaterialInterfaceEquivalenceSet::SetResolvedIds(
+  int numMembers, int offset, const int* ids, int numIds)
+{
+  this->EquivalenceArray->SetNumberOfTuples(numMembers);
+  for (int ii = 0; ii < numMembers; ++ii)
+    {
+    this->EquivalenceArray->SetValue(ii, 0);
+    }
+  for (int ii = 0; ii < numIds; ++ii)
+    {
+    this->EquivalenceArray->SetValue(offset+ii, ids[ii]);
+    }
+  this->Resolved = 1;
+}
+
+
 //============================================================================
 // Helper object to clip hexahedra wih implicit half sphere.
 class vtkMaterialInterfaceFilterHalfSphere
@@ -1695,6 +1716,7 @@ vtkMaterialInterfaceFilter::vtkMaterialInterfaceFilter()
 
   // Variable that will invert a material.
   this->InvertVolumeFraction = 0;
+  this->DistributedResolution = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -8352,7 +8374,14 @@ void vtkMaterialInterfaceFilter::ResolveEquivalences()
 
   // Resolve intraprocess and extra process equivalences.
   // This also renumbers set ids to be sequential.
-  this->GatherEquivalenceSets(this->EquivalenceSet);
+  if (this->DistributedResolution)
+    {
+    this->ResolveEquivalencesDistributed(this->EquivalenceSet);
+    }
+  else
+    {
+    this->GatherEquivalenceSets(this->EquivalenceSet);
+    }
   #ifdef vtkMaterialInterfaceFilterDEBUG
   cerr << "[" << __LINE__ << "] "
        << myProcId
@@ -8523,6 +8552,301 @@ void vtkMaterialInterfaceFilter::GatherEquivalenceSets(
   delete globalSet;
 }
 
+//----------------------------------------------------------------------------
+// Fragment pairs (local id, remote id) shared with one neighboring process.
+struct vtkMaterialInterfaceBoundaryPairs
+{
+  int Process;
+  vector<std::pair<int,int> > Pairs;
+};
+
+//----------------------------------------------------------------------------
+// Sort and remove duplicate pairs. The pairs are ordered by the id on the
+// lower process so that both processes hold them in the same order.
+static void vtkMaterialInterfaceSortBoundaryPairs(
+  vtkMaterialInterfaceBoundaryPairs &neighbor,
+  int myProcId)
+{
+  vector<std::pair<int,int> > &pairs = neighbor.Pairs;
+  const bool swapIds = neighbor.Process < myProcId;
+  if (swapIds)
+    {
+    for (size_t ii = 0; ii < pairs.size(); ++ii)
+      {
+      std::swap(pairs[ii].first, pairs[ii].second);
+      }
+    }
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+  if (swapIds)
+    {
+    for (size_t ii = 0; ii < pairs.size(); ++ii)
+      {
+      std::swap(pairs[ii].first, pairs[ii].second);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Swap a buffer with another process. To avoid blocking, the higher process
+// sends first.
+static void vtkMaterialInterfaceSwapBuffers(
+  vtkMultiProcessController* controller,
+  int otherProc,
+  vector<int> &sendBuf,
+  vector<int> &recvBuf)
+{
+  const bool sendFirst = otherProc < controller->GetLocalProcessId();
+  int sendNum = static_cast<int>(sendBuf.size());
+  int recvNum = 0;
+  if (sendFirst)
+    {
+    controller->Send(&sendNum, 1, otherProc, 875036);
+    controller->Receive(&recvNum, 1, otherProc, 875036);
+    }
+  else
+    {
+    controller->Receive(&recvNum, 1, otherProc, 875036);
+    controller->Send(&sendNum, 1, otherProc, 875036);
+    }
+  recvBuf.resize(recvNum);
+  if (sendFirst && sendNum > 0)
+    {
+    controller->Send(&sendBuf[0], sendNum, otherProc, 875037);
+    }
+  if (recvNum > 0)
+    {
+    controller->Receive(&recvBuf[0], recvNum, otherProc, 875037);
+    }
+  if (!sendFirst && sendNum > 0)
+    {
+    controller->Send(&sendBuf[0], sendNum, otherProc, 875037);
+    }
+}
+
+//----------------------------------------------------------------------------
+// One round of label propagation. The labels of the local sets (indexed by
+// their root) are exchanged across every boundary pair and the smallest
+// (or largest) is kept. Returns 1 if a label changed on any process.
+static int vtkMaterialInterfacePropagateLabels(
+  vtkMultiProcessController* controller,
+  vector<vtkMaterialInterfaceBoundaryPairs> &neighbors,
+  const vector<int> &roots,
+  vector<int> &labels,
+  bool keepMin)
+{
+  int changed = 0;
+  vector<int> sendBuf;
+  vector<int> recvBuf;
+  for (size_t ii = 0; ii < neighbors.size(); ++ii)
+    {
+    vector<std::pair<int,int> > &pairs = neighbors[ii].Pairs;
+    const size_t num = pairs.size();
+    sendBuf.resize(num);
+    for (size_t jj = 0; jj < num; ++jj)
+      {
+      sendBuf[jj] = labels[roots[pairs[jj].first]];
+      }
+    vtkMaterialInterfaceSwapBuffers(
+      controller, neighbors[ii].Process, sendBuf, recvBuf);
+    for (size_t jj = 0; jj < num && jj < recvBuf.size(); ++jj)
+      {
+      int &label = labels[roots[pairs[jj].first]];
+      if (keepMin ? recvBuf[jj] < label : recvBuf[jj] > label)
+        {
+        label = recvBuf[jj];
+        changed = 1;
+        }
+      }
+    }
+  int anyChanged = 0;
+  controller->AllReduce(&changed, &anyChanged, 1, vtkCommunicator::MAX_OP);
+  return anyChanged;
+}
+
+//----------------------------------------------------------------------------
+// Resolves the same fragment ids as GatherEquivalenceSets without gathering
+// the equivalences. Every local set is labeled with the smallest global id
+// of its members and labels are propagated across process boundaries until
+// they converge. Sets are then numbered in the order of their smallest id
+// and the numbers are propagated the same way. Only the final ids of the
+// local fragments go to process 0, which resolves the integrated attributes.
+// This fills in the same ivars as GatherEquivalenceSets.
+void vtkMaterialInterfaceFilter::ResolveEquivalencesDistributed(
+  vtkMaterialInterfaceEquivalenceSet* set)
+{
+  #ifdef vtkMaterialInterfaceFilterDEBUG
+  ostringstream progressMesg;
+  progressMesg << "vtkMaterialInterfaceFilter::ResolveEquivalencesDistributed("
+               << ") , Material "
+               << this->MaterialId;
+  this->SetProgressText(progressMesg.str().c_str());
+  #endif
+  this->Progress+=this->ProgressResolutionInc;
+  this->UpdateProgress(this->Progress);
+
+  const int numProcs = this->Controller->GetNumberOfProcesses();
+  const int myProcId = this->Controller->GetLocalProcessId();
+  int numLocalMembers = set->GetNumberOfMembers();
+  vtkCommunicator* com = this->Controller->GetCommunicator();
+
+  // Find a mapping between local fragment id and the global fragment ids.
+  com->AllGather(&numLocalMembers, this->NumberOfRawFragmentsInProcess, 1);
+  int totalNumberOfIds = 0;
+  for (int ii = 0; ii < numProcs; ++ii)
+    {
+    this->LocalToGlobalOffsets[ii] = totalNumberOfIds;
+    totalNumberOfIds += this->NumberOfRawFragmentsInProcess[ii];
+    }
+  this->TotalNumberOfRawFragments = totalNumberOfIds;
+  const int myOffset = this->LocalToGlobalOffsets[myProcId];
+
+  // Label each local set with its smallest global id.
+  vector<int> roots(numLocalMembers);
+  vector<int> labels(numLocalMembers);
+  for (int ii = 0; ii < numLocalMembers; ++ii)
+    {
+    roots[ii] = set->GetEquivalentSetId(ii);
+    labels[ii] = roots[ii] + myOffset;
+    }
+
+  // Find the fragments touching fragments of other processes.
+  vector<int> found;
+  this->ShareGhostEquivalences(0, this->LocalToGlobalOffsets, &found);
+
+  // Neighbors are the processes we sent ghost ids to or received them from,
+  // so the relation is symmetric.
+  vector<int> neighborProcs;
+  int numGhostBlocks = this->GhostBlocks.size();
+  for (int blockId = 0; blockId < numGhostBlocks; ++blockId)
+    {
+    vtkMaterialInterfaceFilterBlock* block = this->GhostBlocks[blockId];
+    if (block && block->GetGhostFlag()
+        && block->GetOwnerProcessId() != myProcId)
+      {
+      neighborProcs.push_back(block->GetOwnerProcessId());
+      }
+    }
+  for (size_t ii = 0; ii < found.size(); ii += 3)
+    {
+    neighborProcs.push_back(found[ii]);
+    }
+  std::sort(neighborProcs.begin(), neighborProcs.end());
+  neighborProcs.erase(std::unique(neighborProcs.begin(), neighborProcs.end()),
+                      neighborProcs.end());
+
+  vector<vtkMaterialInterfaceBoundaryPairs> neighbors(neighborProcs.size());
+  for (size_t ii = 0; ii < neighborProcs.size(); ++ii)
+    {
+    neighbors[ii].Process = neighborProcs[ii];
+    }
+  for (size_t ii = 0; ii < found.size(); ii += 3)
+    {
+    if (found[ii+1] >= 0)
+      {
+      size_t idx = std::lower_bound(neighborProcs.begin(), neighborProcs.end(),
+                                    found[ii]) - neighborProcs.begin();
+      neighbors[idx].Pairs.push_back(std::make_pair(found[ii+1], found[ii+2]));
+      }
+    }
+  vector<int>().swap(found);
+
+  // Each process only found the pairs seen through its own ghost blocks.
+  // Exchange them so that both sides hold the same list.
+  vector<int> sendBuf;
+  vector<int> recvBuf;
+  for (size_t ii = 0; ii < neighbors.size(); ++ii)
+    {
+    vtkMaterialInterfaceSortBoundaryPairs(neighbors[ii], myProcId);
+    vector<std::pair<int,int> > &pairs = neighbors[ii].Pairs;
+    sendBuf.resize(2*pairs.size());
+    for (size_t jj = 0; jj < pairs.size(); ++jj)
+      { // Ids as seen from the other process.
+      sendBuf[2*jj] = pairs[jj].second;
+      sendBuf[2*jj+1] = pairs[jj].first;
+      }
+    vtkMaterialInterfaceSwapBuffers(
+      this->Controller, neighbors[ii].Process, sendBuf, recvBuf);
+    for (size_t jj = 0; jj+1 < recvBuf.size(); jj += 2)
+      {
+      pairs.push_back(std::make_pair(recvBuf[jj], recvBuf[jj+1]));
+      }
+    vtkMaterialInterfaceSortBoundaryPairs(neighbors[ii], myProcId);
+    }
+
+  // Propagate the smallest id of every fragment.
+  while (vtkMaterialInterfacePropagateLabels(
+           this->Controller, neighbors, roots, labels, true))
+    {
+    }
+
+  // Sets whose smallest id is one of ours are numbered here.
+  int numSets = 0;
+  for (int ii = 0; ii < numLocalMembers; ++ii)
+    {
+    if (labels[roots[ii]] == ii + myOffset)
+      {
+      ++numSets;
+      }
+    }
+  vector<int> setsInProcess(numProcs);
+  com->AllGather(&numSets, &setsInProcess[0], 1);
+  int nextSetId = 0;
+  this->NumberOfResolvedFragments = 0;
+  for (int ii = 0; ii < numProcs; ++ii)
+    {
+    if (ii < myProcId)
+      {
+      nextSetId += setsInProcess[ii];
+      }
+    this->NumberOfResolvedFragments += setsInProcess[ii];
+    }
+  vector<int> setIds(numLocalMembers, -1);
+  for (int ii = 0; ii < numLocalMembers; ++ii)
+    {
+    if (labels[roots[ii]] == ii + myOffset)
+      {
+      setIds[ii] = nextSetId++;
+      }
+    }
+
+  // The other sets get their number from their neighbors.
+  while (vtkMaterialInterfacePropagateLabels(
+           this->Controller, neighbors, roots, setIds, false))
+    {
+    }
+
+  vector<int> localIds(numLocalMembers);
+  for (int ii = 0; ii < numLocalMembers; ++ii)
+    {
+    localIds[ii] = setIds[roots[ii]];
+    }
+  int* localPtr = numLocalMembers ? &localIds[0] : 0;
+
+  // Process 0 needs all the ids to resolve the integrated attributes.
+  if (myProcId == 0)
+    {
+    vector<int> globalIds(totalNumberOfIds);
+    vector<vtkIdType> lengths(numProcs);
+    vector<vtkIdType> offsets(numProcs);
+    for (int ii = 0; ii < numProcs; ++ii)
+      {
+      lengths[ii] = this->NumberOfRawFragmentsInProcess[ii];
+      offsets[ii] = this->LocalToGlobalOffsets[ii];
+      }
+    int* globalPtr = totalNumberOfIds ? &globalIds[0] : 0;
+    com->GatherV(localPtr, globalPtr, numLocalMembers,
+                 &lengths[0], &offsets[0], 0);
+    set->SetResolvedIds(totalNumberOfIds, 0, globalPtr, totalNumberOfIds);
+    }
+  else
+    {
+    com->GatherV(localPtr, static_cast<int*>(0), numLocalMembers,
+                 static_cast<vtkIdType*>(0), static_cast<vtkIdType*>(0), 0);
+    set->SetResolvedIds(totalNumberOfIds, myOffset, localPtr, numLocalMembers);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkMaterialInterfaceFilter::MergeGhostEquivalenceSets(
   vtkMaterialInterfaceEquivalenceSet* globalSet)
@@ -8583,9 +8907,13 @@ void vtkMaterialInterfaceFilter::MergeGhostEquivalenceSets(
  }
 
 //----------------------------------------------------------------------------
+// When boundaryPairs is given, the equivalences found with remote fragments
+// are appended to it as (process, local id, remote id) instead of being
+// added to globalSet.
 void vtkMaterialInterfaceFilter::ShareGhostEquivalences(
   vtkMaterialInterfaceEquivalenceSet* globalSet,
-  int* procOffsets)
+  int* procOffsets,
+  vector<int>* boundaryPairs)
 {
   const int numProcs = this->Controller->GetNumberOfProcesses();
   const int myProcId = this->Controller->GetLocalProcessId();
@@ -8596,7 +8924,7 @@ void vtkMaterialInterfaceFilter::ShareGhostEquivalences(
     {
     if (otherProc == myProcId)
       {
-      this->ReceiveGhostFragmentIds(globalSet, procOffsets);
+      this->ReceiveGhostFragmentIds(globalSet, procOffsets, boundaryPairs);
       }
     else
       {
@@ -8636,7 +8964,8 @@ void vtkMaterialInterfaceFilter::ShareGhostEquivalences(
 // find the equivalences.
 void vtkMaterialInterfaceFilter::ReceiveGhostFragmentIds(
   vtkMaterialInterfaceEquivalenceSet* globalSet,
-  int* procOffsets)
+  int* procOffsets,
+  vector<int>* boundaryPairs)
 {
   int msg[8];
   int otherProc;
@@ -8671,6 +9000,12 @@ void vtkMaterialInterfaceFilter::ReceiveGhostFragmentIds(
         vtkErrorMacro("Missing block request.");
         return;
         }
+      if (boundaryPairs)
+        { // Mark the sender as a neighbor even if no fragments touch.
+        boundaryPairs->push_back(otherProc);
+        boundaryPairs->push_back(-1);
+        boundaryPairs->push_back(-1);
+        }
       // Receive the ghost fragment ids.
       remoteExt = msg+2;
       dataSize = (remoteExt[1]-remoteExt[0]+1)
@@ -8709,7 +9044,18 @@ void vtkMaterialInterfaceFilter::ReceiveGhostFragmentIds(
             // Convert local fragment ids to global ids.
             localId = *px;
             remoteId = *remoteFragmentIds;
-            if (localId >= 0 && remoteId >= 0)
+            if (localId >= 0 && remoteId >= 0 && boundaryPairs)
+              {
+              // Neighboring voxels mostly repeat the last pair.
+              int* last = &(*boundaryPairs)[boundaryPairs->size()-3];
+              if (last[0] != otherProc || last[1] != localId || last[2] != remoteId)
+                {
+                boundaryPairs->push_back(otherProc);
+                boundaryPairs->push_back(localId);
+                boundaryPairs->push_back(remoteId);
+                }
+              }
+            else if (localId >= 0 && remoteId >= 0)
               {
               globalSet->AddEquivalence(localId + localOffset,
                                         remoteId + remoteOffset);
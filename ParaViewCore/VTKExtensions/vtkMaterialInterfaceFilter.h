@@ -250,6 +250,15 @@ public:
   vtkSetMacro(InvertVolumeFraction,int);
   vtkGetMacro(InvertVolumeFraction,int);
 
+  // Description:
+  // Resolve fragments that are split between processes without gathering
+  // the equivalences on process 0. Processes exchange the fragment pairs
+  // found on their boundaries with their neighbors and propagate the
+  // smallest fragment id until no label changes. Off by default.
+  vtkSetMacro(DistributedResolution,int);
+  vtkGetMacro(DistributedResolution,int);
+  vtkBooleanMacro(DistributedResolution,int);
+
   // Description:
   // Return the mtime also considering the locator and clip function.
   unsigned long GetMTime();
@@ -343,12 +352,16 @@ protected:
   void GatherEquivalenceSets(vtkMaterialInterfaceEquivalenceSet* set);
   void ShareGhostEquivalences(
     vtkMaterialInterfaceEquivalenceSet* globalSet,
-    int*  procOffsets);
+    int*  procOffsets,
+    std::vector<int>* boundaryPairs=0);
   void ReceiveGhostFragmentIds(
     vtkMaterialInterfaceEquivalenceSet* globalSet,
-    int* procOffset);
+    int* procOffset,
+    std::vector<int>* boundaryPairs=0);
   void MergeGhostEquivalenceSets(
     vtkMaterialInterfaceEquivalenceSet* globalSet);
+  // Distributed alternative to GatherEquivalenceSets.
+  void ResolveEquivalencesDistributed(vtkMaterialInterfaceEquivalenceSet* set);
 
   // Sum/finalize attribute's contribution for those
   // which are split over multiple processes.
@@ -700,6 +713,9 @@ protected:
   // Variable that will invert a material.
   int InvertVolumeFraction;
 
+  // Resolve equivalences with neighbor exchanges instead of on process 0.
+  int DistributedResolution;
+
 
 #ifdef vtkMaterialInterfaceFilterPROFILE
 // Lets profile to see what takes the most time for large number of processes.
@@ -16,6 +16,7 @@
 
 #include "vtkAttributeDataReductionFilter.h"
 #include "vtkCellData.h"
+#include "vtkCommunicator.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkInformation.h"
@@ -181,6 +182,31 @@ bool vtkPExtractHistogram::InitializeBinExtents(
 #endif
 }
 
+//-----------------------------------------------------------------------------
+void vtkPExtractHistogram::ReduceRange(double range[2])
+{
+  if (!this->Controller || this->Controller->GetNumberOfProcesses() <= 1)
+    {
+    return;
+    }
+  double local[2] = { range[0], range[1] };
+  this->Controller->AllReduce(&local[0], &range[0], 1, vtkCommunicator::MIN_OP);
+  this->Controller->AllReduce(&local[1], &range[1], 1, vtkCommunicator::MAX_OP);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkPExtractHistogram::ReduceCacheValidity(bool valid)
+{
+  if (!this->Controller || this->Controller->GetNumberOfProcesses() <= 1)
+    {
+    return valid;
+    }
+  int local = valid ? 1 : 0;
+  int global = 0;
+  this->Controller->AllReduce(&local, &global, 1, vtkCommunicator::MIN_OP);
+  return global == 1;
+}
+
 //-----------------------------------------------------------------------------
 int vtkPExtractHistogram::RequestData(vtkInformation *request,
   vtkInformationVector **inputVector, vtkInformationVector *outputVector)
@@ -52,6 +52,11 @@ protected:
     vtkInformationVector** inputVector, vtkDoubleArray* bin_extents,
     double& min, double& max);
 
+  // Description:
+  // Reductions over all the processes of the controller.
+  virtual void ReduceRange(double range[2]);
+  virtual bool ReduceCacheValidity(bool valid);
+
   vtkMultiProcessController* Controller;
 private:
   vtkPExtractHistogram(const vtkPExtractHistogram&); // Not implemented.
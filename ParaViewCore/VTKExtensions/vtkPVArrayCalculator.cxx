@@ -15,6 +15,7 @@
 #include "vtkPVArrayCalculator.h"
 
 #include "vtkCellData.h"
+#include "vtkDataArray.h"
 #include "vtkDataObject.h"
 #include "vtkDataSet.h"
 #include "vtkGraph.h"
@@ -22,12 +23,22 @@
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkPVMultiThreader.h"
 #include "vtkPVPostFilter.h"
+#include "vtkSmartPointer.h"
 
 #include <algorithm>
 #include <assert.h>
+#include <ctype.h>
+#include <map>
+#include <math.h>
 #include <set>
+#include <stdlib.h>
+#include <string.h>
 #include <string>
+#include <vector>
 #include <vtksys/ios/sstream>
 
 namespace
@@ -54,17 +65,1032 @@ namespace
       this->Calc->AddScalarVariable(name.c_str(), this->ArrayName, this->Component);
       }
     };
+
+  // --------------------------------------------------------------------------
+  // Compiled evaluation. The function is parsed once into a list of
+  // instructions, each one evaluated over a chunk of tuples at a time.
+  // Vectors are stored one component after the other so that every
+  // instruction is a simple loop over the chunk.
+  const vtkIdType VTK_CALCULATOR_CHUNK_SIZE = 512;
+
+  enum vtkCalculatorOp
+    {
+    OP_VARIABLE,
+    OP_CONSTANT,
+    OP_ADD,
+    OP_SUBTRACT,
+    OP_MULTIPLY,
+    OP_DIVIDE,
+    OP_POWER,
+    OP_MIN,
+    OP_MAX,
+    OP_LESS,
+    OP_GREATER,
+    OP_EQUAL,
+    OP_AND,
+    OP_OR,
+    OP_SCALAR_TIMES_VECTOR,
+    OP_VECTOR_TIMES_SCALAR,
+    OP_VECTOR_OVER_SCALAR,
+    OP_DOT,
+    OP_CROSS,
+    OP_NEGATE,
+    OP_ABS,
+    OP_EXP,
+    OP_CEIL,
+    OP_FLOOR,
+    OP_LN,
+    OP_LOG10,
+    OP_SQRT,
+    OP_SIN,
+    OP_COS,
+    OP_TAN,
+    OP_ASIN,
+    OP_ACOS,
+    OP_ATAN,
+    OP_SINH,
+    OP_COSH,
+    OP_TANH,
+    OP_SIGN,
+    OP_MAGNITUDE,
+    OP_NORMALIZE,
+    OP_IF
+    };
+
+  struct vtkCalculatorVariable
+    {
+    std::string ArrayName;
+    bool Coordinates;
+    int Width;          // 1 for scalars, 3 for vectors, 0 when ambiguous
+    int Components[3];
+
+    bool operator==(const vtkCalculatorVariable& other) const
+      {
+      return this->ArrayName == other.ArrayName &&
+        this->Coordinates == other.Coordinates &&
+        this->Width == other.Width &&
+        std::equal(this->Components, this->Components + this->Width,
+          other.Components);
+      }
+    };
+
+  struct vtkCalculatorInstruction
+    {
+    int Op;
+    int Width;          // of the result
+    int Args[3];        // instructions giving the operands
+    int Variable;       // for OP_VARIABLE
+    double Constant[3]; // for OP_CONSTANT
+    vtkIdType Offset;   // of the result in the registers, in chunks
+    };
+
+  struct vtkCalculatorProgram
+    {
+    std::vector<vtkCalculatorInstruction> Instructions;
+    std::vector<vtkCalculatorVariable> Variables;
+    vtkIdType RegisterSize; // in chunks
+    };
+
+  void vtkAddCalculatorVariable(
+    std::map<std::string, vtkCalculatorVariable>& variables,
+    vtksys_ios::ostringstream& key, const char* name, const char* arrayName,
+    int width, const int* components)
+    {
+    if (!name)
+      {
+      return;
+      }
+    vtkCalculatorVariable var;
+    var.ArrayName = arrayName ? arrayName : "";
+    var.Coordinates = (arrayName == NULL);
+    var.Width = width;
+    key << "\n" << name << "\t" << var.ArrayName << "\t" << var.Coordinates;
+    for (int c = 0; c < width; c++)
+      {
+      var.Components[c] = components[c];
+      key << "\t" << components[c];
+      }
+
+    std::map<std::string, vtkCalculatorVariable>::iterator iter =
+      variables.find(name);
+    if (iter == variables.end())
+      {
+      variables[name] = var;
+      }
+    else if (!(iter->second == var))
+      {
+      iter->second.Width = 0;
+      }
+    }
+
+  // Recursive descent parser following the grammar and the precedences of
+  // vtkFunctionParser. Anything it is not sure to evaluate the same way makes
+  // Compile() fail, the function is then left to vtkFunctionParser.
+  class vtkCalculatorCompiler
+    {
+  public:
+    vtkCalculatorCompiler(const char* function,
+      const std::map<std::string, vtkCalculatorVariable>& variables,
+      vtkCalculatorProgram& program) :
+      Variables(variables), Program(program), Pos(0), Failed(false)
+      {
+      for (const char* c = function; *c; ++c)
+        {
+        if (*c != ' ')
+          {
+          this->Text += *c;
+          }
+        }
+      }
+
+    bool Compile()
+      {
+      this->Program.Instructions.clear();
+      this->Program.Variables.clear();
+      this->Program.RegisterSize = 0;
+      this->ParseOr();
+      if (this->Failed || this->Pos != this->Text.size() ||
+        this->Program.Instructions.empty())
+        {
+        return false;
+        }
+      for (size_t i = 0; i < this->Program.Instructions.size(); i++)
+        {
+        this->Program.Instructions[i].Offset = this->Program.RegisterSize;
+        this->Program.RegisterSize += this->Program.Instructions[i].Width;
+        }
+      return true;
+      }
+
+  private:
+    const std::map<std::string, vtkCalculatorVariable>& Variables;
+    std::map<std::string, int> VariableIndices;
+    vtkCalculatorProgram& Program;
+    std::string Text;
+    size_t Pos;
+    bool Failed;
+
+    int Fail()
+      {
+      this->Failed = true;
+      return -1;
+      }
+
+    bool Accept(char c)
+      {
+      if (!this->Failed && this->Pos < this->Text.size() &&
+        this->Text[this->Pos] == c)
+        {
+        this->Pos++;
+        return true;
+        }
+      return false;
+      }
+
+    int Width(int arg) const
+      {
+      return this->Program.Instructions[arg].Width;
+      }
+
+    int Emit(int op, int width, int arg0 = -1, int arg1 = -1, int arg2 = -1)
+      {
+      if (this->Failed)
+        {
+        return -1;
+        }
+      vtkCalculatorInstruction inst;
+      inst.Op = op;
+      inst.Width = width;
+      inst.Args[0] = arg0;
+      inst.Args[1] = arg1;
+      inst.Args[2] = arg2;
+      inst.Variable = -1;
+      inst.Constant[0] = inst.Constant[1] = inst.Constant[2] = 0.0;
+      inst.Offset = 0;
+      this->Program.Instructions.push_back(inst);
+      return static_cast<int>(this->Program.Instructions.size()) - 1;
+      }
+
+    int EmitConstant(double x, double y, double z, int width)
+      {
+      int result = this->Emit(OP_CONSTANT, width);
+      if (result >= 0)
+        {
+        this->Program.Instructions[result].Constant[0] = x;
+        this->Program.Instructions[result].Constant[1] = y;
+        this->Program.Instructions[result].Constant[2] = z;
+        }
+      return result;
+      }
+
+    // Both operands must be scalars
+    int EmitScalar(int op, int left, int right)
+      {
+      if (this->Failed || this->Width(left) != 1 || this->Width(right) != 1)
+        {
+        return this->Fail();
+        }
+      return this->Emit(op, 1, left, right);
+      }
+
+    int ParseOr()
+      {
+      int left = this->ParseAnd();
+      while (this->Accept('|'))
+        {
+        left = this->EmitScalar(OP_OR, left, this->ParseAnd());
+        }
+      return left;
+      }
+
+    int ParseAnd()
+      {
+      int left = this->ParseComparison();
+      while (this->Accept('&'))
+        {
+        left = this->EmitScalar(OP_AND, left, this->ParseComparison());
+        }
+      return left;
+      }
+
+    int ParseComparison()
+      {
+      int left = this->ParseAdditive();
+      if (this->Accept('<'))
+        {
+        left = this->EmitScalar(OP_LESS, left, this->ParseAdditive());
+        }
+      else if (this->Accept('>'))
+        {
+        left = this->EmitScalar(OP_GREATER, left, this->ParseAdditive());
+        }
+      else if (this->Accept('='))
+        {
+        left = this->EmitScalar(OP_EQUAL, left, this->ParseAdditive());
+        }
+      return left;
+      }
+
+    int ParseAdditive()
+      {
+      int left = this->ParseDot();
+      for (;;)
+        {
+        int op;
+        if (this->Accept('+'))
+          {
+          op = OP_ADD;
+          }
+        else if (this->Accept('-'))
+          {
+          op = OP_SUBTRACT;
+          }
+        else
+          {
+          return left;
+          }
+        int right = this->ParseDot();
+        if (this->Failed || this->Width(left) != this->Width(right))
+          {
+          return this->Fail();
+          }
+        left = this->Emit(op, this->Width(left), left, right);
+        }
+      }
+
+    // The dot product binds less tightly than * and /, as in
+    // vtkFunctionParser.
+    int ParseDot()
+      {
+      int left = this->ParseMultiplicative();
+      while (this->Accept('.'))
+        {
+        int right = this->ParseMultiplicative();
+        if (this->Failed || this->Width(left) != 3 || this->Width(right) != 3)
+          {
+          return this->Fail();
+          }
+        left = this->Emit(OP_DOT, 1, left, right);
+        }
+      return left;
+      }
+
+    int ParseMultiplicative()
+      {
+      int left = this->ParseUnary();
+      for (;;)
+        {
+        bool multiply;
+        if (this->Accept('*'))
+          {
+          multiply = true;
+          }
+        else if (this->Accept('/'))
+          {
+          multiply = false;
+          }
+        else
+          {
+          return left;
+          }
+        int right = this->ParseUnary();
+        if (this->Failed)
+          {
+          return -1;
+          }
+        int leftWidth = this->Width(left);
+        int rightWidth = this->Width(right);
+        if (leftWidth == 1 && rightWidth == 1)
+          {
+          left = this->Emit(multiply ? OP_MULTIPLY : OP_DIVIDE, 1, left, right);
+          }
+        else if (multiply && leftWidth == 1)
+          {
+          left = this->Emit(OP_SCALAR_TIMES_VECTOR, 3, left, right);
+          }
+        else if (rightWidth == 1)
+          {
+          left = this->Emit(multiply ? OP_VECTOR_TIMES_SCALAR :
+            OP_VECTOR_OVER_SCALAR, 3, left, right);
+          }
+        else
+          {
+          return this->Fail();
+          }
+        }
+      }
+
+    int ParseUnary()
+      {
+      if (this->Accept('-'))
+        {
+        int arg = this->ParseUnary();
+        return this->Failed ? -1 : this->Emit(OP_NEGATE, this->Width(arg), arg);
+        }
+      return this->ParsePower();
+      }
+
+    int ParsePower()
+      {
+      int base = this->ParsePrimary();
+      if (this->Accept('^'))
+        {
+        int exponent = this->ParseUnary();
+        if (this->Accept('^'))
+          {
+          // Associativity of a^b^c is not worth guessing
+          return this->Fail();
+          }
+        return this->EmitScalar(OP_POWER, base, exponent);
+        }
+      return base;
+      }
+
+    // Length of the longest variable name at the current position
+    size_t MatchVariable(std::string& name) const
+      {
+      size_t length = 0;
+      std::map<std::string, vtkCalculatorVariable>::const_iterator iter;
+      for (iter = this->Variables.begin(); iter != this->Variables.end(); ++iter)
+        {
+        const std::string& candidate = iter->first;
+        if (candidate.size() > length &&
+          this->Text.compare(this->Pos, candidate.size(), candidate) == 0)
+          {
+          length = candidate.size();
+          name = candidate;
+          }
+        }
+      return length;
+      }
+
+    // Index of the function, followed by '(', at the current position
+    int MatchFunction(size_t& length) const
+      {
+      static const char* const names[] = { "abs", "exp", "ceil", "floor",
+        "ln", "log10", "sqrt", "sin", "cos", "tan", "asin", "acos", "atan",
+        "sinh", "cosh", "tanh", "sign", "mag", "norm", "min", "max", "cross",
+        "if", NULL };
+      for (int i = 0; names[i]; i++)
+        {
+        size_t len = strlen(names[i]);
+        if (this->Text.compare(this->Pos, len, names[i]) == 0 &&
+          this->Pos + len < this->Text.size() &&
+          this->Text[this->Pos + len] == '(')
+          {
+          length = len;
+          return i;
+          }
+        }
+      return -1;
+      }
+
+    int MatchUnitVector() const
+      {
+      static const char* const names[] = { "iHat", "jHat", "kHat", NULL };
+      for (int i = 0; names[i]; i++)
+        {
+        if (this->Text.compare(this->Pos, 4, names[i]) == 0)
+          {
+          return i;
+          }
+        }
+      return -1;
+      }
+
+    int ParsePrimary()
+      {
+      if (this->Failed || this->Pos >= this->Text.size())
+        {
+        return this->Fail();
+        }
+      if (this->Accept('('))
+        {
+        int result = this->ParseOr();
+        return this->Accept(')') ? result : this->Fail();
+        }
+
+      const char* start = this->Text.c_str() + this->Pos;
+      bool number = isdigit(static_cast<unsigned char>(start[0])) ||
+        (start[0] == '.' && isdigit(static_cast<unsigned char>(start[1])));
+      std::string variableName;
+      size_t variableLength = this->MatchVariable(variableName);
+      size_t functionLength = 0;
+      int function = this->MatchFunction(functionLength);
+      int unitVector = this->MatchUnitVector();
+
+      // Leave the function parser decide between ambiguous tokens
+      int matches = (number ? 1 : 0) + (variableLength > 0 ? 1 : 0) +
+        (function >= 0 ? 1 : 0) + (unitVector >= 0 ? 1 : 0);
+      if (matches != 1)
+        {
+        return this->Fail();
+        }
+
+      if (number)
+        {
+        char* end;
+        double value = strtod(start, &end);
+        this->Pos += end - start;
+        return this->EmitConstant(value, 0.0, 0.0, 1);
+        }
+      if (unitVector >= 0)
+        {
+        this->Pos += 4;
+        return this->EmitConstant(unitVector == 0 ? 1.0 : 0.0,
+          unitVector == 1 ? 1.0 : 0.0, unitVector == 2 ? 1.0 : 0.0, 3);
+        }
+      if (variableLength > 0)
+        {
+        this->Pos += variableLength;
+        return this->EmitVariable(variableName);
+        }
+      this->Pos += functionLength + 1;
+      return this->ParseFunction(function);
+      }
+
+    int EmitVariable(const std::string& name)
+      {
+      const vtkCalculatorVariable& var =
+        this->Variables.find(name)->second;
+      if (var.Width == 0)
+        {
+        return this->Fail();
+        }
+      std::map<std::string, int>::iterator iter =
+        this->VariableIndices.find(name);
+      int index;
+      if (iter == this->VariableIndices.end())
+        {
+        index = static_cast<int>(this->Program.Variables.size());
+        this->Program.Variables.push_back(var);
+        this->VariableIndices[name] = index;
+        }
+      else
+        {
+        index = iter->second;
+        }
+      int result = this->Emit(OP_VARIABLE, var.Width);
+      if (result >= 0)
+        {
+        this->Program.Instructions[result].Variable = index;
+        }
+      return result;
+      }
+
+    // Parses the arguments and the closing parenthesis of function
+    int ParseFunction(int function)
+      {
+      static const int scalarOps[] = { OP_ABS, OP_EXP, OP_CEIL, OP_FLOOR,
+        OP_LN, OP_LOG10, OP_SQRT, OP_SIN, OP_COS, OP_TAN, OP_ASIN, OP_ACOS,
+        OP_ATAN, OP_SINH, OP_COSH, OP_TANH, OP_SIGN };
+      const int numScalarOps = sizeof(scalarOps) / sizeof(scalarOps[0]);
+
+      int args[3];
+      int numArgs = 0;
+      do
+        {
+        if (numArgs == 3)
+          {
+          return this->Fail();
+          }
+        args[numArgs++] = this->ParseOr();
+        }
+      while (this->Accept(','));
+      if (this->Failed || !this->Accept(')'))
+        {
+        return this->Fail();
+        }
+
+      if (function < numScalarOps)
+        {
+        if (numArgs != 1 || this->Width(args[0]) != 1)
+          {
+          return this->Fail();
+          }
+        return this->Emit(scalarOps[function], 1, args[0]);
+        }
+      switch (function - numScalarOps)
+        {
+        case 0: // mag
+        case 1: // norm
+          if (numArgs != 1 || this->Width(args[0]) != 3)
+            {
+            return this->Fail();
+            }
+          return function == numScalarOps ?
+            this->Emit(OP_MAGNITUDE, 1, args[0]) :
+            this->Emit(OP_NORMALIZE, 3, args[0]);
+        case 2: // min
+        case 3: // max
+          if (numArgs != 2)
+            {
+            return this->Fail();
+            }
+          return this->EmitScalar(function == numScalarOps + 2 ? OP_MIN :
+            OP_MAX, args[0], args[1]);
+        case 4: // cross
+          if (numArgs != 2 || this->Width(args[0]) != 3 ||
+            this->Width(args[1]) != 3)
+            {
+            return this->Fail();
+            }
+          return this->Emit(OP_CROSS, 3, args[0], args[1]);
+        case 5: // if
+          if (numArgs != 3 || this->Width(args[0]) != 1 ||
+            this->Width(args[1]) != this->Width(args[2]))
+            {
+            return this->Fail();
+            }
+          return this->Emit(OP_IF, this->Width(args[1]), args[0], args[1],
+            args[2]);
+        }
+      return this->Fail();
+      }
+    };
+
+  template <class T>
+  void vtkCalculatorGather(const T* data, int numComps, const int* comps,
+    int width, vtkIdType start, vtkIdType n, double* reg)
+    {
+    for (int c = 0; c < width; c++)
+      {
+      const T* src = data + start * numComps + comps[c];
+      double* dst = reg + c * VTK_CALCULATOR_CHUNK_SIZE;
+      for (vtkIdType i = 0; i < n; i++)
+        {
+        dst[i] = static_cast<double>(src[i * numComps]);
+        }
+      }
+    }
+
+  template <class T>
+  void vtkCalculatorScatter(const double* reg, int width, vtkIdType start,
+    vtkIdType n, T* data)
+    {
+    for (int c = 0; c < width; c++)
+      {
+      const double* src = reg + c * VTK_CALCULATOR_CHUNK_SIZE;
+      T* dst = data + start * width + c;
+      for (vtkIdType i = 0; i < n; i++)
+        {
+        dst[i * width] = static_cast<T>(src[i]);
+        }
+      }
+    }
+
+  bool vtkCalculatorIsSupportedType(int dataType)
+    {
+    switch (dataType)
+      {
+      vtkTemplateMacro(return true);
+      }
+    return false;
+    }
+
+  // Evaluates the program on n tuples from start. The result is in the
+  // registers of the last instruction. Returns false when an operation is
+  // invalid and replace is off.
+  bool vtkCalculatorExecute(const vtkCalculatorProgram& program,
+    vtkDataArray* const* arrays, vtkIdType start, vtkIdType n, bool replace,
+    double replacement, double* registers)
+    {
+    const vtkIdType S = VTK_CALCULATOR_CHUNK_SIZE;
+    int invalid = 0;
+    for (size_t k = 0; k < program.Instructions.size(); k++)
+      {
+      const vtkCalculatorInstruction& inst = program.Instructions[k];
+      double* r = registers + inst.Offset * S;
+      const double* a = inst.Args[0] < 0 ? NULL :
+        registers + program.Instructions[inst.Args[0]].Offset * S;
+      const double* b = inst.Args[1] < 0 ? NULL :
+        registers + program.Instructions[inst.Args[1]].Offset * S;
+      const double* d = inst.Args[2] < 0 ? NULL :
+        registers + program.Instructions[inst.Args[2]].Offset * S;
+      vtkIdType i;
+      int c;
+      switch (inst.Op)
+        {
+        case OP_VARIABLE:
+          {
+          const vtkCalculatorVariable& var = program.Variables[inst.Variable];
+          vtkDataArray* array = arrays[inst.Variable];
+          switch (array->GetDataType())
+            {
+            vtkTemplateMacro(vtkCalculatorGather(
+                static_cast<VTK_TT*>(array->GetVoidPointer(0)),
+                array->GetNumberOfComponents(), var.Components, var.Width,
+                start, n, r));
+            }
+          }
+          break;
+        case OP_CONSTANT:
+          for (c = 0; c < inst.Width; c++)
+            {
+            for (i = 0; i < n; i++)
+              {
+              r[c * S + i] = inst.Constant[c];
+              }
+            }
+          break;
+        case OP_ADD:
+          for (c = 0; c < inst.Width; c++)
+            {
+            for (i = 0; i < n; i++)
+              {
+              r[c * S + i] = a[c * S + i] + b[c * S + i];
+              }
+            }
+          break;
+        case OP_SUBTRACT:
+          for (c = 0; c < inst.Width; c++)
+            {
+            for (i = 0; i < n; i++)
+              {
+              r[c * S + i] = a[c * S + i] - b[c * S + i];
+              }
+            }
+          break;
+        case OP_NEGATE:
+          for (c = 0; c < inst.Width; c++)
+            {
+            for (i = 0; i < n; i++)
+              {
+              r[c * S + i] = -a[c * S + i];
+              }
+            }
+          break;
+        case OP_IF:
+          for (c = 0; c < inst.Width; c++)
+            {
+            for (i = 0; i < n; i++)
+              {
+              r[c * S + i] = a[i] != 0.0 ? b[c * S + i] : d[c * S + i];
+              }
+            }
+          break;
+        case OP_MULTIPLY:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[i] * b[i];
+            }
+          break;
+        case OP_DIVIDE:
+          for (i = 0; i < n; i++)
+            {
+            invalid |= (b[i] == 0.0);
+            r[i] = b[i] == 0.0 ? replacement : a[i] / b[i];
+            }
+          break;
+        case OP_POWER:
+          for (i = 0; i < n; i++)
+            {
+            bool out = (a[i] < 0.0 && b[i] != floor(b[i]));
+            invalid |= out;
+            r[i] = out ? replacement : pow(a[i], b[i]);
+            }
+          break;
+        case OP_MIN:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[i] < b[i] ? a[i] : b[i];
+            }
+          break;
+        case OP_MAX:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[i] > b[i] ? a[i] : b[i];
+            }
+          break;
+        case OP_LESS:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[i] < b[i] ? 1.0 : 0.0;
+            }
+          break;
+        case OP_GREATER:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[i] > b[i] ? 1.0 : 0.0;
+            }
+          break;
+        case OP_EQUAL:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[i] == b[i] ? 1.0 : 0.0;
+            }
+          break;
+        case OP_AND:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = (a[i] != 0.0 && b[i] != 0.0) ? 1.0 : 0.0;
+            }
+          break;
+        case OP_OR:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = (a[i] != 0.0 || b[i] != 0.0) ? 1.0 : 0.0;
+            }
+          break;
+        case OP_SCALAR_TIMES_VECTOR:
+          for (c = 0; c < 3; c++)
+            {
+            for (i = 0; i < n; i++)
+              {
+              r[c * S + i] = a[i] * b[c * S + i];
+              }
+            }
+          break;
+        case OP_VECTOR_TIMES_SCALAR:
+          for (c = 0; c < 3; c++)
+            {
+            for (i = 0; i < n; i++)
+              {
+              r[c * S + i] = a[c * S + i] * b[i];
+              }
+            }
+          break;
+        case OP_VECTOR_OVER_SCALAR:
+          for (c = 0; c < 3; c++)
+            {
+            for (i = 0; i < n; i++)
+              {
+              invalid |= (b[i] == 0.0);
+              r[c * S + i] = b[i] == 0.0 ? replacement : a[c * S + i] / b[i];
+              }
+            }
+          break;
+        case OP_DOT:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[i] * b[i] + a[S + i] * b[S + i] +
+              a[2 * S + i] * b[2 * S + i];
+            }
+          break;
+        case OP_CROSS:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[S + i] * b[2 * S + i] - a[2 * S + i] * b[S + i];
+            r[S + i] = a[2 * S + i] * b[i] - a[i] * b[2 * S + i];
+            r[2 * S + i] = a[i] * b[S + i] - a[S + i] * b[i];
+            }
+          break;
+        case OP_MAGNITUDE:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = sqrt(a[i] * a[i] + a[S + i] * a[S + i] +
+              a[2 * S + i] * a[2 * S + i]);
+            }
+          break;
+        case OP_NORMALIZE:
+          for (i = 0; i < n; i++)
+            {
+            double norm = sqrt(a[i] * a[i] + a[S + i] * a[S + i] +
+              a[2 * S + i] * a[2 * S + i]);
+            invalid |= (norm == 0.0);
+            for (c = 0; c < 3; c++)
+              {
+              r[c * S + i] = norm == 0.0 ? replacement : a[c * S + i] / norm;
+              }
+            }
+          break;
+        case OP_ABS:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = fabs(a[i]);
+            }
+          break;
+        case OP_EXP:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = exp(a[i]);
+            }
+          break;
+        case OP_CEIL:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = ceil(a[i]);
+            }
+          break;
+        case OP_FLOOR:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = floor(a[i]);
+            }
+          break;
+        case OP_LN:
+          for (i = 0; i < n; i++)
+            {
+            invalid |= (a[i] <= 0.0);
+            r[i] = a[i] <= 0.0 ? replacement : log(a[i]);
+            }
+          break;
+        case OP_LOG10:
+          for (i = 0; i < n; i++)
+            {
+            invalid |= (a[i] <= 0.0);
+            r[i] = a[i] <= 0.0 ? replacement : log10(a[i]);
+            }
+          break;
+        case OP_SQRT:
+          for (i = 0; i < n; i++)
+            {
+            invalid |= (a[i] < 0.0);
+            r[i] = a[i] < 0.0 ? replacement : sqrt(a[i]);
+            }
+          break;
+        case OP_SIN:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = sin(a[i]);
+            }
+          break;
+        case OP_COS:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = cos(a[i]);
+            }
+          break;
+        case OP_TAN:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = tan(a[i]);
+            }
+          break;
+        case OP_ASIN:
+          for (i = 0; i < n; i++)
+            {
+            bool out = (a[i] < -1.0 || a[i] > 1.0);
+            invalid |= out;
+            r[i] = out ? replacement : asin(a[i]);
+            }
+          break;
+        case OP_ACOS:
+          for (i = 0; i < n; i++)
+            {
+            bool out = (a[i] < -1.0 || a[i] > 1.0);
+            invalid |= out;
+            r[i] = out ? replacement : acos(a[i]);
+            }
+          break;
+        case OP_ATAN:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = atan(a[i]);
+            }
+          break;
+        case OP_SINH:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = sinh(a[i]);
+            }
+          break;
+        case OP_COSH:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = cosh(a[i]);
+            }
+          break;
+        case OP_TANH:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = tanh(a[i]);
+            }
+          break;
+        case OP_SIGN:
+          for (i = 0; i < n; i++)
+            {
+            r[i] = a[i] > 0.0 ? 1.0 : (a[i] < 0.0 ? -1.0 : 0.0);
+            }
+          break;
+        }
+      if (invalid && !replace)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  struct vtkCalculatorThreadData
+    {
+    const vtkCalculatorProgram* Program;
+    vtkDataArray* const* Arrays;
+    vtkDataArray* Result;
+    vtkIdType NumberOfTuples;
+    bool Replace;
+    double Replacement;
+    int* Valid; // one per thread
+    };
+
+  void vtkCalculatorEvaluate(vtkCalculatorThreadData* data, int threadId,
+    int numThreads)
+    {
+    const vtkCalculatorProgram& program = *data->Program;
+    std::vector<double> registers(
+      program.RegisterSize * VTK_CALCULATOR_CHUNK_SIZE);
+    const vtkCalculatorInstruction& last = program.Instructions.back();
+    const double* result =
+      &registers[0] + last.Offset * VTK_CALCULATOR_CHUNK_SIZE;
+    vtkDataArray* output = data->Result;
+
+    vtkIdType numChunks = (data->NumberOfTuples + VTK_CALCULATOR_CHUNK_SIZE - 1)
+      / VTK_CALCULATOR_CHUNK_SIZE;
+    for (vtkIdType chunk = threadId; chunk < numChunks; chunk += numThreads)
+      {
+      vtkIdType start = chunk * VTK_CALCULATOR_CHUNK_SIZE;
+      vtkIdType n = data->NumberOfTuples - start;
+      if (n > VTK_CALCULATOR_CHUNK_SIZE)
+        {
+        n = VTK_CALCULATOR_CHUNK_SIZE;
+        }
+      if (!vtkCalculatorExecute(program, data->Arrays, start, n,
+          data->Replace, data->Replacement, &registers[0]))
+        {
+        data->Valid[threadId] = 0;
+        return;
+        }
+      switch (output->GetDataType())
+        {
+        vtkTemplateMacro(vtkCalculatorScatter(result, last.Width, start, n,
+            static_cast<VTK_TT*>(output->GetVoidPointer(0))));
+        }
+      }
+    }
+
+  VTK_THREAD_RETURN_TYPE vtkCalculatorThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkCalculatorEvaluate(static_cast<vtkCalculatorThreadData*>(info->UserData),
+      info->ThreadID, info->NumberOfThreads);
+    return VTK_THREAD_RETURN_VALUE;
+    }
 }
 
+class vtkPVArrayCalculator::vtkInternals
+{
+public:
+  vtkInternals() : Compiled(false) {}
+
+  // Function and variables the program was compiled for
+  std::string Key;
+  bool Compiled;
+  vtkCalculatorProgram Program;
+};
+
 vtkStandardNewMacro( vtkPVArrayCalculator );
 // ----------------------------------------------------------------------------
 vtkPVArrayCalculator::vtkPVArrayCalculator()
 {
+  this->CompiledEvaluation = 1;
+  this->Internals = new vtkInternals();
 }
 
 // ----------------------------------------------------------------------------
 vtkPVArrayCalculator::~vtkPVArrayCalculator()
 {
+  delete this->Internals;
 }
 
 // ----------------------------------------------------------------------------
@@ -184,6 +1210,12 @@ int vtkPVArrayCalculator::RequestData
     // put is the input of a (some) subsequent calculator(s) or the user changes
     // the input of a downstream calculator.
     this->UpdateArrayAndVariableNames( input, dataAttrs );
+
+    if ( this->CompiledEvaluation &&
+         this->ExecuteCompiled( input, dataAttrs, numTuples, outputVector ) )
+      {
+      return 1;
+      }
     }
   
   input      = NULL;
@@ -194,8 +1226,180 @@ int vtkPVArrayCalculator::RequestData
   return this->Superclass::RequestData( request, inputVector, outputVector );
 }
 
+// ----------------------------------------------------------------------------
+int vtkPVArrayCalculator::ExecuteCompiled
+  ( vtkDataObject * theInputObj, vtkDataSetAttributes * inDataAttrs,
+    vtkIdType numTuples, vtkInformationVector * outputVector )
+{
+  // Results that change the points or the active attributes are left to the
+  // superclass.
+  if ( !this->Function || !this->ResultArrayName || this->CoordinateResults ||
+       this->ResultNormals || this->ResultTCoords )
+    {
+    return 0;
+    }
+
+  vtkDataSet * dsInput    = vtkDataSet::SafeDownCast( theInputObj );
+  vtkGraph   * graphInput = vtkGraph::SafeDownCast( theInputObj );
+  bool pointMode;
+  if ( dsInput &&
+       ( this->AttributeMode == VTK_ATTRIBUTE_MODE_DEFAULT ||
+         this->AttributeMode == VTK_ATTRIBUTE_MODE_USE_POINT_DATA ||
+         this->AttributeMode == VTK_ATTRIBUTE_MODE_USE_CELL_DATA ) )
+    {
+    pointMode = this->AttributeMode != VTK_ATTRIBUTE_MODE_USE_CELL_DATA;
+    }
+  else if ( graphInput &&
+       ( this->AttributeMode == VTK_ATTRIBUTE_MODE_DEFAULT ||
+         this->AttributeMode == VTK_ATTRIBUTE_MODE_USE_VERTEX_DATA ||
+         this->AttributeMode == VTK_ATTRIBUTE_MODE_USE_EDGE_DATA ) )
+    {
+    pointMode = this->AttributeMode != VTK_ATTRIBUTE_MODE_USE_EDGE_DATA;
+    }
+  else
+    {
+    return 0;
+    }
+
+  // The program depends on the function and on the variables it may refer
+  // to, it is compiled again only when one of them changes.
+  std::map<std::string, vtkCalculatorVariable> variables;
+  vtksys_ios::ostringstream key;
+  key << this->Function;
+  int i;
+  for ( i = 0; i < this->NumberOfScalarArrays; i ++ )
+    {
+    vtkAddCalculatorVariable( variables, key, this->ScalarVariableNames[i],
+      this->ScalarArrayNames[i], 1, &this->SelectedScalarComponents[i] );
+    }
+  for ( i = 0; i < this->NumberOfVectorArrays; i ++ )
+    {
+    vtkAddCalculatorVariable( variables, key, this->VectorVariableNames[i],
+      this->VectorArrayNames[i], 3, this->SelectedVectorComponents[i] );
+    }
+  for ( i = 0; i < this->NumberOfCoordinateScalarArrays; i ++ )
+    {
+    vtkAddCalculatorVariable( variables, key,
+      this->CoordinateScalarVariableNames[i], NULL, 1,
+      &this->SelectedCoordinateScalarComponents[i] );
+    }
+  for ( i = 0; i < this->NumberOfCoordinateVectorArrays; i ++ )
+    {
+    vtkAddCalculatorVariable( variables, key,
+      this->CoordinateVectorVariableNames[i], NULL, 3,
+      this->SelectedCoordinateVectorComponents[i] );
+    }
+
+  vtkInternals* internals = this->Internals;
+  if ( internals->Key != key.str() )
+    {
+    internals->Key = key.str();
+    vtkCalculatorCompiler compiler( this->Function, variables,
+                                    internals->Program );
+    internals->Compiled = compiler.Compile();
+    }
+  if ( !internals->Compiled )
+    {
+    return 0;
+    }
+  const vtkCalculatorProgram & program = internals->Program;
+
+  // Bind the variables to the input arrays
+  vtkPointSet * psInput = vtkPointSet::SafeDownCast( theInputObj );
+  std::vector<vtkDataArray*> arrays( program.Variables.size() );
+  for ( size_t cc = 0; cc < program.Variables.size(); cc ++ )
+    {
+    const vtkCalculatorVariable & var = program.Variables[cc];
+    vtkDataArray * array = NULL;
+    if ( var.Coordinates )
+      {
+      if ( pointMode && psInput && psInput->GetPoints() )
+        {
+        array = psInput->GetPoints()->GetData();
+        }
+      }
+    else
+      {
+      array = inDataAttrs->GetArray( var.ArrayName.c_str() );
+      }
+    if ( !array || array->GetNumberOfTuples() < numTuples ||
+         !vtkCalculatorIsSupportedType( array->GetDataType() ) )
+      {
+      return 0;
+      }
+    for ( int c = 0; c < var.Width; c ++ )
+      {
+      if ( var.Components[c] < 0 ||
+           var.Components[c] >= array->GetNumberOfComponents() )
+        {
+        return 0;
+        }
+      }
+    arrays[cc] = array;
+    }
+
+  vtkSmartPointer<vtkDataArray> resultArray;
+  resultArray.TakeReference(
+    vtkDataArray::CreateDataArray( this->ResultArrayType ) );
+  if ( !resultArray ||
+       !vtkCalculatorIsSupportedType( resultArray->GetDataType() ) )
+    {
+    return 0;
+    }
+  resultArray->SetNumberOfComponents( program.Instructions.back().Width );
+  resultArray->SetNumberOfTuples( numTuples );
+  resultArray->SetName( this->ResultArrayName );
+
+  vtkPVMultiThreader * threader = vtkPVMultiThreader::New();
+  vtkIdType numChunks = ( numTuples + VTK_CALCULATOR_CHUNK_SIZE - 1 ) /
+                        VTK_CALCULATOR_CHUNK_SIZE;
+  int numThreads = threader->GetNumberOfThreadsFor( numChunks, 1 );
+
+  std::vector<int> valid( numThreads, 1 );
+  vtkCalculatorThreadData data;
+  data.Program        = &program;
+  data.Arrays         = arrays.empty() ? NULL : &arrays[0];
+  data.Result         = resultArray;
+  data.NumberOfTuples = numTuples;
+  data.Replace        = ( this->ReplaceInvalidValues != 0 );
+  data.Replacement    = this->ReplacementValue;
+  data.Valid          = &valid[0];
+  threader->Execute( numThreads, vtkCalculatorThread, &data );
+  threader->Delete();
+
+  // Let vtkFunctionParser report the invalid operations
+  if ( std::find( valid.begin(), valid.end(), 0 ) != valid.end() )
+    {
+    return 0;
+    }
+
+  vtkDataObject * output = outputVector->GetInformationObject( 0 )
+                           ->Get( vtkDataObject::DATA_OBJECT() );
+  vtkDataSetAttributes * outDataAttrs = NULL;
+  if ( dsInput )
+    {
+    vtkDataSet * dsOutput = vtkDataSet::SafeDownCast( output );
+    dsOutput->CopyStructure( dsInput );
+    dsOutput->CopyAttributes( dsInput );
+    outDataAttrs = pointMode ?
+      static_cast<vtkDataSetAttributes*>( dsOutput->GetPointData() ) :
+      static_cast<vtkDataSetAttributes*>( dsOutput->GetCellData() );
+    }
+  else
+    {
+    vtkGraph * graphOutput = vtkGraph::SafeDownCast( output );
+    graphOutput->ShallowCopy( graphInput );
+    outDataAttrs = pointMode ? graphOutput->GetVertexData() :
+                               graphOutput->GetEdgeData();
+    }
+  outDataAttrs->AddArray( resultArray );
+  outDataAttrs->SetActiveScalars( this->ResultArrayName );
+  return 1;
+}
+
 // ----------------------------------------------------------------------------
 void vtkPVArrayCalculator::PrintSelf( ostream & os, vtkIndent indent )
 {
   this->Superclass::PrintSelf( os, indent );
+  os << indent << "CompiledEvaluation: " << this->CompiledEvaluation << endl;
 }
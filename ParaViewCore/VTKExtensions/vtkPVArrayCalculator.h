@@ -24,6 +24,13 @@
 //  array can either be stored in a new array or it can overwrite an 
 //  existing array.
 //
+//  By default expressions are compiled into a program that evaluates whole
+//  arrays a chunk of tuples at a time, on several threads. The program is
+//  kept as long as the expression and the input arrays do not change, so
+//  that it is not parsed again for each block or timestep. Expressions the
+//  compiled mode does not handle, and inputs on which it would report
+//  invalid operations, are evaluated by vtkArrayCalculator.
+//
 // .SECTION See Also
 //  vtkArrayCalculator vtkFunctionParser
 
@@ -43,6 +50,13 @@ public:
 
   static vtkPVArrayCalculator * New();
 
+  // Description:
+  // When on, the default, evaluate the function with the compiled program
+  // when it can be, instead of tuple by tuple with vtkFunctionParser.
+  vtkSetMacro( CompiledEvaluation, int );
+  vtkGetMacro( CompiledEvaluation, int );
+  vtkBooleanMacro( CompiledEvaluation, int );
+
 protected:
   vtkPVArrayCalculator();
   ~vtkPVArrayCalculator();
@@ -60,6 +74,23 @@ protected:
   // RequestData() only.
   void    UpdateArrayAndVariableNames( vtkDataObject        * theInputObj, 
                                        vtkDataSetAttributes * inDataAttrs );
+
+  // Description:
+  // Evaluate the function with the compiled program and fill the output.
+  // Returns 0, leaving the output untouched, when the function or the input
+  // can not be handled that way.
+  int     ExecuteCompiled( vtkDataObject        * theInputObj,
+                           vtkDataSetAttributes * inDataAttrs,
+                           vtkIdType              numTuples,
+                           vtkInformationVector * outputVector );
+
+  int CompiledEvaluation;
+
+//BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+
 private:
   vtkPVArrayCalculator( const vtkPVArrayCalculator & ); // Not implemented.
   void operator = ( const vtkPVArrayCalculator & );     // Not implemented.
@@ -0,0 +1,77 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVMultiThreader.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVMultiThreader.h"
+
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkPVMultiThreader);
+//----------------------------------------------------------------------------
+vtkPVMultiThreader::vtkPVMultiThreader()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkPVMultiThreader::~vtkPVMultiThreader()
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkPVMultiThreader::GetNumberOfThreadsFor(vtkIdType size,
+  vtkIdType minimumSize)
+{
+  if (size < minimumSize)
+    {
+    return 1;
+    }
+  int numThreads = this->GetNumberOfThreads();
+  int maxThreads = vtkMultiThreader::GetGlobalMaximumNumberOfThreads();
+  if (maxThreads > 0 && numThreads > maxThreads)
+    {
+    numThreads = maxThreads;
+    }
+  if (size < numThreads)
+    {
+    numThreads = static_cast<int>(size);
+    }
+  return numThreads < 1 ? 1 : numThreads;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVMultiThreader::Execute(int numberOfThreads,
+  vtkThreadFunctionType method, void* data)
+{
+  if (numberOfThreads > 1)
+    {
+    this->SetNumberOfThreads(numberOfThreads);
+    this->SetSingleMethod(method, data);
+    this->SingleMethodExecute();
+    }
+  else
+    {
+    vtkMultiThreader::ThreadInfo info;
+    info.ThreadID = 0;
+    info.NumberOfThreads = 1;
+    info.ActiveFlag = NULL;
+    info.ActiveFlagLock = NULL;
+    info.UserData = data;
+    method(&info);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVMultiThreader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
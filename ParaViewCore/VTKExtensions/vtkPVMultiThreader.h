@@ -0,0 +1,56 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVMultiThreader.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVMultiThreader - runs a method over slices of some work.
+// .SECTION Description
+// vtkPVMultiThreader is used by filters that split their work into slices
+// processed by several threads. GetNumberOfThreadsFor() gives the number of
+// threads to use for some work: the NumberOfThreads of the threader, capped
+// by vtkMultiThreader::GetGlobalMaximumNumberOfThreads(), and a single thread
+// when the work is too small to be worth splitting. Execute() then runs the
+// method on that many threads, or directly in the calling thread when there
+// is only one, so that the method always gets a vtkMultiThreader::ThreadInfo.
+
+#ifndef __vtkPVMultiThreader_h
+#define __vtkPVMultiThreader_h
+
+#include "vtkMultiThreader.h"
+
+class VTK_EXPORT vtkPVMultiThreader : public vtkMultiThreader
+{
+public:
+  static vtkPVMultiThreader* New();
+  vtkTypeMacro(vtkPVMultiThreader, vtkMultiThreader);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Returns the number of threads to split size items over, 1 when size is
+  // smaller than minimumSize.
+  int GetNumberOfThreadsFor(vtkIdType size, vtkIdType minimumSize);
+
+  // Description:
+  // Calls method from numberOfThreads threads with data as UserData. It is
+  // called directly when numberOfThreads is 1.
+  void Execute(int numberOfThreads, vtkThreadFunctionType method, void* data);
+
+protected:
+  vtkPVMultiThreader();
+  ~vtkPVMultiThreader();
+
+private:
+  vtkPVMultiThreader(const vtkPVMultiThreader&); // Not implemented
+  void operator=(const vtkPVMultiThreader&); // Not implemented
+};
+
+#endif
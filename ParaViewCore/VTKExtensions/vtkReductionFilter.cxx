@@ -16,6 +16,8 @@
 
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
 #include "vtkDataObjectTypes.h"
 #include "vtkDataSet.h"
 #include "vtkGenericDataObjectReader.h"
@@ -33,6 +35,7 @@
 #include "vtkSmartPointer.h"
 #include "vtkSocketController.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStringArray.h"
 #include "vtkStructuredGrid.h"
 #include "vtkTable.h"
 #include "vtkToolkits.h"
@@ -41,6 +44,7 @@
 #include "vtkSelectionSerializer.h"
 
 #include <vtksys/ios/sstream>
+#include <string>
 #include <vector>
 
 vtkStandardNewMacro(vtkReductionFilter);
@@ -57,6 +61,8 @@ vtkReductionFilter::vtkReductionFilter()
   this->PostGatherHelper = 0;
   this->PassThrough = -1;
   this->GenerateProcessIds = 0;
+  this->PassSelectedArrays = 0;
+  this->SelectedArrays = vtkStringArray::New();
 }
 
 //-----------------------------------------------------------------------------
@@ -65,6 +71,7 @@ vtkReductionFilter::~vtkReductionFilter()
   this->SetPreGatherHelper(0);
   this->SetPostGatherHelper(0);
   this->SetController(0);
+  this->SelectedArrays->Delete();
 }
 
 //-----------------------------------------------------------------------------
@@ -90,6 +97,26 @@ void vtkReductionFilter::SetPostGatherHelperName(const char* name)
   this->SetPostGatherHelper(vtkAlgorithm::SafeDownCast(foo));
 }
 
+//-----------------------------------------------------------------------------
+void vtkReductionFilter::AddSelectedArray(const char* name)
+{
+  if (name)
+    {
+    this->SelectedArrays->InsertNextValue(name);
+    this->Modified();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkReductionFilter::ClearSelectedArrays()
+{
+  if (this->SelectedArrays->GetNumberOfTuples() > 0)
+    {
+    this->SelectedArrays->Initialize();
+    this->Modified();
+    }
+}
+
 //-----------------------------------------------------------------------------
 int vtkReductionFilter::RequestDataObject(
   vtkInformation* reqInfo,
@@ -235,9 +262,60 @@ vtkDataObject* vtkReductionFilter::PreProcess(vtkDataObject* input)
 
   vtkDataObject* clone = result->NewInstance();
   clone->ShallowCopy(result);
+  if (this->PassSelectedArrays)
+    {
+    this->RemoveUnselectedArrays(clone);
+    }
   return clone;
 }
 
+//-----------------------------------------------------------------------------
+void vtkReductionFilter::RemoveUnselectedArrays(vtkDataObject* data)
+{
+  vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data);
+  if (cd)
+    {
+    // The leaves are shared with the input, so strip shallow copies of them.
+    vtkCompositeDataIterator* iter = cd->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkDataObject* leaf = iter->GetCurrentDataObject()->NewInstance();
+      leaf->ShallowCopy(iter->GetCurrentDataObject());
+      this->RemoveUnselectedArrays(leaf);
+      cd->SetDataSet(iter, leaf);
+      leaf->Delete();
+      }
+    iter->Delete();
+    }
+
+  for (int type = 0; type < vtkDataObject::NUMBER_OF_ATTRIBUTE_TYPES; type++)
+    {
+    if (type == vtkDataObject::POINT_THEN_CELL)
+      {
+      continue;
+      }
+    vtkFieldData* fd = data->GetAttributesAsFieldData(type);
+    if (!fd)
+      {
+      continue;
+      }
+    std::vector<std::string> toRemove;
+    for (int cc = 0; cc < fd->GetNumberOfArrays(); cc++)
+      {
+      const char* name = fd->GetArrayName(cc);
+      if (name && this->SelectedArrays->LookupValue(name) < 0)
+        {
+        toRemove.push_back(name);
+        }
+      }
+    for (size_t cc = 0; cc < toRemove.size(); cc++)
+      {
+      fd->RemoveArray(toRemove[cc].c_str());
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkReductionFilter::PostProcess(vtkDataObject* output,
   vtkSmartPointer<vtkDataObject> inputs[], unsigned int num_inputs)
@@ -374,7 +452,7 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
           ds->ShallowCopy(preOutput);
           }
         }
-      else
+      else if (this->PassThrough < 0 || this->PassThrough == cc)
         {
         ds.TakeReference(this->Receive(cc, output->GetDataObjectType()));
         }
@@ -386,7 +464,10 @@ void vtkReductionFilter::Reduce(vtkDataObject* input, vtkDataObject* output)
     }
   else
     {
-    this->Send(0, preOutput);
+    if (this->PassThrough < 0 || this->PassThrough == myId)
+      {
+      this->Send(0, preOutput);
+      }
     if (preOutput)
       {
       data_sets.push_back(preOutput);
@@ -459,4 +540,5 @@ void vtkReductionFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Controller: " << this->Controller << endl;
   os << indent << "PassThrough: " << this->PassThrough << endl;
   os << indent << "GenerateProcessIds: " << this->GenerateProcessIds << endl;
+  os << indent << "PassSelectedArrays: " << this->PassSelectedArrays << endl;
 }
@@ -33,6 +33,7 @@
 #include "vtkDataObjectAlgorithm.h"
 #include "vtkSmartPointer.h" // needed for vtkSmartPointer.
 class vtkMultiProcessController;
+class vtkStringArray;
 
 class VTK_EXPORT vtkReductionFilter : public vtkDataObjectAlgorithm
 {
@@ -65,10 +66,22 @@ public:
   //Get/Set the PassThrough flag which (when set to a nonnegative number N) 
   //tells the filter to produce results that come from node N only. The 
   //data from that node still runs through the PreReduction and 
-  //PostGatherHelper algorithms.
+  //PostGatherHelper algorithms. Only node N sends its data to the root.
   vtkSetMacro(PassThrough, int);
   vtkGetMacro(PassThrough, int);
 
+  // Description:
+  // When PassSelectedArrays is set, the arrays that were not added with
+  // AddSelectedArray() are removed from the output of the pre-gather helper
+  // (or input) on every node, before it is sent to the root. This applies to
+  // all attributes (point, cell, field, row...) and to every block of
+  // composite datasets. Off by default.
+  vtkSetMacro(PassSelectedArrays, int);
+  vtkGetMacro(PassSelectedArrays, int);
+  vtkBooleanMacro(PassSelectedArrays, int);
+  void AddSelectedArray(const char* name);
+  void ClearSelectedArrays();
+
   // Description:
   // When set, a new array vtkOriginalProcessIds will be added
   // to the output of the the pre-gather helper (or input, if no pre-gather
@@ -99,6 +112,7 @@ protected:
 
   void Reduce(vtkDataObject* input, vtkDataObject* output);
   vtkDataObject* PreProcess(vtkDataObject* input);
+  void RemoveUnselectedArrays(vtkDataObject* data);
   void PostProcess(vtkDataObject* output,
     vtkSmartPointer<vtkDataObject> inputs[],
     unsigned int num_inputs);
@@ -111,6 +125,8 @@ protected:
   vtkMultiProcessController* Controller;
   int PassThrough;
   int GenerateProcessIds;
+  int PassSelectedArrays;
+  vtkStringArray* SelectedArrays;
 
 private:
   vtkReductionFilter(const vtkReductionFilter&); // Not implemented.
@@ -15,14 +15,15 @@
 #include "vtkMath.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkPointData.h"
+#include "vtkPVMultiThreader.h"
 #include "vtkStatisticsAlgorithm.h"
 #include "vtkStdString.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
-#include "vtkVariantArray.h"
 #include "vtkDataArray.h"
 
 #include <set>
+#include <vector>
 #include <vtksys/ios/sstream>
 
 vtkInformationKeyMacro(vtkSciVizStatistics, MULTIPLE_MODELS, Integer);
@@ -388,6 +389,102 @@ int vtkSciVizStatistics::RequestData(
   return stat;
 }
 
+namespace
+{
+  // Tables with less rows are filled by a single thread
+  const vtkIdType VTK_SVS_MIN_THREADED_SIZE = 100000;
+
+  // Table columns filled with values of a component of a data array.
+  struct vtkSVSGatherData
+    {
+    std::vector<vtkDataArray*> Sources;
+    std::vector<int> Components;
+    std::vector<vtkDataArray*> Columns;
+    const vtkIdType* Rows; // tuples to copy, all of them when NULL
+    vtkIdType NumberOfRows;
+    };
+
+  template <class T>
+  void vtkSVSGatherValues(const T* src, int numComps, int comp, T* dst,
+    const vtkIdType* rows, vtkIdType begin, vtkIdType end)
+    {
+    if (rows)
+      {
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        dst[i] = src[rows[i] * numComps + comp];
+        }
+      }
+    else
+      {
+      const T* ptr = src + begin * numComps + comp;
+      for (vtkIdType i = begin; i < end; ++i, ptr += numComps)
+        {
+        dst[i] = *ptr;
+        }
+      }
+    }
+
+  void vtkSVSGatherSlice(vtkSVSGatherData* gd, int threadId, int numThreads)
+    {
+    vtkIdType begin = (gd->NumberOfRows * threadId) / numThreads;
+    vtkIdType end = (gd->NumberOfRows * (threadId + 1)) / numThreads;
+    for (size_t c = 0; c < gd->Columns.size(); ++c)
+      {
+      vtkDataArray* src = gd->Sources[c];
+      vtkDataArray* dst = gd->Columns[c];
+      switch (dst->GetDataType())
+        {
+        vtkTemplateMacro(vtkSVSGatherValues(
+            static_cast<VTK_TT*>(src->GetVoidPointer(0)),
+            src->GetNumberOfComponents(), gd->Components[c],
+            static_cast<VTK_TT*>(dst->GetVoidPointer(0)), gd->Rows,
+            begin, end));
+        }
+      }
+    }
+
+  VTK_THREAD_RETURN_TYPE vtkSVSGatherThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkSVSGatherSlice(static_cast<vtkSVSGatherData*>(info->UserData),
+      info->ThreadID, info->NumberOfThreads);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // Copies the requested rows of every column, splitting the rows among
+  // threads. Columns must be allocated beforehand.
+  void vtkSVSGather(vtkSVSGatherData* gd)
+    {
+    if (gd->Columns.size() == 0 || gd->NumberOfRows == 0)
+      {
+      return;
+      }
+
+    vtkPVMultiThreader* threader = vtkPVMultiThreader::New();
+    int numThreads = threader->GetNumberOfThreadsFor(gd->NumberOfRows,
+      VTK_SVS_MIN_THREADED_SIZE);
+    threader->Execute(numThreads, vtkSVSGatherThread, gd);
+    threader->Delete();
+    }
+
+  // Chooses exactly m of the n rows in a single pass (selection sampling),
+  // so that rows are listed in increasing order without any lookup table.
+  void vtkSVSSampleRows(vtkIdType n, vtkIdType m, std::vector<vtkIdType>& rows)
+    {
+    rows.resize(m);
+    vtkIdType selected = 0;
+    for (vtkIdType i = 0; i < n && selected < m; ++i)
+      {
+      if ((n - i) * vtkMath::Random() < (m - selected))
+        {
+        rows[selected++] = i;
+        }
+      }
+    }
+}
+
 int vtkSciVizStatistics::RequestData(
     vtkDataObject* outData, vtkDataObject* outModel,
     vtkDataObject* inData, vtkDataObject* inModel )
@@ -399,13 +496,26 @@ int vtkSciVizStatistics::RequestData(
     return 1;
     }
 
-  // Create a table with all the data
-  vtkTable* inTable = vtkTable::New();
-  int stat = this->PrepareFullDataTable( inTable, dataAttrIn );
-  if ( stat < 1 )
-    { // return an error (stat=0) or success (stat=-1)
-    inTable->FastDelete();
-    return -stat;
+  vtkIdType N = this->GetNumberOfObservations( dataAttrIn );
+  if ( N < 0 )
+    {
+    vtkWarningMacro( "None of the requested arrays is present." )
+    return 1;
+    }
+
+  // The table with all the data is only needed for assessment or when training uses every observation.
+  // Arrays with a single component are referenced by the table, not copied.
+  vtkTable* inTable = 0;
+  int stat = 1;
+  if ( this->Task == ASSESS_INPUT || this->Task == MODEL_AND_ASSESS )
+    {
+    inTable = vtkTable::New();
+    stat = this->PrepareFullDataTable( inTable, dataAttrIn );
+    if ( stat < 1 )
+      { // return an error (stat=0) or success (stat=-1)
+      inTable->Delete();
+      return -stat;
+      }
     }
 
   // Either create or retrieve the model, depending on the task at hand
@@ -414,10 +524,14 @@ int vtkSciVizStatistics::RequestData(
     // We are creating a model by executing Learn and Derive operations on the input data
     // Create a table to hold the input data (unless the TrainingFraction is exactly 1.0)
     vtkTable* train = 0;
-    vtkIdType N = inTable->GetNumberOfRows();
-    vtkIdType M = this->Task == MODEL_INPUT ? N : this->GetNumberOfObservationsForTraining( inTable );
+    vtkIdType M = this->Task == MODEL_INPUT ? N : this->GetNumberOfObservationsForTraining( N );
     if ( M == N )
       {
+      if ( ! inTable )
+        {
+        inTable = vtkTable::New();
+        stat = this->PrepareFullDataTable( inTable, dataAttrIn );
+        }
       train = inTable;
       train->Register( this );
       if ( this->Task != MODEL_INPUT  && this->TrainingFraction < 1. )
@@ -430,21 +544,25 @@ int vtkSciVizStatistics::RequestData(
       }
     else
       {
+      // Only the sampled rows are copied from the input arrays.
       train = vtkTable::New();
-      this->PrepareTrainingTable( train, inTable, M );
+      stat = this->PrepareTrainingTable( train, dataAttrIn, M );
       }
 
-    // Calculate detailed statistical model from the input data set
-    vtkMultiBlockDataSet* outModelDS = vtkMultiBlockDataSet::SafeDownCast( outModel );
-    if ( ! outModelDS )
-      {
-      vtkErrorMacro( "No model output dataset or incorrect type" );
-      stat = 0;
-      }
-    else
+    if ( stat == 1 )
       {
-      outModel->Initialize();
-      stat = this->LearnAndDerive( outModelDS, train );
+      // Calculate detailed statistical model from the input data set
+      vtkMultiBlockDataSet* outModelDS = vtkMultiBlockDataSet::SafeDownCast( outModel );
+      if ( ! outModelDS )
+        {
+        vtkErrorMacro( "No model output dataset or incorrect type" );
+        stat = 0;
+        }
+      else
+        {
+        outModel->Initialize();
+        stat = this->LearnAndDerive( outModelDS, train );
+        }
       }
 
     if ( train )
@@ -466,7 +584,10 @@ int vtkSciVizStatistics::RequestData(
 
   if ( stat < 1 )
     { // Exit on failure (0) or early success (-1)
-    inTable->Delete();
+    if ( inTable )
+      {
+      inTable->Delete();
+      }
     return -stat;
     }
 
@@ -488,149 +609,156 @@ int vtkSciVizStatistics::RequestData(
       stat = this->AssessData( inTable, outData, outModelDS );
       }
     }
-  inTable->Delete();
+  if ( inTable )
+    {
+    inTable->Delete();
+    }
 
   return stat ? 1 : 0;
 }
 
 int vtkSciVizStatistics::PrepareFullDataTable( vtkTable* inTable, vtkFieldData* dataAttrIn )
 {
+  return this->PrepareTable( inTable, dataAttrIn, 0, this->GetNumberOfObservations( dataAttrIn ) );
+}
+
+int vtkSciVizStatistics::PrepareTrainingTable( vtkTable* trainingTable, vtkFieldData* dataAttrIn, vtkIdType M )
+{
+  // FIXME: this should eventually eliminate duplicate points as well as subsample...
+  //        but will require the original ugrid/polydata/graph.
+  std::vector<vtkIdType> trainRows;
+  vtkSVSSampleRows( this->GetNumberOfObservations( dataAttrIn ), M, trainRows );
+  return this->PrepareTable( trainingTable, dataAttrIn, M ? &trainRows[0] : 0, M );
+}
+
+int vtkSciVizStatistics::PrepareTable(
+  vtkTable* table, vtkFieldData* dataAttrIn, const vtkIdType* rows, vtkIdType numRows )
+{
+  table->Initialize();
+
+  // Columns of arrays with a native type are filled afterwards by several threads.
+  vtkSVSGatherData gd;
+  gd.Rows = rows;
+  gd.NumberOfRows = numRows;
+
   std::set<vtkStdString>::iterator colIt;
   for ( colIt = this->P->Buffer.begin(); colIt != this->P->Buffer.end(); ++ colIt )
     {
     vtkAbstractArray* arr = dataAttrIn->GetAbstractArray( colIt->c_str() );
-    if ( arr )
+    if ( ! arr )
+      {
+      continue;
+      }
+    int ncomp = arr->GetNumberOfComponents();
+    if ( ncomp == 1 && ! rows )
       {
-      vtkIdType ntup = arr->GetNumberOfTuples();
-      int ncomp = arr->GetNumberOfComponents();
+      // Scalar arrays are used as they are.
+      table->AddColumn( arr );
+      continue;
+      }
+
+    // Create a column in the table for each component of non-scalar arrays requested.
+    // FIXME: Should we add a "norm" column when arr is a vtkDataArray? It would make sense.
+    std::vector<vtkAbstractArray*> comps;
+    int i;
+    const char* compName;
+    for ( i = 0; i < ncomp; ++ i )
+      {
+      vtksys_ios::ostringstream os;
       if ( ncomp > 1 )
         {
-        // Create a column in the table for each component of non-scalar arrays requested.
-        // FIXME: Should we add a "norm" column when arr is a vtkDataArray? It would make sense.
-        std::vector<vtkAbstractArray*> comps;
-        int i;
-        const char* compName;
-        for ( i = 0; i < ncomp; ++ i )
-          {
-          vtksys_ios::ostringstream os;
-          compName = arr->GetComponentName( i );
-          os << arr->GetName() << "_";
-          ( compName ) ? os << compName : os << i;
-
-          vtkAbstractArray* arrCol = vtkAbstractArray::CreateArray( arr->GetDataType() );
-          arrCol->SetName( os.str().c_str() );
-          arrCol->SetNumberOfComponents( 1 );
-          arrCol->SetNumberOfTuples( ntup );
-          comps.push_back( arrCol );
-          inTable->AddColumn( arrCol );
-          arrCol->FastDelete();
-          }
-        vtkIdType vidx = 0;
-        vtkDataArray* darr = vtkDataArray::SafeDownCast( arr );
-        vtkStringArray* sarr = vtkStringArray::SafeDownCast( arr );
-        if ( darr )
-          {
-          for ( i = 0; i < ncomp; ++ i )
-            {
-            vtkDataArray::SafeDownCast( comps[i] )->CopyComponent( 0, darr, i );
-            }
-          }
-        else if ( sarr )
-          {
-          std::vector<vtkStringArray*> scomps;
-          for ( i = 0; i < ncomp; ++ i, ++vidx )
-            {
-            scomps[i] = vtkStringArray::SafeDownCast( comps[i] );
-            }
-          for ( vtkIdType j = 0; j < ntup; ++ j )
-            {
-            for ( i = 0; i < ncomp; ++ i, ++vidx )
-              {
-              scomps[i]->SetValue( j, sarr->GetValue( vidx ) );
-              }
-            }
-          }
-        else
+        compName = arr->GetComponentName( i );
+        os << arr->GetName() << "_";
+        ( compName ) ? os << compName : os << i;
+        }
+      else
+        {
+        os << arr->GetName();
+        }
+
+      vtkAbstractArray* arrCol = vtkAbstractArray::CreateArray( arr->GetDataType() );
+      arrCol->SetName( os.str().c_str() );
+      arrCol->SetNumberOfComponents( 1 );
+      arrCol->SetNumberOfTuples( numRows );
+      comps.push_back( arrCol );
+      table->AddColumn( arrCol );
+      arrCol->FastDelete();
+      }
+
+    vtkDataArray* darr = vtkDataArray::SafeDownCast( arr );
+    vtkStringArray* sarr = vtkStringArray::SafeDownCast( arr );
+    // Bit arrays do not store one value per element, they are copied below.
+    if ( darr && darr->GetDataType() != VTK_BIT )
+      {
+      for ( i = 0; i < ncomp; ++ i )
+        {
+        gd.Sources.push_back( darr );
+        gd.Components.push_back( i );
+        gd.Columns.push_back( vtkDataArray::SafeDownCast( comps[i] ) );
+        }
+      }
+    else if ( sarr )
+      {
+      std::vector<vtkStringArray*> scomps( ncomp );
+      for ( i = 0; i < ncomp; ++ i )
+        {
+        scomps[i] = vtkStringArray::SafeDownCast( comps[i] );
+        }
+      for ( vtkIdType j = 0; j < numRows; ++ j )
+        {
+        vtkIdType vidx = ( rows ? rows[j] : j ) * ncomp;
+        for ( i = 0; i < ncomp; ++ i, ++vidx )
           {
-          // Inefficient, but works for any array type.
-          for ( vtkIdType j = 0; j < ntup; ++ j )
-            {
-            for ( i = 0; i < ncomp; ++ i, ++vidx )
-              {
-              comps[i]->InsertVariantValue( j, arr->GetVariantValue( vidx ) );
-              }
-            }
+          scomps[i]->SetValue( j, sarr->GetValue( vidx ) );
           }
         }
-      else
+      }
+    else
+      {
+      // Inefficient, but works for any array type.
+      for ( vtkIdType j = 0; j < numRows; ++ j )
         {
-        inTable->AddColumn( arr );
+        vtkIdType vidx = ( rows ? rows[j] : j ) * ncomp;
+        for ( i = 0; i < ncomp; ++ i, ++vidx )
+          {
+          comps[i]->InsertVariantValue( j, arr->GetVariantValue( vidx ) );
+          }
         }
       }
     }
 
-  vtkIdType ncols = inTable->GetNumberOfColumns();
+  vtkIdType ncols = table->GetNumberOfColumns();
   if ( ncols < 1 )
     {
     vtkWarningMacro( "Every requested array wasn't a scalar or wasn't present." )
     return -1;
     }
 
+  ::vtkSVSGather( &gd );
   return 1;
 }
 
-int vtkSciVizStatistics::PrepareTrainingTable( vtkTable* trainingTable, vtkTable* fullDataTable, vtkIdType M )
+vtkIdType vtkSciVizStatistics::GetNumberOfObservations( vtkFieldData* dataAttrIn )
 {
-  // FIXME: this should eventually eliminate duplicate points as well as subsample...
-  //        but will require the original ugrid/polydata/graph.
-  std::set<vtkIdType> trainRows;
-  vtkIdType N = fullDataTable->GetNumberOfRows();
-  double frac = static_cast<double>( M ) / static_cast<double>( N );
-  for ( vtkIdType i = 0; i < N; ++ i )
+  std::set<vtkStdString>::iterator colIt;
+  for ( colIt = this->P->Buffer.begin(); colIt != this->P->Buffer.end(); ++ colIt )
     {
-    if ( vtkMath::Random() < frac )
+    vtkAbstractArray* arr = dataAttrIn->GetAbstractArray( colIt->c_str() );
+    if ( arr )
       {
-      trainRows.insert( i );
+      return arr->GetNumberOfTuples();
       }
     }
-  // Now add or subtract entries as required.
-  N = N - 1;
-  while ( static_cast<vtkIdType>(trainRows.size()) > M )
-    {
-    vtkIdType rec = static_cast<vtkIdType>( vtkMath::Random( 0, N ) );
-    trainRows.erase( rec );
-    }
-  while ( static_cast<vtkIdType>(trainRows.size()) < M )
-    {
-    vtkIdType rec = static_cast<vtkIdType>( vtkMath::Random( 0, N ) );
-    trainRows.insert( rec );
-    }
-  // Finally, copy the subset into the training table
-  trainingTable->Initialize();
-  for ( int i = 0; i < fullDataTable->GetNumberOfColumns(); ++ i )
-    {
-    vtkAbstractArray* srcCol = fullDataTable->GetColumn( i );
-    vtkAbstractArray* dstCol = vtkAbstractArray::CreateArray( srcCol->GetDataType() );
-    dstCol->SetName( srcCol->GetName() );
-    trainingTable->AddColumn( dstCol );
-    dstCol->FastDelete();
-    }
-  trainingTable->SetNumberOfRows( M );
-  vtkVariantArray* row = vtkVariantArray::New();
-  vtkIdType dstRow = 0;
-  for ( std::set<vtkIdType>::iterator it = trainRows.begin(); it != trainRows.end(); ++ it, ++ dstRow )
-    {
-    fullDataTable->GetRow( *it, row );
-    trainingTable->SetRow( dstRow, row );
-    }
-  row->Delete();
-  return 1;
+  return -1;
 }
 
-vtkIdType vtkSciVizStatistics::GetNumberOfObservationsForTraining( vtkTable* observations )
+vtkIdType vtkSciVizStatistics::GetNumberOfObservationsForTraining( vtkIdType N )
 {
-  vtkIdType N = observations->GetNumberOfRows();
   vtkIdType M = static_cast<vtkIdType>( N * this->TrainingFraction );
   return M < 100 ? ( N < 100 ? N : 100 ) : M;
 }
 
+vtkIdType vtkSciVizStatistics::GetNumberOfObservationsForTraining( vtkTable* observations )
+{
+  return this->GetNumberOfObservationsForTraining( observations->GetNumberOfRows() );
+}
@@ -79,9 +79,10 @@ public:
   // regardless of the value of TrainingFraction.
   // The default value is 0.1.
   //
-  // The random sample of the original dataset (say, of size N) is obtained by choosing N random numbers in [0,1).
-  // Any sample where the random number is less than \a TrainingFraction is included in the training data.
-  // Samples are then randomly added or removed from the training data until it is the desired size.
+  // The random sample of the original dataset (say, of size N) is obtained in a single pass over
+  // the observations: each one is kept with a probability equal to the number of samples still
+  // needed divided by the number of observations left, so that the sample has exactly the desired size.
+  // Only the sampled observations are copied from the input arrays into the training table.
   vtkSetClampMacro(TrainingFraction,double,0.0,1.0);
   vtkGetMacro(TrainingFraction,double);
 
@@ -134,8 +135,25 @@ protected:
     vtkDataObject* observationsOut, vtkDataObject* modelOut,
     vtkDataObject* observationsIn, vtkDataObject* modelIn );
 
+  // Description:
+  // Fill \a table with the selected arrays of \a dataAttrIn.
+  // Scalar arrays are added as they are while each component of other arrays becomes a column.
   virtual int PrepareFullDataTable( vtkTable* table, vtkFieldData* dataAttrIn );
-  virtual int PrepareTrainingTable( vtkTable* trainingTable, vtkTable* fullDataTable, vtkIdType numObservations );
+
+  // Description:
+  // Fill \a trainingTable with \a numObservations randomly sampled rows of the selected arrays of
+  // \a dataAttrIn, without creating a table of all the observations first.
+  virtual int PrepareTrainingTable( vtkTable* trainingTable, vtkFieldData* dataAttrIn, vtkIdType numObservations );
+
+  // Description:
+  // Fill \a table with the tuples \a rows (all of them when \a rows is NULL) of the selected arrays.
+  // Columns of arrays with a native type are filled by several threads when the table is large.
+  // Returns -1 when none of the selected arrays is present.
+  int PrepareTable( vtkTable* table, vtkFieldData* dataAttrIn, const vtkIdType* rows, vtkIdType numRows );
+
+  // Description:
+  // Returns the number of tuples of the selected arrays, or -1 if none of them is present.
+  vtkIdType GetNumberOfObservations( vtkFieldData* dataAttrIn );
 
   // Description:
   // Method subclasses <b>must</b> override to calculate a full model from the given input data.
@@ -159,10 +177,17 @@ protected:
   // Subclasses <b>may</b> (but need not) override this function to guarantee that
   // some minimum number of observations are included in the training data.
   // By default, it returns the maximum of:
-  //   observations->GetNumberOfRows() * this->TrainingFraction and
-  //   min( observations->GetNumberOfRows(), 100 ).
+  //   numObservations * this->TrainingFraction and
+  //   min( numObservations, 100 ).
   // Thus, it will require the entire set of observations unless there are more than 100.
   //
+  // @params[in] numObservations - the full number of available observations (in this process).
+  virtual vtkIdType GetNumberOfObservationsForTraining( vtkIdType numObservations );
+
+  // Description:
+  // Same as above, with the number of rows of \a observations.
+  // Kept for subclasses written against the former signature: it is not called by this class.
+  //
   // @params[in] observations - a table containing the full number of available observations (in this process).
   virtual vtkIdType GetNumberOfObservationsForTraining( vtkTable* observations );
 
@@ -44,6 +44,7 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkPVMergeTables.h"
+#include "vtkPVMultiThreader.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkDoubleArray.h"
@@ -54,6 +55,7 @@
 #include <set>
 
 #include <float.h>
+#include <string.h>
 
 #include <string>
 #include <vtksys/ios/sstream>
@@ -62,12 +64,89 @@ using vtksys_ios::ostringstream;
 #define MAX(a,b)		(((a)>(b)) ? (a) : (b))
 #define MIN(a,b)		(((a)<(b)) ? (a) : (b))
 //****************************************************************************
+namespace
+{
+  // Arrays smaller than that are sorted by a single thread
+  const vtkIdType VTK_THREADED_SORT_MIN_SIZE = 100000;
+
+  template<class Item, class Compare>
+  struct vtkThreadedSortData
+  {
+    Item* Array;
+    vtkIdType* Bounds;
+    Compare Comp;
+  };
+
+  template<class Item, class Compare>
+  VTK_THREAD_RETURN_TYPE vtkThreadedSortSlice(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkThreadedSortData<Item, Compare>* data =
+      static_cast<vtkThreadedSortData<Item, Compare>*>(info->UserData);
+    int id = info->ThreadID;
+    std::sort(data->Array + data->Bounds[id],
+              data->Array + data->Bounds[id + 1],
+              data->Comp);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // Each thread sorts a slice of the array, slices are then merged two by
+  // two.
+  template<class Item, class Compare>
+  void vtkThreadedSort(Item* array, vtkIdType size, Compare comp)
+    {
+    vtkPVMultiThreader* threader = vtkPVMultiThreader::New();
+    int numThreads = threader->GetNumberOfThreadsFor(size,
+      VTK_THREADED_SORT_MIN_SIZE);
+    if (numThreads < 2)
+      {
+      threader->Delete();
+      std::sort(array, array + size, comp);
+      return;
+      }
+
+    std::vector<vtkIdType> bounds(numThreads + 1);
+    for (int i=0; i <= numThreads; ++i)
+      {
+      bounds[i] = (size * i) / numThreads;
+      }
+    vtkThreadedSortData<Item, Compare> data;
+    data.Array = array;
+    data.Bounds = &bounds[0];
+    data.Comp = comp;
+    threader->Execute(numThreads, vtkThreadedSortSlice<Item, Compare>, &data);
+    threader->Delete();
+
+    for (int width=1; width < numThreads; width *= 2)
+      {
+      for (int i=0; i + width < numThreads; i += 2 * width)
+        {
+        std::inplace_merge(array + bounds[i],
+                           array + bounds[i + width],
+                           array + bounds[MIN(i + 2 * width, numThreads)],
+                           comp);
+        }
+      }
+    }
+}
+//****************************************************************************
+class vtkSortedTableStreamer::vtkColumnSet : public std::set<std::string>
+{
+};
+//****************************************************************************
 class vtkSortedTableStreamer::InternalsBase
 {
 public:
-  InternalsBase() {}
+  InternalsBase() { this->HiddenColumns = 0; this->SampleSort = false; }
   virtual ~InternalsBase() {}
 
+  // Columns the user does not want in the output
+  const vtkColumnSet* HiddenColumns;
+
+  // Compute the global rank of every row with a sample sort
+  bool SampleSort;
+
   virtual void SetSelectedComponent(int newValue) = 0;
   virtual void InvalidateCache() = 0;
   virtual int  Extract( vtkTable* input, vtkTable* output,
@@ -79,6 +158,53 @@ public:
   virtual bool IsInvalid(vtkTable* input, vtkDataArray* dataToProcess) = 0;
   virtual bool IsSortable() = 0;
   virtual bool TestInternalClasses() = 0;
+  virtual vtkIdType FindRow( vtkTable* input, vtkDataArray* column,
+                             int component, double range[2],
+                             vtkIdType startRow, bool sortedColumn,
+                             vtkIdType blockSize, bool revertOrder) = 0;
+
+  // --------------------------------------------------------------------------
+  // Hidden columns that can really be left out of the output.
+  void GetSkippedColumns(const char* sortedColumn,
+                         std::set<std::string>& skipped)
+    {
+    skipped.clear();
+    if(!this->HiddenColumns)
+      {
+      return;
+      }
+    skipped.insert(this->HiddenColumns->begin(), this->HiddenColumns->end());
+    skipped.erase("vtkOriginalIndices");
+    skipped.erase("vtkOriginalProcessIds");
+    skipped.erase("vtkCompositeIndexArray");
+    skipped.erase("__vtkIsSelected__");
+    if(sortedColumn)
+      {
+      skipped.erase(sortedColumn);
+      }
+    }
+
+  // --------------------------------------------------------------------------
+  static bool IsInRange(vtkDataArray* array, vtkIdType row, int component,
+                        const double range[2])
+    {
+    double value = 0;
+    int numComponents = array->GetNumberOfComponents();
+    if(component < 0 && numComponents > 1)
+      {
+      for(int k=0; k < numComponents; ++k)
+        {
+        double tmp = array->GetComponent(row, k);
+        value += tmp*tmp;
+        }
+      value = sqrt(value);
+      }
+    else
+      {
+      value = array->GetComponent(row, (component < 0) ? 0 : component);
+      }
+    return value >= range[0] && value <= range[1];
+    }
 
   // --------------------------------------------------------------------------
 //  static void WaitForGDB()
@@ -530,11 +656,11 @@ public:
       // Sort it
       if(reverseOrder)
         {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
+        vtkThreadedSort(this->Array, this->ArraySize, SortableArrayItem::Ascendent);
         }
       else
         {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
+        vtkThreadedSort(this->Array, this->ArraySize, SortableArrayItem::Descendent);
         }
       }
 
@@ -564,14 +690,67 @@ public:
       // Sort it
       if(reverseOrder)
         {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
+        vtkThreadedSort(this->Array, this->ArraySize, SortableArrayItem::Ascendent);
         }
       else
         {
-        std::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
+        vtkThreadedSort(this->Array, this->ArraySize, SortableArrayItem::Descendent);
         }
       }
   };
+  // Compare sorted items with a searched value, to bisect a sorted array
+  // in increasing (ValueLess) or decreasing (ValueGreater) order.
+  struct ValueLess
+  {
+    bool operator()(const SortableArrayItem& a, double value) const
+      {
+      return static_cast<double>(a.Value) < value;
+      }
+    bool operator()(double value, const SortableArrayItem& a) const
+      {
+      return value < static_cast<double>(a.Value);
+      }
+  };
+  struct ValueGreater
+  {
+    bool operator()(const SortableArrayItem& a, double value) const
+      {
+      return static_cast<double>(a.Value) > value;
+      }
+    bool operator()(double value, const SortableArrayItem& a) const
+      {
+      return value > static_cast<double>(a.Value);
+      }
+  };
+  // Item exchanged by the sample sort. Items are ordered by value, then by
+  // process and index, so each one has a distinct rank consistent with the
+  // order of the local sorted arrays.
+  class RankedItem
+  {
+  public:
+    T Value;
+    vtkIdType ProcessId;
+    vtkIdType Index;
+
+    static bool Increasing(const RankedItem& a, const RankedItem& b)
+      {
+      if (a.Value != b.Value)
+        {
+        return a.Value < b.Value;
+        }
+      if (a.ProcessId != b.ProcessId)
+        {
+        return a.ProcessId < b.ProcessId;
+        }
+      return a.Index < b.Index;
+      }
+
+    static bool Decreasing(const RankedItem& a, const RankedItem& b)
+      {
+      return Increasing(b, a);
+      }
+  };
+  typedef bool (*RankedItemCompare)(const RankedItem&, const RankedItem&);
 
 public:
 
@@ -581,6 +760,8 @@ public:
     this->LocalSorter = 0;
     this->GlobalHistogram = 0;
     this->Debug = false;
+    this->ProcessOrder = false;
+    this->HasGlobalRanks = false;
     }
 
   Internals( vtkTable* input, vtkDataArray* dataToSort,
@@ -589,6 +770,8 @@ public:
     // Default values
     this->SelectedComponent = 0;
     this->NeedToBuildCache = true;
+    this->ProcessOrder = false;
+    this->HasGlobalRanks = false;
     this->DataToSort = dataToSort;
 
     this->InputMTime = input->GetMTime();
@@ -683,6 +866,7 @@ public:
     {
     // We are building the cache so no need to build it next time
     this->NeedToBuildCache = false;
+    this->HasGlobalRanks = false;
 
     // Communication buffer
     vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs *  HISTOGRAM_SIZE];
@@ -756,11 +940,16 @@ public:
       {
       this->BuildCache(false, revertOrder);
       }
+    this->ProcessOrder = true;
 
+    std::set<std::string> skipped;
+    this->GetSkippedColumns(
+      this->DataToSort ? this->DataToSort->GetName() : NULL, skipped);
 
     // Build empty local table with empty arrays so they stay in the same order
     vtkSmartPointer<vtkTable> localResult;
-    localResult.TakeReference(NewSubsetTable(input, NULL, 0, blockSize));
+    localResult.TakeReference(NewSubsetTable(input, NULL, 0, blockSize,
+                                             &skipped));
 
     // Get the array size of each processes
     vtkIdType* tableSizes = new vtkIdType[this->NumProcs];
@@ -804,7 +993,8 @@ public:
     localResult.TakeReference(this->NewSubsetTable(input,
                                                    this->LocalSorter,
                                                    localOffset,
-                                                   localSize));
+                                                   localSize,
+                                                   &skipped));
 
     // Free array used for MPI exchange
     delete[] tableSizes;
@@ -902,6 +1092,16 @@ public:
       {
       this->BuildCache(true, revertOrder);
       }
+    this->ProcessOrder = false;
+
+    if(this->SampleSort)
+      {
+      if(!this->HasGlobalRanks)
+        {
+        this->BuildGlobalRanks(revertOrder);
+        }
+      return this->ComputeFromGlobalRanks(input, output, block, blockSize);
+      }
 
     // ------------------------------------------------------------------------
     // Search for lower bound
@@ -942,11 +1142,16 @@ public:
     // ------------------------------------------------------------------------
     // Build local subset table
     // ------------------------------------------------------------------------
+    std::set<std::string> skipped;
+    this->GetSkippedColumns(
+      this->DataToSort ? this->DataToSort->GetName() : NULL, skipped);
+
     vtkSmartPointer<vtkTable> localSubset;
     localSubset.TakeReference( this->NewSubsetTable( input,
                                                      this->LocalSorter,
                                                      localOffset,
-                                                     localSize));
+                                                     localSize,
+                                                     &skipped));
 
     // ------------------------------------------------------------------------
     // Find the process that will merge all subset table
@@ -1038,6 +1243,296 @@ public:
     return 1;
     }
 
+  // --------------------------------------------------------------------------
+  RankedItem GetRankedItem(vtkIdType localIdx)
+    {
+    RankedItem item;
+    item.Value = this->LocalSorter->Array[localIdx].Value;
+    item.ProcessId = this->Me;
+    item.Index = this->LocalSorter->Array[localIdx].OriginalIndex;
+    return item;
+    }
+
+  // --------------------------------------------------------------------------
+  // Exchange variable size buffers between all processes. In round r,
+  // process i talks to (r - i) mod NumProcs, the lowest id of each pair
+  // sending first, so that blocking communications can not deadlock.
+  void ExchangeBuffers(const char* sendBuffer, const vtkIdType* sendOffsets,
+                       const vtkIdType* sendLengths, char* recvBuffer,
+                       const vtkIdType* recvOffsets,
+                       const vtkIdType* recvLengths)
+    {
+    for(int round=0; round < this->NumProcs; ++round)
+      {
+      int partner = ((round - this->Me) % this->NumProcs + this->NumProcs)
+                    % this->NumProcs;
+      if(partner == this->Me)
+        {
+        if(sendLengths[partner] > 0)
+          {
+          memcpy(recvBuffer + recvOffsets[partner],
+                 sendBuffer + sendOffsets[partner], sendLengths[partner]);
+          }
+        continue;
+        }
+      for(int step=0; step < 2; ++step)
+        {
+        bool sending = (step == 0) == (this->Me < partner);
+        if(sending && sendLengths[partner] > 0)
+          {
+          this->MPI->Send(sendBuffer + sendOffsets[partner],
+                          sendLengths[partner], partner,
+                          VTK_SAMPLE_SORT_TAG);
+          }
+        else if(!sending && recvLengths[partner] > 0)
+          {
+          this->MPI->Receive(recvBuffer + recvOffsets[partner],
+                             recvLengths[partner], partner,
+                             VTK_SAMPLE_SORT_TAG);
+          }
+        }
+      }
+    }
+
+  // --------------------------------------------------------------------------
+  // Sample sort of the sorted local arrays. Regular samples of every process
+  // give NumProcs-1 splitters, each process receives the items that fall
+  // between two of them and sorts them, which gives their global rank. The
+  // ranks are sent back so that every process knows the rank of its rows,
+  // in local sorted order. Fetching a block is then a lookup in GlobalRanks.
+  void BuildGlobalRanks(bool revertOrder)
+    {
+    this->HasGlobalRanks = true;
+    this->GlobalRanks.clear();
+
+    RankedItemCompare comp =
+      revertOrder ? RankedItem::Decreasing : RankedItem::Increasing;
+    int numProcs = this->NumProcs;
+    vtkIdType localSize = (this->DataToSort && this->LocalSorter->Array) ?
+                          this->LocalSorter->ArraySize : 0;
+
+    // Regular samples, processes without data send invalid ones
+    std::vector<RankedItem> localSamples(numProcs);
+    for(int j=0; j < numProcs; ++j)
+      {
+      if(localSize > 0)
+        {
+        localSamples[j] = this->GetRankedItem((j * localSize) / numProcs);
+        }
+      else
+        {
+        memset(&localSamples[j], 0, sizeof(RankedItem));
+        localSamples[j].ProcessId = -1;
+        }
+      }
+    std::vector<RankedItem> allSamples(numProcs * numProcs);
+    this->MPI->AllGather(reinterpret_cast<char*>(&localSamples[0]),
+                         reinterpret_cast<char*>(&allSamples[0]),
+                         numProcs * sizeof(RankedItem));
+
+    std::vector<RankedItem> samples;
+    for(size_t j=0; j < allSamples.size(); ++j)
+      {
+      if(allSamples[j].ProcessId >= 0)
+        {
+        samples.push_back(allSamples[j]);
+        }
+      }
+    if(samples.empty())
+      {
+      return; // Nothing to sort anywhere
+      }
+    std::sort(samples.begin(), samples.end(), comp);
+
+    // Split the local sorted array, bucket k goes to process k
+    std::vector<vtkIdType> bounds(numProcs + 1, 0);
+    bounds[numProcs] = localSize;
+    for(int k=1; k < numProcs; ++k)
+      {
+      const RankedItem& splitter = samples[(k * samples.size()) / numProcs];
+      vtkIdType lower = bounds[k-1];
+      vtkIdType upper = localSize;
+      while(lower < upper)
+        {
+        vtkIdType middle = (lower + upper) / 2;
+        if(comp(splitter, this->GetRankedItem(middle)))
+          {
+          upper = middle;
+          }
+        else
+          {
+          lower = middle + 1;
+          }
+        }
+      bounds[k] = lower;
+      }
+
+    std::vector<vtkIdType> sendCounts(numProcs);
+    for(int k=0; k < numProcs; ++k)
+      {
+      sendCounts[k] = bounds[k+1] - bounds[k];
+      }
+    std::vector<vtkIdType> allCounts(numProcs * numProcs);
+    this->MPI->AllGather(&sendCounts[0], &allCounts[0], numProcs);
+
+    // Items sent to or received from every process, in bytes
+    const vtkIdType itemSize = sizeof(RankedItem);
+    std::vector<vtkIdType> sendOffsets(numProcs), sendLengths(numProcs);
+    std::vector<vtkIdType> recvOffsets(numProcs), recvLengths(numProcs);
+    vtkIdType nbReceived = 0;
+    vtkIdType rankOffset = 0;
+    for(int k=0; k < numProcs; ++k)
+      {
+      sendOffsets[k] = bounds[k] * itemSize;
+      sendLengths[k] = sendCounts[k] * itemSize;
+      recvOffsets[k] = nbReceived * itemSize;
+      recvLengths[k] = allCounts[k * numProcs + this->Me] * itemSize;
+      nbReceived += allCounts[k * numProcs + this->Me];
+      for(int dst=0; dst < this->Me; ++dst)
+        {
+        rankOffset += allCounts[k * numProcs + dst];
+        }
+      }
+
+    std::vector<RankedItem> sent(localSize + 1);
+    for(vtkIdType idx=0; idx < localSize; ++idx)
+      {
+      sent[idx] = this->GetRankedItem(idx);
+      }
+    std::vector<RankedItem> received(nbReceived + 1);
+    this->ExchangeBuffers(reinterpret_cast<char*>(&sent[0]),
+                          &sendOffsets[0], &sendLengths[0],
+                          reinterpret_cast<char*>(&received[0]),
+                          &recvOffsets[0], &recvLengths[0]);
+    vtkThreadedSort(&received[0], nbReceived, comp);
+
+    // Send back the ranks, in the order the items were received from each
+    // process, which is their local sorted order.
+    std::vector<vtkIdType> ranks(nbReceived + 1);
+    std::vector<vtkIdType> next(numProcs);
+    for(int k=0; k < numProcs; ++k)
+      {
+      next[k] = recvOffsets[k] / itemSize;
+      }
+    for(vtkIdType idx=0; idx < nbReceived; ++idx)
+      {
+      ranks[next[received[idx].ProcessId]++] = rankOffset + idx;
+      }
+
+    const vtkIdType rankSize = sizeof(vtkIdType);
+    for(int k=0; k < numProcs; ++k)
+      {
+      sendOffsets[k] = (recvOffsets[k] / itemSize) * rankSize;
+      sendLengths[k] = (recvLengths[k] / itemSize) * rankSize;
+      recvOffsets[k] = bounds[k] * rankSize;
+      recvLengths[k] = sendCounts[k] * rankSize;
+      }
+    this->GlobalRanks.resize(localSize + 1);
+    this->ExchangeBuffers(reinterpret_cast<char*>(&ranks[0]),
+                          &sendOffsets[0], &sendLengths[0],
+                          reinterpret_cast<char*>(&this->GlobalRanks[0]),
+                          &recvOffsets[0], &recvLengths[0]);
+    this->GlobalRanks.resize(localSize);
+    }
+
+  // --------------------------------------------------------------------------
+  // Rows of the block are the local rows whose global rank is in the block.
+  // The merging process orders them by rank.
+  int ComputeFromGlobalRanks(vtkTable* input, vtkTable* output,
+                             vtkIdType block, vtkIdType blockSize)
+    {
+    vtkIdType localOffset = 0;
+    vtkIdType localSize = 0;
+    if(!this->GlobalRanks.empty())
+      {
+      const vtkIdType* begin = &this->GlobalRanks[0];
+      const vtkIdType* end = begin + this->GlobalRanks.size();
+      const vtkIdType* first = std::lower_bound(begin, end, block * blockSize);
+      const vtkIdType* last =
+        std::lower_bound(first, end, (block + 1) * blockSize);
+      localOffset = first - begin;
+      localSize = last - first;
+      }
+
+    std::set<std::string> skipped;
+    this->GetSkippedColumns(
+      this->DataToSort ? this->DataToSort->GetName() : NULL, skipped);
+
+    vtkSmartPointer<vtkTable> localSubset;
+    localSubset.TakeReference( this->NewSubsetTable( input,
+                                                     this->LocalSorter,
+                                                     localOffset,
+                                                     localSize,
+                                                     &skipped));
+    vtkIdTypeArray* rankArray = vtkIdTypeArray::New();
+    rankArray->SetName("vtkGlobalRanks");
+    rankArray->SetNumberOfTuples(localSize);
+    for(vtkIdType idx=0; idx < localSize; ++idx)
+      {
+      rankArray->SetValue(idx, this->GlobalRanks[localOffset + idx]);
+      }
+    localSubset->GetRowData()->AddArray(rankArray);
+    rankArray->Delete();
+
+    int mergePid = GetMergingProcessId(localSubset.GetPointer());
+    if(this->Me != mergePid)
+      {
+      this->MPI->Send(localSubset.GetPointer(), mergePid, VTK_TABLE_EXCHANGE_TAG);
+      this->DecorateTable(input, NULL, mergePid);
+      return 1;
+      }
+
+    if(this->NumProcs > 1)
+      {
+      vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
+      processIdArray->SetName("vtkOriginalProcessIds");
+      processIdArray->SetNumberOfComponents(1);
+      processIdArray->Allocate(blockSize);
+      for(vtkIdType idx=0; idx < localSubset->GetNumberOfRows(); idx++)
+        {
+        processIdArray->InsertNextTuple1(mergePid);
+        }
+      localSubset->GetRowData()->AddArray(processIdArray);
+      }
+
+    vtkSmartPointer<vtkTable> tmp = vtkSmartPointer<vtkTable>::New();
+    for(int i=0; i < this->NumProcs; i++)
+      {
+      if(i == mergePid)
+        continue;
+
+      this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
+      this->MergeTable(i,tmp.GetPointer(),localSubset.GetPointer(),blockSize);
+      }
+
+    // Order the merged rows by rank
+    vtkIdTypeArray* mergedRanks = vtkIdTypeArray::SafeDownCast(
+      localSubset->GetColumnByName("vtkGlobalRanks"));
+    vtkIdType nbRows = mergedRanks ? mergedRanks->GetNumberOfTuples() : 0;
+    std::vector<std::pair<vtkIdType, vtkIdType> > order(nbRows);
+    for(vtkIdType idx=0; idx < nbRows; ++idx)
+      {
+      order[idx] = std::pair<vtkIdType, vtkIdType>(mergedRanks->GetValue(idx), idx);
+      }
+    std::sort(order.begin(), order.end());
+    ArraySorter sorter;
+    sorter.FillArray(nbRows);
+    for(vtkIdType idx=0; idx < nbRows; ++idx)
+      {
+      sorter.Array[idx].OriginalIndex = order[idx].second;
+      }
+    localSubset.TakeReference(
+      this->NewSubsetTable(localSubset.GetPointer(), &sorter, 0, nbRows));
+    localSubset->RemoveColumnByName("vtkGlobalRanks");
+
+    // Add extra information such as structured indices, block number...
+    this->DecorateTable(input, localSubset.GetPointer(), mergePid);
+
+    // ShallowCopy it to the output
+    output->ShallowCopy(localSubset.GetPointer());
+    return 1;
+    }
+
   // --------------------------------------------------------------------------
   // nbGlobalToSkip is the number of elements that should be skiped at the end
   // if you exactly want to reach the searchedGlobalIndex.
@@ -1117,7 +1612,8 @@ public:
   static vtkTable* NewSubsetTable( vtkTable* srcTable,
                             ArraySorter* sorter,
                             vtkIdType offset,
-                            vtkIdType size)
+                            vtkIdType size,
+                            const std::set<std::string>* skipped = NULL)
     {
     vtkTable* subTable = vtkTable::New();
 
@@ -1125,6 +1621,11 @@ public:
     for(vtkIdType colIdx=0; colIdx < srcTable->GetNumberOfColumns(); ++colIdx)
       {
       vtkAbstractArray* srcArray = srcTable->GetColumn(colIdx);
+      if(skipped && srcArray->GetName() &&
+         skipped->find(srcArray->GetName()) != skipped->end())
+        {
+        continue;
+        }
 
       // Manage subset items
       vtkAbstractArray* subArray = srcArray->NewInstance();
@@ -1372,6 +1873,280 @@ public:
 
     return true;
   }
+  // --------------------------------------------------------------------------
+  vtkIdType FindRow(vtkTable* input, vtkDataArray* column, int component,
+                    double range[2], vtkIdType startRow, bool sortedColumn,
+                    vtkIdType blockSize, bool revertOrder)
+    {
+    startRow = MAX(startRow, 0);
+    if(this->ProcessOrder)
+      {
+      return this->FindRowInProcessOrder(input, column, component, range,
+                                         startRow, blockSize, revertOrder);
+      }
+    if(sortedColumn)
+      {
+      return this->FindRowInSortedColumn(range, startRow, revertOrder);
+      }
+    if(this->HasGlobalRanks)
+      {
+      return this->FindRowWithGlobalRanks(column, component, range, startRow);
+      }
+    return this->FindRowInSortedTable(column, component, range, startRow,
+                                      revertOrder);
+    }
+
+  // --------------------------------------------------------------------------
+  // Ranks grow along the local sorted order, so the first local match after
+  // startRow is the best local candidate.
+  vtkIdType FindRowWithGlobalRanks(vtkDataArray* column, int component,
+                                   double range[2], vtkIdType startRow)
+    {
+    vtkIdType found = VTK_ID_MAX;
+    if(column && !this->GlobalRanks.empty())
+      {
+      vtkIdType size = static_cast<vtkIdType>(this->GlobalRanks.size());
+      vtkIdType idx = std::lower_bound(this->GlobalRanks.begin(),
+                                       this->GlobalRanks.end(), startRow) -
+                      this->GlobalRanks.begin();
+      for(; idx < size; ++idx)
+        {
+        if(IsInRange(column, this->LocalSorter->Array[idx].OriginalIndex,
+                     component, range))
+          {
+          found = this->GlobalRanks[idx];
+          break;
+          }
+        }
+      }
+
+    vtkIdType globalFound = VTK_ID_MAX;
+    this->MPI->AllReduce(&found, &globalFound, 1, vtkCommunicator::MIN_OP);
+    return (globalFound == VTK_ID_MAX) ? -1 : globalFound;
+    }
+
+  // --------------------------------------------------------------------------
+  // Rows in range are contiguous in the sorted order, so they start after
+  // every row sorted before the range.
+  vtkIdType FindRowInSortedColumn(double range[2], vtkIdType startRow,
+                                  bool revertOrder)
+    {
+    vtkIdType localCounts[2] = {0, 0}; // Before the range, in the range
+    vtkIdType globalCounts[2] = {0, 0};
+    if(this->DataToSort && this->LocalSorter->Array)
+      {
+      double lower = range[0];
+      double upper = range[1];
+      int numComponents = this->DataToSort->GetNumberOfComponents();
+      if(this->SelectedComponent < 0 && numComponents > 1)
+        {
+        // Sorted magnitudes are scaled down to fit in the type (see Update)
+        lower /= sqrt(static_cast<double>(numComponents));
+        upper /= sqrt(static_cast<double>(numComponents));
+        }
+      SortableArrayItem* begin = this->LocalSorter->Array;
+      SortableArrayItem* end = begin + this->LocalSorter->ArraySize;
+      SortableArrayItem* first;
+      SortableArrayItem* last;
+      if(revertOrder)
+        {
+        first = std::lower_bound(begin, end, upper, ValueGreater());
+        last = std::upper_bound(first, end, lower, ValueGreater());
+        }
+      else
+        {
+        first = std::lower_bound(begin, end, lower, ValueLess());
+        last = std::upper_bound(first, end, upper, ValueLess());
+        }
+      localCounts[0] = first - begin;
+      localCounts[1] = last - first;
+      }
+    this->MPI->AllReduce(localCounts, globalCounts, 2,
+                         vtkCommunicator::SUM_OP);
+
+    vtkIdType row = MAX(globalCounts[0], startRow);
+    return (row < globalCounts[0] + globalCounts[1]) ? row : -1;
+    }
+
+  // --------------------------------------------------------------------------
+  // Same layout as Extract(): processes follow each other, and when the
+  // order is inverted each process part of a block is reversed.
+  vtkIdType FindRowInProcessOrder(vtkTable* input, vtkDataArray* column,
+                                  int component, double range[2],
+                                  vtkIdType startRow, vtkIdType blockSize,
+                                  bool revertOrder)
+    {
+    vtkIdType* tableSizes = new vtkIdType[this->NumProcs];
+    vtkIdType nbElems = input->GetNumberOfRows();
+    this->MPI->AllGather(&nbElems, tableSizes, 1);
+    vtkIdType processOffset = 0;
+    if(revertOrder)
+      {
+      for(int i=this->NumProcs-1;this->Me < i;i--)
+        {
+        processOffset += tableSizes[i];
+        }
+      }
+    else
+      {
+      for(int i=0;i<this->Me;i++)
+        {
+        processOffset += tableSizes[i];
+        }
+      }
+    delete[] tableSizes;
+
+    vtkIdType found = VTK_ID_MAX;
+    if(column && blockSize > 0)
+      {
+      vtkIdType idx =
+        MAX(0, (startRow / blockSize) * blockSize - processOffset);
+      for(; idx < nbElems; ++idx)
+        {
+        vtkIdType globalIdx = processOffset + idx;
+        vtkIdType blockStart = (globalIdx / blockSize) * blockSize;
+        if(blockStart > found)
+          {
+          break;
+          }
+        if(!IsInRange(column, idx, component, range))
+          {
+          continue;
+          }
+        vtkIdType row = globalIdx;
+        if(revertOrder)
+          {
+          vtkIdType partStart = MAX(blockStart, processOffset);
+          vtkIdType partEnd = MIN(blockStart + blockSize,
+                                  processOffset + nbElems);
+          row = partStart + (partEnd - 1 - globalIdx);
+          }
+        if(row >= startRow && row < found)
+          {
+          found = row;
+          }
+        }
+      }
+
+    vtkIdType globalFound = VTK_ID_MAX;
+    this->MPI->AllReduce(&found, &globalFound, 1, vtkCommunicator::MIN_OP);
+    return (globalFound == VTK_ID_MAX) ? -1 : globalFound;
+    }
+
+  // --------------------------------------------------------------------------
+  // Look for the first match in the local sorted order of each process, and
+  // keep the one with the lowest sorted value (highest if inverted). Rows
+  // sharing that value come process by process (last process first if
+  // inverted), by increasing original id, so the run of that value is walked
+  // to locate the first match at or after startRow. If there is none, the
+  // search goes on with the next value.
+  vtkIdType FindRowInSortedTable(vtkDataArray* column, int component,
+                                 double range[2], vtkIdType startRow,
+                                 bool revertOrder)
+    {
+    if(startRow >= this->GlobalHistogram->TotalValues)
+      {
+      return -1;
+      }
+
+    // Rows in the histogram bars before the one of startRow come before it
+    vtkIdType nbGlobalToSkip = 0;
+    vtkIdType localOffset = 0;
+    vtkIdType nbInLocalBar = 0;
+    this->SearchGlobalIndexLocation(startRow,
+                                    this->LocalSorter->Histo,
+                                    this->GlobalHistogram,
+                                    nbGlobalToSkip,
+                                    localOffset,
+                                    nbInLocalBar);
+
+    std::vector<vtkIdType> runSizes(this->NumProcs);
+    while(true)
+      {
+      int localFound = 0;
+      double localValue = revertOrder ? -VTK_DOUBLE_MAX : VTK_DOUBLE_MAX;
+      if(column && this->LocalSorter->Array)
+        {
+        for(vtkIdType idx=localOffset; idx < this->LocalSorter->ArraySize;
+            ++idx)
+          {
+          if(IsInRange(column, this->LocalSorter->Array[idx].OriginalIndex,
+                       component, range))
+            {
+            localFound = 1;
+            localValue =
+              static_cast<double>(this->LocalSorter->Array[idx].Value);
+            break;
+            }
+          }
+        }
+
+      int globalFound = 0;
+      double globalValue = localValue;
+      this->MPI->AllReduce(&localFound, &globalFound, 1,
+                           vtkCommunicator::MAX_OP);
+      if(!globalFound)
+        {
+        return -1;
+        }
+      this->MPI->AllReduce(&localValue, &globalValue, 1,
+                           revertOrder ? vtkCommunicator::MAX_OP :
+                                         vtkCommunicator::MIN_OP);
+
+      // Local run of that value, and rows sorted strictly before it
+      vtkIdType first = 0;
+      vtkIdType last = 0;
+      if(this->LocalSorter->Array)
+        {
+        SortableArrayItem* begin = this->LocalSorter->Array;
+        SortableArrayItem* end = begin + this->LocalSorter->ArraySize;
+        std::pair<SortableArrayItem*, SortableArrayItem*> run = revertOrder ?
+          std::equal_range(begin, end, globalValue, ValueGreater()) :
+          std::equal_range(begin, end, globalValue, ValueLess());
+        first = run.first - begin;
+        last = run.second - begin;
+        }
+      vtkIdType localBefore = first;
+      vtkIdType globalBefore = 0;
+      this->MPI->AllReduce(&localBefore, &globalBefore, 1,
+                           vtkCommunicator::SUM_OP);
+      vtkIdType runSize = last - first;
+      this->MPI->AllGather(&runSize, &runSizes[0], 1);
+      vtkIdType runOffset = globalBefore;
+      for(int pid=0; pid < this->NumProcs; ++pid)
+        {
+        if(revertOrder ? (pid > this->Me) : (pid < this->Me))
+          {
+          runOffset += runSizes[pid];
+          }
+        }
+
+      // The local run is sorted by decreasing original id when inverted
+      vtkIdType found = VTK_ID_MAX;
+      for(vtkIdType cc=0; column && cc < runSize; ++cc)
+        {
+        vtkIdType idx = revertOrder ? (last - 1 - cc) : (first + cc);
+        vtkIdType row = runOffset + cc;
+        if(row >= startRow &&
+           IsInRange(column, this->LocalSorter->Array[idx].OriginalIndex,
+                     component, range))
+          {
+          found = row;
+          break;
+          }
+        }
+      vtkIdType globalRow = VTK_ID_MAX;
+      this->MPI->AllReduce(&found, &globalRow, 1, vtkCommunicator::MIN_OP);
+      if(globalRow != VTK_ID_MAX)
+        {
+        return globalRow;
+        }
+
+      // All the matches of that value come before startRow
+      localOffset = MAX(localOffset, last);
+      }
+    }
+
   // --------------------------------------------------------------------------
   int GetMergingProcessId(vtkTable* localTable)
     {
@@ -1406,9 +2181,13 @@ private:
   vtkCommunicator* MPI;       // MPI communicator to send/receive/gather
   int SelectedComponent;      // Component used to sort array
   bool NeedToBuildCache;
+  bool ProcessOrder;          // Last output was extracted in process order
+  bool HasGlobalRanks;        // GlobalRanks matches the local sorted array
+  std::vector<vtkIdType> GlobalRanks; // Global rank of each local sorted item
   bool Debug;
 
   const static int VTK_TABLE_EXCHANGE_TAG = 50;
+  const static int VTK_SAMPLE_SORT_TAG = 51;
   // HISTOGRAM_SIZE could be computed dynamically based on the type of the
   // array to sort but to make sure that unsigned char won't be distributed
   // correctly we set the histogram size to be their max number of element
@@ -1430,6 +2209,9 @@ vtkSortedTableStreamer::vtkSortedTableStreamer()
   this->Block = 0;
   this->BlockSize = 1024;
   this->Internal = 0;
+  this->HiddenColumns = new vtkColumnSet();
+  this->SampleSort = 0;
+  this->CompositeInputTable = 0;
   this->SelectedComponent = 0;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
@@ -1444,6 +2226,13 @@ vtkSortedTableStreamer::~vtkSortedTableStreamer()
     delete this->Internal;
     this->Internal = 0;
     }
+  delete this->HiddenColumns;
+  this->HiddenColumns = 0;
+  if(this->CompositeInputTable)
+    {
+    this->CompositeInputTable->Delete();
+    this->CompositeInputTable = 0;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -1469,8 +2258,14 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
 
   bool orderInverted = this->InvertOrder > 0;
 
-  // Convert a composite dataset into a vtkTable input.
-  if(!input)
+  // Convert a composite dataset into a vtkTable input. The result is kept as
+  // long as the input is not regenerated.
+  if(!input && this->CompositeInputTable &&
+     inputDO->GetUpdateTime() < this->CompositeInputTime.GetMTime())
+    {
+    input = this->CompositeInputTable;
+    }
+  else if(!input)
     {
     vtkSmartPointer<vtkCompositeDataSet> inputCompositeDS =
         vtkCompositeDataSet::SafeDownCast(inputDO);
@@ -1556,6 +2351,14 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
         }
       }
     iter->Delete();
+
+    if(this->CompositeInputTable)
+      {
+      this->CompositeInputTable->Delete();
+      }
+    this->CompositeInputTable = input;
+    this->CompositeInputTable->Register(this);
+    this->CompositeInputTime.Modified();
     }
 
   // Get input data
@@ -1583,6 +2386,8 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
   int realComponent = (!arrayToProcess) ?  0 :
                       this->GetSelectedComponent() % arrayToProcess->GetNumberOfComponents();
   this->Internal->SetSelectedComponent(realComponent);
+  this->Internal->HiddenColumns = this->HiddenColumns;
+  this->Internal->SampleSort = (this->SampleSort != 0);
 
 
   // Manage custom case where sorting occur on a virtual array (process id)
@@ -1598,6 +2403,33 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
                              this->Block, this->BlockSize, orderInverted);
     }
 
+  // List every column, the hidden ones included, in the order of the input.
+  // Columns added by the streamer come last.
+  if(!this->HiddenColumns->empty() && output->GetNumberOfColumns() > 0)
+    {
+    vtkStringArray* columnNames = vtkStringArray::New();
+    columnNames->SetName("vtkColumnNames");
+    std::set<std::string> listed;
+    for(vtkIdType cc=0; cc < input->GetNumberOfColumns(); ++cc)
+      {
+      const char* name = input->GetColumn(cc)->GetName();
+      if(name && listed.insert(name).second)
+        {
+        columnNames->InsertNextValue(name);
+        }
+      }
+    for(vtkIdType cc=0; cc < output->GetNumberOfColumns(); ++cc)
+      {
+      const char* name = output->GetColumn(cc)->GetName();
+      if(name && listed.insert(name).second)
+        {
+        columnNames->InsertNextValue(name);
+        }
+      }
+    output->GetFieldData()->AddArray(columnNames);
+    columnNames->Delete();
+    }
+
   return 1;
 }
 
@@ -1607,6 +2439,77 @@ void vtkSortedTableStreamer::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "Sorting column: "
      << (this->ColumnToSort?this->ColumnToSort:"(none)") << endl;
+  os << indent << "Hidden columns: " << this->HiddenColumns->size() << endl;
+  os << indent << "SampleSort: " << this->SampleSort << endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkSortedTableStreamer::SetSampleSort(int newValue)
+{
+  if(this->SampleSort != newValue)
+    {
+    this->SampleSort = newValue;
+    if(this->Internal)
+      {
+      delete this->Internal;
+      this->Internal = 0;
+      }
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSortedTableStreamer::AddHiddenColumn(const char* columnName)
+{
+  if(columnName && this->HiddenColumns->insert(columnName).second)
+    {
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSortedTableStreamer::RemoveAllHiddenColumns()
+{
+  if(!this->HiddenColumns->empty())
+    {
+    this->HiddenColumns->clear();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSortedTableStreamer::FindRow(const char* columnName,
+                                          int component,
+                                          double min, double max,
+                                          vtkIdType startRow)
+{
+  if(this->GetNumberOfInputConnections(0) == 0)
+    {
+    return -1;
+    }
+
+  // Make sure the sorted structure matches the current input and settings
+  this->Update();
+
+  vtkTable* input = vtkTable::SafeDownCast(this->GetInputDataObject(0, 0));
+  if(!input)
+    {
+    input = this->CompositeInputTable;
+    }
+  if(!this->Internal || !input || !columnName)
+    {
+    return -1;
+    }
+
+  vtkDataArray* column =
+    vtkDataArray::SafeDownCast(input->GetColumnByName(columnName));
+  bool sortedColumn = this->GetColumnToSort() &&
+    strcmp(this->GetColumnToSort(), columnName) == 0 &&
+    component == this->SelectedComponent;
+  double range[2] = {min, max};
+  return this->Internal->FindRow(input, column, component, range, startRow,
+                                 sortedColumn, this->BlockSize,
+                                 this->InvertOrder > 0);
 }
 
 //----------------------------------------------------------------------------
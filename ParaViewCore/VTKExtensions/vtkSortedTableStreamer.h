@@ -18,6 +18,15 @@
 // This filter is used quickly get a sorted subset of a given vtkTable.
 // By sorted we mean a subset build from a global sort even if some optimisation
 // allow us to skip a global table sorting.
+// Columns can be hidden so that only the ones displayed are moved around.
+// When some are hidden, the output field data holds a "vtkColumnNames" string
+// array listing every column, hidden or not, in order.
+//
+// By default the rows of a block are located by refining histograms of the
+// sorted values across processes, for every block. With SampleSort on, a
+// distributed sample sort gives once the global rank of every row, after
+// which any block is found by a lookup. It costs an exchange of the sorted
+// values and a rank per row, and pays off on large tables.
 
 #ifndef __vtkSortedTableStreamer_h
 #define __vtkSortedTableStreamer_h
@@ -33,6 +42,8 @@ private:
   class InternalsBase;
   template<class T> class Internals;
   InternalsBase* Internal;
+  class vtkColumnSet;
+  vtkColumnSet* HiddenColumns;
 
 public:
   static void PrintInfo(vtkTable* input);
@@ -79,6 +90,33 @@ public:
   void SetInvertOrder(int newValue);
   vtkGetMacro(InvertOrder, int);
 
+  // Description:
+  // Use a sample sort to compute the global order once per sort key instead
+  // of locating each block through histograms. Off by default.
+  void SetSampleSort(int newValue);
+  vtkGetMacro(SampleSort, int);
+  vtkBooleanMacro(SampleSort, int);
+
+  // Description:
+  // Leave a column out of the output. Columns the streamer relies on (the
+  // sorted column, original ids and process ids, selection flags) are always
+  // kept.
+  void AddHiddenColumn(const char* columnName);
+  void RemoveAllHiddenColumns();
+
+  // Description:
+  // Return the index, in the sorted order, of the first row at or after
+  // startRow whose value for columnName lies in [min, max], or -1 if none.
+  // component selects the component to test, -1 for the magnitude.
+  // The search uses the sorted structure when columnName is the sorted
+  // column or when SampleSort is on. Otherwise, when the table is sorted on
+  // another column, rows sharing the same sorted value are taken process by
+  // process and by increasing original id, as in a block built on a single
+  // process.
+  // This must be called on all processes.
+  vtkIdType FindRow(const char* columnName, int component,
+                    double min, double max, vtkIdType startRow);
+
 protected:
   vtkSortedTableStreamer();
   ~vtkSortedTableStreamer();
@@ -103,6 +141,12 @@ protected:
   char* ColumnToSort;
   int SelectedComponent;
   int InvertOrder;
+  int SampleSort;
+
+  // Table built from a composite input. It is kept between executions, so
+  // that the sorted structure built on it stays valid while browsing.
+  vtkTable* CompositeInputTable;
+  vtkTimeStamp CompositeInputTime;
 private:
   vtkSortedTableStreamer(const vtkSortedTableStreamer&); // Not implemented
   void operator=(const vtkSortedTableStreamer&);   // Not implemented
@@ -60,6 +60,7 @@
 //
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/RegularExpression.hxx>
+#include <vtksys/ios/sstream>
 #include <vector>
 //
 #include "vtkCharArray.h"
@@ -75,6 +76,8 @@
 
 #ifdef VTK_USE_MPI
 #include "vtkMultiProcessController.h"
+#include "vtkMPICommunicator.h"
+#include "vtkMPI.h"
 vtkCxxSetObjectMacro(vtkH5PartReader, Controller, vtkMultiProcessController);
 #endif
 
@@ -109,36 +112,18 @@ static hid_t H5PartGetNativeDatasetType(H5PartFile *f, const char *name)
 }
 
 //----------------------------------------------------------------------------
-static hid_t H5PartGetDiskShape(H5PartFile *f, hid_t dataset)
+// Copies a contiguous single component array into component c of an
+// interleaved array.
+template <class T>
+void vtkH5PartInterleave(const T* source, T* dest, vtkIdType numTuples,
+                         int numComponents, int c)
 {
-  hid_t space = H5Dget_space(dataset);
-  if (H5PartHasView(f))
-    {
-    int r;
-    hsize_t stride, count;
-    hsize_t range[2];
-    /* so, is this selection inclusive or exclusive? */
-    range[0]=f->viewstart;
-    range[1]=f->viewend;
-    count = range[1]-range[0]; /* to be inclusive */
-    stride=1;
-    /* now we select a subset */
-    if (f->diskshape>0)
-      {
-      r=H5Sselect_hyperslab(f->diskshape,H5S_SELECT_SET,
-        range/* only using first element */,
-        &stride,&count,NULL);
-      }
-    /* now we select a subset */
-    r=H5Sselect_hyperslab(space,H5S_SELECT_SET,
-      range,&stride,&count,NULL);
-    if (r<0)
-      {
-      fprintf(stderr,"Abort: Selection Failed!\n");
-      return space;
-      }
-    }
-  return space;
+  dest += c;
+  for (vtkIdType i=0; i<numTuples; ++i)
+    {
+    *dest = source[i];
+    dest += numComponents;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -163,6 +148,11 @@ vtkH5PartReader::vtkH5PartReader()
   this->UpdateNumPieces          = 0;
   this->TimeOutOfRange           = 0;
   this->MaskOutOfTimeRangeOutput = 0;
+  this->LevelOfDetail            = 0;
+  this->SubsampleIndexArray      = NULL;
+  this->LevelOfDetailCache       = NULL;
+  this->LevelOfDetailCacheLevel  = -1;
+  this->LevelOfDetailCacheStep   = -1;
   this->PointDataArraySelection  = vtkDataArraySelection::New();
   this->SetXarray("Coords_0");
   this->SetYarray("Coords_1");
@@ -188,6 +178,15 @@ vtkH5PartReader::~vtkH5PartReader()
   delete [] this->Zarray;
   this->Zarray = NULL;
 
+  delete [] this->SubsampleIndexArray;
+  this->SubsampleIndexArray = NULL;
+
+  if (this->LevelOfDetailCache)
+    {
+    this->LevelOfDetailCache->Delete();
+    this->LevelOfDetailCache = NULL;
+    }
+
   this->PointDataArraySelection->Delete();
   this->PointDataArraySelection = 0;
 
@@ -255,7 +254,21 @@ int vtkH5PartReader::OpenFile()
 
   if (!this->H5FileId)
     {
-    this->H5FileId = H5PartOpenFile(this->FileName, H5PART_READ);
+#if defined(VTK_USE_MPI) && defined(H5PART_HAS_MPI)
+    // In parallel, open the file on all processes at once so that the data
+    // can be read with collective MPI-IO.
+    vtkMPICommunicator* communicator = this->Controller ?
+      vtkMPICommunicator::SafeDownCast(this->Controller->GetCommunicator()) : 0;
+    if (communicator && this->Controller->GetNumberOfProcesses()>1)
+      {
+      this->H5FileId = H5PartOpenFileParallel(this->FileName, H5PART_READ,
+        *communicator->GetMPIComm()->GetHandle());
+      }
+#endif
+    if (!this->H5FileId)
+      {
+      this->H5FileId = H5PartOpenFile(this->FileName, H5PART_READ);
+      }
     this->FileOpenedTime.Modified();
     }
 
@@ -324,7 +337,52 @@ int vtkH5PartReader::RequestInformation(
     return 0;
     }
 
-  if (1 || NeedToReadInformation)
+  // The steps are only walked again when the file changed.
+  if (NeedToReadInformation && !this->ReadStepInformation())
+    {
+    return 0;
+    }
+
+  if (this->NumberOfTimeSteps==0)
+    {
+    vtkErrorMacro(<<"No time steps in data");
+    return 0;
+    }
+
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(),
+    &this->TimeStepValues[0],
+    static_cast<int>(this->TimeStepValues.size()));
+  double timeRange[2];
+  timeRange[0] = this->TimeStepValues.front();
+  timeRange[1] = this->TimeStepValues.back();
+  if (this->TimeStepValues.size()>1)
+    {
+    this->TimeStepTolerance = 0.01*(this->TimeStepValues[1]-this->TimeStepValues[0]);
+    }
+  else
+    {
+    this->TimeStepTolerance = 1E-3;
+    }
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), timeRange, 2);
+
+  return 1;
+}
+//----------------------------------------------------------------------------
+int vtkH5PartReader::ReadStepInformation()
+{
+  int procId = 0;
+  int numProcs = 1;
+#ifdef VTK_USE_MPI
+  if (this->Controller)
+    {
+    procId = this->Controller->GetLocalProcessId();
+    numProcs = this->Controller->GetNumberOfProcesses();
+    }
+#endif
+
+  // Names of the datasets, separated by null characters.
+  std::vector<char> names;
+  if (procId==0)
     {
     this->NumberOfTimeSteps = H5PartGetNumSteps(this->H5FileId);
     H5PartSetStep(this->H5FileId, 0);
@@ -335,6 +393,7 @@ int vtkH5PartReader::RequestInformation(
       // return 0 for no, 1,2,3,4,5 etc for index (1 based offset)
       H5PartGetDatasetName(this->H5FileId, i, name, 512);
       this->PointDataArraySelection->AddArray(name);
+      names.insert(names.end(), name, name+strlen(name)+1);
       }
 
     this->TimeStepValues.assign(this->NumberOfTimeSteps, 0.0);
@@ -371,12 +430,6 @@ int vtkH5PartReader::RequestInformation(
       }
     H5PartSetStep(this->H5FileId, 0);
 
-    if (this->NumberOfTimeSteps==0)
-      {
-      vtkErrorMacro(<<"No time steps in data");
-      return 0;
-      }
-
     // if TIME information was either not present ot not consistent, then
     // set something so that consumers of this data can iterate sensibly
     if (this->NumberOfTimeSteps>0 && this->NumberOfTimeSteps!=validTimes)
@@ -387,25 +440,82 @@ int vtkH5PartReader::RequestInformation(
         this->TimeStepValues[i] = i;
         }
       }
-    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(),
-      &this->TimeStepValues[0],
-      static_cast<int>(this->TimeStepValues.size()));
-    double timeRange[2];
-    timeRange[0] = this->TimeStepValues.front();
-    timeRange[1] = this->TimeStepValues.back();
-    if (this->TimeStepValues.size()>1)
+    }
+
+#ifdef VTK_USE_MPI
+  if (numProcs>1)
+    {
+    int sizes[2];
+    sizes[0] = this->NumberOfTimeSteps;
+    sizes[1] = static_cast<int>(names.size());
+    this->Controller->Broadcast(sizes, 2, 0);
+    if (procId!=0)
+      {
+      this->NumberOfTimeSteps = sizes[0];
+      this->TimeStepValues.resize(sizes[0]);
+      names.resize(sizes[1]);
+      }
+    if (sizes[0]>0)
       {
-      this->TimeStepTolerance = 0.01*(this->TimeStepValues[1]-this->TimeStepValues[0]);
+      this->Controller->Broadcast(&this->TimeStepValues[0], sizes[0], 0);
       }
-    else
+    if (sizes[1]>0)
       {
-      this->TimeStepTolerance = 1E-3;
+      this->Controller->Broadcast(&names[0], sizes[1], 0);
+      }
+    if (procId!=0)
+      {
+      for (size_t i=0; i<names.size(); i+=strlen(&names[i])+1)
+        {
+        this->PointDataArraySelection->AddArray(&names[i]);
+        }
       }
-    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), timeRange, 2);
     }
+#else
+  (void)numProcs;
+#endif
 
+  this->NumberOfParticles.assign(this->NumberOfTimeSteps, -1);
   return 1;
 }
+//----------------------------------------------------------------------------
+vtkIdType vtkH5PartReader::GetNumberOfParticles(int step)
+{
+  bool cached = (step>=0 &&
+    step<static_cast<int>(this->NumberOfParticles.size()));
+  if (cached && this->NumberOfParticles[step]>=0)
+    {
+    return this->NumberOfParticles[step];
+    }
+
+  vtkIdType numParticles = 0;
+#ifdef VTK_USE_MPI
+  if (this->Controller && this->Controller->GetNumberOfProcesses()>1)
+    {
+    // Only process 0 queries the file.
+    if (this->Controller->GetLocalProcessId()==0)
+      {
+      H5PartSetStep(this->H5FileId, step);
+      numParticles = H5PartGetNumParticles(this->H5FileId);
+      }
+    this->Controller->Broadcast(&numParticles, 1, 0);
+    }
+  else
+#endif
+    {
+    H5PartSetStep(this->H5FileId, step);
+    numParticles = H5PartGetNumParticles(this->H5FileId);
+    }
+  if (numParticles<0)
+    {
+    numParticles = 0;
+    }
+  if (cached)
+    {
+    this->NumberOfParticles[step] = numParticles;
+    }
+  return numParticles;
+}
 
 int GetVTKDataType(int datatype)
 {
@@ -460,33 +570,6 @@ int GetVTKDataType(int datatype)
   return VTK_VOID;
 }
 
-//----------------------------------------------------------------------------
-//A Convenience Macro which does what we want for any dataset type
-#define H5PartReadDataArray(null, T2)  \
-  dataarray->SetNumberOfComponents(Nc); \
-  dataarray->SetNumberOfTuples(Nt);                           \
-  dataarray->SetName(rootname.c_str());                       \
-  herr_t r;                                                   \
-  hsize_t     count1_mem[] = { Nt*Nc };                       \
-  hsize_t     count2_mem[] = { Nt };                          \
-  hsize_t     offset_mem[] = { 0 };                           \
-  hsize_t     stride_mem[] = { Nc };                          \
-  for (c=0; c<Nc; c++) {                                      \
-    const char *name = arraylist[c].c_str();                  \
-    hid_t dataset   = H5Dopen(H5FileId->timegroup,name);      \
-    hid_t diskshape = H5PartGetDiskShape(H5FileId,dataset);   \
-    hid_t memspace = H5Screate_simple(1, count1_mem, NULL);   \
-    offset_mem[0] = c;                                        \
-    r = H5Sselect_hyperslab(                                  \
-      memspace, H5S_SELECT_SET,                               \
-      offset_mem, stride_mem, count2_mem, NULL);              \
-      H5Dread(dataset, null##T2, memspace,                    \
-      diskshape, H5P_DEFAULT, dataarray->GetVoidPointer(0));  \
-    if (memspace!=H5S_ALL) H5Sclose(memspace);                \
-    if (diskshape!=H5S_ALL) H5Sclose(diskshape);              \
-    H5Dclose(dataset);                                        \
-  }
-
 //----------------------------------------------------------------------------
 /*
 template <class T1, class T2>
@@ -550,6 +633,130 @@ void vtkH5PartReader::CopyIntoCoords(int offset, vtkDataArray *source, vtkDataAr
 }
 */
 
+//----------------------------------------------------------------------------
+// The particles read from a dataset: either strided ranges or an explicit,
+// sorted list of particle indices.
+struct vtkH5PartSelection
+{
+  std::vector<hsize_t> Start;
+  std::vector<hsize_t> Stride;
+  std::vector<hsize_t> Count;
+  std::vector<hsize_t> Elements;
+  bool UseElements;
+
+  vtkH5PartSelection() : UseElements(false) {}
+
+  // Adds the particles i of [begin, end) with i%stride == offset.
+  void AddRange(vtkIdType begin, vtkIdType end, vtkIdType offset,
+                vtkIdType stride)
+    {
+    vtkIdType first = begin + ((offset - begin)%stride + stride)%stride;
+    if (first<end)
+      {
+      this->Start.push_back(first);
+      this->Stride.push_back(stride);
+      this->Count.push_back((end - 1 - first)/stride + 1);
+      }
+    }
+
+  vtkIdType GetNumberOfParticles()
+    {
+    if (this->UseElements)
+      {
+      return static_cast<vtkIdType>(this->Elements.size());
+      }
+    vtkIdType n = 0;
+    for (size_t i=0; i<this->Count.size(); ++i)
+      {
+      n += this->Count[i];
+      }
+    return n;
+    }
+
+  void Select(hid_t diskshape)
+    {
+    H5Sselect_none(diskshape);
+    if (this->UseElements)
+      {
+      if (!this->Elements.empty())
+        {
+        H5Sselect_elements(diskshape, H5S_SELECT_SET,
+          this->Elements.size(), &this->Elements[0]);
+        }
+      return;
+      }
+    for (size_t i=0; i<this->Count.size(); ++i)
+      {
+      H5Sselect_hyperslab(diskshape, H5S_SELECT_OR,
+        &this->Start[i], &this->Stride[i], &this->Count[i], NULL);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Reads the selected particles of a dataset of the current step into
+// component c of dataarray, starting at tuple offset. With collective IO,
+// every process has to take part in the read even if it has nothing to read.
+static void vtkH5PartReadComponent(H5PartFile *f, const char *name,
+  vtkH5PartSelection &selection, vtkDataArray *dataarray,
+  vtkIdType offset, int c)
+{
+  vtkIdType n = selection.GetNumberOfParticles();
+  int Nc = dataarray->GetNumberOfComponents();
+  hsize_t count_mem[] = { static_cast<hsize_t>(std::max(n, vtkIdType(1))) };
+  hid_t dataset   = H5Dopen(f->timegroup,name);
+  hid_t diskshape = H5Dget_space(dataset);
+  hid_t memspace  = H5Screate_simple(1, count_mem, NULL);
+  hid_t component_datatype = H5PartGetNativeDatasetType(f, name);
+  selection.Select(diskshape);
+  if (n==0)
+    {
+    double empty_buffer[1];
+    H5Sselect_none(memspace);
+    H5Dread(dataset, component_datatype, memspace,
+      diskshape, f->xfer_prop, empty_buffer);
+    }
+  else if (Nc==1 &&
+           GetVTKDataType(component_datatype) == dataarray->GetDataType())
+    {
+    H5Dread(dataset, component_datatype, memspace,
+      diskshape, f->xfer_prop, dataarray->GetVoidPointer(offset));
+    }
+  else
+    {
+    // read data into a temporary array of the right type and then copy it
+    // over to the "dataarray".
+    vtkDataArray* temparray =
+      vtkDataArray::CreateDataArray(GetVTKDataType(component_datatype));
+    temparray->SetNumberOfComponents(1);
+    temparray->SetNumberOfTuples(n);
+    H5Dread(dataset, component_datatype, memspace,
+      diskshape, f->xfer_prop, temparray->GetVoidPointer(0));
+    if (temparray->GetDataType() == dataarray->GetDataType())
+      {
+      switch (dataarray->GetDataType())
+        {
+        vtkTemplateMacro(vtkH5PartInterleave(
+          static_cast<VTK_TT*>(temparray->GetVoidPointer(0)),
+          static_cast<VTK_TT*>(dataarray->GetVoidPointer(offset*Nc)),
+          n, Nc, c));
+        }
+      }
+    else
+      {
+      for (vtkIdType i=0; i<n; ++i)
+        {
+        dataarray->SetComponent(offset+i, c, temparray->GetComponent(i, 0));
+        }
+      }
+    temparray->Delete();
+    }
+  H5Tclose(component_datatype);
+  H5Sclose(memspace);
+  H5Sclose(diskshape);
+  H5Dclose(dataset);
+}
+
 class H5PartToleranceCheck: public std::binary_function<double, double, bool>
 {
 public:
@@ -581,11 +788,10 @@ int vtkH5PartReader::RequestData(
     this->UpdatePiece = this->Controller->GetLocalProcessId();
     this->UpdateNumPieces = this->Controller->GetNumberOfProcesses();
   }
+#else
+  this->UpdatePiece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+  this->UpdateNumPieces = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
 #endif
-  //
-  // Parallel read currently not implemented, just read on process zero and
-  // exit quick on the others. @TODO : Add in Slab selection code
-  if (this->UpdatePiece>0) return 1;
   //
   typedef std::map< std::string, std::vector<std::string> > FieldMap;
   FieldMap scalarFields;
@@ -715,10 +921,92 @@ int vtkH5PartReader::RequestData(
     return 1;
     }
 
+  // Each piece reads a contiguous slab of the particles of this step.
+  vtkIdType numParticles = this->GetNumberOfParticles(this->ActualTimeStep);
+  int numPieces = std::max(this->UpdateNumPieces, 1);
+  vtkIdType start = (numParticles*this->UpdatePiece)/numPieces;
+  vtkIdType end = (numParticles*(this->UpdatePiece+1))/numPieces;
+
   // Set the TimeStep on the H5 file
   H5PartSetStep(this->H5FileId, this->ActualTimeStep);
-  // Get the number of points for this step
-  vtkIdType Nt = H5PartGetNumParticles(this->H5FileId);
+
+  //
+  // Level of detail : when the same particles were already loaded at a
+  // coarser level, only the particles that are missing are read.
+  //
+  int level = this->LevelOfDetail;
+  vtksys_ios::ostringstream key;
+  key << this->FileOpenedTime.GetMTime() << " " << this->UpdatePiece << " "
+      << numPieces << " "
+      << (this->SubsampleIndexArray ? this->SubsampleIndexArray : "");
+  for (FieldMap::iterator it=scalarFields.begin(); it!=scalarFields.end(); it++)
+    {
+    key << " " << (*it).first;
+    for (size_t c=0; c<(*it).second.size(); ++c)
+      {
+      key << ":" << (*it).second[c];
+      }
+    }
+  int loadedLevel = -1;
+  if (this->LevelOfDetailCache &&
+      this->LevelOfDetailCacheStep == this->ActualTimeStep &&
+      this->LevelOfDetailCacheKey == key.str() &&
+      this->LevelOfDetailCacheLevel >= level)
+    {
+    loadedLevel = this->LevelOfDetailCacheLevel;
+    }
+  vtkIdType Nloaded = loadedLevel>=0 ?
+    this->LevelOfDetailCache->GetNumberOfPoints() : 0;
+  bool useIndexArray = (level>0 || loadedLevel>0) &&
+    this->SubsampleIndexArray && this->SubsampleIndexArray[0];
+
+  vtkH5PartSelection selection;
+  if (loadedLevel==level)
+    {
+    // Everything is already there.
+    }
+  else if (useIndexArray)
+    {
+    // The index array lists the particles in refinement order, a level
+    // holds the first numParticles/2^level of them.
+    vtkIdType stride = vtkIdType(1)<<level;
+    vtkIdType first = 0;
+    if (loadedLevel>=0)
+      {
+      vtkIdType loadedStride = vtkIdType(1)<<loadedLevel;
+      first = (numParticles + loadedStride - 1)/loadedStride;
+      }
+    vtkIdType last = (numParticles + stride - 1)/stride;
+    vtkH5PartSelection indexSelection;
+    indexSelection.AddRange(
+      first + ((last - first)*this->UpdatePiece)/numPieces,
+      first + ((last - first)*(this->UpdatePiece+1))/numPieces, 0, 1);
+    vtkSmartPointer<vtkLongLongArray> indices =
+      vtkSmartPointer<vtkLongLongArray>::New();
+    indices->SetNumberOfTuples(indexSelection.GetNumberOfParticles());
+    vtkH5PartReadComponent(this->H5FileId, this->SubsampleIndexArray,
+      indexSelection, indices, 0, 0);
+    selection.UseElements = true;
+    selection.Elements.resize(indices->GetNumberOfTuples());
+    for (vtkIdType i=0; i<indices->GetNumberOfTuples(); ++i)
+      {
+      selection.Elements[i] = static_cast<hsize_t>(indices->GetValue(i));
+      }
+    std::sort(selection.Elements.begin(), selection.Elements.end());
+    }
+  else if (loadedLevel<0)
+    {
+    selection.AddRange(start, end, 0, vtkIdType(1)<<level);
+    }
+  else
+    {
+    // The particles of level k that are not in level k+1.
+    for (int k=loadedLevel-1; k>=level; --k)
+      {
+      selection.AddRange(start, end, vtkIdType(1)<<k, vtkIdType(2)<<k);
+      }
+    }
+  vtkIdType Nt = Nloaded + selection.GetNumberOfParticles();
 
   // Setup arrays for reading data
   vtkSmartPointer<vtkPoints>    points = vtkSmartPointer<vtkPoints>::New();
@@ -742,54 +1030,23 @@ int vtkH5PartReader::RequestData(
       dataarray->SetNumberOfTuples(Nt);
       dataarray->SetName(rootname.c_str());
 
-      // now read the data components.
-      hsize_t count1_mem[] = { Nt*Nc };
-      hsize_t count2_mem[] = { Nt };
-      hsize_t offset_mem[] = { 0 };
-      hsize_t stride_mem[] = { Nc };
+      // Start from the particles already loaded.
+      if (Nloaded>0)
+        {
+        vtkDataArray *loaded = ((*it).first=="Coords") ?
+          this->LevelOfDetailCache->GetPoints()->GetData() :
+          this->LevelOfDetailCache->GetPointData()->GetArray(rootname.c_str());
+        memcpy(dataarray->GetVoidPointer(0), loaded->GetVoidPointer(0),
+          Nloaded*Nc*dataarray->GetDataTypeSize());
+        }
+
+      // now read the data components. Each one is read in a single call
+      // and then interleaved in memory. The reads are collective, so they
+      // are made even when this piece has no new particle.
       for (int c=0; c<Nc; c++)
         {
-        const char *name = arraylist[c].c_str();
-        hid_t dataset   = H5Dopen(H5FileId->timegroup,name);
-        hid_t diskshape = H5PartGetDiskShape(H5FileId,dataset);
-        hid_t memspace = H5Screate_simple(1, count1_mem, NULL);
-        hid_t component_datatype = H5PartGetNativeDatasetType(H5FileId, name);
-        offset_mem[0] = c;
-        H5Sselect_hyperslab(
-          memspace, H5S_SELECT_SET,
-          offset_mem, stride_mem, count2_mem, NULL);
-        if (component_datatype == datatype)
-          {
-          H5Dread(dataset, datatype, memspace,
-            diskshape, H5P_DEFAULT, dataarray->GetVoidPointer(0));
-          }
-        else
-          {
-          // read data into a temporary array of the right type and then copy it
-          // over to the "dataarray".
-          // This can be optimized to create a single component array. But I
-          // don't understand the stride/offset stuff too well to fix that.
-          vtkDataArray* temparray =
-            vtkDataArray::CreateDataArray(GetVTKDataType(component_datatype));
-          temparray->SetNumberOfComponents(Nc);
-          temparray->SetNumberOfTuples(Nt);
-          H5Sselect_hyperslab(
-            memspace, H5S_SELECT_SET,
-            offset_mem, stride_mem, count2_mem, NULL);
-          H5Dread(dataset, component_datatype, memspace,
-            diskshape, H5P_DEFAULT, temparray->GetVoidPointer(0));
-          dataarray->CopyComponent(c, temparray, c);
-          temparray->Delete();
-          }
-        if (memspace!=H5S_ALL)
-          {
-          H5Sclose(memspace);
-          }
-        if (diskshape!=H5S_ALL)
-          {
-          H5Sclose(diskshape);
-          }
-        H5Dclose(dataset);
+        vtkH5PartReadComponent(this->H5FileId, arraylist[c].c_str(),
+          selection, dataarray, Nloaded, c);
         }
       }
     else
@@ -828,6 +1085,25 @@ int vtkH5PartReader::RequestData(
   //
   points->SetData(coords);
   output->SetPoints(points);
+
+  // Keep the subsampled particles so that a finer level can build on them.
+  if (level>0)
+    {
+    if (!this->LevelOfDetailCache)
+      {
+      this->LevelOfDetailCache = vtkPolyData::New();
+      }
+    this->LevelOfDetailCache->ShallowCopy(output);
+    this->LevelOfDetailCacheLevel = level;
+    this->LevelOfDetailCacheStep = this->ActualTimeStep;
+    this->LevelOfDetailCacheKey = key.str();
+    }
+  else if (this->LevelOfDetailCache)
+    {
+    this->LevelOfDetailCache->Delete();
+    this->LevelOfDetailCache = NULL;
+    this->LevelOfDetailCacheLevel = -1;
+    }
   return 1;
 }
 
@@ -909,4 +1185,9 @@ void vtkH5PartReader::PrintSelf(ostream& os, vtkIndent indent)
     (this->FileName ? this->FileName : "(none)") << "\n";
 
   os << indent << "NumberOfSteps: " <<  this->NumberOfTimeSteps << "\n";
+
+  os << indent << "LevelOfDetail: " << this->LevelOfDetail << "\n";
+
+  os << indent << "SubsampleIndexArray: " <<
+    (this->SubsampleIndexArray ? this->SubsampleIndexArray : "(none)") << "\n";
 }
@@ -36,6 +36,9 @@
 // .SECTION Description
 // vtkH5PartReader reads compatible with H5Part : documented here
 // http://amas.web.psi.ch/docs/H5Part-doc/h5part.html 
+// In parallel, each process reads a contiguous slab of the particles,
+// using collective MPI-IO when HDF5 supports it. The step information is
+// read once per file by process 0 and broadcast to the others.
 // .SECTION Thanks
 // John Bidiscombe of
 // CSCS - Swiss National Supercomputing Centre for creating and contributing
@@ -121,6 +124,23 @@ public:
   vtkGetMacro(MaskOutOfTimeRangeOutput, int);
   vtkBooleanMacro(MaskOutOfTimeRangeOutput, int);
 
+  // Description:
+  // Only read one particle in 2^LevelOfDetail, 0 (the default) reads all
+  // of them. The subsets are nested: when the level is lowered on the same
+  // step, only the particles missing from the previous level are read.
+  vtkSetClampMacro(LevelOfDetail, int, 0, 30);
+  vtkGetMacro(LevelOfDetail, int);
+
+  // Description:
+  // Name of an optional dataset of each step that lists the particle indices
+  // in refinement order, e.g. a random permutation or a Morton ordering
+  // written by a preprocessing tool. A level then reads the first
+  // 1/2^LevelOfDetail of the listed particles. When not set, every
+  // 2^LevelOfDetail-th particle of the file is read, which is spatially
+  // stratified when the file itself is spatially sorted.
+  vtkSetStringMacro(SubsampleIndexArray);
+  vtkGetStringMacro(SubsampleIndexArray);
+
   bool HasStep(int Step);
 
   // Description:
@@ -175,6 +195,13 @@ protected:
   int   RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   int   OpenFile();
   void  CloseFile();
+  // Description:
+  // Reads the number of steps, their time values and the names of the
+  // datasets on process 0 and broadcasts them.
+  int   ReadStepInformation();
+  // Description:
+  // Total number of particles of a step, cached once known.
+  vtkIdType GetNumberOfParticles(int step);
 //  void  CopyIntoCoords(int offset, vtkDataArray *source, vtkDataArray *dest);
   // returns 0 if no, returns 1,2,3,45 etc for the first, second...
   // example : if CombineVectorComponents is true, then 
@@ -202,12 +229,20 @@ protected:
   int           UpdateNumPieces;
   int           MaskOutOfTimeRangeOutput;
   int           TimeOutOfRange;
+  int           LevelOfDetail;
+  char         *SubsampleIndexArray;
+  // Particles loaded at a coarser level, refined when a finer one is asked.
+  vtkPolyData  *LevelOfDetailCache;
+  int           LevelOfDetailCacheLevel;
+  int           LevelOfDetailCacheStep;
   //
   char         *Xarray;
   char         *Yarray;
   char         *Zarray;
   //BTX
   std::vector<double>                  TimeStepValues;
+  std::vector<vtkIdType>               NumberOfParticles;
+  std::string                          LevelOfDetailCacheKey;
   typedef std::vector<std::string>  stringlist;
   std::vector<stringlist>              FieldArrays;
   //ETX
@@ -30,6 +30,7 @@
 #include "vtkDepthSortPainter.h"
 
 #include "vtkObjectFactory.h"
+#include "vtkActor.h"
 #include "vtkIdTypeArray.h"
 #include "vtkDataSet.h"
 #include "vtkCamera.h"
@@ -48,10 +49,13 @@
 #include "vtkProperty.h"
 #include "vtkDepthSortPolyData.h"
 #include "vtkScalarsToColors.h"
+#include "vtkPVMultiThreader.h"
 
 #include <vector>
+#include <map>
 #include <algorithm>
 #include <functional>
+#include <string.h>
 
 #include <cmath>
 #include "vtkImageData.h"
@@ -60,6 +64,238 @@
 #include "vtkCellData.h"
 #include "vtkPolyData.h"
 
+// Inputs with fewer vertices are sorted using a single thread.
+#define VTK_DSP_MIN_THREADED_SIZE 100000
+
+// The previous order is dropped when fixing it up takes more than this many
+// moves per vertex.
+#define VTK_DSP_MAX_MOVES_PER_VERTEX 4
+
+//-----------------------------------------------------------------------------
+class vtkDepthSortPainter::vtkInternals
+{
+public:
+  struct OrderType
+    {
+    std::vector<vtkIdType> Order;
+    unsigned long MTime;
+    };
+
+  // Order of the last sort for each input dataset. PreviousOrders holds the
+  // orders of the previous render while sorting.
+  std::map<vtkDataSet*, OrderType> Orders;
+  std::map<vtkDataSet*, OrderType> PreviousOrders;
+};
+
+//-----------------------------------------------------------------------------
+namespace
+{
+  struct vtkDSPKey
+    {
+    vtkTypeUInt32 Key;
+    vtkIdType Id;
+    };
+
+  enum { VTK_DSP_DEPTHS, VTK_DSP_KEYS, VTK_DSP_HISTOGRAM, VTK_DSP_SCATTER };
+
+  struct vtkDSPSortData
+    {
+    vtkDataArray* Points;
+    const vtkIdType* FirstPoint; // first point of each cell
+    vtkIdType NumberOfCells;
+    double Origin[3];
+    double Direction[3];
+    double Projection[16];       // model to clip coordinates, for bins
+    int NumberOfScreenBins;
+    int DepthBits;
+    double Max;
+    double Scale;
+
+    int Phase;
+    int Shift;
+    int NumberOfThreads;
+    vtkPVMultiThreader* Threader;
+
+    std::vector<double> Depths;
+    std::vector<double> Ranges;  // one range per thread
+    std::vector<vtkIdType> Counts; // 256 counts per thread
+    vtkDSPKey* Input;
+    vtkDSPKey* Output;
+    };
+
+  template <class T>
+  void vtkDSPComputeDepths(const T* pts, vtkDSPSortData* sd, vtkIdType begin,
+    vtkIdType end, double* range)
+    {
+    const double* o = sd->Origin;
+    const double* v = sd->Direction;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      const T* p = pts + 3 * sd->FirstPoint[i];
+      double depth = (p[0] - o[0]) * v[0] + (p[1] - o[1]) * v[1] +
+        (p[2] - o[2]) * v[2];
+      sd->Depths[i] = depth;
+      range[0] = depth < range[0] ? depth : range[0];
+      range[1] = depth > range[1] ? depth : range[1];
+      }
+    }
+
+  template <class T>
+  void vtkDSPComputeKeys(const T* pts, vtkDSPSortData* sd, vtkIdType begin,
+    vtkIdType end)
+    {
+    const double* m = sd->Projection;
+    const int bins = sd->NumberOfScreenBins;
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      // farthest points first.
+      vtkTypeUInt32 key = static_cast<vtkTypeUInt32>(
+        (sd->Max - sd->Depths[i]) * sd->Scale);
+      if (bins > 1)
+        {
+        const T* p = pts + 3 * sd->FirstPoint[i];
+        double x = m[0] * p[0] + m[1] * p[1] + m[2] * p[2] + m[3];
+        double y = m[4] * p[0] + m[5] * p[1] + m[6] * p[2] + m[7];
+        double w = m[12] * p[0] + m[13] * p[1] + m[14] * p[2] + m[15];
+        int bx = 0;
+        int by = 0;
+        if (w > 0.0)
+          {
+          bx = static_cast<int>((x / w + 1.0) * 0.5 * bins);
+          by = static_cast<int>((y / w + 1.0) * 0.5 * bins);
+          bx = bx < 0 ? 0 : (bx >= bins ? bins - 1 : bx);
+          by = by < 0 ? 0 : (by >= bins ? bins - 1 : by);
+          }
+        key |= static_cast<vtkTypeUInt32>(by * bins + bx) << sd->DepthBits;
+        }
+      sd->Input[i].Key = key;
+      sd->Input[i].Id = i;
+      }
+    }
+
+  void vtkDSPSlice(vtkDSPSortData* sd, int threadId, int numThreads)
+    {
+    vtkIdType begin = (sd->NumberOfCells * threadId) / numThreads;
+    vtkIdType end = (sd->NumberOfCells * (threadId + 1)) / numThreads;
+    vtkIdType* counts = &sd->Counts[256 * threadId];
+    switch (sd->Phase)
+      {
+      case VTK_DSP_DEPTHS:
+        switch (sd->Points->GetDataType())
+          {
+          vtkTemplateMacro(vtkDSPComputeDepths(
+              static_cast<VTK_TT*>(sd->Points->GetVoidPointer(0)), sd, begin,
+              end, &sd->Ranges[2 * threadId]));
+          }
+        break;
+
+      case VTK_DSP_KEYS:
+        switch (sd->Points->GetDataType())
+          {
+          vtkTemplateMacro(vtkDSPComputeKeys(
+              static_cast<VTK_TT*>(sd->Points->GetVoidPointer(0)), sd, begin,
+              end));
+          }
+        break;
+
+      case VTK_DSP_HISTOGRAM:
+        std::fill(counts, counts + 256, 0);
+        for (vtkIdType i = begin; i < end; ++i)
+          {
+          counts[(sd->Input[i].Key >> sd->Shift) & 0xff]++;
+          }
+        break;
+
+      case VTK_DSP_SCATTER:
+        // counts hold the offsets of this thread for each digit.
+        for (vtkIdType i = begin; i < end; ++i)
+          {
+          sd->Output[counts[(sd->Input[i].Key >> sd->Shift) & 0xff]++] =
+            sd->Input[i];
+          }
+        break;
+      }
+    }
+
+  VTK_THREAD_RETURN_TYPE vtkDSPThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkDSPSlice(static_cast<vtkDSPSortData*>(info->UserData),
+      info->ThreadID, info->NumberOfThreads);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  void vtkDSPExecute(vtkDSPSortData* sd, int phase)
+    {
+    sd->Phase = phase;
+    sd->Threader->Execute(sd->NumberOfThreads, vtkDSPThread, sd);
+    }
+
+  // Stable least significant digit radix sort of sd->Input, 8 bits at a
+  // time. buffer must have as many entries as sd->Input. Returns the sorted
+  // entries, which are either sd->Input or buffer.
+  vtkDSPKey* vtkDSPRadixSort(vtkDSPSortData* sd, vtkDSPKey* buffer)
+    {
+    const int numThreads = sd->NumberOfThreads;
+    sd->Output = buffer;
+    for (sd->Shift = 0; sd->Shift < 32; sd->Shift += 8)
+      {
+      vtkDSPExecute(sd, VTK_DSP_HISTOGRAM);
+
+      // turn the counts into offsets, digit major, thread minor.
+      vtkIdType offset = 0;
+      bool constant = false;
+      for (int digit = 0; digit < 256 && !constant; ++digit)
+        {
+        vtkIdType total = 0;
+        for (int t = 0; t < numThreads; ++t)
+          {
+          vtkIdType& count = sd->Counts[256 * t + digit];
+          vtkIdType c = count;
+          count = offset + total;
+          total += c;
+          }
+        offset += total;
+        constant = (total == sd->NumberOfCells);
+        }
+      if (constant)
+        {
+        // all keys have the same digit, nothing to do for this pass.
+        continue;
+        }
+
+      vtkDSPExecute(sd, VTK_DSP_SCATTER);
+      std::swap(sd->Input, sd->Output);
+      }
+    return sd->Input;
+    }
+
+  // Sorts keys, which starts as a nearly sorted array, with an insertion
+  // sort. Returns false if that needs more than maxMoves moves.
+  bool vtkDSPInsertionSort(vtkDSPKey* keys, vtkIdType num, vtkIdType maxMoves)
+    {
+    vtkIdType moves = 0;
+    for (vtkIdType i = 1; i < num; ++i)
+      {
+      vtkDSPKey current = keys[i];
+      vtkIdType j = i;
+      while (j > 0 && keys[j - 1].Key > current.Key)
+        {
+        keys[j] = keys[j - 1];
+        --j;
+        }
+      keys[j] = current;
+      moves += i - j;
+      if (moves > maxMoves)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkDepthSortPainter)
 //-----------------------------------------------------------------------------
@@ -75,17 +311,26 @@ vtkDepthSortPainter::vtkDepthSortPainter()
   this->CachedIsColorSemiTranslucent = 1;
   this->DepthSortPolyData = vtkDepthSortPolyData::New();
   this->OutputData = NULL;
+  this->SortMethod = SORT_RADIX;
+  this->ReuseSortOrder = 1;
+  this->NumberOfScreenBins = 0;
+  this->Internals = new vtkInternals();
 }
 //-----------------------------------------------------------------------------
 vtkDepthSortPainter::~vtkDepthSortPainter()
 {
   this->SetDepthSortPolyData(NULL);
   this->SetOutputData(NULL);
+  delete this->Internals;
 }
 //-----------------------------------------------------------------------------
 void vtkDepthSortPainter::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DepthSortEnableMode: " << this->DepthSortEnableMode << endl;
+  os << indent << "SortMethod: " << this->SortMethod << endl;
+  os << indent << "ReuseSortOrder: " << this->ReuseSortOrder << endl;
+  os << indent << "NumberOfScreenBins: " << this->NumberOfScreenBins << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -120,6 +365,10 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
 
   if (this->DepthSortPolyData != NULL && this->NeedSorting(renderer, actor))
     {
+    // keep the orders of the previous render only until the end of this one.
+    this->Internals->PreviousOrders.swap(this->Internals->Orders);
+    this->Internals->Orders.clear();
+
     if (input->IsA("vtkCompositeDataSet"))
       {
       vtkCompositeDataSet* cdInput = vtkCompositeDataSet::SafeDownCast(input);
@@ -130,10 +379,14 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
         {
         vtkDataSet* pdInput = vtkDataSet::SafeDownCast(
             iter->GetCurrentDataObject());
-        vtkDataSet* pdOutput = vtkDataSet::SafeDownCast(cdOutput->GetDataSet(
-            iter));
-        if (pdInput && pdOutput)
+        if (pdInput)
           {
+          // the shallow copy of the composite input shares its leaves, sort
+          // into a copy of each leaf so that the input is left unchanged.
+          vtkDataSet* pdOutput = pdInput->NewInstance();
+          pdOutput->ShallowCopy(pdInput);
+          cdOutput->SetDataSet(iter, pdOutput);
+          pdOutput->Delete();
           this->Sort(pdOutput, pdInput, renderer, actor);
           }
         }
@@ -145,15 +398,26 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
       this->Sort(vtkDataSet::SafeDownCast(this->OutputData),
           vtkDataSet::SafeDownCast(input), renderer, actor);
       }
+    this->Internals->PreviousOrders.clear();
     this->SortTime.Modified();
     }
+  else
+    {
+    this->Internals->Orders.clear();
+    }
 }
 
 void vtkDepthSortPainter::Sort(vtkDataSet* output,
     vtkDataSet* input,
-    vtkRenderer* vtkNotUsed(renderer),
-    vtkActor* vtkNotUsed(actor))
+    vtkRenderer* renderer,
+    vtkActor* actor)
 {
+  if (this->SortMethod == SORT_RADIX &&
+    this->SortVertices(output, input, renderer, actor))
+    {
+    return;
+    }
+
   this->DepthSortPolyData->SetInputData(input);
 
   this->DepthSortPolyData->Update();
@@ -163,6 +427,178 @@ void vtkDepthSortPainter::Sort(vtkDataSet* output,
   output->ShallowCopy(polyData);
 }
 
+bool vtkDepthSortPainter::SortVertices(vtkDataSet* output,
+    vtkDataSet* input,
+    vtkRenderer* renderer,
+    vtkActor* actor)
+{
+  vtkPolyData* pdInput = vtkPolyData::SafeDownCast(input);
+  vtkPolyData* pdOutput = vtkPolyData::SafeDownCast(output);
+  if (!pdInput || !pdOutput || !pdInput->GetPoints() ||
+    pdInput->GetNumberOfCells() == 0 ||
+    pdInput->GetNumberOfCells() != pdInput->GetNumberOfVerts())
+    {
+    return false;
+    }
+
+  // locate the cells and their first point.
+  vtkCellArray* verts = pdInput->GetVerts();
+  const vtkIdType numCells = verts->GetNumberOfCells();
+  const vtkIdType* connectivity = verts->GetPointer();
+  std::vector<vtkIdType> locations(numCells);
+  std::vector<vtkIdType> firstPoints(numCells);
+  vtkIdType location = 0;
+  for (vtkIdType i = 0; i < numCells; ++i)
+    {
+    if (connectivity[location] < 1)
+      {
+      return false;
+      }
+    locations[i] = location;
+    firstPoints[i] = connectivity[location + 1];
+    location += connectivity[location] + 1;
+    }
+
+  vtkDSPSortData sd;
+  sd.Points = pdInput->GetPoints()->GetData();
+  sd.FirstPoint = &firstPoints[0];
+  sd.NumberOfCells = numCells;
+  sd.NumberOfScreenBins = this->NumberOfScreenBins;
+
+  // view direction in the coordinates of the data, as in vtkDepthSortPolyData.
+  vtkCamera* camera = renderer->GetActiveCamera();
+  double position[4] = { 0.0, 0.0, 0.0, 1.0 };
+  double focalPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+  camera->GetPosition(position);
+  camera->GetFocalPoint(focalPoint);
+  vtkMatrix4x4* matrix = vtkMatrix4x4::New();
+  vtkMatrix4x4* inverse = vtkMatrix4x4::New();
+  if (actor)
+    {
+    matrix->DeepCopy(actor->GetMatrix());
+    }
+  vtkMatrix4x4::Invert(matrix, inverse);
+  inverse->MultiplyPoint(position, position);
+  inverse->MultiplyPoint(focalPoint, focalPoint);
+  for (int c = 0; c < 3; ++c)
+    {
+    sd.Origin[c] = position[c] / position[3];
+    sd.Direction[c] = focalPoint[c] / focalPoint[3] - sd.Origin[c];
+    }
+
+  int binBits = 0;
+  if (this->NumberOfScreenBins > 1)
+    {
+    vtkMatrix4x4* projection = vtkMatrix4x4::New();
+    vtkMatrix4x4::Multiply4x4(camera->GetCompositeProjectionTransformMatrix(
+        renderer->GetTiledAspectRatio(), -1, 1), matrix, projection);
+    vtkMatrix4x4::DeepCopy(sd.Projection, projection);
+    projection->Delete();
+    while ((1 << binBits) <
+      this->NumberOfScreenBins * this->NumberOfScreenBins)
+      {
+      ++binBits;
+      }
+    }
+  matrix->Delete();
+  inverse->Delete();
+  sd.DepthBits = 32 - binBits;
+
+  sd.Threader = vtkPVMultiThreader::New();
+  sd.NumberOfThreads = sd.Threader->GetNumberOfThreadsFor(numCells,
+    VTK_DSP_MIN_THREADED_SIZE);
+  sd.Counts.resize(256 * sd.NumberOfThreads);
+  sd.Ranges.resize(2 * sd.NumberOfThreads);
+  for (int t = 0; t < sd.NumberOfThreads; ++t)
+    {
+    sd.Ranges[2 * t] = VTK_DOUBLE_MAX;
+    sd.Ranges[2 * t + 1] = -VTK_DOUBLE_MAX;
+    }
+
+  // depths, then integer keys with the quantized depths.
+  sd.Depths.resize(numCells);
+  vtkDSPExecute(&sd, VTK_DSP_DEPTHS);
+  double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  for (int t = 0; t < sd.NumberOfThreads; ++t)
+    {
+    range[0] = std::min(range[0], sd.Ranges[2 * t]);
+    range[1] = std::max(range[1], sd.Ranges[2 * t + 1]);
+    }
+  sd.Max = range[1];
+  sd.Scale = range[1] > range[0] ?
+    (std::pow(2.0, sd.DepthBits) - 1.0) / (range[1] - range[0]) : 0.0;
+
+  std::vector<vtkDSPKey> keys(numCells);
+  std::vector<vtkDSPKey> buffer(numCells);
+  sd.Input = &keys[0];
+  vtkDSPExecute(&sd, VTK_DSP_KEYS);
+  std::vector<double>().swap(sd.Depths);
+
+  // try to fix up the previous order first.
+  vtkDSPKey* sorted = NULL;
+  std::map<vtkDataSet*, vtkInternals::OrderType>::iterator prev =
+    this->Internals->PreviousOrders.find(input);
+  if (this->ReuseSortOrder && prev != this->Internals->PreviousOrders.end() &&
+    prev->second.MTime == input->GetMTime() &&
+    static_cast<vtkIdType>(prev->second.Order.size()) == numCells)
+    {
+    const std::vector<vtkIdType>& order = prev->second.Order;
+    for (vtkIdType i = 0; i < numCells; ++i)
+      {
+      buffer[i] = keys[order[i]];
+      }
+    if (vtkDSPInsertionSort(&buffer[0], numCells,
+        VTK_DSP_MAX_MOVES_PER_VERTEX * numCells))
+      {
+      sorted = &buffer[0];
+      }
+    }
+  if (!sorted)
+    {
+    sorted = vtkDSPRadixSort(&sd, &buffer[0]);
+    }
+  sd.Threader->Delete();
+
+  // remember the order for the next render.
+  vtkInternals::OrderType& next = this->Internals->Orders[input];
+  next.MTime = input->GetMTime();
+  next.Order.resize(numCells);
+  for (vtkIdType i = 0; i < numCells; ++i)
+    {
+    next.Order[i] = sorted[i].Id;
+    }
+
+  // reorder the vertex cells and the cell data.
+  vtkIdTypeArray* ids = vtkIdTypeArray::New();
+  ids->SetNumberOfTuples(verts->GetNumberOfConnectivityEntries());
+  vtkIdType* dest = ids->GetPointer(0);
+  for (vtkIdType i = 0; i < numCells; ++i)
+    {
+    const vtkIdType* cell = connectivity + locations[next.Order[i]];
+    memcpy(dest, cell, (cell[0] + 1) * sizeof(vtkIdType));
+    dest += cell[0] + 1;
+    }
+  vtkCellArray* newVerts = vtkCellArray::New();
+  newVerts->SetCells(numCells, ids);
+  pdOutput->SetVerts(newVerts);
+  newVerts->Delete();
+  ids->Delete();
+
+  vtkCellData* inCD = pdInput->GetCellData();
+  if (inCD->GetNumberOfArrays() > 0)
+    {
+    vtkCellData* outCD = vtkCellData::New();
+    outCD->CopyAllocate(inCD, numCells);
+    for (vtkIdType i = 0; i < numCells; ++i)
+      {
+      outCD->CopyData(inCD, next.Order[i], i);
+      }
+    pdOutput->GetCellData()->ShallowCopy(outCD);
+    outCD->Delete();
+    }
+  return true;
+}
+
 int vtkDepthSortPainter::NeedSorting(vtkRenderer* renderer, vtkActor* actor)
 {
   if (!actor || !renderer)
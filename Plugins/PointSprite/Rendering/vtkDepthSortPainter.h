@@ -32,6 +32,14 @@
 // painter does nothing.
 // This painter is useful with the point sprite painter
 // to sort points when depth peeling is disabled.
+//
+// When the input only has vertex cells, as with point sprites, the points are
+// sorted by this painter directly (SortMethod SORT_RADIX): the view-space
+// depths are quantized to integer keys which are sorted with a multi-threaded
+// radix sort. When the camera moved a little since the last render, the
+// previous order is nearly sorted and is simply fixed up instead
+// (ReuseSortOrder). Other inputs are sorted with the vtkDepthSortPolyData
+// filter.
 
 #ifndef __vtkDepthSortPainter_h
 #define __vtkDepthSortPainter_h
@@ -57,6 +65,43 @@ public:
   virtual void PrintSelf(ostream &os, vtkIndent indent);
   static vtkDepthSortPainter *New();
 
+  //BTX
+  // Description:
+  // How the points are sorted.
+  // 0 : SORT_DEPTH_SORT_POLYDATA always uses the vtkDepthSortPolyData filter.
+  // 1 : SORT_RADIX uses a radix sort on quantized depths for inputs with only
+  //     vertex cells, and vtkDepthSortPolyData otherwise.
+  enum { SORT_DEPTH_SORT_POLYDATA=0, SORT_RADIX=1 };
+  //ETX
+
+  // Description:
+  // Set/Get how the points are sorted. SORT_RADIX by default.
+  vtkSetClampMacro(SortMethod, int, SORT_DEPTH_SORT_POLYDATA, SORT_RADIX);
+  vtkGetMacro(SortMethod, int);
+  void SetSortMethodToDepthSortPolyData()
+    { this->SetSortMethod(SORT_DEPTH_SORT_POLYDATA); }
+  void SetSortMethodToRadix() { this->SetSortMethod(SORT_RADIX); }
+
+  // Description:
+  // When on, the order computed for the previous render is used as the
+  // starting point of the next sort of the same input. It is fixed up with an
+  // insertion sort, which is faster than sorting again for small camera moves.
+  // When the order changed too much, the points are sorted again. Only used
+  // with SORT_RADIX. On by default.
+  vtkSetMacro(ReuseSortOrder, int);
+  vtkGetMacro(ReuseSortOrder, int);
+  vtkBooleanMacro(ReuseSortOrder, int);
+
+  // Description:
+  // When greater than 1, the screen is split in NumberOfScreenBins x
+  // NumberOfScreenBins bins and the points are only sorted by depth within
+  // each bin, bins being drawn one after the other. This keeps the points
+  // drawn together close on screen, at the expense of blending errors for
+  // sprites that overlap several bins. Only used with SORT_RADIX. 0 (off) by
+  // default.
+  vtkSetClampMacro(NumberOfScreenBins, int, 0, 256);
+  vtkGetMacro(NumberOfScreenBins, int);
+
   //BTX
   // Description:
   // Enable or Disable depth sort.
@@ -109,6 +154,12 @@ protected:
   // do the sorting for a given dataset
   virtual void Sort(vtkDataSet* output, vtkDataSet* input, vtkRenderer* renderer, vtkActor* actor);
 
+  // Description:
+  // Sorts the vertices of input into output with a radix sort. Returns false
+  // if input does not only have vertex cells, in which case nothing is done.
+  virtual bool SortVertices(vtkDataSet* output, vtkDataSet* input,
+    vtkRenderer* renderer, vtkActor* actor);
+
   // Description:
   // Called just before RenderInternal(). We sort the points here if the
   // renderer's camera has been modified.
@@ -140,6 +191,9 @@ protected:
   vtkTimeStamp          CachedIsColorSemiTranslucentTime;
   int                   CachedIsColorSemiTranslucent;
   vtkDepthSortPolyData* DepthSortPolyData;
+  int                   SortMethod;
+  int                   ReuseSortOrder;
+  int                   NumberOfScreenBins;
 
   //BTX
   vtkWeakPointer<vtkDataObject> PrevInput;
@@ -148,6 +202,11 @@ protected:
   //ETX
 
 private:
+  //BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+  //ETX
+
   vtkDepthSortPainter(const vtkDepthSortPainter &);  // Not implemented.
   void operator=(const vtkDepthSortPainter &);  // Not implemented.
 };
@@ -0,0 +1,354 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDepthSortPainter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the vertices sorted by vtkDepthSortPainter with its radix sort
+// are in the back to front order given by std::sort on the exact depths, with
+// one thread or several, and when the previous order is fixed up after a
+// small camera move, also for the leaves of a composite input which must be
+// left unchanged.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDepthSortPainter.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// Gives access to PrepareForRendering(), which sorts the input.
+class vtkTestDepthSortPainter : public vtkDepthSortPainter
+{
+public:
+  static vtkTestDepthSortPainter* New();
+  vtkTypeMacro(vtkTestDepthSortPainter, vtkDepthSortPainter);
+
+  void Prepare(vtkRenderer* renderer, vtkActor* actor)
+    {
+    this->Modified();
+    this->PrepareForRendering(renderer, actor);
+    }
+};
+vtkStandardNewMacro(vtkTestDepthSortPainter);
+
+// ----------------------------------------------------------------------------
+// Random vertices, some of them at the same place, with a cell array holding
+// the index of each vertex.
+vtkSmartPointer<vtkPolyData> CreateVertices(vtkIdType numPoints)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetNumberOfPoints(numPoints);
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  vtkSmartPointer<vtkIdTypeArray> index =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  index->SetName("Index");
+  index->SetNumberOfTuples(numPoints);
+  vtkMath::RandomSeed(1234);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    if (i % 10 == 9)
+      {
+      points->SetPoint(i, points->GetPoint(i - 1));
+      }
+    else
+      {
+      points->SetPoint(i, vtkMath::Random(-1.0, 1.0),
+        vtkMath::Random(-1.0, 1.0), vtkMath::Random(-1.0, 1.0));
+      }
+    verts->InsertNextCell(1, &i);
+    index->SetValue(i, i);
+    }
+  vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+  pd->SetPoints(points);
+  pd->SetVerts(verts);
+  pd->GetCellData()->AddArray(index);
+  return pd;
+}
+
+// ----------------------------------------------------------------------------
+struct FartherFirst
+{
+  const std::vector<double>* Depths;
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    return (*this->Depths)[a] > (*this->Depths)[b];
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Returns the order of the vertices in output, or an empty order if the
+// vertices or their cell data are not a permutation of the input.
+std::vector<vtkIdType> GetOrder(vtkPolyData* output, vtkIdType numPoints)
+{
+  std::vector<vtkIdType> order;
+  vtkIdTypeArray* index = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("Index"));
+  if (!index || output->GetNumberOfVerts() != numPoints ||
+    index->GetNumberOfTuples() != numPoints)
+    {
+    cout << "The output does not have " << numPoints << " vertices." << endl;
+    return order;
+    }
+  std::vector<bool> seen(numPoints, false);
+  const vtkIdType* cells = output->GetVerts()->GetPointer();
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    vtkIdType id = cells[2 * i + 1];
+    if (cells[2 * i] != 1 || id < 0 || id >= numPoints || seen[id] ||
+      index->GetValue(i) != id)
+      {
+      cout << "Vertex " << i << " is not a permutation of the input." << endl;
+      order.clear();
+      return order;
+      }
+    seen[id] = true;
+    order.push_back(id);
+    }
+  return order;
+}
+
+// ----------------------------------------------------------------------------
+// The depths are quantized before sorting, so vertices closer than one
+// quantization step may be swapped: the depths at each position must match
+// those sorted by std::sort up to that step.
+bool CheckOrder(const std::vector<vtkIdType>& order, vtkPolyData* input,
+  vtkCamera* camera, const char* what)
+{
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  if (static_cast<vtkIdType>(order.size()) != numPoints)
+    {
+    cout << what << ": the vertices were not sorted." << endl;
+    return false;
+    }
+
+  double position[3];
+  double focalPoint[3];
+  camera->GetPosition(position);
+  camera->GetFocalPoint(focalPoint);
+  std::vector<double> depths(numPoints);
+  std::vector<vtkIdType> expected(numPoints);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    double* x = input->GetPoint(i);
+    depths[i] = 0.0;
+    for (int c = 0; c < 3; ++c)
+      {
+      depths[i] += (x[c] - position[c]) * (focalPoint[c] - position[c]);
+      }
+    expected[i] = i;
+    }
+  FartherFirst comp;
+  comp.Depths = &depths;
+  std::sort(expected.begin(), expected.end(), comp);
+
+  double range = depths[expected[0]] - depths[expected[numPoints - 1]];
+  double tolerance = 2.0 * range / (std::pow(2.0, 32) - 1.0);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    if (fabs(depths[order[i]] - depths[expected[i]]) > tolerance)
+      {
+      cout << what << ": vertex " << i << " is " << order[i] << " at depth "
+           << depths[order[i]] << " instead of " << expected[i] << " at depth "
+           << depths[expected[i]] << "." << endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+std::vector<vtkIdType> Sort(vtkPolyData* input, vtkRenderer* renderer,
+  vtkActor* actor, int reuse)
+{
+  vtkSmartPointer<vtkTestDepthSortPainter> painter =
+    vtkSmartPointer<vtkTestDepthSortPainter>::New();
+  painter->SetInput(input);
+  painter->SetDepthSortEnableModeToAlways();
+  painter->SetSortMethodToRadix();
+  painter->SetReuseSortOrder(reuse);
+  painter->Prepare(renderer, actor);
+  return GetOrder(vtkPolyData::SafeDownCast(painter->GetOutput()),
+    input->GetNumberOfPoints());
+}
+
+// ----------------------------------------------------------------------------
+// Random vertices, the first two of which are at the same depth when seen
+// from the z axis.
+vtkSmartPointer<vtkPolyData> CreateTiedVertices(vtkIdType numPoints)
+{
+  vtkSmartPointer<vtkPolyData> pd = CreateVertices(numPoints);
+  pd->GetPoints()->SetPoint(0, 1.0, 0.0, 0.0);
+  pd->GetPoints()->SetPoint(1, -1.0, 0.0, 0.0);
+  return pd;
+}
+
+// ----------------------------------------------------------------------------
+// Returns the position of vertex id in order, or -1.
+vtkIdType Position(const std::vector<vtkIdType>& order, vtkIdType id)
+{
+  std::vector<vtkIdType>::const_iterator it =
+    std::find(order.begin(), order.end(), id);
+  return it == order.end() ? -1 : static_cast<vtkIdType>(it - order.begin());
+}
+
+// ----------------------------------------------------------------------------
+// The leaves of a composite input are sorted into copies and the input is not
+// modified, so that the order of the previous render is reused: vertices 0
+// and 1 are at the same depth from the second camera, the reused order keeps
+// the farther one from the first camera, 1, first while a new sort keeps the
+// input order.
+bool CheckCompositeInput(vtkRenderer* renderer, vtkActor* actor)
+{
+  const int numBlocks = 2;
+  vtkSmartPointer<vtkMultiBlockDataSet> input =
+    vtkSmartPointer<vtkMultiBlockDataSet>::New();
+  vtkCellArray* verts[numBlocks];
+  unsigned long mtimes[numBlocks];
+  for (int b = 0; b < numBlocks; ++b)
+    {
+    vtkSmartPointer<vtkPolyData> leaf = CreateTiedVertices(1000);
+    input->SetBlock(b, leaf);
+    verts[b] = leaf->GetVerts();
+    mtimes[b] = leaf->GetMTime();
+    }
+
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetFocalPoint(0.0, 0.0, 0.0);
+  camera->SetViewUp(0.0, 1.0, 0.0);
+  vtkSmartPointer<vtkTestDepthSortPainter> painter =
+    vtkSmartPointer<vtkTestDepthSortPainter>::New();
+  painter->SetInput(input);
+  painter->SetDepthSortEnableModeToAlways();
+  painter->SetSortMethodToRadix();
+  painter->SetReuseSortOrder(1);
+  const double x[] = { 0.01, 0.0 };
+  bool ok = true;
+  for (int c = 0; c < 2; ++c)
+    {
+    camera->SetPosition(x[c], 0.0, 5.0);
+    painter->Prepare(renderer, actor);
+    vtkMultiBlockDataSet* output =
+      vtkMultiBlockDataSet::SafeDownCast(painter->GetOutput());
+    for (int b = 0; b < numBlocks; ++b)
+      {
+      vtkPolyData* leaf = vtkPolyData::SafeDownCast(input->GetBlock(b));
+      vtkPolyData* sorted = output ?
+        vtkPolyData::SafeDownCast(output->GetBlock(b)) : NULL;
+      if (!sorted || sorted == leaf)
+        {
+        cout << "Block " << b << " was not sorted into a copy." << endl;
+        return false;
+        }
+      std::vector<vtkIdType> order =
+        GetOrder(sorted, leaf->GetNumberOfPoints());
+      ok = CheckOrder(order, leaf, camera, "Composite input") && ok;
+      if (Position(order, 1) > Position(order, 0))
+        {
+        cout << "Block " << b << " was sorted again instead of reusing the "
+             << "previous order." << endl;
+        ok = false;
+        }
+
+      std::vector<vtkIdType> inputOrder =
+        GetOrder(leaf, leaf->GetNumberOfPoints());
+      bool identity = inputOrder.size() == 1000;
+      for (size_t i = 0; i < inputOrder.size(); ++i)
+        {
+        identity = identity && inputOrder[i] == static_cast<vtkIdType>(i);
+        }
+      if (!identity || leaf->GetVerts() != verts[b] ||
+        leaf->GetMTime() != mtimes[b])
+        {
+        cout << "Block " << b << " of the input was modified." << endl;
+        ok = false;
+        }
+      }
+    }
+
+  // A new sort keeps vertex 0 first.
+  std::vector<vtkIdType> order = Sort(
+    vtkPolyData::SafeDownCast(input->GetBlock(0)), renderer, actor, 0);
+  if (Position(order, 0) > Position(order, 1))
+    {
+    cout << "The vertices at the same depth were not kept in order." << endl;
+    ok = false;
+    }
+  return ok;
+}
+
+// ----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetPosition(0.3, -0.2, 5.0);
+  camera->SetFocalPoint(0.0, 0.0, 0.0);
+  vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+  actor->GetProperty()->SetOpacity(0.5);
+
+  int ok = 1;
+
+  // Fewer vertices than are sorted with several threads.
+  vtkSmartPointer<vtkPolyData> small = CreateVertices(1000);
+  ok = CheckOrder(Sort(small, renderer, actor, 0), small, camera, "Small") &&
+    ok;
+
+  // Enough vertices to sort with several threads, which must give the same
+  // order as a single thread since the radix sort is stable.
+  vtkSmartPointer<vtkPolyData> large = CreateVertices(250000);
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(1);
+  std::vector<vtkIdType> serial = Sort(large, renderer, actor, 0);
+  vtkMultiThreader::SetGlobalMaximumNumberOfThreads(0);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  std::vector<vtkIdType> threaded = Sort(large, renderer, actor, 0);
+  ok = CheckOrder(serial, large, camera, "Serial") && ok;
+  ok = CheckOrder(threaded, large, camera, "Threaded") && ok;
+  if (serial != threaded)
+    {
+    cout << "The serial and threaded orders differ." << endl;
+    ok = 0;
+    }
+
+  // The previous order is fixed up after a small camera move, or the vertices
+  // are sorted again.
+  vtkSmartPointer<vtkTestDepthSortPainter> painter =
+    vtkSmartPointer<vtkTestDepthSortPainter>::New();
+  painter->SetInput(small);
+  painter->SetDepthSortEnableModeToAlways();
+  painter->SetReuseSortOrder(1);
+  const double angles[] = { 0.0, 0.5, 2.0, 90.0 };
+  for (int a = 0; a < 4; ++a)
+    {
+    camera->Azimuth(angles[a]);
+    painter->Prepare(renderer, actor);
+    ok = CheckOrder(GetOrder(vtkPolyData::SafeDownCast(painter->GetOutput()),
+        small->GetNumberOfPoints()), small, camera, "Reused order") && ok;
+    }
+
+  ok = CheckCompositeInput(renderer, actor) && ok;
+
+  return ok ? 0 : 1;
+}
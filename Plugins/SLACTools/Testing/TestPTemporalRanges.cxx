@@ -0,0 +1,262 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPTemporalRanges.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the ranges vtkPTemporalRanges computes over several processes
+// with the time steps split among groups of processes are the ones it
+// computes when every process iterates over all time steps, and that they
+// match the values of the source.
+
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMPIController.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkPTemporalRanges.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+
+#include <math.h>
+
+#define NUMBER_OF_POINTS 1000
+#define NUMBER_OF_TIME_STEPS 7
+
+// ----------------------------------------------------------------------------
+// The points of the requested piece with a scalar and a vector field whose
+// values depend on the time step.
+class vtkTestTemporalPointSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkTestTemporalPointSource* New();
+  vtkTypeMacro(vtkTestTemporalPointSource, vtkPolyDataAlgorithm);
+
+  static double ScalarValue(int t, vtkIdType i)
+    {
+    return 10.0 * t + (i % 7);
+    }
+
+protected:
+  vtkTestTemporalPointSource()
+    {
+    this->SetNumberOfInputPorts(0);
+    }
+
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double times[NUMBER_OF_TIME_STEPS];
+    for (int t = 0; t < NUMBER_OF_TIME_STEPS; ++t)
+      {
+      times[t] = t;
+      }
+    double range[2] = { 0, NUMBER_OF_TIME_STEPS - 1 };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times,
+      NUMBER_OF_TIME_STEPS);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::MAXIMUM_NUMBER_OF_PIECES(),
+      -1);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData* output = vtkPolyData::GetData(outInfo);
+    int piece = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    int numPieces = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    double time = 0.0;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()))
+      {
+      time = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS())[0];
+      }
+    int t = static_cast<int>(floor(time + 0.5));
+
+    vtkIdType begin = (NUMBER_OF_POINTS * piece) / numPieces;
+    vtkIdType end = (NUMBER_OF_POINTS * (piece + 1)) / numPieces;
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetNumberOfPoints(end - begin);
+    vtkSmartPointer<vtkDoubleArray> f = vtkSmartPointer<vtkDoubleArray>::New();
+    f->SetName("f");
+    f->SetNumberOfTuples(end - begin);
+    vtkSmartPointer<vtkDoubleArray> v = vtkSmartPointer<vtkDoubleArray>::New();
+    v->SetName("v");
+    v->SetNumberOfComponents(3);
+    v->SetNumberOfTuples(end - begin);
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      points->SetPoint(i - begin, i, 0.0, 0.0);
+      f->SetValue(i - begin, ScalarValue(t, i));
+      v->SetTuple3(i - begin, t, i % 5, -t - (i % 3));
+      }
+    output->SetPoints(points);
+    output->GetPointData()->AddArray(f);
+    output->GetPointData()->AddArray(v);
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEPS(), &time, 1);
+    return 1;
+    }
+};
+vtkStandardNewMacro(vtkTestTemporalPointSource);
+
+// ----------------------------------------------------------------------------
+// The ranges reduced on process 0.
+vtkSmartPointer<vtkTable> ComputeRanges(vtkMultiProcessController* controller,
+  int numberOfTimeGroups)
+{
+  vtkSmartPointer<vtkTestTemporalPointSource> source =
+    vtkSmartPointer<vtkTestTemporalPointSource>::New();
+  vtkSmartPointer<vtkPTemporalRanges> ranges =
+    vtkSmartPointer<vtkPTemporalRanges>::New();
+  ranges->SetController(controller);
+  ranges->SetNumberOfTimeGroups(numberOfTimeGroups);
+  ranges->SetInputConnection(source->GetOutputPort());
+
+  vtkStreamingDemandDrivenPipeline* exec =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(ranges->GetExecutive());
+  exec->SetUpdateExtent(0, controller->GetLocalProcessId(),
+    controller->GetNumberOfProcesses(), 0);
+  ranges->Update();
+
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  table->ShallowCopy(ranges->GetOutput());
+  return table;
+}
+
+// ----------------------------------------------------------------------------
+bool CompareRanges(vtkTable* expected, vtkTable* table, const char* what)
+{
+  if (table->GetNumberOfColumns() != expected->GetNumberOfColumns() ||
+    table->GetNumberOfRows() != vtkTemporalRanges::NUMBER_OF_ROWS)
+    {
+    cout << what << ": " << table->GetNumberOfColumns() << " columns and "
+         << table->GetNumberOfRows() << " rows instead of "
+         << expected->GetNumberOfColumns() << " and "
+         << vtkTemporalRanges::NUMBER_OF_ROWS << "." << endl;
+    return false;
+    }
+  for (vtkIdType c = 0; c < expected->GetNumberOfColumns(); ++c)
+    {
+    vtkDoubleArray* expectedColumn =
+      vtkDoubleArray::SafeDownCast(expected->GetColumn(c));
+    if (!expectedColumn)
+      {
+      continue;
+      }
+    vtkDoubleArray* column = vtkDoubleArray::SafeDownCast(
+      table->GetColumnByName(expectedColumn->GetName()));
+    if (!column)
+      {
+      cout << what << ": no " << expectedColumn->GetName() << " column."
+           << endl;
+      return false;
+      }
+    for (int r = 0; r < vtkTemporalRanges::NUMBER_OF_ROWS; ++r)
+      {
+      double value = column->GetValue(r);
+      double expectedValue = expectedColumn->GetValue(r);
+      if (fabs(value - expectedValue) > 1e-9 * (1.0 + fabs(expectedValue)))
+        {
+        cout << what << ": row " << r << " of " << column->GetName()
+             << " is " << value << " instead of " << expectedValue << "."
+             << endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// The ranges of f over all points and time steps.
+bool CheckScalarRanges(vtkTable* table)
+{
+  double sum = 0.0;
+  double min = VTK_DOUBLE_MAX;
+  double max = -VTK_DOUBLE_MAX;
+  for (int t = 0; t < NUMBER_OF_TIME_STEPS; ++t)
+    {
+    for (vtkIdType i = 0; i < NUMBER_OF_POINTS; ++i)
+      {
+      double value = vtkTestTemporalPointSource::ScalarValue(t, i);
+      sum += value;
+      min = value < min ? value : min;
+      max = value > max ? value : max;
+      }
+    }
+
+  vtkSmartPointer<vtkTable> expected = vtkSmartPointer<vtkTable>::New();
+  vtkSmartPointer<vtkDoubleArray> f = vtkSmartPointer<vtkDoubleArray>::New();
+  f->SetName("f");
+  f->SetNumberOfTuples(vtkTemporalRanges::NUMBER_OF_ROWS);
+  f->SetValue(vtkTemporalRanges::AVERAGE_ROW,
+    sum / (NUMBER_OF_POINTS * NUMBER_OF_TIME_STEPS));
+  f->SetValue(vtkTemporalRanges::MINIMUM_ROW, min);
+  f->SetValue(vtkTemporalRanges::MAXIMUM_ROW, max);
+  f->SetValue(vtkTemporalRanges::COUNT_ROW,
+    NUMBER_OF_POINTS * NUMBER_OF_TIME_STEPS);
+  expected->AddColumn(f);
+
+  vtkAbstractArray* column = table->GetColumnByName("f");
+  if (!column)
+    {
+    cout << "No f column." << endl;
+    return false;
+    }
+  vtkSmartPointer<vtkTable> scalar = vtkSmartPointer<vtkTable>::New();
+  scalar->AddColumn(column);
+  return CompareRanges(expected, scalar, "Ranges of f");
+}
+
+// ----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+  int me = controller->GetLocalProcessId();
+
+  int ok = 1;
+  vtkSmartPointer<vtkTable> single = ComputeRanges(controller, 1);
+  if (me == 0)
+    {
+    ok = CheckScalarRanges(single);
+    }
+
+  // More groups than processes are limited to the number of processes.
+  const int numberOfGroups[] = { 2, 3, 100 };
+  for (int g = 0; g < 3; ++g)
+    {
+    vtkSmartPointer<vtkTable> grouped =
+      ComputeRanges(controller, numberOfGroups[g]);
+    if (me == 0)
+      {
+      cout << "Comparing the ranges of " << numberOfGroups[g]
+           << " time groups." << endl;
+      ok = CompareRanges(single, grouped, "Time groups") && ok;
+      }
+    }
+
+  controller->Broadcast(&ok, 1, 0);
+  controller->Finalize();
+  controller->Delete();
+  return ok ? 0 : 1;
+}
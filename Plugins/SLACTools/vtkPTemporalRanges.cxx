@@ -32,6 +32,8 @@
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
+#include <algorithm>
+
 //=============================================================================
 //=============================================================================
 class vtkPTemporalRanges::vtkRangeTableReduction : public vtkTableAlgorithm
@@ -100,6 +102,7 @@ vtkPTemporalRanges::vtkPTemporalRanges()
 {
   this->Controller = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
+  this->NumberOfTimeGroups = 1;
 }
 
 vtkPTemporalRanges::~vtkPTemporalRanges()
@@ -112,6 +115,74 @@ void vtkPTemporalRanges::PrintSelf(ostream &os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "NumberOfTimeGroups: " << this->NumberOfTimeGroups << endl;
+}
+
+//-----------------------------------------------------------------------------
+int vtkPTemporalRanges::GetTimeGroup(int numTimeSteps, int &group,
+                                     int &groupRank, int &groupSize)
+{
+  int numProcs = 1;
+  int procId = 0;
+  if (this->Controller)
+    {
+    numProcs = this->Controller->GetNumberOfProcesses();
+    procId = this->Controller->GetLocalProcessId();
+    }
+  int numGroups = std::min(this->NumberOfTimeGroups,
+                           std::min(numProcs, numTimeSteps));
+  if (numGroups <= 1)
+    {
+    group = 0;
+    groupRank = procId;
+    groupSize = numProcs;
+    return 1;
+    }
+
+  // Groups are made of consecutive ranks and differ in size by at most one.
+  group = (procId*numGroups)/numProcs;
+  int firstRank = (group*numProcs + numGroups - 1)/numGroups;
+  int nextRank = ((group + 1)*numProcs + numGroups - 1)/numGroups;
+  groupRank = procId - firstRank;
+  groupSize = nextRank - firstRank;
+  return numGroups;
+}
+
+//-----------------------------------------------------------------------------
+void vtkPTemporalRanges::GetTimeWindow(int numTimeSteps, int window[2])
+{
+  int group, groupRank, groupSize;
+  int numGroups = this->GetTimeGroup(numTimeSteps, group, groupRank, groupSize);
+  window[0] = (group*numTimeSteps)/numGroups;
+  window[1] = ((group + 1)*numTimeSteps)/numGroups;
+}
+
+//-----------------------------------------------------------------------------
+int vtkPTemporalRanges::RequestUpdateExtent(vtkInformation *request,
+                                            vtkInformationVector **inputVector,
+                                            vtkInformationVector *outputVector)
+{
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector,
+                                             outputVector))
+    {
+    return 0;
+    }
+
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  int group, groupRank, groupSize;
+  int numGroups = this->GetTimeGroup(
+    inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()),
+    group, groupRank, groupSize);
+  if (numGroups > 1)
+    {
+    // The processes of a group share the data of its time steps.
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+                groupRank);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+                groupSize);
+    }
+
+  return 1;
 }
 
 //-----------------------------------------------------------------------------
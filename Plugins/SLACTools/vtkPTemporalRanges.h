@@ -25,6 +25,13 @@
 // vtkPTemporalRanges works basically like its superclass, vtkTemporalRanges,
 // except that it works in a data parallel manner.
 //
+// When NumberOfTimeGroups is more than 1, the processes are also split into
+// that many groups of consecutive ranks, each group iterating over its own
+// window of time steps while its processes share the pieces of the data.
+// The partial ranges are merged at the end as in the data parallel case.
+// Since the groups iterate a different number of times, the upstream
+// pipeline must not communicate between processes in this mode.
+//
 
 #ifndef __vtkPTemporalRanges_h
 #define __vtkPTemporalRanges_h
@@ -43,16 +50,36 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController *);
 
+  // Description:
+  // Number of groups of processes the time steps are divided among.  1, the
+  // default, has all processes iterate over all time steps.  It is limited
+  // to the number of processes and of time steps.
+  vtkSetClampMacro(NumberOfTimeGroups, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfTimeGroups, int);
+
 protected:
   vtkPTemporalRanges();
   ~vtkPTemporalRanges();
 
   vtkMultiProcessController *Controller;
+  int NumberOfTimeGroups;
+
+  virtual int RequestUpdateExtent(vtkInformation *,
+                                  vtkInformationVector **,
+                                  vtkInformationVector *);
 
   virtual int RequestData(vtkInformation *,
                           vtkInformationVector **,
                           vtkInformationVector *);
 
+  virtual void GetTimeWindow(int numTimeSteps, int window[2]);
+
+  // Description:
+  // Group of this process, and its rank and size, for the given number of
+  // time steps.  Returns the number of groups actually used.
+  int GetTimeGroup(int numTimeSteps, int &group, int &groupRank,
+                   int &groupSize);
+
   virtual void Reduce(vtkTable *table);
 
 private:
@@ -172,8 +172,11 @@ int vtkTemporalRanges::RequestUpdateExtent(
   double *inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
   if (inTimes)
     {
+    int window[2];
+    this->GetTimeWindow(
+      inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()), window);
     inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(),
-                &inTimes[this->CurrentTimeIndex], 1);
+                &inTimes[window[0] + this->CurrentTimeIndex], 1);
     }
 
   return 1;
@@ -213,8 +216,10 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
 
   this->CurrentTimeIndex++;
 
-  if (  this->CurrentTimeIndex
-      < inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()) )
+  int window[2];
+  this->GetTimeWindow(
+    inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()), window);
+  if (this->CurrentTimeIndex < window[1] - window[0])
     {
     // There is still more to do.
     request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
@@ -229,6 +234,13 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::GetTimeWindow(int numTimeSteps, int window[2])
+{
+  window[0] = 0;
+  window[1] = numTimeSteps;
+}
+
 //-----------------------------------------------------------------------------
 void vtkTemporalRanges::InitializeTable(vtkTable *output)
 {
@@ -79,6 +79,11 @@ protected:
                           vtkInformationVector **,
                           vtkInformationVector *);
 
+  // Description:
+  // The time steps, in [window[0], window[1]), that this process iterates
+  // over.  All time steps by default.
+  virtual void GetTimeWindow(int numTimeSteps, int window[2]);
+
   virtual void InitializeTable(vtkTable *output);
 
   virtual void AccumulateCompositeData(vtkCompositeDataSet *input,
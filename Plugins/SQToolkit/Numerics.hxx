@@ -19,6 +19,9 @@ using std::endl;
 #endif
 
 #include <cmath>
+#include <algorithm>
+#include <complex>
+#include <vector>
 
 #include<Eigen/Core>
 #include<Eigen/QR>
@@ -539,6 +542,245 @@ void Convolution(
 }
 
 
+// input  -> patch input array is defined on
+// output -> patch output array is defined on
+// axis   -> direction to convolve in, 0,1, or 2
+// nComp  -> number of components in V
+// mode   -> dim, 2d or 3d
+// V      -> scalar or vector field
+// W      -> convolution of V and K along axis
+// K      -> 1d kernel (vector whose sum is 1)
+// nk     -> number of elements in K (odd)
+//
+// One pass of a separable convolution. The output patch needs only
+// to be shrunk by nk/2 along axis. Each output row is accumulated a
+// kernel tap at a time so that the inner most loop runs over contiguous
+// memory in both V and W.
+//*****************************************************************************
+template <typename T>
+void ConvolutionAxis(
+      int *input,
+      int *output,
+      int axis,
+      int nComp,
+      int mode,
+      T *V,
+      T *W,
+      float *K,
+      int nk)
+{
+  // input array bounds.
+  const int ni=input[1]-input[0]+1;
+  const int nj=input[3]-input[2]+1;
+  const int nk_=input[5]-input[4]+1;
+  FlatIndex idx(ni,nj,nk_,mode);
+
+  // output array bounds
+  const int _ni=output[1]-output[0]+1;
+  const int _nj=output[3]-output[2]+1;
+  const int _nk=output[5]-output[4]+1;
+  FlatIndex _idx(_ni,_nj,_nk,mode);
+
+  // distance between kernel taps in the input array
+  int tap[3]={0,0,0};
+  tap[axis]=1;
+  const int tapStride=nComp*idx.Index(tap[0],tap[1],tap[2]);
+
+  const int nk2=nk/2;
+  const int rowLen=nComp*_ni;
+
+  for (int r=output[4]; r<=output[5]; ++r)
+    {
+    const int _k=r-output[4];
+    const int  k=r-input[4];
+
+    for (int q=output[2]; q<=output[3]; ++q)
+      {
+      const int _j=q-output[2];
+      const int  j=q-input[2];
+
+      T *w=W+nComp*_idx.Index(0,_j,_k);
+      const T *v=V+nComp*idx.Index(output[0]-input[0],j,k);
+
+      for (int n=0; n<rowLen; ++n)
+        {
+        w[n]=0.0;
+        }
+
+      for (int t=-nk2; t<=nk2; ++t)
+        {
+        const T kt=K[t+nk2];
+        const T *vt=v+t*tapStride;
+
+        for (int n=0; n<rowLen; ++n)
+          {
+          w[n]+=kt*vt[n];
+          }
+        }
+      }
+    }
+}
+
+//*****************************************************************************
+inline
+void FFT(std::complex<double> *X, int n, int dir)
+{
+  // in-place radix 2 Cooley-Tukey transform of X, n must be a power of 2.
+  // dir=-1 is the forward transform, dir=1 the (un-normalized) inverse.
+
+  // bit reversal permutation
+  for (int i=1, j=0; i<n; ++i)
+    {
+    int bit=n>>1;
+    for (; j&bit; bit>>=1)
+      {
+      j^=bit;
+      }
+    j^=bit;
+    if (i<j)
+      {
+      std::swap(X[i],X[j]);
+      }
+    }
+
+  // butterflies
+  const double pi=3.14159265358979323846;
+  for (int len=2; len<=n; len<<=1)
+    {
+    const double theta=dir*2.0*pi/len;
+    const std::complex<double> wlen(cos(theta),sin(theta));
+    const int hlen=len/2;
+    for (int i=0; i<n; i+=len)
+      {
+      std::complex<double> w(1.0,0.0);
+      for (int j=0; j<hlen; ++j)
+        {
+        std::complex<double> u=X[i+j];
+        std::complex<double> v=X[i+j+hlen]*w;
+        X[i+j]=u+v;
+        X[i+j+hlen]=u-v;
+        w*=wlen;
+        }
+      }
+    }
+}
+
+// input  -> patch input array is defined on
+// output -> patch output array is defined on
+// axis   -> direction to convolve in, 0,1, or 2
+// nComp  -> number of components in V
+// mode   -> dim, 2d or 3d
+// V      -> scalar or vector field
+// W      -> convolution of V and K along axis
+// K      -> 1d kernel (vector whose sum is 1)
+// nk     -> number of elements in K (odd)
+//
+// Same as ConvolutionAxis but each line is transformed into
+// frequency space where the convolution is a product. Cost
+// is O(n log n) per line independent of the kernel width.
+//*****************************************************************************
+template <typename T>
+void ConvolutionAxisFFT(
+      int *input,
+      int *output,
+      int axis,
+      int nComp,
+      int mode,
+      T *V,
+      T *W,
+      float *K,
+      int nk)
+{
+  // input array bounds.
+  const int ni=input[1]-input[0]+1;
+  const int nj=input[3]-input[2]+1;
+  const int nk_=input[5]-input[4]+1;
+  FlatIndex idx(ni,nj,nk_,mode);
+
+  // output array bounds
+  const int _ni=output[1]-output[0]+1;
+  const int _nj=output[3]-output[2]+1;
+  const int _nk=output[5]-output[4]+1;
+  FlatIndex _idx(_ni,_nj,_nk,mode);
+
+  int tap[3]={0,0,0};
+  tap[axis]=1;
+  const int vStride=nComp*idx.Index(tap[0],tap[1],tap[2]);
+  const int wStride=nComp*_idx.Index(tap[0],tap[1],tap[2]);
+
+  // lines are long enough to hold the output plus the kernel's
+  // support, padded to the next power of 2. The circular wrap
+  // only pollutes the first nk-1 values which are discarded.
+  const int nk2=nk/2;
+  const int nOut=output[2*axis+1]-output[2*axis]+1;
+  const int nIn=nOut+2*nk2;
+  int n=1;
+  while (n<nIn)
+    {
+    n*=2;
+    }
+
+  // transform of the reversed kernel, so that the product computes
+  // the same sum as the direct method.
+  std::vector<std::complex<double> > Kf(n,std::complex<double>(0.0,0.0));
+  for (int m=0; m<nk; ++m)
+    {
+    Kf[m]=K[nk-1-m];
+    }
+  FFT(&Kf[0],n,-1);
+
+  std::vector<std::complex<double> > X(n);
+
+  // visit each line along axis
+  int lo[3]={output[0],output[2],output[4]};
+  int hi[3]={output[1],output[3],output[5]};
+  hi[axis]=lo[axis];
+
+  for (int r=lo[2]; r<=hi[2]; ++r)
+    {
+    for (int q=lo[1]; q<=hi[1]; ++q)
+      {
+      for (int p=lo[0]; p<=hi[0]; ++p)
+        {
+        int i=p-input[0];
+        int j=q-input[2];
+        int k=r-input[4];
+        int *ijk[3]={&i,&j,&k};
+        *ijk[axis]-=nk2;
+
+        const T *v=V+nComp*idx.Index(i,j,k);
+        T *w=W+nComp*_idx.Index(p-output[0],q-output[2],r-output[4]);
+
+        for (int c=0; c<nComp; ++c)
+          {
+          int m=0;
+          for (; m<nIn; ++m)
+            {
+            X[m]=v[m*vStride+c];
+            }
+          for (; m<n; ++m)
+            {
+            X[m]=0.0;
+            }
+
+          FFT(&X[0],n,-1);
+          for (m=0; m<n; ++m)
+            {
+            X[m]*=Kf[m];
+            }
+          FFT(&X[0],n,1);
+
+          for (m=0; m<nOut; ++m)
+            {
+            w[m*wStride+c]=static_cast<T>(X[m+2*nk2].real()/n);
+            }
+          }
+        }
+      }
+    }
+}
+
+
 //*****************************************************************************
 template <typename T>
 void DivergenceFace(int *I, double *dX, T *V, T *mV, T *div)
@@ -0,0 +1,197 @@
+/*
+   ____    _ __           ____               __    ____
+  / __/___(_) /  ___ ____/ __ \__ _____ ___ / /_  /  _/__  ____
+ _\ \/ __/ / _ \/ -_) __/ /_/ / // / -_|_-</ __/ _/ // _ \/ __/
+/___/\__/_/_.__/\__/_/  \___\_\_,_/\__/___/\__/ /___/_//_/\__(_)
+
+Copyright 2008 SciberQuest Inc.
+*/
+#include "vtkSQKernelConvolution.h"
+#include "vtkImageData.h"
+#include "vtkFloatArray.h"
+#include "vtkPointData.h"
+#include "vtkDataObject.h"
+#include "vtkMath.h"
+
+#include <iostream>
+using std::cerr;
+using std::endl;
+
+#include <cmath>
+
+/**
+TestKernelConvolution
+
+Convolves a random vector field with each of the methods and
+thread counts and checks that the result matches the direct,
+single threaded convolution.
+
+Input:
+  none
+
+Output:
+  returns 0 when all of the results match.
+*/
+
+//*****************************************************************************
+vtkImageData *NewInput(int n)
+{
+  vtkImageData *im=vtkImageData::New();
+  im->SetExtent(0,n-1,0,n-1,0,n-1);
+  im->SetOrigin(0.0,0.0,0.0);
+  im->SetSpacing(1.0,1.0,1.0);
+
+  vtkIdType nPts=im->GetNumberOfPoints();
+  vtkFloatArray *V=vtkFloatArray::New();
+  V->SetName("V");
+  V->SetNumberOfComponents(3);
+  V->SetNumberOfTuples(nPts);
+  float *pV=V->GetPointer(0);
+  vtkMath::RandomSeed(1234);
+  for (vtkIdType i=0; i<3*nPts; ++i)
+    {
+    pV[i]=static_cast<float>(vtkMath::Random(-1.0,1.0));
+    }
+  im->GetPointData()->AddArray(V);
+  V->Delete();
+
+  return im;
+}
+
+//*****************************************************************************
+vtkFloatArray *Convolve(
+      vtkImageData *input,
+      int method,
+      int kernelType,
+      int nIterations,
+      int nThreads,
+      int kernelWidth=5)
+{
+  vtkSQKernelConvolution *conv=vtkSQKernelConvolution::New();
+  conv->SetInputData(input);
+  conv->SetInputArrayToProcess(
+        0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,"V");
+  conv->SetKernelWidth(kernelWidth);
+  conv->SetKernelType(kernelType);
+  conv->SetMethod(method);
+  conv->SetNumberOfIterations(nIterations);
+  conv->SetNumberOfThreads(nThreads);
+  conv->Update();
+
+  vtkImageData *output=vtkImageData::SafeDownCast(conv->GetOutput());
+  vtkFloatArray *W
+    = output?vtkFloatArray::SafeDownCast(output->GetPointData()->GetArray("V")):0;
+  if (W)
+    {
+    W->Register(0);
+    }
+  conv->Delete();
+
+  return W;
+}
+
+//*****************************************************************************
+int Compare(vtkFloatArray *ref, vtkFloatArray *W, const char *name)
+{
+  if (!W)
+    {
+    cerr << name << ": no output." << endl;
+    return 1;
+    }
+
+  if ((W->GetNumberOfTuples()!=ref->GetNumberOfTuples())
+    || (W->GetNumberOfComponents()!=ref->GetNumberOfComponents()))
+    {
+    cerr
+      << name << ": output size " << W->GetNumberOfTuples()
+      << " does not match " << ref->GetNumberOfTuples() << "." << endl;
+    return 1;
+    }
+
+  vtkIdType n=ref->GetNumberOfTuples()*ref->GetNumberOfComponents();
+  float *pRef=ref->GetPointer(0);
+  float *pW=W->GetPointer(0);
+  for (vtkIdType i=0; i<n; ++i)
+    {
+    if (fabs(pRef[i]-pW[i])>1.0e-4*(1.0+fabs(pRef[i])))
+      {
+      cerr
+        << name << ": value " << i << " is " << pW[i]
+        << " but " << pRef[i] << " was expected." << endl;
+      return 1;
+      }
+    }
+
+  return 0;
+}
+
+//*****************************************************************************
+int main(int, char **)
+{
+  vtkImageData *input=NewInput(24);
+
+  int nFail=0;
+  const int kernelTypes[2]={
+      vtkSQKernelConvolution::KERNEL_TYPE_GAUSIAN,
+      vtkSQKernelConvolution::KERNEL_TYPE_CONSTANT};
+
+  for (int k=0; k<2; ++k)
+    {
+    for (int nIts=1; nIts<=2; ++nIts)
+      {
+      vtkFloatArray *ref
+        = Convolve(input,vtkSQKernelConvolution::METHOD_DIRECT,kernelTypes[k],nIts,1);
+      if (!ref)
+        {
+        cerr << "The direct convolution failed." << endl;
+        input->Delete();
+        return 1;
+        }
+
+      vtkFloatArray *W;
+
+      W=Convolve(input,vtkSQKernelConvolution::METHOD_DIRECT,kernelTypes[k],nIts,4);
+      nFail+=Compare(ref,W,"threaded direct");
+      if (W) W->Delete();
+
+      W=Convolve(input,vtkSQKernelConvolution::METHOD_SEPARABLE,kernelTypes[k],nIts,1);
+      nFail+=Compare(ref,W,"separable");
+      if (W) W->Delete();
+
+      W=Convolve(input,vtkSQKernelConvolution::METHOD_SEPARABLE,kernelTypes[k],nIts,4);
+      nFail+=Compare(ref,W,"threaded separable");
+      if (W) W->Delete();
+
+      W=Convolve(input,vtkSQKernelConvolution::METHOD_FFT,kernelTypes[k],nIts,4);
+      nFail+=Compare(ref,W,"threaded fft");
+      if (W) W->Delete();
+
+      ref->Delete();
+      }
+    }
+
+  // widths below 3 are rejected, the default width of 3 is kept
+  // and every method gives its direct result.
+  vtkFloatArray *ref
+    = Convolve(input,vtkSQKernelConvolution::METHOD_DIRECT,kernelTypes[0],1,1,3);
+  const int methods[3]={
+      vtkSQKernelConvolution::METHOD_DIRECT,
+      vtkSQKernelConvolution::METHOD_SEPARABLE,
+      vtkSQKernelConvolution::METHOD_FFT};
+  if (!ref)
+    {
+    cerr << "The direct convolution failed." << endl;
+    ++nFail;
+    }
+  for (int m=0; ref && (m<3); ++m)
+    {
+    vtkFloatArray *W=Convolve(input,methods[m],kernelTypes[0],1,4,1);
+    nFail+=Compare(ref,W,"kernel width 1");
+    if (W) W->Delete();
+    }
+  if (ref) ref->Delete();
+
+  input->Delete();
+
+  return nFail?1:0;
+}
@@ -26,6 +26,7 @@ Copyright 2008 SciberQuest Inc.
 #include "vtkDoubleArray.h"
 #include "vtkPointData.h"
 #include "vtkCellData.h"
+#include "vtkMultiThreader.h"
 
 #include <string>
 using std::string;
@@ -37,15 +38,267 @@ using std::string;
 vtkCxxRevisionMacro(vtkSQKernelConvolution, "$Revision: 0.0 $");
 vtkStandardNewMacro(vtkSQKernelConvolution);
 
+namespace
+{
+// Description:
+// A single convolution pass, shared by all of the threads that
+// work on it. Threads split the output into slabs along its
+// slowest varying direction.
+template <typename T>
+class ConvolutionPass
+{
+public:
+  int Method;
+  int Axis;
+  int Mode;
+  int NComps;
+  int *SrcExt;
+  int *DstExt;
+  int *KernelExt;
+  T *Src;
+  T *Dst;
+  float *Kernel;
+  int KernelWidth;
+};
+
+//-----------------------------------------------------------------------------
+template <typename T>
+VTK_THREAD_RETURN_TYPE ConvolutionPassThreadedExecute(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+
+  ConvolutionPass<T> *pass
+    = static_cast<ConvolutionPass<T>*>(info->UserData);
+
+  // split along k, or j for 2D data in the xy plane.
+  CartesianExtent dstExt(pass->DstExt);
+  int q=((dstExt[5]>dstExt[4])?2:1);
+  int n=dstExt[2*q+1]-dstExt[2*q]+1;
+  int nThreads=info->NumberOfThreads;
+  int slab=n/nThreads;
+  int left=n%nThreads;
+  int id=info->ThreadID;
+  int lo=dstExt[2*q]+id*slab+(id<left?id:left);
+  int hi=lo+slab+(id<left?1:0)-1;
+  if (hi<lo)
+    {
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  CartesianExtent subExt(dstExt);
+  subExt[2*q]=lo;
+  subExt[2*q+1]=hi;
+
+  // slabs in the slowest direction are contiguous in the output.
+  FlatIndex idx(
+      dstExt[1]-dstExt[0]+1,
+      dstExt[3]-dstExt[2]+1,
+      dstExt[5]-dstExt[4]+1,
+      pass->Mode);
+  int ijk[3]={0,0,0};
+  ijk[q]=lo-dstExt[2*q];
+  T *dst=pass->Dst+pass->NComps*idx.Index(ijk[0],ijk[1],ijk[2]);
+
+  switch (pass->Method)
+    {
+    case vtkSQKernelConvolution::METHOD_DIRECT:
+      Convolution<T>(
+          pass->SrcExt,
+          subExt.GetData(),
+          pass->KernelExt,
+          pass->NComps,
+          pass->Mode,
+          pass->Src,
+          dst,
+          pass->Kernel);
+      break;
+
+    case vtkSQKernelConvolution::METHOD_SEPARABLE:
+      ConvolutionAxis<T>(
+          pass->SrcExt,
+          subExt.GetData(),
+          pass->Axis,
+          pass->NComps,
+          pass->Mode,
+          pass->Src,
+          dst,
+          pass->Kernel,
+          pass->KernelWidth);
+      break;
+
+    case vtkSQKernelConvolution::METHOD_FFT:
+      ConvolutionAxisFFT<T>(
+          pass->SrcExt,
+          subExt.GetData(),
+          pass->Axis,
+          pass->NComps,
+          pass->Mode,
+          pass->Src,
+          dst,
+          pass->Kernel,
+          pass->KernelWidth);
+      break;
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void RunConvolutionPass(vtkMultiThreader *threader, ConvolutionPass<T> &pass)
+{
+  threader->SetSingleMethod(ConvolutionPassThreadedExecute<T>,&pass);
+  threader->SingleMethodExecute();
+}
+
+// Description:
+// Copy the values of V in dstExt, a sub-extent of srcExt, into W.
+//-----------------------------------------------------------------------------
+template <typename T>
+void CopyExtent(
+      int *srcExt,
+      int *dstExt,
+      int nComps,
+      T *V,
+      T *W)
+{
+  int ni=srcExt[1]-srcExt[0]+1;
+  int nj=srcExt[3]-srcExt[2]+1;
+  int rowLen=nComps*(dstExt[1]-dstExt[0]+1);
+
+  for (int k=dstExt[4]; k<=dstExt[5]; ++k)
+    {
+    for (int j=dstExt[2]; j<=dstExt[3]; ++j)
+      {
+      vtkIdType src
+        = nComps*(ni*(nj*(vtkIdType)(k-srcExt[4])+(j-srcExt[2]))+(dstExt[0]-srcExt[0]));
+      for (int q=0; q<rowLen; ++q)
+        {
+        W[q]=V[src+q];
+        }
+      W+=rowLen;
+      }
+    }
+}
+
+// Description:
+// Apply the kernel nIts times. Each iteration shrinks the valid
+// region by the kernel half width, so that the last one lands on
+// outputExt. Separable methods make one pass per non-degenerate
+// direction. Intermediate results are kept in temporary buffers,
+// the last pass writes directly into W.
+//-----------------------------------------------------------------------------
+template <typename T>
+void ConvolutionIterations(
+      vtkMultiThreader *threader,
+      int method,
+      int mode,
+      int nIts,
+      int *inputExt,
+      int *outputExt,
+      int *kernelExt,
+      int nComps,
+      T *V,
+      T *W,
+      float *K,
+      float *K1,
+      int kernelWidth)
+{
+  const int nk2=kernelWidth/2;
+
+  CartesianExtent srcExt(inputExt);
+  T *src=V;
+  T *srcBuf=0;
+
+  // directions that the kernel spans.
+  int axes[3];
+  int nAxes=0;
+  for (int q=0; q<3; ++q)
+    {
+    if (kernelExt[2*q+1]>kernelExt[2*q])
+      {
+      axes[nAxes]=q;
+      ++nAxes;
+      }
+    }
+
+  // a kernel that spans no direction is the identity, there is
+  // nothing to convolve.
+  if (nAxes==0)
+    {
+    CopyExtent<T>(inputExt,outputExt,nComps,V,W);
+    return;
+    }
+
+  int nPasses=(method==vtkSQKernelConvolution::METHOD_DIRECT?1:nAxes);
+
+  for (int it=0; it<nIts; ++it)
+    {
+    CartesianExtent tgtExt
+      = CartesianExtent::Grow(
+            CartesianExtent(outputExt),
+            nk2*(nIts-1-it),
+            mode);
+
+    for (int p=0; p<nPasses; ++p)
+      {
+      CartesianExtent dstExt(tgtExt);
+      if (p<(nPasses-1))
+        {
+        // only the directions already convolved shrink.
+        for (int q=p+1; q<nAxes; ++q)
+          {
+          dstExt[2*axes[q]]=srcExt[2*axes[q]];
+          dstExt[2*axes[q]+1]=srcExt[2*axes[q]+1];
+          }
+        }
+
+      T *dst=W;
+      T *dstBuf=0;
+      if ((it<(nIts-1)) || (p<(nPasses-1)))
+        {
+        dstBuf=new T[nComps*dstExt.Size()];
+        dst=dstBuf;
+        }
+
+      ConvolutionPass<T> pass;
+      pass.Method=method;
+      pass.Axis=axes[p];
+      pass.Mode=mode;
+      pass.NComps=nComps;
+      pass.SrcExt=srcExt.GetData();
+      pass.DstExt=dstExt.GetData();
+      pass.KernelExt=kernelExt;
+      pass.Src=src;
+      pass.Dst=dst;
+      pass.Kernel=(method==vtkSQKernelConvolution::METHOD_DIRECT?K:K1);
+      pass.KernelWidth=kernelWidth;
+
+      RunConvolutionPass<T>(threader,pass);
+
+      delete [] srcBuf;
+      srcBuf=dstBuf;
+      src=dst;
+      srcExt=dstExt;
+      }
+    }
+}
+
+}
+
 //-----------------------------------------------------------------------------
 vtkSQKernelConvolution::vtkSQKernelConvolution()
     :
   KernelWidth(3),
   KernelType(KERNEL_TYPE_GAUSIAN),
   Kernel(0),
+  Kernel1D(0),
   KernelModified(1),
   Mode(CartesianExtent::DIM_MODE_3D),
-  NumberOfIterations(1)
+  Method(METHOD_SEPARABLE),
+  NumberOfIterations(1),
+  NumberOfThreads(0)
 {
   #ifdef vtkSQKernelConvolutionDEBUG
   pCerr() << "===============================vtkSQKernelConvolution::vtkSQKernelConvolution" << endl;
@@ -67,6 +320,52 @@ vtkSQKernelConvolution::~vtkSQKernelConvolution()
     delete [] this->Kernel;
     this->Kernel=0;
     }
+
+  if (this->Kernel1D)
+    {
+    delete [] this->Kernel1D;
+    this->Kernel1D=0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQKernelConvolution::SetMethod(int method)
+{
+  #ifdef vtkSQKernelConvolutionDEBUG
+  pCerr() << "===============================vtkSQKernelConvolution::SetMethod" << endl;
+  #endif
+
+  if (method==this->Method)
+    {
+    return;
+    }
+
+  if ((method<METHOD_DIRECT) || (method>METHOD_FFT))
+    {
+    vtkErrorMacro("Unsupported Method " << method << ".");
+    return;
+    }
+
+  this->Method=method;
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQKernelConvolution::SetNumberOfIterations(int n)
+{
+  #ifdef vtkSQKernelConvolutionDEBUG
+  pCerr() << "===============================vtkSQKernelConvolution::SetNumberOfIterations" << endl;
+  #endif
+
+  n=(n<1?1:n);
+
+  if (n==this->NumberOfIterations)
+    {
+    return;
+    }
+
+  this->NumberOfIterations=n;
+  this->Modified();
 }
 
 //-----------------------------------------------------------------------------
@@ -115,12 +414,18 @@ void vtkSQKernelConvolution::SetKernelWidth(int width)
     return;
     }
 
-  if ((this->KernelWidth%2)==0)
+  if ((width%2)==0)
     {
     vtkErrorMacro("KernelWidth must be odd.");
     return;
     }
 
+  if (width<3)
+    {
+    vtkErrorMacro("KernelWidth must be at least 3.");
+    return;
+    }
+
   this->KernelWidth=width;
   this->Modified();
   this->KernelModified=1;
@@ -144,6 +449,12 @@ int vtkSQKernelConvolution::UpdateKernel()
     this->Kernel=0;
     }
 
+  if (this->Kernel1D)
+    {
+    delete [] this->Kernel1D;
+    this->Kernel1D=0;
+    }
+
   int nk2 = this->KernelWidth/2;
   CartesianExtent ext(-nk2, nk2, -nk2, nk2, -nk2, nk2);
   switch(this->Mode)
@@ -170,6 +481,11 @@ int vtkSQKernelConvolution::UpdateKernel()
   this->Kernel=new float [size];
   float kernelNorm=0.0;
 
+  // The supported kernels are separable, the full kernel is the
+  // product of this one along each direction.
+  this->Kernel1D=new float [this->KernelWidth];
+  float kernel1DNorm=0.0;
+
   if (this->KernelType==KERNEL_TYPE_GAUSIAN)
     {
     float *X=new float[this->KernelWidth];
@@ -179,6 +495,13 @@ int vtkSQKernelConvolution::UpdateKernel()
     float a=1.0;
     float c=0.55;
 
+    for (int i=0; i<this->KernelWidth; ++i)
+      {
+      float x[3]={X[i],0.0,0.0};
+      this->Kernel1D[i]=Gaussian(x,a,B,c);
+      kernel1DNorm+=this->Kernel1D[i];
+      }
+
     int H=(this->Mode==CartesianExtent::DIM_MODE_3D?this->KernelWidth:1);
 
     for (int k=0; k<H; ++k)
@@ -196,6 +519,8 @@ int vtkSQKernelConvolution::UpdateKernel()
           }
         }
       }
+
+    delete [] X;
     }
   else
   if (this->KernelType==KERNEL_TYPE_CONSTANT)
@@ -205,12 +530,20 @@ int vtkSQKernelConvolution::UpdateKernel()
       {
       this->Kernel[i]=1.0;
       }
+
+    kernel1DNorm=this->KernelWidth;
+    for (int i=0; i<this->KernelWidth; ++i)
+      {
+      this->Kernel1D[i]=1.0;
+      }
     }
   else
     {
     vtkErrorMacro("Unsupported KernelType " << this->KernelType << ".");
     delete [] this->Kernel;
     this->Kernel=0;
+    delete [] this->Kernel1D;
+    this->Kernel1D=0;
     return -1;
     }
 
@@ -220,6 +553,11 @@ int vtkSQKernelConvolution::UpdateKernel()
     this->Kernel[i]/=kernelNorm;
     }
 
+  for (int i=0; i<this->KernelWidth; ++i)
+    {
+    this->Kernel1D[i]/=kernel1DNorm;
+    }
+
   this->KernelModified = 0;
 
   #ifdef vtkSQKernelConvolutionDEBUG
@@ -278,8 +616,8 @@ int vtkSQKernelConvolution::RequestInformation(
   // We will work in a restricted problem domain so that we have
   // always a single layer of ghost cells available. To make it so
   // we'll take the upstream's domain and shrink it by half the 
-  // kernel width.
-  int nGhosts = this->KernelWidth/2;
+  // kernel width, once for each iteration.
+  int nGhosts = this->GetNumberOfGhosts();
 
   vtkInformation *inInfo=inInfos[0]->GetInformationObject(0);
   CartesianExtent inputDomain;
@@ -288,10 +626,16 @@ int vtkSQKernelConvolution::RequestInformation(
         inputDomain.GetData());
 
   // determine the dimensionality of the input.
-  this->Mode
+  int mode
     = CartesianExtent::GetDimensionMode(
           inputDomain,
           nGhosts);
+  if (mode!=this->Mode)
+    {
+    // the kernel's shape depends on the mode.
+    this->Mode=mode;
+    this->KernelModified=1;
+    }
 
   // shrink the output problem domain by the requisite number of
   // ghost cells.
@@ -346,7 +690,7 @@ int vtkSQKernelConvolution::RequestUpdateExtent(
   // We will modify the extents we request from our input so
   // that we will have a layers of ghost cells. We also pass
   // the number of ghosts through the piece based key.
-  int nGhosts = this->KernelWidth/2;
+  int nGhosts = this->GetNumberOfGhosts();
 
   inInfo->Set(
         vtkSDDPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
@@ -449,7 +793,7 @@ int vtkSQKernelConvolution::RequestData(
         domainExt.GetData());
 
   // Check that we have the ghost cells that we need (more is OK).
-  int nGhost = this->KernelWidth/2;
+  int nGhost = this->GetNumberOfGhosts();
 
   CartesianExtent inputBox(inputExt);
   CartesianExtent outputBox
@@ -523,20 +867,33 @@ int vtkSQKernelConvolution::RequestData(
     W->SetNumberOfTuples(outputTups);
     W->SetName(V->GetName());
 
+    vtkMultiThreader *threader=vtkMultiThreader::New();
+    if (this->NumberOfThreads>0)
+      {
+      threader->SetNumberOfThreads(this->NumberOfThreads);
+      }
+
     switch (V->GetDataType())
       {
       vtkTemplateMacro(
-        Convolution<VTK_TT>(
+        ConvolutionIterations<VTK_TT>(
+            threader,
+            this->Method,
+            this->Mode,
+            this->NumberOfIterations,
             inputExt.GetData(),
             outputExt.GetData(),
             this->KernelExt.GetData(),
             nComps,
-            this->Mode,
             (VTK_TT*)V->GetVoidPointer(0),
             (VTK_TT*)W->GetVoidPointer(0),
-            this->Kernel));
+            this->Kernel,
+            this->Kernel1D,
+            this->KernelWidth));
       }
 
+    threader->Delete();
+
     outImData->GetPointData()->AddArray(W);
     W->Delete();
 
@@ -560,7 +917,12 @@ void vtkSQKernelConvolution::PrintSelf(ostream& os, vtkIndent indent)
 
   this->Superclass::PrintSelf(os,indent);
 
-  // TODO
+  os << indent << "KernelWidth: " << this->KernelWidth << endl;
+  os << indent << "KernelType: " << this->KernelType << endl;
+  os << indent << "Mode: " << this->Mode << endl;
+  os << indent << "Method: " << this->Method << endl;
+  os << indent << "NumberOfIterations: " << this->NumberOfIterations << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 
 }
 
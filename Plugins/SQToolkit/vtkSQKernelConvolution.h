@@ -11,6 +11,7 @@ Copyright 2008 SciberQuest Inc.
 #define __vtkSQKernelConvolution_h
 
 #include "vtkDataSetAlgorithm.h"
+#include "vtkMultiThreader.h" // for VTK_MAX_THREADS
 #include "CartesianExtent.h"
 
 class vtkInformation;
@@ -55,11 +56,37 @@ public:
   void SetKernelWidth(int width);
   vtkGetMacro(KernelWidth,int);
 
+  //BTX
+  enum {
+    METHOD_DIRECT=0,
+    METHOD_SEPARABLE=1,
+    METHOD_FFT=2
+    };
+  //ETX
+  // Description:
+  // Select how the convolution is computed. DIRECT applies the full
+  // KernelWidth^3 stencil at each output point. SEPARABLE applies
+  // a 1D kernel once along each axis, cost grows linearly with the
+  // kernel width. FFT is separable with each line convolved in
+  // frequency space, cost is independent of the kernel width and
+  // it is the fastest choice for very wide kernels. All of the
+  // supported kernels are separable.
+  void SetMethod(int method);
+  vtkGetMacro(Method,int);
+
   // Description:
-  // Set the number of itterations to apply. NOT IMPLEMENTED.
-  vtkSetMacro(NumberOfIterations,int);
+  // Set the number of times to apply the kernel. Each iteration
+  // consumes another KernelWidth/2 layers of ghost cells.
+  void SetNumberOfIterations(int n);
   vtkGetMacro(NumberOfIterations,int);
 
+  // Description:
+  // Set the number of threads used to process a block. If 0 the
+  // vtkMultiThreader default is used. In either case the global
+  // maximum set on vtkMultiThreader is respected.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
 protected:
   //int FillInputPortInformation(int port, vtkInformation *info);
   //int FillOutputPortInformation(int port, vtkInformation *info);
@@ -74,16 +101,23 @@ protected:
   // Called before execution to generate the selected kernel.
   int UpdateKernel();
 
+  // Description:
+  // Number of ghost layers needed by all of the iterations.
+  int GetNumberOfGhosts(){ return (this->KernelWidth/2)*this->NumberOfIterations; }
+
 private:
   int KernelWidth;
   int KernelType;
   CartesianExtent KernelExt;
   float *Kernel;
+  float *Kernel1D;
   int KernelModified;
   //
   int Mode;
+  int Method;
   //
   int NumberOfIterations;
+  int NumberOfThreads;
 
 private:
   vtkSQKernelConvolution(const vtkSQKernelConvolution &); // Not implemented
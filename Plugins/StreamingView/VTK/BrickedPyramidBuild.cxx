@@ -0,0 +1,92 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    BrickedPyramidBuild.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Command line front end to vtkBrickedPyramidBuilder. Converts a raw float
+// volume into the multiresolution layout read by vtkBrickedPyramidReader.
+
+#include "vtkBrickedPyramidBuilder.h"
+#include "vtkSmartPointer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------------------------------------------------
+static void Usage(const char *exe)
+{
+  cerr << "Usage: " << exe
+       << " input.raw output.bpx i0 i1 j0 j1 k0 k1" << endl
+       << "   [-origin x y z] [-spacing x y z] [-brick n]"
+       << " [-levels n] [-swap]" << endl;
+}
+
+//---------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  if (argc < 9)
+    {
+    Usage(argv[0]);
+    return 1;
+    }
+
+  vtkSmartPointer<vtkBrickedPyramidBuilder> builder =
+    vtkSmartPointer<vtkBrickedPyramidBuilder>::New();
+  builder->SetFileName(argv[1]);
+  builder->SetOutputFileName(argv[2]);
+
+  int ext[6];
+  for (int i = 0; i < 6; i++)
+    {
+    ext[i] = atoi(argv[3+i]);
+    }
+  builder->SetWholeExtent(ext);
+
+  for (int i = 9; i < argc; i++)
+    {
+    if (!strcmp(argv[i], "-origin") && i+3 < argc)
+      {
+      builder->SetOrigin(
+        atof(argv[i+1]), atof(argv[i+2]), atof(argv[i+3]));
+      i += 3;
+      }
+    else if (!strcmp(argv[i], "-spacing") && i+3 < argc)
+      {
+      builder->SetSpacing(
+        atof(argv[i+1]), atof(argv[i+2]), atof(argv[i+3]));
+      i += 3;
+      }
+    else if (!strcmp(argv[i], "-brick") && i+1 < argc)
+      {
+      int n = atoi(argv[i+1]);
+      builder->SetBrickSize(n, n, n);
+      i += 1;
+      }
+    else if (!strcmp(argv[i], "-levels") && i+1 < argc)
+      {
+      builder->SetNumberOfLevels(atoi(argv[i+1]));
+      i += 1;
+      }
+    else if (!strcmp(argv[i], "-swap"))
+      {
+      builder->SwapBytesOn();
+      }
+    else
+      {
+      Usage(argv[0]);
+      return 1;
+      }
+    }
+
+  return builder->Build() ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    BrickedPyramid.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Tests that a raw volume converted into a bricked pyramid reads back
+// the same values at full resolution, and the expected subsamples at
+// lower resolutions, for different pieces. Also checks the value range
+// recorded for every brick, the piece ranges and the bounds reported
+// before reading.
+
+#include "vtkBrickedPyramidBuilder.h"
+#include "vtkBrickedPyramidReader.h"
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTesting.h"
+
+#include <fstream>
+#include <string>
+
+static float BrickedPyramidValue(int i, int j, int k)
+{
+  return (float)(i + 100*j + 10000*k);
+}
+
+// The values increase along every axis, so the range of the full
+// resolution data under bricks b0..b1 of a level is given by its corners.
+static void BrickedPyramidRange(const int n[3], const int bs[3], int level,
+                                const int b0[3], const int b1[3],
+                                double range[2])
+{
+  int lo[3];
+  int hi[3];
+  for (int q = 0; q < 3; q++)
+    {
+    lo[q] = (b0[q] * bs[q]) << level;
+    hi[q] = ((b1[q] + 1) * bs[q]) << level;
+    hi[q] = (hi[q] < n[q] ? hi[q] : n[q]) - 1;
+    }
+  range[0] = BrickedPyramidValue(lo[0], lo[1], lo[2]);
+  range[1] = BrickedPyramidValue(hi[0], hi[1], hi[2]);
+}
+
+//---------------------------------------------------------------------------
+int BrickedPyramid(int argc, char *argv[])
+{
+  vtkSmartPointer<vtkTesting> testing = vtkSmartPointer<vtkTesting>::New();
+  for (int i = 0; i < argc; i++)
+    {
+    testing->AddArgument(argv[i]);
+    }
+  std::string raw = std::string(testing->GetTempDirectory()) + "/bricks.raw";
+  std::string bpx = std::string(testing->GetTempDirectory()) + "/bricks.bpx";
+
+  // a volume whose sizes are not multiples of the brick size
+  const int ni = 37, nj = 29, nk = 23;
+  FILE *fp = fopen(raw.c_str(), "wb");
+  if (!fp)
+    {
+    cerr << "test failed, could not write " << raw << endl;
+    return 1;
+    }
+  for (int k = 0; k < nk; k++)
+    {
+    for (int j = 0; j < nj; j++)
+      {
+      for (int i = 0; i < ni; i++)
+        {
+        float v = BrickedPyramidValue(i, j, k);
+        fwrite(&v, sizeof(float), 1, fp);
+        }
+      }
+    }
+  fclose(fp);
+
+  vtkSmartPointer<vtkBrickedPyramidBuilder> builder =
+    vtkSmartPointer<vtkBrickedPyramidBuilder>::New();
+  builder->SetFileName(raw.c_str());
+  builder->SetOutputFileName(bpx.c_str());
+  builder->SetWholeExtent(0, ni-1, 0, nj-1, 0, nk-1);
+  builder->SetBrickSize(8, 8, 8);
+  if (!builder->Build())
+    {
+    cerr << "test failed, could not build the pyramid" << endl;
+    return 1;
+    }
+
+  vtkSmartPointer<vtkBrickedPyramidReader> reader =
+    vtkSmartPointer<vtkBrickedPyramidReader>::New();
+  if (!reader->CanReadFile(bpx.c_str()))
+    {
+    cerr << "test failed, reader does not recognize " << bpx << endl;
+    return 1;
+    }
+  reader->SetFileName(bpx.c_str());
+  reader->UpdateInformation();
+  if (reader->GetNumberOfLevels() != 4)
+    {
+    cerr << "test failed, expected 4 levels, got "
+         << reader->GetNumberOfLevels() << endl;
+    return 1;
+    }
+
+  // the ranges recorded for every brick, level by level
+  const int n[3] = {ni, nj, nk};
+  const int bs[3] = {8, 8, 8};
+  int wholeExtent[6] = {0, ni-1, 0, nj-1, 0, nk-1};
+  int brickSize[3] = {8, 8, 8};
+  ifstream header(bpx.c_str());
+  std::string key;
+  while (header >> key && key != "Ranges")
+    {
+    }
+  for (int l = 0; l < reader->GetNumberOfLevels(); l++)
+    {
+    int nb[3];
+    vtkBrickedPyramidReader::GetLevelBricks(wholeExtent, brickSize, l, nb);
+    for (int bk = 0; bk < nb[2]; bk++)
+      {
+      for (int bj = 0; bj < nb[1]; bj++)
+        {
+        for (int bi = 0; bi < nb[0]; bi++)
+          {
+          int b[3] = {bi, bj, bk};
+          double e[2];
+          BrickedPyramidRange(n, bs, l, b, b, e);
+          double r[2];
+          header >> r[0] >> r[1];
+          if (header.fail() || r[0] != e[0] || r[1] != e[1])
+            {
+            cerr << "test failed, brick " << bi << "," << bj << "," << bk
+                 << "@L" << l << " has range " << r[0] << ".." << r[1]
+                 << " expected " << e[0] << ".." << e[1] << endl;
+            return 1;
+            }
+          }
+        }
+      }
+    }
+  header.close();
+
+  vtkInformation* info = reader->GetOutputInformation(0);
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(reader->GetExecutive());
+
+  bool failed = false;
+  const int numers[4] = {0, 0, 1, 3};
+  const int denoms[4] = {1, 2, 2, 4};
+  const double resolutions[3] = {1.0, 0.5, 0.0};
+  for (int p = 0; p < 4; p++)
+    {
+    for (int r = 0; r < 3; r++)
+      {
+      double res = resolutions[r];
+      int stride = 1 << reader->GetLevel(res);
+
+      reader->Modified();
+      sddp->SetUpdateResolution(info, res);
+      sddp->SetUpdateExtent(info, numers[p], denoms[p], 0);
+      reader->Update();
+      reader->Modified();
+      sddp->SetUpdateResolution(info, res);
+      sddp->SetUpdateExtent(info, numers[p], denoms[p], 0);
+      reader->Update();
+
+      vtkImageData *id = reader->GetOutput();
+      int ext[6];
+      id->GetExtent(ext);
+
+      // the whole piece covers the bounds announced by RequestInformation
+      if (denoms[p] == 1)
+        {
+        double *wbb = info->Get(
+          vtkStreamingDemandDrivenPipeline::WHOLE_BOUNDING_BOX());
+        int *wext = info->Get(
+          vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT());
+        double bds[6];
+        id->GetBounds(bds);
+        for (int q = 0; q < 3; q++)
+          {
+          double hi = (double)(wext[2*q+1] * stride);
+          if (wbb[2*q] != 0.0 || wbb[2*q+1] != hi ||
+              bds[2*q] != wbb[2*q] || bds[2*q+1] != wbb[2*q+1] ||
+              hi > n[q] - 1 || (stride == 1 && hi != n[q] - 1))
+            {
+            cerr << "test failed, bounds @" << res << " are "
+                 << wbb[2*q] << ".." << wbb[2*q+1] << " along " << q
+                 << ", data bounds are " << bds[2*q] << ".." << bds[2*q+1]
+                 << " expected 0.." << hi << endl;
+            failed = true;
+            }
+          }
+        }
+
+      // the piece range comes from the bricks under the piece, it covers
+      // the values read and none beyond those bricks
+      sddp->ComputePriority(0);
+      vtkInformationVector *miv =
+        info->Get(vtkDataObject::POINT_DATA_VECTOR());
+      vtkInformation *fInfo = miv ? miv->GetInformationObject(0) : NULL;
+      if (!fInfo || !fInfo->Has(vtkDataObject::PIECE_FIELD_RANGE()))
+        {
+        cerr << "test failed, no range for piece " << numers[p] << "/"
+             << denoms[p] << "@" << res << endl;
+        failed = true;
+        }
+      else
+        {
+        double *pr = fInfo->Get(vtkDataObject::PIECE_FIELD_RANGE());
+        double dr[2];
+        id->GetPointData()->GetScalars()->GetRange(dr);
+        int b0[3];
+        int b1[3];
+        for (int q = 0; q < 3; q++)
+          {
+          b0[q] = ext[2*q] / bs[q];
+          b1[q] = ext[2*q+1] / bs[q];
+          }
+        double br[2];
+        BrickedPyramidRange(n, bs, reader->GetLevel(res), b0, b1, br);
+        if (pr[0] > dr[0] || pr[1] < dr[1] || pr[0] < br[0] || pr[1] > br[1])
+          {
+          cerr << "test failed, piece " << numers[p] << "/" << denoms[p]
+               << "@" << res << " has range " << pr[0] << ".." << pr[1]
+               << " for data in " << dr[0] << ".." << dr[1]
+               << " and bricks in " << br[0] << ".." << br[1] << endl;
+          failed = true;
+          }
+        }
+      for (int k = ext[4]; k <= ext[5] && !failed; k++)
+        {
+        for (int j = ext[2]; j <= ext[3] && !failed; j++)
+          {
+          for (int i = ext[0]; i <= ext[1] && !failed; i++)
+            {
+            float v = *(float*)id->GetScalarPointer(i, j, k);
+            float e = BrickedPyramidValue(i*stride, j*stride, k*stride);
+            if (v != e)
+              {
+              cerr << "test failed, piece " << numers[p] << "/" << denoms[p]
+                   << "@" << res << " has " << v << " at "
+                   << i << "," << j << "," << k << " expected " << e << endl;
+              failed = true;
+              }
+            }
+          }
+        }
+      }
+    }
+
+  return failed;
+}
@@ -215,6 +215,36 @@ int PieceCache(int , char *[])
     failed = true;
     }
 
+  cerr << "VERIFY STATISTICS" << endl;
+  if (pcf->GetNumberOfHits() == 0 || pcf->GetNumberOfMisses() == 0 ||
+      pcf->GetCacheMemorySize() == 0)
+    {
+    cerr << pcf->GetNumberOfHits() << " " << pcf->GetNumberOfMisses() << " "
+         << pcf->GetCacheMemorySize();
+    cerr << " test failed statistics are wrong" << endl;
+    failed = true;
+    }
+
+  cerr << "VERIFY MEMORY LIMIT EVICTS INVISIBLE PIECES FIRST" << endl;
+  harness->SetPiece(2);
+  harness->Update();
+  pcf->SetPiecePriority(0, 16, 0.0, 1.0);
+  pcf->SetPiecePriority(1, 16, 1.0, 1.0);
+  pcf->SetPiecePriority(2, 16, 1.0, 1.0);
+  unsigned long limit = pcf->GetCacheMemorySize() - 1;
+  pcf->SetCacheMemoryLimit(limit);
+  p0c = pcf->InCache(0, 16, 1.0);
+  if (p0c != 0 || pcf->GetNumberOfEvictions() == 0 ||
+      pcf->GetCacheMemorySize() > limit)
+    {
+    cerr << p0c << " " << pcf->GetNumberOfEvictions() << " "
+         << pcf->GetCacheMemorySize();
+    cerr << " test failed eviction is wrong" << endl;
+    failed = true;
+    }
+  pcf->SetCacheMemoryLimit(0);
+  pcf->ClearPiecePriorities();
+
   cerr << "CHANGE UPSTREAM PIPELINE" << endl;
   contour->SetValue(0,10.0);
   harness->Update();
@@ -0,0 +1,406 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBrickedPyramidBuilder.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBrickedPyramidBuilder.h"
+
+#include "vtkBrickedPyramidReader.h"
+#include "vtkByteSwap.h"
+#include "vtkObjectFactory.h"
+
+#include "vtksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkBrickedPyramidBuilder);
+
+//----------------------------------------------------------------------------
+static int vtkBrickedPyramidBuilderSeek(FILE *fp, vtkTypeInt64 offset)
+{
+#if defined(_WIN32)
+  return _fseeki64(fp, offset, SEEK_SET);
+#else
+  return fseeko(fp, (off_t)offset, SEEK_SET);
+#endif
+}
+
+//----------------------------------------------------------------------------
+vtkBrickedPyramidBuilder::vtkBrickedPyramidBuilder()
+{
+  this->FileName = NULL;
+  this->OutputFileName = NULL;
+  this->WholeExtent[0] = this->WholeExtent[2] = this->WholeExtent[4] = 0;
+  this->WholeExtent[1] = this->WholeExtent[3] = this->WholeExtent[5] = 99;
+  this->Origin[0] = this->Origin[1] = this->Origin[2] = 0.0;
+  this->Spacing[0] = this->Spacing[1] = this->Spacing[2] = 1.0;
+  this->SwapBytes = 0;
+  this->BrickSize[0] = this->BrickSize[1] = this->BrickSize[2] = 64;
+  this->NumberOfLevels = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkBrickedPyramidBuilder::~vtkBrickedPyramidBuilder()
+{
+  this->SetFileName(NULL);
+  this->SetOutputFileName(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedPyramidBuilder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: "
+     << (this->FileName ? this->FileName : "(none)") << endl;
+  os << indent << "OutputFileName: "
+     << (this->OutputFileName ? this->OutputFileName : "(none)") << endl;
+  os << indent << "BrickSize: "
+     << this->BrickSize[0] << " " << this->BrickSize[1] << " "
+     << this->BrickSize[2] << endl;
+  os << indent << "NumberOfLevels: " << this->NumberOfLevels << endl;
+  os << indent << "SwapBytes: " << this->SwapBytes << endl;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedPyramidBuilder::Build()
+{
+  if (!this->FileName || !this->OutputFileName)
+    {
+    vtkErrorMacro(<< "Must specify input and output filenames.");
+    return 0;
+    }
+  if (this->BrickSize[0] < 1 || this->BrickSize[1] < 1 ||
+      this->BrickSize[2] < 1)
+    {
+    vtkErrorMacro(<< "Invalid brick size.");
+    return 0;
+    }
+
+  // by default stop when the coarsest level is a single brick
+  int nLevels = this->NumberOfLevels;
+  if (nLevels < 1)
+    {
+    nLevels = 1;
+    int nb[3];
+    vtkBrickedPyramidReader::GetLevelBricks(
+      this->WholeExtent, this->BrickSize, nLevels-1, nb);
+    while ((nb[0] > 1 || nb[1] > 1 || nb[2] > 1) && nLevels < 31)
+      {
+      nLevels++;
+      vtkBrickedPyramidReader::GetLevelBricks(
+        this->WholeExtent, this->BrickSize, nLevels-1, nb);
+      }
+    }
+
+  std::vector<vtkIdType> firstBrick;
+  vtkIdType nBricks = 0;
+  for (int l = 0; l < nLevels; l++)
+    {
+    int nb[3];
+    vtkBrickedPyramidReader::GetLevelBricks(
+      this->WholeExtent, this->BrickSize, l, nb);
+    firstBrick.push_back(nBricks);
+    nBricks += (vtkIdType)nb[0] * nb[1] * nb[2];
+    }
+  std::vector<float> ranges(2 * nBricks);
+
+  FILE *raw = fopen(this->FileName, "rb");
+  if (!raw)
+    {
+    vtkErrorMacro(<< "Could not open file " << this->FileName << ".");
+    return 0;
+    }
+
+  std::string dataFile = std::string(this->OutputFileName) + ".raw";
+  FILE *out = fopen(dataFile.c_str(), "w+b");
+  if (!out)
+    {
+    vtkErrorMacro(<< "Could not open file " << dataFile.c_str() << ".");
+    fclose(raw);
+    return 0;
+    }
+
+  int ok = this->BuildLevel0(raw, out, &ranges[0]);
+  fclose(raw);
+
+  for (int l = 1; ok && l < nLevels; l++)
+    {
+    ok = this->BuildLevel(l, out, out,
+                          &ranges[2 * firstBrick[l-1]],
+                          &ranges[2 * firstBrick[l]]);
+    }
+  fclose(out);
+
+  if (!ok)
+    {
+    return 0;
+    }
+
+  return this->WriteHeader(
+    vtksys::SystemTools::GetFilenameName(dataFile).c_str(),
+    nLevels, &ranges[0], nBricks);
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedPyramidBuilder::BuildLevel0(FILE *raw, FILE *out, float *ranges)
+{
+  int *bs = this->BrickSize;
+  int nb[3];
+  vtkBrickedPyramidReader::GetLevelBricks(
+    this->WholeExtent, this->BrickSize, 0, nb);
+
+  size_t ni = this->WholeExtent[1] - this->WholeExtent[0] + 1;
+  size_t nj = this->WholeExtent[3] - this->WholeExtent[2] + 1;
+  size_t nk = this->WholeExtent[5] - this->WholeExtent[4] + 1;
+
+  // one row of bricks at a time, read as whole i rows of the raw file
+  std::vector<float> slab(ni * bs[1] * bs[2]);
+  size_t brickLen = (size_t)bs[0] * bs[1] * bs[2];
+  std::vector<float> brick(brickLen);
+
+  for (int bk = 0; bk < nb[2]; bk++)
+    {
+    size_t k0 = (size_t)bk * bs[2];
+    size_t kn = (k0 + bs[2] > nk ? nk - k0 : bs[2]);
+    for (int bj = 0; bj < nb[1]; bj++)
+      {
+      size_t j0 = (size_t)bj * bs[1];
+      size_t jn = (j0 + bs[1] > nj ? nj - j0 : bs[1]);
+
+      for (size_t k = 0; k < kn; k++)
+        {
+        for (size_t j = 0; j < jn; j++)
+          {
+          float *row = &slab[0] + ni * (j + bs[1] * k);
+          vtkTypeInt64 offset = (vtkTypeInt64)sizeof(float) *
+            (vtkTypeInt64)ni * ((j0 + j) + nj * (k0 + k));
+          if (vtkBrickedPyramidBuilderSeek(raw, offset) ||
+              fread(row, sizeof(float), ni, raw) != ni)
+            {
+            vtkErrorMacro(<< "Read failure in " << this->FileName << ".");
+            return 0;
+            }
+          if (this->SwapBytes)
+            {
+            vtkByteSwap::SwapVoidRange(row, (int)ni, sizeof(float));
+            }
+          }
+        }
+
+      for (int bi = 0; bi < nb[0]; bi++)
+        {
+        size_t i0 = (size_t)bi * bs[0];
+        size_t in = (i0 + bs[0] > ni ? ni - i0 : bs[0]);
+
+        // pad past the end of the data
+        std::fill(brick.begin(), brick.end(), 0.0f);
+        float lo = VTK_FLOAT_MAX;
+        float hi = -VTK_FLOAT_MAX;
+        for (size_t k = 0; k < kn; k++)
+          {
+          for (size_t j = 0; j < jn; j++)
+            {
+            const float *src = &slab[0] + i0 + ni * (j + bs[1] * k);
+            float *dst = &brick[0] + bs[0] * (j + bs[1] * k);
+            for (size_t i = 0; i < in; i++)
+              {
+              dst[i] = src[i];
+              lo = (src[i] < lo ? src[i] : lo);
+              hi = (src[i] > hi ? src[i] : hi);
+              }
+            }
+          }
+
+        vtkIdType id = bi + (vtkIdType)nb[0] * (bj + (vtkIdType)nb[1] * bk);
+        ranges[2*id] = lo;
+        ranges[2*id+1] = hi;
+
+        vtkTypeInt64 offset = vtkBrickedPyramidReader::GetBrickOffset(
+          this->WholeExtent, this->BrickSize, 0, id);
+        if (vtkBrickedPyramidBuilderSeek(out, offset) ||
+            fwrite(&brick[0], sizeof(float), brickLen, out) != brickLen)
+          {
+          vtkErrorMacro(<< "Write failure.");
+          return 0;
+          }
+        }
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedPyramidBuilder::BuildLevel(int level, FILE *in, FILE *out,
+                                         const float *childRanges,
+                                         float *ranges)
+{
+  int *bs = this->BrickSize;
+  int nb[3];
+  int cnb[3];
+  int dims[3];
+  vtkBrickedPyramidReader::GetLevelBricks(
+    this->WholeExtent, this->BrickSize, level, nb);
+  vtkBrickedPyramidReader::GetLevelBricks(
+    this->WholeExtent, this->BrickSize, level-1, cnb);
+  vtkBrickedPyramidReader::GetLevelDimensions(this->WholeExtent, level, dims);
+
+  size_t brickLen = (size_t)bs[0] * bs[1] * bs[2];
+  std::vector<float> brick(brickLen);
+  std::vector<float> child(brickLen);
+
+  // sample x of a brick comes from sample 2x of the level below, which
+  // lives in child (2x)/bs of the pair of children under the brick.
+  std::vector<int> which[3];
+  std::vector<int> where[3];
+  for (int q = 0; q < 3; q++)
+    {
+    which[q].resize(bs[q]);
+    where[q].resize(bs[q]);
+    for (int x = 0; x < bs[q]; x++)
+      {
+      which[q][x] = (2 * x) / bs[q];
+      where[q][x] = (2 * x) % bs[q];
+      }
+    }
+
+  for (int bk = 0; bk < nb[2]; bk++)
+    {
+    int kn = (bk * bs[2] + bs[2] > dims[2] ? dims[2] - bk * bs[2] : bs[2]);
+    for (int bj = 0; bj < nb[1]; bj++)
+      {
+      int jn = (bj * bs[1] + bs[1] > dims[1] ? dims[1] - bj * bs[1] : bs[1]);
+      for (int bi = 0; bi < nb[0]; bi++)
+        {
+        int in = (bi * bs[0] + bs[0] > dims[0] ? dims[0] - bi * bs[0] : bs[0]);
+
+        std::fill(brick.begin(), brick.end(), 0.0f);
+        float lo = VTK_FLOAT_MAX;
+        float hi = -VTK_FLOAT_MAX;
+
+        for (int ck = 0; ck < 2; ck++)
+          {
+          for (int cj = 0; cj < 2; cj++)
+            {
+            for (int ci = 0; ci < 2; ci++)
+              {
+              int c[3] = {2*bi + ci, 2*bj + cj, 2*bk + ck};
+              if (c[0] >= cnb[0] || c[1] >= cnb[1] || c[2] >= cnb[2])
+                {
+                continue;
+                }
+              vtkIdType cid =
+                c[0] + (vtkIdType)cnb[0] * (c[1] + (vtkIdType)cnb[1] * c[2]);
+
+              // the brick covers all of the data under its children
+              lo = (childRanges[2*cid] < lo ? childRanges[2*cid] : lo);
+              hi = (childRanges[2*cid+1] > hi ? childRanges[2*cid+1] : hi);
+
+              vtkTypeInt64 offset = vtkBrickedPyramidReader::GetBrickOffset(
+                this->WholeExtent, this->BrickSize, level-1, cid);
+              if (vtkBrickedPyramidBuilderSeek(in, offset) ||
+                  fread(&child[0], sizeof(float), brickLen, in) != brickLen)
+                {
+                vtkErrorMacro(<< "Read failure at level " << level-1 << ".");
+                return 0;
+                }
+
+              for (int k = 0; k < kn; k++)
+                {
+                if (which[2][k] != ck)
+                  {
+                  continue;
+                  }
+                for (int j = 0; j < jn; j++)
+                  {
+                  if (which[1][j] != cj)
+                    {
+                    continue;
+                    }
+                  float *dst = &brick[0] + bs[0] * (j + bs[1] * k);
+                  const float *src = &child[0] +
+                    bs[0] * (where[1][j] + bs[1] * where[2][k]);
+                  for (int i = 0; i < in; i++)
+                    {
+                    if (which[0][i] == ci)
+                      {
+                      dst[i] = src[where[0][i]];
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+
+        vtkIdType id = bi + (vtkIdType)nb[0] * (bj + (vtkIdType)nb[1] * bk);
+        ranges[2*id] = lo;
+        ranges[2*id+1] = hi;
+
+        vtkTypeInt64 offset = vtkBrickedPyramidReader::GetBrickOffset(
+          this->WholeExtent, this->BrickSize, level, id);
+        if (vtkBrickedPyramidBuilderSeek(out, offset) ||
+            fwrite(&brick[0], sizeof(float), brickLen, out) != brickLen)
+          {
+          vtkErrorMacro(<< "Write failure.");
+          return 0;
+          }
+        }
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedPyramidBuilder::WriteHeader(const char *dataFile, int nLevels,
+                                          const float *ranges,
+                                          vtkIdType nBricks)
+{
+  ofstream header(this->OutputFileName);
+  if (!header.is_open())
+    {
+    vtkErrorMacro(<< "Could not open file " << this->OutputFileName << ".");
+    return 0;
+    }
+
+  header.precision(17);
+  header << "# vtkBrickedPyramid 1" << endl
+         << "WholeExtent "
+         << this->WholeExtent[0] << " " << this->WholeExtent[1] << " "
+         << this->WholeExtent[2] << " " << this->WholeExtent[3] << " "
+         << this->WholeExtent[4] << " " << this->WholeExtent[5] << endl
+         << "Origin "
+         << this->Origin[0] << " " << this->Origin[1] << " "
+         << this->Origin[2] << endl
+         << "Spacing "
+         << this->Spacing[0] << " " << this->Spacing[1] << " "
+         << this->Spacing[2] << endl
+         << "BrickSize "
+         << this->BrickSize[0] << " " << this->BrickSize[1] << " "
+         << this->BrickSize[2] << endl
+         << "NumberOfLevels " << nLevels << endl
+         << "ArrayName PointCenteredData" << endl
+         << "DataFile " << dataFile << endl
+         << "Ranges" << endl;
+
+  header.precision(9);
+  for (vtkIdType i = 0; i < nBricks; i++)
+    {
+    header << ranges[2*i] << " " << ranges[2*i+1] << endl;
+    }
+
+  return header.good() ? 1 : 0;
+}
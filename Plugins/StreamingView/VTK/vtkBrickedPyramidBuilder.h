@@ -0,0 +1,104 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBrickedPyramidBuilder.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkBrickedPyramidBuilder - preprocesses a raw volume for streaming
+// .SECTION Description
+// vtkBrickedPyramidBuilder converts a raw file of floats, as read by
+// vtkRawStridedReader1/2, into the bricked multiresolution layout that
+// vtkBrickedPyramidReader reads. Level 0 is copied from the raw file a slab
+// of brick rows at a time. Each coarser level is made by taking every other
+// sample of the level below, each of its bricks is made from the eight
+// bricks beneath it. The whole volume is never held in memory.
+//
+// Two files are written, a small text header (OutputFileName, .bpx by
+// convention) and the brick data next to it (OutputFileName with .raw
+// appended). The header also records, for every brick, the range of the full
+// resolution values beneath it.
+//
+// .SECTION See Also
+// vtkBrickedPyramidReader
+
+#ifndef __vtkBrickedPyramidBuilder_h
+#define __vtkBrickedPyramidBuilder_h
+
+#include "vtkObject.h"
+
+class VTK_EXPORT vtkBrickedPyramidBuilder : public vtkObject
+{
+public:
+  static vtkBrickedPyramidBuilder *New();
+  vtkTypeMacro(vtkBrickedPyramidBuilder,vtkObject);
+  virtual void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // The raw file to convert.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  // Description:
+  // The header file to write.
+  vtkSetStringMacro(OutputFileName);
+  vtkGetStringMacro(OutputFileName);
+
+  // Description:
+  // Description of the raw file, as for vtkRawStridedReader1.
+  vtkSetVector6Macro(WholeExtent, int);
+  vtkGetVector6Macro(WholeExtent, int);
+  vtkSetVector3Macro(Origin, double);
+  vtkGetVector3Macro(Origin, double);
+  vtkSetVector3Macro(Spacing, double);
+  vtkGetVector3Macro(Spacing, double);
+  vtkSetMacro(SwapBytes, int);
+  vtkGetMacro(SwapBytes, int);
+  vtkBooleanMacro(SwapBytes, int);
+
+  // Description:
+  // Number of samples in each direction of a brick. Default is 64^3.
+  vtkSetVector3Macro(BrickSize, int);
+  vtkGetVector3Macro(BrickSize, int);
+
+  // Description:
+  // Number of levels in the pyramid. When 0, the default, levels are added
+  // until the coarsest fits in a single brick.
+  vtkSetClampMacro(NumberOfLevels, int, 0, 31);
+  vtkGetMacro(NumberOfLevels, int);
+
+  // Description:
+  // Do the conversion. Returns 1 on success.
+  int Build();
+
+protected:
+  vtkBrickedPyramidBuilder();
+  ~vtkBrickedPyramidBuilder();
+
+  int BuildLevel0(FILE *raw, FILE *out, float *ranges);
+  int BuildLevel(int level, FILE *in, FILE *out,
+                 const float *childRanges, float *ranges);
+  int WriteHeader(const char *dataFile, int nLevels,
+                  const float *ranges, vtkIdType nBricks);
+
+  char *FileName;
+  char *OutputFileName;
+  int WholeExtent[6];
+  double Origin[3];
+  double Spacing[3];
+  int SwapBytes;
+  int BrickSize[3];
+  int NumberOfLevels;
+
+private:
+  vtkBrickedPyramidBuilder(const vtkBrickedPyramidBuilder&);  // Not implemented.
+  void operator=(const vtkBrickedPyramidBuilder&);  // Not implemented.
+};
+#endif
@@ -0,0 +1,702 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBrickedPyramidReader.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBrickedPyramidReader.h"
+
+#include "vtkDataArray.h"
+#include "vtkExtentTranslator.h"
+#include "vtkGridSampler1.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkIntArray.h"
+#include "vtkMetaInfoDatabase.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimerLog.h"
+
+#include "vtksys/SystemTools.hxx"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkBrickedPyramidReader);
+
+#define DEBUGPRINT_BRICKED_READER(arg)\
+  ;
+
+//----------------------------------------------------------------------------
+static int vtkBrickedPyramidSeek(FILE *fp, vtkTypeInt64 offset)
+{
+#if defined(_WIN32)
+  return _fseeki64(fp, offset, SEEK_SET);
+#else
+  return fseeko(fp, (off_t)offset, SEEK_SET);
+#endif
+}
+
+//============================================================================
+class vtkBrickedPyramidReader::vtkInternals
+{
+public:
+  vtkInternals() : HeaderTime(0), Data(0) {}
+  ~vtkInternals() { this->CloseData(); }
+
+  void CloseData()
+  {
+    if (this->Data)
+      {
+      fclose(this->Data);
+      }
+    this->Data = 0;
+  }
+
+  //header the rest of this was read from, and its modification time
+  std::string Header;
+  long int HeaderTime;
+
+  //min and max of the full resolution data under each brick,
+  //level by level, in disk order
+  std::vector<float> Ranges;
+  std::vector<vtkIdType> LevelFirstBrick;
+
+  FILE *Data;
+};
+
+//============================================================================
+vtkBrickedPyramidReader::vtkBrickedPyramidReader()
+{
+  this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(1);
+
+  this->FileName = NULL;
+  this->DataFileName = NULL;
+  this->ArrayName = NULL;
+  this->WholeExtent[0] = this->WholeExtent[2] = this->WholeExtent[4] = 0;
+  this->WholeExtent[1] = this->WholeExtent[3] = this->WholeExtent[5] = -1;
+  this->Origin[0] = this->Origin[1] = this->Origin[2] = 0.0;
+  this->Spacing[0] = this->Spacing[1] = this->Spacing[2] = 1.0;
+  this->BrickSize[0] = this->BrickSize[1] = this->BrickSize[2] = 64;
+  this->NumberOfLevels = 1;
+
+  this->Level = 0;
+  this->Resolution = 1.0;
+
+  this->RangeKeeper = vtkMetaInfoDatabase::New();
+  this->GridSampler = vtkGridSampler1::New();
+  this->Internals = new vtkInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkBrickedPyramidReader::~vtkBrickedPyramidReader()
+{
+  this->SetFileName(NULL);
+  delete [] this->DataFileName;
+  delete [] this->ArrayName;
+  this->RangeKeeper->Delete();
+  this->GridSampler->Delete();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedPyramidReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: "
+     << (this->FileName ? this->FileName : "(none)") << endl;
+  os << indent << "WholeExtent: "
+     << this->WholeExtent[0] << " " << this->WholeExtent[1] << " "
+     << this->WholeExtent[2] << " " << this->WholeExtent[3] << " "
+     << this->WholeExtent[4] << " " << this->WholeExtent[5] << endl;
+  os << indent << "BrickSize: "
+     << this->BrickSize[0] << " " << this->BrickSize[1] << " "
+     << this->BrickSize[2] << endl;
+  os << indent << "NumberOfLevels: " << this->NumberOfLevels << endl;
+}
+
+//------------------------------------------------------------------------------
+int vtkBrickedPyramidReader::CanReadFile(const char* filename)
+{
+  ifstream file(filename);
+  if (!file.is_open())
+    {
+    return 0;
+    }
+  std::string hash, magic;
+  file >> hash >> magic;
+  return (hash == "#" && magic == "vtkBrickedPyramid");
+}
+
+//------------------------------------------------------------------------------
+void vtkBrickedPyramidReader::GetLevelDimensions(
+  int wholeExtent[6], int level, int dims[3])
+{
+  for (int q = 0; q < 3; q++)
+    {
+    int n = wholeExtent[2*q+1] - wholeExtent[2*q] + 1;
+    int s = 1 << level;
+    dims[q] = n / s + (n % s > 0 ? 1 : 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkBrickedPyramidReader::GetLevelBricks(
+  int wholeExtent[6], int brickSize[3], int level, int nBricks[3])
+{
+  int dims[3];
+  vtkBrickedPyramidReader::GetLevelDimensions(wholeExtent, level, dims);
+  for (int q = 0; q < 3; q++)
+    {
+    nBricks[q] = dims[q] / brickSize[q] + (dims[q] % brickSize[q] > 0 ? 1 : 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkBrickedPyramidReader::GetBrickOffset(
+  int wholeExtent[6], int brickSize[3], int level, vtkIdType brick)
+{
+  vtkTypeInt64 brickBytes = (vtkTypeInt64)sizeof(float) *
+    brickSize[0] * brickSize[1] * brickSize[2];
+
+  vtkTypeInt64 nBefore = brick;
+  for (int l = 0; l < level; l++)
+    {
+    int nb[3];
+    vtkBrickedPyramidReader::GetLevelBricks(wholeExtent, brickSize, l, nb);
+    nBefore += (vtkTypeInt64)nb[0] * nb[1] * nb[2];
+    }
+
+  return nBefore * brickBytes;
+}
+
+//------------------------------------------------------------------------------
+int vtkBrickedPyramidReader::GetLevel(double resolution)
+{
+  if (resolution < 0.0)
+    {
+    resolution = 0.0;
+    }
+  if (resolution > 1.0)
+    {
+    resolution = 1.0;
+    }
+  return (int)((1.0 - resolution) * (this->NumberOfLevels - 1) + 0.5);
+}
+
+//------------------------------------------------------------------------------
+double vtkBrickedPyramidReader::GetLevelResolution(int level)
+{
+  if (this->NumberOfLevels < 2)
+    {
+    return 1.0;
+    }
+  return 1.0 - (double)level / (double)(this->NumberOfLevels - 1);
+}
+
+//------------------------------------------------------------------------------
+int vtkBrickedPyramidReader::ReadHeader()
+{
+  if (!this->FileName)
+    {
+    vtkErrorMacro(<< "Must specify filename.");
+    return 0;
+    }
+
+  // the file may have been rewritten under the same name
+  long int headerTime = vtksys::SystemTools::ModifiedTime(this->FileName);
+  if (this->Internals->Header == this->FileName &&
+      this->Internals->HeaderTime == headerTime)
+    {
+    return 1;
+    }
+
+  this->Internals->Header = "";
+  this->Internals->HeaderTime = 0;
+  this->Internals->CloseData();
+  this->Internals->Ranges.clear();
+  this->Internals->LevelFirstBrick.clear();
+
+  ifstream file(this->FileName);
+  if (!file.is_open())
+    {
+    vtkErrorMacro(<< "Could not open file " << this->FileName << ".");
+    return 0;
+    }
+
+  std::string dataFile;
+  std::string arrayName("PointCenteredData");
+  std::string key;
+  bool haveRanges = false;
+  while (!haveRanges && (file >> key))
+    {
+    if (key == "#")
+      {
+      std::getline(file, key);
+      }
+    else if (key == "WholeExtent")
+      {
+      for (int i = 0; i < 6; i++)
+        {
+        file >> this->WholeExtent[i];
+        }
+      }
+    else if (key == "Origin")
+      {
+      file >> this->Origin[0] >> this->Origin[1] >> this->Origin[2];
+      }
+    else if (key == "Spacing")
+      {
+      file >> this->Spacing[0] >> this->Spacing[1] >> this->Spacing[2];
+      }
+    else if (key == "BrickSize")
+      {
+      file >> this->BrickSize[0] >> this->BrickSize[1] >> this->BrickSize[2];
+      }
+    else if (key == "NumberOfLevels")
+      {
+      file >> this->NumberOfLevels;
+      }
+    else if (key == "ArrayName")
+      {
+      file >> arrayName;
+      }
+    else if (key == "DataFile")
+      {
+      file >> dataFile;
+      }
+    else if (key == "Ranges")
+      {
+      haveRanges = true;
+      }
+    else
+      {
+      vtkErrorMacro(<< "Unknown key " << key << " in " << this->FileName << ".");
+      return 0;
+      }
+    }
+
+  if (!haveRanges || dataFile.empty() || this->NumberOfLevels < 1 ||
+      this->BrickSize[0] < 1 || this->BrickSize[1] < 1 || this->BrickSize[2] < 1)
+    {
+    vtkErrorMacro(<< this->FileName << " is not a bricked pyramid header.");
+    return 0;
+    }
+
+  vtkIdType nBricks = 0;
+  for (int l = 0; l < this->NumberOfLevels; l++)
+    {
+    int nb[3];
+    vtkBrickedPyramidReader::GetLevelBricks(
+      this->WholeExtent, this->BrickSize, l, nb);
+    this->Internals->LevelFirstBrick.push_back(nBricks);
+    nBricks += (vtkIdType)nb[0] * nb[1] * nb[2];
+    }
+
+  this->Internals->Ranges.resize(2 * nBricks);
+  for (vtkIdType i = 0; i < 2 * nBricks; i++)
+    {
+    file >> this->Internals->Ranges[i];
+    }
+  if (file.fail())
+    {
+    vtkErrorMacro(<< "Missing brick ranges in " << this->FileName << ".");
+    return 0;
+    }
+
+  // data file is relative to the header
+  if (!vtksys::SystemTools::FileIsFullPath(dataFile.c_str()))
+    {
+    dataFile = vtksys::SystemTools::CollapseFullPath(
+      dataFile.c_str(),
+      vtksys::SystemTools::GetFilenamePath(this->FileName).c_str());
+    }
+  delete [] this->DataFileName;
+  this->DataFileName = vtksys::SystemTools::DuplicateString(dataFile.c_str());
+  delete [] this->ArrayName;
+  this->ArrayName = vtksys::SystemTools::DuplicateString(arrayName.c_str());
+
+  this->Internals->Header = this->FileName;
+  this->Internals->HeaderTime = headerTime;
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkBrickedPyramidReader::ReadExtent(int level, int ext[6], float *data)
+{
+  if (!this->Internals->Data)
+    {
+    this->Internals->Data = fopen(this->DataFileName, "rb");
+    if (!this->Internals->Data)
+      {
+      vtkErrorMacro(<< "Could not open file " << this->DataFileName << ".");
+      return 0;
+      }
+    }
+  FILE *fp = this->Internals->Data;
+
+  int *bs = this->BrickSize;
+  int nb[3];
+  vtkBrickedPyramidReader::GetLevelBricks(
+    this->WholeExtent, this->BrickSize, level, nb);
+
+  // requested extent relative to the level's first point
+  int le[6];
+  int b0[3];
+  int b1[3];
+  for (int q = 0; q < 3; q++)
+    {
+    le[2*q] = ext[2*q] - this->WholeExtent[2*q];
+    le[2*q+1] = ext[2*q+1] - this->WholeExtent[2*q];
+    b0[q] = le[2*q] / bs[q];
+    b1[q] = le[2*q+1] / bs[q];
+    if (le[2*q] < 0 || b1[q] >= nb[q])
+      {
+      vtkErrorMacro(<< "Extent is outside of level " << level << ".");
+      return 0;
+      }
+    }
+  size_t nx = le[1] - le[0] + 1;
+  size_t ny = le[3] - le[2] + 1;
+
+  size_t brickLen = (size_t)bs[0] * bs[1] * bs[2];
+  std::vector<float> brick(brickLen);
+
+  for (int bk = b0[2]; bk <= b1[2]; bk++)
+    {
+    for (int bj = b0[1]; bj <= b1[1]; bj++)
+      {
+      for (int bi = b0[0]; bi <= b1[0]; bi++)
+        {
+        vtkIdType id = bi + (vtkIdType)nb[0] * (bj + (vtkIdType)nb[1] * bk);
+        vtkTypeInt64 offset = vtkBrickedPyramidReader::GetBrickOffset(
+          this->WholeExtent, this->BrickSize, level, id);
+
+        if (vtkBrickedPyramidSeek(fp, offset) ||
+            fread(&brick[0], sizeof(float), brickLen, fp) != brickLen)
+          {
+          vtkErrorMacro(<< "Read failure at brick " << id
+                        << " of level " << level << ".");
+          return 0;
+          }
+
+        // the part of the brick that was asked for
+        int lo[3] = {bi * bs[0], bj * bs[1], bk * bs[2]};
+        int o[6];
+        for (int q = 0; q < 3; q++)
+          {
+          o[2*q] = (le[2*q] > lo[q] ? le[2*q] : lo[q]);
+          o[2*q+1] =
+            (le[2*q+1] < lo[q]+bs[q]-1 ? le[2*q+1] : lo[q]+bs[q]-1);
+          }
+        size_t rowLen = o[1] - o[0] + 1;
+
+        for (int k = o[4]; k <= o[5]; k++)
+          {
+          for (int j = o[2]; j <= o[3]; j++)
+            {
+            float *src = &brick[0] + (o[0] - lo[0]) +
+              bs[0] * ((j - lo[1]) + (size_t)bs[1] * (k - lo[2]));
+            float *dst = data + (o[0] - le[0]) +
+              nx * ((j - le[2]) + ny * (k - le[4]));
+            memcpy(dst, src, rowLen * sizeof(float));
+            }
+          }
+        }
+      }
+    }
+
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkBrickedPyramidReader::GetExtentRange(
+  int level, int ext[6], double range[2])
+{
+  if (level < 0 || level >= this->NumberOfLevels)
+    {
+    return 0;
+    }
+
+  int *bs = this->BrickSize;
+  int nb[3];
+  vtkBrickedPyramidReader::GetLevelBricks(
+    this->WholeExtent, this->BrickSize, level, nb);
+
+  int b0[3];
+  int b1[3];
+  for (int q = 0; q < 3; q++)
+    {
+    b0[q] = (ext[2*q] - this->WholeExtent[2*q]) / bs[q];
+    b1[q] = (ext[2*q+1] - this->WholeExtent[2*q]) / bs[q];
+    if (b0[q] < 0 || b1[q] >= nb[q] || b1[q] < b0[q])
+      {
+      return 0;
+      }
+    }
+
+  range[0] = VTK_DOUBLE_MAX;
+  range[1] = -VTK_DOUBLE_MAX;
+  const float *ranges = &this->Internals->Ranges[0] +
+    2 * this->Internals->LevelFirstBrick[level];
+  for (int bk = b0[2]; bk <= b1[2]; bk++)
+    {
+    for (int bj = b0[1]; bj <= b1[1]; bj++)
+      {
+      for (int bi = b0[0]; bi <= b1[0]; bi++)
+        {
+        vtkIdType id = bi + (vtkIdType)nb[0] * (bj + (vtkIdType)nb[1] * bk);
+        if (ranges[2*id] < range[0])
+          {
+          range[0] = ranges[2*id];
+          }
+        if (ranges[2*id+1] > range[1])
+          {
+          range[1] = ranges[2*id+1];
+          }
+        }
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedPyramidReader::RequestInformation(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector),
+  vtkInformationVector* outputVector)
+{
+  if (!this->ReadHeader())
+    {
+    return 0;
+    }
+
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  outInfo->Set(vtkDataObject::ORIGIN(), this->Origin, 3);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+               this->WholeExtent, 6);
+  outInfo->Set(vtkDataObject::SPACING(), this->Spacing, 3);
+
+  this->Level = 0;
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION()))
+    {
+    double rRes =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION());
+
+    //save split path in translator so that pieces nest across levels
+    this->GridSampler->SetWholeExtent(this->WholeExtent);
+    vtkIntArray *ia = this->GridSampler->GetSplitPath();
+    vtkExtentTranslator *et = vtkExtentTranslator::SafeDownCast(
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::EXTENT_TRANSLATOR()));
+    if (et)
+      {
+      et->SetSplitPath(ia->GetNumberOfTuples(), ia->GetPointer(0));
+      }
+
+    this->Level = this->GetLevel(rRes);
+    }
+  this->Resolution = this->GetLevelResolution(this->Level);
+
+  int dims[3];
+  vtkBrickedPyramidReader::GetLevelDimensions(
+    this->WholeExtent, this->Level, dims);
+  // Level index i samples full resolution index
+  // WholeExtent[0] + 2^level * (i - WholeExtent[0]), so the origin is moved
+  // to keep the first sample in place when the extent does not start at 0.
+  int sWholeExtent[6];
+  double sSpacing[3];
+  double sOrigin[3];
+  for (int q = 0; q < 3; q++)
+    {
+    sWholeExtent[2*q] = this->WholeExtent[2*q];
+    sWholeExtent[2*q+1] = this->WholeExtent[2*q] + dims[q] - 1;
+    sSpacing[q] = this->Spacing[q] * (1 << this->Level);
+    sOrigin[q] = this->Origin[q] +
+      (this->Spacing[q] - sSpacing[q]) * this->WholeExtent[2*q];
+    }
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+               sWholeExtent, 6);
+  outInfo->Set(vtkDataObject::SPACING(), sSpacing, 3);
+  outInfo->Set(vtkDataObject::ORIGIN(), sOrigin, 3);
+
+  // the last sample of a coarse level may fall short of the last full
+  // resolution sample, the bounds are those of the samples produced
+  double bounds[6];
+  for (int q = 0; q < 3; q++)
+    {
+    bounds[2*q] = sOrigin[q] + sSpacing[q] * sWholeExtent[2*q];
+    bounds[2*q+1] = sOrigin[q] + sSpacing[q] * sWholeExtent[2*q+1];
+    }
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_BOUNDING_BOX(),
+               bounds, 6);
+
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_FLOAT, 1);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedPyramidReader::RequestData(
+    vtkInformation* vtkNotUsed(request),
+    vtkInformationVector** vtkNotUsed(inputVector),
+    vtkInformationVector* outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkImageData *outData = vtkImageData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if (!outData)
+    {
+    vtkErrorMacro(<< "Wrong output type.");
+    return 0;
+    }
+  if (!this->ReadHeader())
+    {
+    return 0;
+    }
+  outData->Initialize();
+
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION()))
+    {
+    this->Level = this->GetLevel(
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION()));
+    this->Resolution = this->GetLevelResolution(this->Level);
+    }
+
+  vtkInformation *dInfo = outData->GetInformation();
+  dInfo->Set(vtkDataObject::DATA_RESOLUTION(), this->Resolution);
+
+  int P = outInfo->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+  int NP = outInfo->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+
+  int *uext = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT());
+  outData->SetExtent(uext);
+  outData->AllocateScalars(outInfo);
+  outData->GetPointData()->GetScalars()->SetName(this->ArrayName);
+
+  if (uext[1] < uext[0] ||
+      uext[3] < uext[2] ||
+      uext[5] < uext[4])
+    {
+    return 1;
+    }
+
+  if (!this->ReadExtent(this->Level, uext,
+                        (float*)outData->GetScalarPointer()))
+    {
+    return 0;
+    }
+
+  double range[2];
+  outData->GetPointData()->GetScalars()->GetRange(range);
+  this->RangeKeeper->Insert(P, NP, uext, this->Resolution,
+                            0, this->ArrayName, 0,
+                            range);
+
+  char message[100];
+  sprintf(message, "READ %d/%d@%f L%d %ld KB",
+          P, NP, this->Resolution, this->Level,
+          outData->GetActualMemorySize());
+  vtkTimerLog::MarkEvent(message);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedPyramidReader::ProcessRequest(vtkInformation *request,
+                   vtkInformationVector **inputVector,
+                   vtkInformationVector *outputVector)
+{
+  if(request->Has
+     (vtkStreamingDemandDrivenPipeline::REQUEST_UPDATE_EXTENT_INFORMATION()))
+    {
+    //create meta information for this piece
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double *origin = outInfo->Get(vtkDataObject::ORIGIN());
+    double *spacing = outInfo->Get(vtkDataObject::SPACING());
+    int *ext = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT());
+    int P = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    int NP = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    if (!origin || !spacing || !ext)
+      {
+      return this->Superclass::ProcessRequest
+        (request, inputVector, outputVector);
+      }
+
+    double bounds[6];
+    for (int q = 0; q < 3; q++)
+      {
+      bounds[2*q] = origin[q] + spacing[q] * ext[2*q];
+      bounds[2*q+1] = origin[q] + spacing[q] * ext[2*q+1];
+      }
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::PIECE_BOUNDING_BOX(),
+                 bounds, 6);
+
+    int ic = (ext[1]-ext[0]);
+    int jc = (ext[3]-ext[2]);
+    int kc = (ext[5]-ext[4]);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::ORIGINAL_NUMBER_OF_CELLS(),
+                 (ic < 1 ? 1 : ic) * (jc < 1 ? 1 : jc) * (kc < 1 ? 1 : kc));
+
+    int level = this->Level;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION()))
+      {
+      level = this->GetLevel(
+        outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION()));
+      }
+
+    vtkInformationVector *miv =
+      outInfo->Get(vtkDataObject::POINT_DATA_VECTOR());
+    vtkInformation *fInfo = miv->GetInformationObject(0);
+    if (!fInfo)
+      {
+      fInfo = vtkInformation::New();
+      miv->SetInformationObject(0, fInfo);
+      fInfo->Delete();
+      }
+
+    // The brick ranges cover the full resolution data under each brick,
+    // so they are known before anything is read and are never narrower
+    // than what a later refinement will find.
+    double range[2];
+    if (this->GetExtentRange(level, ext, range))
+      {
+      DEBUGPRINT_BRICKED_READER(
+        cerr << "BPR(" << this << ") range for " << P << "/" << NP
+        << "@L" << level << " is " << range[0] << ".." << range[1] << endl;
+        );
+      this->RangeKeeper->Insert(P, NP, ext, this->GetLevelResolution(level),
+                                0, this->ArrayName, 0,
+                                range);
+      }
+    if (this->RangeKeeper->Search(P, NP, ext,
+                                  0, this->ArrayName, 0,
+                                  range))
+      {
+      fInfo->Set(vtkDataObject::FIELD_ARRAY_NAME(), this->ArrayName);
+      fInfo->Set(vtkDataObject::PIECE_FIELD_RANGE(), range, 2);
+      }
+    else
+      {
+      fInfo->Remove(vtkDataObject::FIELD_ARRAY_NAME());
+      fInfo->Remove(vtkDataObject::PIECE_FIELD_RANGE());
+      }
+    }
+
+  return this->Superclass::ProcessRequest(request, inputVector, outputVector);
+}
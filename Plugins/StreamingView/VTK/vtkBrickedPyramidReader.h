@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBrickedPyramidReader.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkBrickedPyramidReader - reads a precomputed multiresolution volume
+// .SECTION Description
+// vtkBrickedPyramidReader reads the output of vtkBrickedPyramidBuilder.
+// The builder stores a raw float volume as a pyramid of resolution levels.
+// Each level is half the size of the one below it in every direction and is
+// chopped into fixed size bricks that are contiguous on disk. Level 0 is
+// full resolution.
+//
+// The requested resolution selects a level, and a piece is produced by
+// reading only the bricks of that level that it overlaps. So the amount read
+// is proportional to the detail shown rather than to the size of the file,
+// which is what the strided readers need to do.
+//
+// The builder also records the value range of every brick. These are used to
+// answer meta information requests before any data is read. The answers are
+// also kept in a vtkMetaInfoDatabase.
+//
+// .SECTION See Also
+// vtkBrickedPyramidBuilder vtkRawStridedReader2
+
+#ifndef __vtkBrickedPyramidReader_h
+#define __vtkBrickedPyramidReader_h
+
+#include "vtkImageAlgorithm.h"
+
+class vtkMetaInfoDatabase;
+class vtkGridSampler1;
+
+class VTK_EXPORT vtkBrickedPyramidReader : public vtkImageAlgorithm
+{
+public:
+  static vtkBrickedPyramidReader *New();
+  vtkTypeMacro(vtkBrickedPyramidReader,vtkImageAlgorithm);
+  virtual void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // The name of the pyramid's header file (.bpx).
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  // Description:
+  // Checks that the file is a pyramid header.
+  int CanReadFile(const char *filename);
+
+  // Description:
+  // Layout of the pyramid, available after UpdateInformation.
+  vtkGetVector6Macro(WholeExtent, int);
+  vtkGetVector3Macro(BrickSize, int);
+  vtkGetMacro(NumberOfLevels, int);
+
+  // Description:
+  // Map a resolution in [0,1] to the level that will be read, and back.
+  int GetLevel(double resolution);
+  double GetLevelResolution(int level);
+
+  // Description:
+  // Helpers that define the on disk layout, shared with the builder.
+  // Level dimensions are ceil(dims/2^level), bricks are padded to the full
+  // brick size and stored level by level with i varying fastest.
+  //BTX
+  static void GetLevelDimensions(int wholeExtent[6], int level, int dims[3]);
+  static void GetLevelBricks(
+    int wholeExtent[6], int brickSize[3], int level, int nBricks[3]);
+  static vtkTypeInt64 GetBrickOffset(
+    int wholeExtent[6], int brickSize[3], int level, vtkIdType brick);
+  //ETX
+
+protected:
+  vtkBrickedPyramidReader();
+  ~vtkBrickedPyramidReader();
+
+  // Description:
+  // Overridden to provide meta info from the brick ranges.
+  virtual int ProcessRequest(vtkInformation*,
+                             vtkInformationVector**,
+                             vtkInformationVector*);
+
+  // Description:
+  // Reads the bricks overlapping the requested extent.
+  virtual int RequestData(
+    vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector);
+
+  // Description:
+  // Overridden to produce meta information corresponding to requested
+  // resolution.
+  virtual int RequestInformation(
+    vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector);
+
+  // Description:
+  // Parse the header, only done when the file name changes.
+  int ReadHeader();
+
+  // Description:
+  // Fill data with the values of ext, in level index space.
+  int ReadExtent(int level, int ext[6], float *data);
+
+  // Description:
+  // Range of the values in ext, from the brick ranges.
+  int GetExtentRange(int level, int ext[6], double range[2]);
+
+  char *FileName;
+  char *DataFileName;
+  int WholeExtent[6];
+  double Origin[3];
+  double Spacing[3];
+  int BrickSize[3];
+  int NumberOfLevels;
+  char *ArrayName;
+
+  //actual produced resolution
+  int Level;
+  double Resolution;
+
+  //Stores meta information as it is obtained.
+  vtkMetaInfoDatabase *RangeKeeper;
+
+  //Computes the split path used by the extent translator
+  vtkGridSampler1 *GridSampler;
+
+  //per brick ranges and the header they were read from
+  class vtkInternals;
+  vtkInternals *Internals;
+
+private:
+  vtkBrickedPyramidReader(const vtkBrickedPyramidReader&);  // Not implemented.
+  void operator=(const vtkBrickedPyramidReader&);  // Not implemented.
+};
+#endif
@@ -55,6 +55,7 @@ void vtkIterativeStreamer::AddHarnessInternal(vtkStreamingHarness *harness)
   if (pcf)
     {
     pcf->SetCacheSize(this->CacheSize);
+    pcf->SetCacheMemoryLimit(this->CacheMemoryLimit);
     }
   harness->SetNumberOfPieces(this->NumberOfPasses);
 }
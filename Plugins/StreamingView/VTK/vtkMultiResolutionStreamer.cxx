@@ -89,6 +89,7 @@ void vtkMultiResolutionStreamer::AddHarnessInternal(vtkStreamingHarness *harness
   if (pcf)
     {
     pcf->SetCacheSize(this->CacheSize);
+    pcf->SetCacheMemoryLimit(this->CacheMemoryLimit);
     }
   harness->SetPass(0);
   harness->SetNumberOfPieces(1);
@@ -226,6 +227,10 @@ void vtkMultiResolutionStreamer::PrepareFirstPass()
     //skip
 
     //compute priorities for everything we are going to draw this wend
+    if (pcf)
+      {
+      pcf->ClearPiecePriorities();
+      }
     for (int i = 0; i < ToDo->GetNumberOfPieces(); i++)
       {
       vtkPiece piece = ToDo->GetPiece(i);
@@ -295,6 +300,12 @@ void vtkMultiResolutionStreamer::PrepareFirstPass()
       //don't use cached priority calculated last pass
       piece.SetCachedPriority(1.0);
 
+      //let the cache know what is worth keeping
+      if (pcf)
+        {
+        pcf->SetPiecePriority(p, np, piece.GetPriority(), res);
+        }
+
       if (!piece.GetPriority() && pcf)
         {
         //remove unimportant pieces from the cache
@@ -134,6 +134,7 @@ int vtkPieceCacheExecutive
              << updateResolution << " DR=" << dataResolution << " in slot "
              << index << endl;
              );
+          myPCF->RecordHit(index);
           //pipeline request can terminate now, yeah!
           return 0;
           }
@@ -204,6 +205,7 @@ int vtkPieceCacheExecutive
             (
              cerr << "PCE(" << this << ") SD cache hit " << updatePiece << endl;
              );
+          myPCF->RecordHit(index);
           //pipeline request can terminate now, yeah!
           return 0;
           }
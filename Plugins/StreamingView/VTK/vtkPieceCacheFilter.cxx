@@ -35,6 +35,13 @@ vtkStandardNewMacro(vtkPieceCacheFilter);
 vtkPieceCacheFilter::vtkPieceCacheFilter()
 {
   this->CacheSize = -1;
+  this->CacheMemoryLimit = 0;
+  this->CacheMemorySize = 0;
+  this->AccessCount = 0;
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  this->NumberOfRejections = 0;
   this->GetInformation()->Set(vtkAlgorithm::PRESERVES_DATASET(), 1);
   this->AppendFilter = vtkAppendPolyData::New();
   this->AppendFilter->UserManagedInputsOn();
@@ -59,6 +66,12 @@ void vtkPieceCacheFilter::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "CacheSize: " << this->CacheSize << endl;
+  os << indent << "CacheMemoryLimit: " << this->CacheMemoryLimit << endl;
+  os << indent << "CacheMemorySize: " << this->CacheMemorySize << endl;
+  os << indent << "NumberOfHits: " << this->NumberOfHits << endl;
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << endl;
+  os << indent << "NumberOfEvictions: " << this->NumberOfEvictions << endl;
+  os << indent << "NumberOfRejections: " << this->NumberOfRejections << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -78,6 +91,154 @@ void vtkPieceCacheFilter::SetCacheSize(int size)
   this->EmptyCache();
 }
 
+//----------------------------------------------------------------------------
+void vtkPieceCacheFilter::SetCacheMemoryLimit(unsigned long limit)
+{
+  //not Modified(), that would make everything in the cache stale
+  this->CacheMemoryLimit = limit;
+  this->MakeRoom(0, 0, VTK_DOUBLE_MAX, -1);
+}
+
+//----------------------------------------------------------------------------
+void vtkPieceCacheFilter::SetPiecePriority(int piece, int numPieces,
+                                           double priority, double resolution)
+{
+  int index = this->ComputeIndex(piece, numPieces);
+  this->PriorityTable[index] =
+    std::pair<double, double>(priority, resolution);
+}
+
+//----------------------------------------------------------------------------
+void vtkPieceCacheFilter::ClearPiecePriorities()
+{
+  this->PriorityTable.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkPieceCacheFilter::ResetStatistics()
+{
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfEvictions = 0;
+  this->NumberOfRejections = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPieceCacheFilter::RecordHit(int index)
+{
+  this->NumberOfHits++;
+  UsageIndex::iterator upos = this->UsageTable.find(index);
+  if (upos != this->UsageTable.end())
+    {
+    upos->second.second = ++this->AccessCount;
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkPieceCacheFilter::ComputeEvictionScore(int index,
+                                                 double dataResolution)
+{
+  if (this->PriorityTable.empty())
+    {
+    //no driver has told us anything, so everything is equally useful
+    return 2.5;
+    }
+  PriorityIndex::iterator pos = this->PriorityTable.find(index);
+  if (pos == this->PriorityTable.end())
+    {
+    //not asked for anymore, the driver has moved on to other pieces
+    return 1.0;
+    }
+  double priority = pos->second.first;
+  if (priority <= 0.0)
+    {
+    //invisible
+    return 0.0;
+    }
+  //map priority into [0,1) so that it orders pieces within a category
+  double rank = priority / (1.0 + priority);
+  if (dataResolution > pos->second.second)
+    {
+    //more detail than the view currently needs
+    return 1.0 + rank;
+    }
+  return 2.0 + rank;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPieceCacheFilter::MakeRoom(int pieces, unsigned long size,
+                                   double score, int skip)
+{
+  if ((this->CacheSize >= 0 && pieces > this->CacheSize) ||
+      (this->CacheMemoryLimit && size > this->CacheMemoryLimit))
+    {
+    return false;
+    }
+
+  while (1)
+    {
+    //what is held, not counting the slot that is about to be replaced
+    int count = static_cast<int>(this->Cache.size());
+    unsigned long held = this->CacheMemorySize;
+    UsageIndex::iterator upos = this->UsageTable.find(skip);
+    if (upos != this->UsageTable.end())
+      {
+      count--;
+      held -= upos->second.first;
+      }
+    if ((this->CacheSize < 0 || count + pieces <= this->CacheSize) &&
+        (!this->CacheMemoryLimit || held + size <= this->CacheMemoryLimit))
+      {
+      return true;
+      }
+
+    //find the least useful piece, breaking ties by least recent use
+    bool found = false;
+    int victim = 0;
+    double victimScore = 0.0;
+    unsigned long victimAccess = 0;
+    CacheType::iterator pos;
+    for (pos = this->Cache.begin(); pos != this->Cache.end(); pos++)
+      {
+      if (pos->first == skip)
+        {
+        continue;
+        }
+      vtkInformation* dataInfo = pos->second.second->GetInformation();
+      double dataResolution = 1.0;
+      if (dataInfo->Has(vtkDataObject::DATA_RESOLUTION()))
+        {
+        dataResolution = dataInfo->Get(vtkDataObject::DATA_RESOLUTION());
+        }
+      double pScore = this->ComputeEvictionScore(pos->first, dataResolution);
+      unsigned long pAccess = this->UsageTable[pos->first].second;
+      if (!found ||
+          pScore < victimScore ||
+          (pScore == victimScore && pAccess < victimAccess))
+        {
+        found = true;
+        victim = pos->first;
+        victimScore = pScore;
+        victimAccess = pAccess;
+        }
+      }
+
+    if (!found || victimScore >= score)
+      {
+      //everything left is at least as useful as what we want to add
+      return false;
+      }
+
+    DEBUGPRINT_CACHING
+      (
+       cerr << "PCF(" << this << ") Evicting slot " << victim
+       << " score " << victimScore << " for " << score << endl;
+       );
+    this->DeletePiece(victim);
+    this->NumberOfEvictions++;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkPieceCacheFilter::EmptyCache()
 {
@@ -89,6 +250,8 @@ void vtkPieceCacheFilter::EmptyCache()
     pos->second.second->Delete();
     this->Cache.erase(pos++);
     }
+  this->UsageTable.clear();
+  this->CacheMemorySize = 0;
 
   this->EmptyAppend();
 }
@@ -155,6 +318,13 @@ void vtkPieceCacheFilter::DeletePiece(int pieceNum )
     pos->second.second->Delete();
     this->Cache.erase(pos);
 
+    UsageIndex::iterator upos = this->UsageTable.find(pieceNum);
+    if (upos != this->UsageTable.end())
+      {
+      this->CacheMemorySize -= upos->second.first;
+      this->UsageTable.erase(upos);
+      }
+
     AppendIndex::iterator apos = this->AppendTable.find(pieceNum);
     if (apos != this->AppendTable.end())
       {
@@ -263,6 +433,7 @@ int vtkPieceCacheFilter::RequestData(
 
     // update the m time in the cache
     pos->second.first = outData->GetUpdateTime();
+    this->RecordHit(index);
 
     //pass the cached data onward
     DEBUGPRINT_CACHING
@@ -274,9 +445,13 @@ int vtkPieceCacheFilter::RequestData(
     return 1;
     }
 
-  //if there is space, store a copy of the data for later reuse
-  if ((this->CacheSize < 0 ||
-      this->Cache.size() < static_cast<unsigned long>(this->CacheSize)))
+  this->NumberOfMisses++;
+
+  //if there is space, or we can make some by evicting less useful pieces,
+  //store a copy of the data for later reuse
+  unsigned long size = inData->GetActualMemorySize();
+  double score = this->ComputeEvictionScore(index, updateResolution);
+  if (this->MakeRoom(1, size, score, index))
     {
     DEBUGPRINT_CACHING
       (
@@ -301,14 +476,19 @@ int vtkPieceCacheFilter::RequestData(
       {
       pos->second.second->Delete();
       this->Cache.erase(pos);
+      this->CacheMemorySize -= this->UsageTable[index].first;
       }
 
     this->Cache[index] =
       std::pair<unsigned long, vtkDataSet *>
       (outData->GetUpdateTime(), cpy);
+    this->UsageTable[index] =
+      std::pair<unsigned long, unsigned long>(size, ++this->AccessCount);
+    this->CacheMemorySize += size;
     }
   else
     {
+    this->NumberOfRejections++;
     DEBUGPRINT_CACHING
       (
        cerr << "PCF(" << this << ") Cache full. Piece "
@@ -25,6 +25,15 @@
 // This filter must be paired with a vtkPieceCacheExecutive. The Executive
 // prevents upstream filter execution in the event of a cache hit.
 //
+// The cache can be bounded by a number of pieces, by the memory the pieces
+// occupy, or both. When a bound is reached a new piece is only stored if
+// something less useful can be evicted to make room for it. Usefulness is
+// determined from the priorities that the streaming drivers report with
+// SetPiecePriority. Pieces that are invisible go first, followed by pieces
+// that are no longer being asked for, pieces that are at a higher resolution
+// than is currently wanted, and finally visible pieces in order of
+// increasing priority. Ties go to the least recently used piece.
+//
 // .SEE ALSO
 // vtkPieceCacheExecutive
 
@@ -51,6 +60,43 @@ public:
   void SetCacheSize(int size);
   vtkGetMacro(CacheSize,int);
 
+  // Description:
+  // This is the maximum amount of memory, in kibibytes, that the cached
+  // pieces can occupy. It defaults to 0, meaning unbounded.
+  void SetCacheMemoryLimit(unsigned long kibibytes);
+  vtkGetMacro(CacheMemoryLimit,unsigned long);
+
+  // Description:
+  // The amount of memory, in kibibytes, currently held by the cached pieces.
+  vtkGetMacro(CacheMemorySize,unsigned long);
+
+  //Description:
+  //Tells the cache how important a piece is to the current view and the
+  //resolution at which it is currently wanted. Drivers call this for every
+  //piece they intend to draw. Pieces with zero priority are invisible.
+  void SetPiecePriority(int piece, int numPieces,
+                        double priority, double resolution);
+
+  //Description:
+  //Forgets all priorities. Drivers call this before reporting a new set, so
+  //that cached pieces which are not reported again are known to be unneeded.
+  void ClearPiecePriorities();
+
+  //Description:
+  //Cache statistics. Hits are requests satisfied from the cache, misses are
+  //requests that had to execute upstream, evictions are pieces dropped to
+  //make room and rejections are pieces that were not stored because
+  //everything in the cache was more useful.
+  vtkGetMacro(NumberOfHits,unsigned long);
+  vtkGetMacro(NumberOfMisses,unsigned long);
+  vtkGetMacro(NumberOfEvictions,unsigned long);
+  vtkGetMacro(NumberOfRejections,unsigned long);
+  void ResetStatistics();
+
+  //Description:
+  //The executive calls this when it satisfies a request from the cache.
+  void RecordHit(int index);
+
   //Description:
   //Returns the dataset stored in the i'th cache slot.
   //Note: There is no SetPiece because Pieces are put into slots
@@ -127,6 +173,16 @@ protected:
                           vtkInformationVector **,
                           vtkInformationVector *);
 
+  //Description:
+  //Returns how useful the piece in a slot is, lower scores are evicted first.
+  double ComputeEvictionScore(int index, double dataResolution);
+
+  //Description:
+  //Evicts pieces scoring below score, never the one in slot skip, until
+  //the given number of pieces occupying size kibibytes will fit.
+  //Returns false if that is not possible.
+  bool MakeRoom(int pieces, unsigned long size, double score, int skip);
+
 //BTX
   //The cache is a map of slots to datasets. The datasets are stored with their
   //pipeline time so that they do not become stale.
@@ -145,9 +201,34 @@ protected:
     double //resolution
     > AppendIndex;
   AppendIndex AppendTable;
+
+  //Memory held by each slot, and when it was last used
+  typedef std::map<
+    int, //slot
+    std::pair<
+    unsigned long, //size in kibibytes
+    unsigned long> //access count at last use
+    > UsageIndex;
+  UsageIndex UsageTable;
+  unsigned long AccessCount;
+
+  //Priority and wanted resolution reported by the driver for each slot
+  typedef std::map<
+    int, //slot
+    std::pair<
+    double, //priority
+    double> //resolution
+    > PriorityIndex;
+  PriorityIndex PriorityTable;
 //ETX
 
   int CacheSize;
+  unsigned long CacheMemoryLimit;
+  unsigned long CacheMemorySize;
+  unsigned long NumberOfHits;
+  unsigned long NumberOfMisses;
+  unsigned long NumberOfEvictions;
+  unsigned long NumberOfRejections;
   vtkAppendPolyData *AppendFilter;
   vtkPolyData *AppendResult;
 
@@ -79,6 +79,7 @@ void vtkPrioritizedStreamer::AddHarnessInternal(vtkStreamingHarness *harness)
   if (pcf)
     {
     pcf->SetCacheSize(this->CacheSize);
+    pcf->SetCacheMemoryLimit(this->CacheMemoryLimit);
     }
   harness->SetNumberOfPieces(this->NumberOfPasses);
 }
@@ -145,6 +146,11 @@ void vtkPrioritizedStreamer::PrepareFirstPass()
       }
     //start off cleanly
     pl->Clear();
+    vtkPieceCacheFilter *pcf = harness->GetCacheFilter();
+    if (pcf)
+      {
+      pcf->ClearPiecePriorities();
+      }
 
     //compute a priority for each piece and sort them
     int max = harness->GetNumberOfPieces();
@@ -195,6 +201,12 @@ void vtkPrioritizedStreamer::PrepareFirstPass()
          );
       p.SetViewPriority(gPri);
 
+      //let the cache know what is worth keeping
+      if (pcf)
+        {
+        pcf->SetPiecePriority(i, max, p.GetPriority(), 1.0);
+        }
+
       pl->AddPiece(p);
       }
     pl->SortPriorities();
@@ -118,6 +118,7 @@ vtkStreamingDriver::vtkStreamingDriver()
 
   this->DisplayFrequency = 0;
   this->CacheSize = 32;
+  this->CacheMemoryLimit = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -376,6 +377,35 @@ void vtkStreamingDriver::SetCacheSize(int nv)
   this->Modified();
 }
 
+//------------------------------------------------------------------------------
+void vtkStreamingDriver::SetCacheMemoryLimit(unsigned long nv)
+{
+  if (this->CacheMemoryLimit == nv)
+    {
+    return;
+    }
+  this->CacheMemoryLimit = nv;
+  vtkCollection *harnesses = this->GetHarnesses();
+  if (harnesses)
+    {
+    vtkCollectionIterator *iter = harnesses->NewIterator();
+    iter->InitTraversal();
+    while(!iter->IsDoneWithTraversal())
+      {
+      vtkStreamingHarness *harness = vtkStreamingHarness::SafeDownCast
+        (iter->GetCurrentObject());
+      iter->GoToNextItem();
+      vtkPieceCacheFilter *pcf = harness->GetCacheFilter();
+      if (pcf)
+        {
+        pcf->SetCacheMemoryLimit(nv);
+        }
+      }
+    iter->Delete();
+    }
+  this->Modified();
+}
+
 //------------------------------------------------------------------------------
 void vtkStreamingDriver::CopyBackBufferToFront()
 {
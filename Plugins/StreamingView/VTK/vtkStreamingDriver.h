@@ -87,6 +87,12 @@ public:
   void SetCacheSize(int);
   vtkGetMacro(CacheSize, int);
 
+  //Description:
+  //Sets the memory limit, in kibibytes, of all of the piece cache filters
+  //for all harnesses shown in the window. Default is 0, unbounded.
+  void SetCacheMemoryLimit(unsigned long);
+  vtkGetMacro(CacheMemoryLimit, unsigned long);
+
   //Description:
   //A command to restart streaming on next render.
   virtual void RestartStreaming() = 0;
@@ -141,6 +147,7 @@ protected:
   bool ManualFinish;
 
   int CacheSize;
+  unsigned long CacheMemoryLimit;
   int DisplayFrequency;
 
 private:
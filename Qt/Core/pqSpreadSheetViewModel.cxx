@@ -61,6 +61,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <QItemSelectionModel>
 #include <QtDebug>
 #include <QPointer>
+#include <QStringList>
 
 // ParaView Includes.
 #include "pqDataRepresentation.h"
@@ -520,6 +521,48 @@ void pqSpreadSheetViewModel::sortSection (int section, Qt::SortOrder order)
     }
 }
 
+//-----------------------------------------------------------------------------
+void pqSpreadSheetViewModel::setHiddenColumns(const QList<int>& sections)
+{
+  vtkSpreadSheetView* view = this->GetView();
+  QStringList labels;
+  foreach (int section, sections)
+    {
+    if (section >= 0 && view->GetNumberOfColumns() > section)
+      {
+      labels.append(view->GetColumnName(section));
+      }
+    }
+
+  vtkSMPropertyHelper helper(this->ViewProxy, "HiddenColumnLabels");
+  QStringList current;
+  for (unsigned int cc=0; cc < helper.GetNumberOfElements(); cc++)
+    {
+    current.append(helper.GetAsString(cc));
+    }
+  if (labels == current)
+    {
+    return;
+    }
+
+  helper.SetNumberOfElements(static_cast<unsigned int>(labels.size()));
+  for (int cc=0; cc < labels.size(); cc++)
+    {
+    helper.Set(static_cast<unsigned int>(cc),
+      labels[cc].toAscii().data());
+    }
+  this->ViewProxy->UpdateVTKObjects();
+
+  // The columns stay the same, only their values are fetched again.
+  int rows = this->rowCount();
+  int columns = this->columnCount();
+  if (rows && columns)
+    {
+    emit this->dataChanged(this->index(0, 0),
+      this->index(rows-1, columns-1));
+    }
+}
+
 //-----------------------------------------------------------------------------
 bool pqSpreadSheetViewModel::isSortable(int section)
 {
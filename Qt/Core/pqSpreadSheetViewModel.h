@@ -106,6 +106,10 @@ public:
   /// Return true only if the given column is sortable.
   bool isSortable(int section);
 
+  /// Sets the columns hidden in the view. Their values are no longer
+  /// delivered by the server, and are shown empty.
+  void setHiddenColumns(const QList<int>& sections);
+
   /// Returns the field type for the data currently shown by this model.
   int getFieldType() const;
 
@@ -242,6 +242,29 @@ void pqSpreadSheetViewWidget::onHeaderDataChanged()
       this->model()->headerData(cc, Qt::Horizontal).toString();
     this->setColumnHidden(cc, pqIsColumnInternal(headerTitle));
     }
+  this->updateHiddenColumns();
+}
+
+//-----------------------------------------------------------------------------
+void pqSpreadSheetViewWidget::updateHiddenColumns()
+{
+  pqSpreadSheetViewModel* smodel = this->spreadSheetViewModel();
+  if (!smodel)
+    {
+    return;
+    }
+
+  // The internal columns are hidden but still needed.
+  QList<int> hidden;
+  for (int cc=0; cc < smodel->columnCount(); cc++)
+    {
+    QString headerTitle = smodel->headerData(cc, Qt::Horizontal).toString();
+    if (this->isColumnHidden(cc) && !pqIsColumnInternal(headerTitle))
+      {
+      hidden.append(cc);
+      }
+    }
+  smodel->setHiddenColumns(hidden);
 }
 
 //-----------------------------------------------------------------------------
@@ -306,6 +329,7 @@ void pqSpreadSheetViewWidget::onSectionDoubleClicked(int logicalindex)
       }
     }
 
+  this->updateHiddenColumns();
   if (!this->SingleColumnMode)
     {
     this->resizeColumnsToContents();
@@ -77,6 +77,10 @@ protected:
   /// Overridden to tell the pqSpreadSheetViewModel about the active viewport.
   virtual void paintEvent(QPaintEvent* event);
 
+  /// Tells the pqSpreadSheetViewModel which columns are hidden, so that their
+  /// values are not delivered.
+  void updateHiddenColumns();
+
   bool SingleColumnMode;
 private:
   Q_DISABLE_COPY(pqSpreadSheetViewWidget)
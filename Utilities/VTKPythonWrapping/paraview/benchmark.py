@@ -16,6 +16,23 @@ or
 - call parse_logs() to let the script identify and report on per frame and per
 filter execution times
 
+Third, the same information is also recorded as typed events (see
+vtkPVProfiler) which do not need to be parsed from the text logs:
+1) call enable_profiling()
+2) setup and run your visualization pipeline
+3) call get_profile_events() to gather the events from all processes, then
+- call summarize_profile() to report per filter and per category times
+or
+- call export_chrome_trace() to save a trace that can be loaded in
+chrome://tracing
+
+Fourth, run_scenarios() runs a suite of named scenarios on synthetic data
+(reading, surface extraction, delivery, compositing, image compression, state
+loading and property pushes). Its results can be saved with save_results() and
+checked for regressions against a saved baseline with compare_results().
+ParaViewCore/ServerManager/Testing/Python/BenchmarkSuite.py runs it from the
+command line.
+
 WARNING: This was meant for server side rendering, but it could work
 reasonably well when geometry is delivered to the client and rendered there
 if the script were changed to recognize MPIMoveData as end of frame and did
@@ -227,6 +244,138 @@ def print_logs() :
     for i in logs:
        i.print_log(True)
 
+profile_categories = ['other', 'filter_execute', 'data_delivery',
+                      'rendering', 'compositing', 'compression', 'transmission']
+
+def enable_profiling(enabled=True) :
+    """
+    Turns the recording of profiling events on or off on all processes.
+    """
+    profiler = paraview.servermanager.misc.Profiler()
+    profiler.Enabled = enabled
+    profiler.UpdateVTKObjects()
+
+def get_profile_events(clear=False) :
+    """
+    Gathers the profiling events recorded by all processes. Returns a list of
+    dictionaries, one per event, sorted by start time. If clear is True, the
+    events are discarded on the processes once gathered.
+    """
+    events = []
+
+    pm = paraview.servermanager.vtkProcessModule.GetProcessModule()
+    if pm == None:
+        return events
+
+    session = paraview.servermanager.ActiveConnection.Session
+    # see get_logs() for what these values are.
+    if pm.GetOptions().GetProcessType() == 0x40:
+        components = [0x04]
+    elif session.GetRenderClientMode() == 0x01:
+        components = [0x10, 0x04]
+    else:
+        components = [0x10, 0x04, 0x01]
+
+    for component in components:
+        info = paraview.servermanager.vtkPVProfilingInformation()
+        info.SetClearEvents(clear)
+        session.GatherInformation(component, info, 0)
+        for i in range(info.GetNumberOfEvents()):
+            category = info.GetEventCategory(i)
+            if category < 0 or category >= len(profile_categories):
+                category = 0
+            start = info.GetEventStartTime(i)
+            end = info.GetEventEndTime(i)
+            events.append({'component' : component,
+                           'process' : info.GetEventProcessId(i),
+                           'process_type' : info.GetEventProcessType(i),
+                           'category' : profile_categories[category],
+                           'name' : info.GetEventName(i),
+                           'start' : start,
+                           'end' : end,
+                           'duration' : end - start,
+                           'proxy_id' : info.GetEventProxyId(i),
+                           'bytes' : info.GetEventBytes(i)})
+    events.sort(key=lambda x: x['start'])
+    return events
+
+def summarize_profile(events=None) :
+    """
+    Prints the total time and bytes per category and per filter for the given
+    events, as returned by get_profile_events(). Returns the summary as a pair
+    of dictionaries keyed by category and by (filter name, proxy id).
+    """
+    if events == None:
+        events = get_profile_events()
+
+    categories = dict()
+    filters = dict()
+    for event in events:
+        record = categories.setdefault(event['category'],
+            {'count' : 0, 'duration' : 0.0, 'bytes' : 0})
+        record['count'] += 1
+        record['duration'] += event['duration']
+        record['bytes'] += event['bytes']
+        if event['category'] == 'filter_execute':
+            key = (event['name'], event['proxy_id'])
+            record = filters.setdefault(key,
+                {'count' : 0, 'duration' : 0.0, 'max' : 0.0})
+            record['count'] += 1
+            record['duration'] += event['duration']
+            record['max'] = max(record['max'], event['duration'])
+
+    print "#CATEGORY TIMINGS"
+    print "#category, count, sum duration, sum bytes"
+    for x in profile_categories:
+        if x in categories:
+            record = categories[x]
+            print x, ",", record['count'], ",",
+            print record['duration'], ",", record['bytes']
+    print
+    print "#FILTER TIMINGS"
+    print "#filter id, filter type, count, sum duration, max duration"
+    for x in sorted(filters, key=lambda k: -filters[k]['duration']):
+        record = filters[x]
+        print x[1], ",", x[0], ",", record['count'], ",",
+        print record['duration'], ",", record['max']
+    print
+    return (categories, filters)
+
+def export_chrome_trace(filename, events=None) :
+    """
+    Saves the given events, as returned by get_profile_events(), in the trace
+    event format understood by chrome://tracing. Each process shows up as a
+    separate row, named after the component it belongs to.
+    """
+    import json
+
+    if events == None:
+        events = get_profile_events()
+
+    names = {0x01 : 'dataserver', 0x04 : 'renderserver', 0x10 : 'client'}
+    trace = []
+    pids = dict()
+    for event in events:
+        key = (event['component'], event['process'])
+        if key not in pids:
+            pids[key] = len(pids)
+            trace.append({'name' : 'process_name', 'ph' : 'M',
+                          'pid' : pids[key], 'tid' : 0,
+                          'args' : {'name' : '%s %d' % \
+                            (names.get(key[0], 'process'), key[1])}})
+        trace.append({'name' : event['name'],
+                      'cat' : event['category'],
+                      'ph' : 'X',
+                      'ts' : event['start'] * 1e6,
+                      'dur' : event['duration'] * 1e6,
+                      'pid' : pids[key],
+                      'tid' : 0,
+                      'args' : {'proxy_id' : event['proxy_id'],
+                                'bytes' : event['bytes']}})
+    f = open(filename, "w")
+    json.dump({'traceEvents' : trace, 'displayTimeUnit' : 'ms'}, f)
+    f.close()
+
 def __process_frame() :
     global filters
     global current_frames_records
@@ -539,6 +688,274 @@ def parse_logs(show_parse = False, tabular = False) :
                 print record['local_duration']
             print
 
+def __time(func, repeat):
+    """Calls func repeat times and returns the wall clock time of each call."""
+    times = []
+    for i in range(repeat):
+        c1 = time.time()
+        func()
+        times.append(time.time() - c1)
+    return times
+
+def __wavelet(size):
+    return Wavelet(WholeExtent=[0, size-1, 0, size-1, 0, size-1])
+
+def __bench_reader(size, repeat, tempdir):
+    """Reads a size^3 image data from a partitioned XML file."""
+    import os.path
+    src = __wavelet(size)
+    filename = os.path.join(tempdir, "benchmark_reader.pvti")
+    writer = CreateWriter(filename, src)
+    writer.UpdatePipeline()
+    Delete(writer)
+    Delete(src)
+
+    def read():
+        reader = OpenDataFile(filename)
+        reader.UpdatePipeline()
+        Delete(reader)
+    return __time(read, repeat), (size-1)**3, 'cells'
+
+def __bench_geometry(source, repeat):
+    source.UpdatePipeline()
+    ncells = source.GetDataInformation().GetNumberOfCells()
+    def extract():
+        surface = servermanager.filters.GeometryFilter(Input=source)
+        surface.UpdatePipeline()
+        Delete(surface)
+    times = __time(extract, repeat)
+    Delete(source)
+    return times, ncells, 'cells'
+
+def __bench_geometry_image(size, repeat, tempdir):
+    """Extracts the surface of a size^3 image data with vtkPVGeometryFilter."""
+    return __bench_geometry(__wavelet(size), repeat)
+
+def __bench_geometry_unstructured(size, repeat, tempdir):
+    """Extracts the surface of a tetrahedralized size^3 image data with
+    vtkPVGeometryFilter."""
+    src = __wavelet(size)
+    tets = Tetrahedralize(Input=src)
+    times = __bench_geometry(tets, repeat)
+    Delete(src)
+    return times
+
+def __bench_geometry_amr(size, repeat, tempdir):
+    """Extracts the surface of a vtkHierarchicalFractal with
+    vtkPVGeometryFilter."""
+    src = HierarchicalFractal(Dimensions=max(2, min(64, size/4)),
+                              MaximumLevel=5)
+    return __bench_geometry(src, repeat)
+
+def __bench_delivery(size, repeat, tempdir):
+    """Collects the contour of a size^3 image data on the root process with
+    vtkMPIMoveData."""
+    src = __wavelet(size)
+    contour = Contour(Input=src, ContourBy=['POINTS', 'RTData'],
+                      Isosurfaces=[100, 150, 200])
+    contour.UpdatePipeline()
+    nbytes = contour.GetDataInformation().GetMemorySize()*1024
+    def deliver():
+        mover = servermanager.filters.MPIMoveData(Input=contour, MoveMode=1,
+                                                  OutputDataType=0)
+        mover.UpdatePipeline()
+        Delete(mover)
+    times = __time(deliver, repeat)
+    Delete(contour)
+    Delete(src)
+    return times, nbytes, 'bytes'
+
+def __benchmark_view(size):
+    src = __wavelet(size)
+    contour = Contour(Input=src, ContourBy=['POINTS', 'RTData'],
+                      Isosurfaces=[100, 150, 200])
+    view = CreateRenderView()
+    view.ViewSize = [1024, 768]
+    view.RemoteRenderThreshold = 0
+    view.LODThreshold = 1e+10
+    Show(contour, view)
+    view.ResetCamera()
+    Render(view)
+    return src, contour, view
+
+def __bench_compositing(size, repeat, tempdir):
+    """Renders and composites a 1024x768 image of the contour of a size^3
+    image data."""
+    src, contour, view = __benchmark_view(size)
+    def render():
+        view.GetActiveCamera().Azimuth(1)
+        view.StillRender()
+    times = __time(render, repeat)
+    Delete(view)
+    Delete(contour)
+    Delete(src)
+    return times, 1024*768, 'pixels'
+
+def __bench_compression(compressor, size, repeat):
+    from vtkRenderingPython import vtkWindowToImageFilter
+    src, contour, view = __benchmark_view(size)
+    grabber = vtkWindowToImageFilter()
+    grabber.SetInput(view.GetRenderWindow())
+    grabber.SetInputBufferTypeToRGBA()
+    grabber.Update()
+    image = grabber.GetOutput().GetPointData().GetScalars()
+    Delete(view)
+    Delete(contour)
+    Delete(src)
+
+    compressor.SetLossLessMode(1)
+    compressor.SetInput(image)
+    return __time(compressor.Compress, repeat), image.GetDataSize(), 'bytes'
+
+def __bench_compression_squirt(size, repeat, tempdir):
+    """Compresses a rendered RGBA image with vtkSquirtCompressor."""
+    from paraview import pvvtkextensions
+    return __bench_compression(pvvtkextensions.vtkSquirtCompressor(), size,
+                               repeat)
+
+def __bench_compression_zlib(size, repeat, tempdir):
+    """Compresses a rendered RGBA image with vtkZlibImageCompressor."""
+    from paraview import pvvtkextensions
+    return __bench_compression(pvvtkextensions.vtkZlibImageCompressor(), size,
+                               repeat)
+
+def __bench_state_load(size, repeat, tempdir):
+    """Loads a state file with a pipeline of 20 filters."""
+    import os.path
+    sources = [__wavelet(size)]
+    for i in range(20):
+        sources.append(Shrink(Input=sources[-1]))
+    filename = os.path.join(tempdir, "benchmark_state.pvsm")
+    servermanager.SaveState(filename)
+    for proxy in reversed(sources):
+        Delete(proxy)
+
+    def load():
+        existing = GetSources().values()
+        servermanager.LoadState(filename)
+        loaded = [x for x in GetSources().values() if x not in existing]
+        for proxy in loaded:
+            Delete(proxy)
+    return __time(load, repeat), len(sources), 'proxies'
+
+def __bench_property_push(size, repeat, tempdir):
+    """Pushes 1000 property changes to the servers."""
+    sphere = Sphere()
+    def push():
+        for i in range(1000):
+            sphere.ThetaResolution = 8 + (i % 2)
+    times = __time(push, repeat)
+    Delete(sphere)
+    return times, 1000, 'pushes'
+
+scenarios = { 'reader' : __bench_reader,
+              'geometry_image' : __bench_geometry_image,
+              'geometry_unstructured' : __bench_geometry_unstructured,
+              'geometry_amr' : __bench_geometry_amr,
+              'delivery' : __bench_delivery,
+              'compositing' : __bench_compositing,
+              'compression_squirt' : __bench_compression_squirt,
+              'compression_zlib' : __bench_compression_zlib,
+              'state_load' : __bench_state_load,
+              'property_push' : __bench_property_push }
+
+def run_scenarios(names=None, size=64, repeat=5, tempdir=None,
+                  profile=False) :
+    """
+    Runs the named benchmark scenarios (all of them by default) and returns a
+    list of results, one dictionary per scenario. Data scenarios work on a
+    size^3 synthetic dataset. Each scenario is timed repeat times after one
+    warm up run. If profile is True, the time spent in each category of
+    profiling events (see get_profile_events()) is added to the results.
+    """
+    import tempfile
+
+    if names == None:
+        names = sorted(scenarios.keys())
+    if tempdir == None:
+        tempdir = tempfile.gettempdir()
+
+    nprocs = servermanager.ActiveConnection.GetNumberOfDataPartitions()
+
+    results = []
+    for name in names:
+        if profile:
+            enable_profiling(True)
+            get_profile_events(True)
+        times, work, unit = scenarios[name](size, repeat+1, tempdir)
+        times = times[1:]
+        best = min(times)
+        result = {'scenario' : name,
+                  'processes' : nprocs,
+                  'size' : size,
+                  'times' : times,
+                  'min' : best,
+                  'mean' : sum(times)/len(times),
+                  'max' : max(times),
+                  'work' : work,
+                  'unit' : unit,
+                  'rate' : work/best if best > 0 else 0.0}
+        if profile:
+            totals = dict()
+            for event in get_profile_events(True):
+                totals[event['category']] = \
+                  totals.get(event['category'], 0.0) + event['duration']
+            result['profile'] = totals
+            enable_profiling(False)
+        print "%s: %g secs (min), %g %s/sec" % \
+              (name, result['min'], result['rate'], unit)
+        results.append(result)
+    return results
+
+def save_results(filename, results) :
+    """Saves results, as returned by run_scenarios(), as JSON."""
+    import json
+    f = open(filename, "w")
+    json.dump(results, f, indent=2)
+    f.close()
+
+def load_results(filename) :
+    """Loads results saved by save_results()."""
+    import json
+    f = open(filename, "r")
+    results = json.load(f)
+    f.close()
+    return results
+
+def compare_results(results, baseline, tolerance=0.25) :
+    """
+    Compares results against baseline results, as returned by
+    run_scenarios() or load_results(). A scenario regressed when its minimum
+    time exceeds the baseline one by more than the tolerance fraction.
+    Scenarios missing from the baseline, or run with a different size or
+    number of processes, are skipped. Returns the list of regressed scenario
+    names.
+    """
+    reference = dict()
+    for result in baseline:
+        reference[result['scenario']] = result
+
+    regressions = []
+    for result in results:
+        name = result['scenario']
+        if name not in reference:
+            print "%s: no baseline" % name
+            continue
+        base = reference[name]
+        if base['size'] != result['size'] or \
+           base['processes'] != result['processes']:
+            print "%s: baseline was run with a different configuration" % name
+            continue
+        ratio = result['min'] / base['min'] if base['min'] > 0 else 1.0
+        if ratio > 1.0 + tolerance:
+            print "%s: REGRESSION, %g secs vs %g secs in baseline" % \
+                  (name, result['min'], base['min'])
+            regressions.append(name)
+        else:
+            print "%s: %g secs vs %g secs in baseline" % \
+                  (name, result['min'], base['min'])
+    return regressions
+
 def __render(ss, v, title, nframes):
     print '============================================================'
     print title
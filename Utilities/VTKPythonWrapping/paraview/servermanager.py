@@ -2223,6 +2223,101 @@ def Fetch(input, arg1=None, arg2=None, idx=0):
     opc.UnRegister(None)
     return opc
 
+def _GetLeafFlatIndices(cdinfo, index=0):
+    """Returns the flat indices of the leaves below a
+    vtkPVCompositeDataInformation whose node has the given flat index,
+    together with the last flat index used by the subtree."""
+    leaves = []
+    multipiece = cdinfo.GetDataIsMultiPiece()
+    for i in range(cdinfo.GetNumberOfChildren()):
+        index += 1
+        childInfo = None
+        if not multipiece:
+            childInfo = cdinfo.GetDataInformation(i)
+        if childInfo and \
+          childInfo.GetCompositeDataInformation().GetDataIsComposite():
+            childLeaves, index = _GetLeafFlatIndices(
+                childInfo.GetCompositeDataInformation(), index)
+            leaves.extend(childLeaves)
+        else:
+            leaves.append(index)
+    return leaves, index
+
+def FetchPieces(input, arrays=None, compression=0, blocks=False, idx=0):
+    """
+    A generator that moves the data from the server to the client one chunk
+    at a time, instead of appending everything into one data object like
+    Fetch does. Only one chunk is held by the client at any time, so this
+    can be used to post-process outputs that do not fit in the client's
+    memory:
+
+    > for piece in FetchPieces(source, arrays=['Pressure'], compression=1):
+    >     process(piece)
+
+    Each chunk is the output of one server process. If blocks is True and the
+    data is composite, each chunk is instead one leaf block of one server
+    process, returned as a dataset. Chunks are yielded process by process,
+    and empty chunks are skipped.
+
+    If arrays is a list of array names, only these arrays are transferred.
+    Other arrays are removed on the server before anything is sent.
+
+    If compression is between 1 and 9, each chunk is zlib-compressed with that
+    level before it is sent to the client.
+
+    Optional argument idx is used to specify the output port number to fetch
+    the data from. Default is port 0.
+    """
+
+    numProcs = input.SMProxy.GetSession().GetServerInformation( \
+        ).GetNumberOfProcesses()
+
+    reducer = filters.ReductionFilter(Input=OutputPort(input,idx))
+    if arrays != None:
+        reducer.PassSelectedArrays = 1
+        reducer.SelectedArrays = arrays
+
+    source = reducer
+    leaves = [None]
+    cdinfo = input.GetDataInformation(idx).GetCompositeDataInformation()
+    if blocks and cdinfo.GetDataIsComposite():
+        leaves = _GetLeafFlatIndices(cdinfo)[0]
+        source = filters.ExtractBlock(Input=reducer, PruneOutput=1)
+
+    fetcher = filters.ClientServerMoveData(Input=source)
+    fetcher.CompressionLevel = compression
+
+    for piece in range(numProcs):
+        reducer.PassThrough = piece
+        for leaf in leaves:
+            if leaf != None:
+                source.BlockIndices = [leaf]
+
+            source.UpdatePipeline()
+            dataInfo = source.GetDataInformation(0)
+            if dataInfo.GetNumberOfPoints() == 0 and \
+              dataInfo.GetNumberOfCells() == 0 and \
+              dataInfo.GetNumberOfRows() == 0:
+                continue
+            dataType = dataInfo.GetDataSetType()
+            if dataInfo.GetCompositeDataSetType() > 0:
+                dataType = dataInfo.GetCompositeDataSetType()
+            fetcher.OutputDataType = dataType
+            fetcher.WholeExtent = dataInfo.GetExtent()[:]
+            fetcher.UpdatePipeline()
+
+            op = fetcher.GetClientSideObject().GetOutputDataObject(0)
+            if leaf != None:
+                iter = op.NewIterator()
+                iter.InitTraversal()
+                if iter.IsDoneWithTraversal():
+                    continue
+                op = iter.GetCurrentDataObject()
+            opc = op.NewInstance()
+            opc.ShallowCopy(op)
+            opc.UnRegister(None)
+            yield opc
+
 def AnimateReader(reader, view, filename=None):
     """This is a utility function that, given a reader and a view
     animates over all time steps of the reader. If the optional
@@ -20,12 +20,7 @@ def _cell_derivatives (narray, dataset, attribute_type, filter):
        raise RuntimeError, 'This function expects vectors.'\
                            'Input shape ' + narray.shape
 
-    # numpy_to_vtk converts only contiguous arrays
-    if not narray.flags.contiguous : narray = narray.copy()
-    varray = numpy_support.numpy_to_vtk(narray)
-
-    if attribute_type == 'scalars': varray.SetName('scalars')
-    else : varray.SetName('vectors')
+    varray = dataset_adapter.numpyTovtkDataArray(narray, attribute_type)
 
     # create a dataset with only our array but the same geometry/topology
     ds = dataset.NewInstance()
@@ -135,21 +130,12 @@ def _matrix_math_filter (narray, operation) :
        raise RuntimeError, operation+' requires an array of 2D square matrices.'\
                            'Input shape ' + narray.shape
 
-    # numpy_to_vtk converts only contiguous arrays
-    if not narray.flags.contiguous : narray = narray.copy()
-
-    # Reshape is necessary because numpy_support.numpy_to_vtk only works with 2D or
-    # less arrays.
-    nrows = narray.shape[0]
-    ncols = narray.shape[1] * narray.shape[2]
-    narray = narray.reshape(nrows, ncols)
-
     ds = dataset.NewInstance()
     ds.UnRegister(None)
     ds.ShallowCopy(dataset.VTKObject)
 
-    varray = numpy_support.numpy_to_vtk(narray)
-    varray.SetName('tensors')
+    # The matrices are flattened to 9-component tuples.
+    varray = dataset_adapter.numpyTovtkDataArray(narray, 'tensors')
 
     filter = vtk.vtkMatrixMathFilter()
 
@@ -536,3 +522,158 @@ def vertex_normal (dataset) :
 
     return ans
 
+
+# Fused evaluation of element-wise expressions
+try:
+    import ast as _ast
+except ImportError:
+    _ast = None
+
+# Functions of this module that are element-wise and can be replaced by a
+# ufunc writing into an existing buffer.
+_elementwise_functions = { abs : numpy.absolute,
+                           ln : numpy.log,
+                           log : numpy.log,
+                           log10 : numpy.log10 }
+
+if _ast:
+    _binary_ufuncs = { _ast.Add : numpy.add,
+                       _ast.Sub : numpy.subtract,
+                       _ast.Mult : numpy.multiply,
+                       _ast.Div : numpy.divide,
+                       _ast.Pow : numpy.power }
+    _unary_ufuncs = { _ast.USub : numpy.negative }
+
+class _NotElementwise(Exception):
+    pass
+
+class _FusedExpression(object):
+    """Evaluates the tree of an element-wise expression one block of tuples
+    at a time. The intermediate results only hold one block, and operations
+    write into the intermediate results of their operands whenever the types
+    allow it."""
+
+    def __init__(self, tree, global_dict, local_dict):
+        self.Values = {}
+        self.NumberOfTuples = 0
+        self.Tree = self._compile(tree, global_dict, local_dict)
+
+    def _lookup(self, name, global_dict, local_dict):
+        if name in local_dict:
+            return local_dict[name]
+        if name in global_dict:
+            return global_dict[name]
+        raise _NotElementwise()
+
+    def _compile(self, node, global_dict, local_dict):
+        """Converts the ast tree to nested tuples, resolving the names."""
+        if isinstance(node, _ast.Num):
+            return ('value', node.n)
+        if isinstance(node, _ast.Name):
+            value = self._lookup(node.id, global_dict, local_dict)
+            if isinstance(value, (int, long, float, numpy.number)):
+                return ('value', value)
+            if not isinstance(value, numpy.ndarray):
+                raise _NotElementwise()
+            value = numpy.asarray(value)
+            if value.ndim > 0 and value.shape[0] > self.NumberOfTuples:
+                self.NumberOfTuples = value.shape[0]
+            self.Values[node.id] = value
+            return ('array', node.id)
+        if isinstance(node, _ast.BinOp) and type(node.op) in _binary_ufuncs:
+            return (_binary_ufuncs[type(node.op)],
+                    self._compile(node.left, global_dict, local_dict),
+                    self._compile(node.right, global_dict, local_dict))
+        if isinstance(node, _ast.UnaryOp):
+            if isinstance(node.op, _ast.UAdd):
+                return self._compile(node.operand, global_dict, local_dict)
+            if type(node.op) in _unary_ufuncs:
+                return (_unary_ufuncs[type(node.op)],
+                        self._compile(node.operand, global_dict, local_dict))
+        if isinstance(node, _ast.Call) and isinstance(node.func, _ast.Name) \
+          and not node.keywords and not node.starargs and not node.kwargs:
+            func = self._lookup(node.func.id, global_dict, local_dict)
+            func = _elementwise_functions.get(func, func)
+            if isinstance(func, numpy.ufunc) and func.nout == 1 and \
+              func.nin == len(node.args):
+                return tuple([func] + [self._compile(arg, global_dict, local_dict)
+                                       for arg in node.args])
+        raise _NotElementwise()
+
+    def _evaluate(self, node, start, end, dest=None):
+        """Returns the value of the node for tuples [start, end) and whether
+        it is an intermediate result that can be overwritten."""
+        if node[0] == 'value':
+            return node[1], False
+        if node[0] == 'array':
+            value = self.Values[node[1]]
+            if value.ndim > 0 and value.shape[0] == self.NumberOfTuples:
+                value = value[start:end]
+            return value, False
+        operands = [self._evaluate(child, start, end) for child in node[1:]]
+        args = [operand[0] for operand in operands]
+        shape = numpy.broadcast(*args).shape
+        # A buffer is only written to if it has the type the ufunc would
+        # return, found by applying it to the first element of each array.
+        err = numpy.seterr(all='ignore')
+        try:
+            dtype = node[0](*[arg[(slice(0, 1),) * arg.ndim]
+                              if numpy.ndim(arg) > 0 else arg
+                              for arg in args]).dtype
+        finally:
+            numpy.seterr(**err)
+        out = None
+        if dest is not None and dest.shape == shape and dest.dtype == dtype:
+            out = dest
+        else:
+            for arg, temporary in operands:
+                if temporary and arg.shape == shape and arg.dtype == dtype:
+                    out = arg
+                    break
+        if out is None:
+            return node[0](*args), True
+        return node[0](*(args + [out])), True
+
+    def __call__(self, blocksize):
+        n = self.NumberOfTuples
+        end = blocksize
+        if end > n:
+            end = n
+        first = self._evaluate(self.Tree, 0, end)[0]
+        if first.ndim == 0 or first.shape[0] != end:
+            raise _NotElementwise()
+        result = numpy.empty((n,) + first.shape[1:], first.dtype)
+        result[0:end] = first
+        del first
+        for start in range(blocksize, n, blocksize):
+            end = start + blocksize
+            if end > n:
+                end = n
+            block = result[start:end]
+            value = self._evaluate(self.Tree, start, end, block)[0]
+            if value is not block:
+                block[...] = value
+        return result
+
+def evaluate(expression, global_dict=None, local_dict=None, blocksize=16384):
+    """Evaluates a Python expression, like eval(). When the expression only
+    applies arithmetic operators and element-wise functions (such as sin,
+    sqrt or log) to arrays of the same number of tuples and scalars, it is
+    evaluated blocksize tuples at a time. The only full-size allocation is
+    then the result, instead of one array per operation. Other expressions
+    are evaluated with eval()."""
+    if global_dict is None:
+        global_dict = globals()
+    if local_dict is None:
+        local_dict = global_dict
+    if _ast:
+        try:
+            tree = compile(expression.strip(), '<expression>', 'eval',
+                           _ast.PyCF_ONLY_AST).body
+            if not isinstance(tree, (_ast.Num, _ast.Name)):
+                fused = _FusedExpression(tree, global_dict, local_dict)
+                if fused.NumberOfTuples > 0:
+                    return fused(blocksize)
+        except (_NotElementwise, SyntaxError):
+            pass
+    return eval(expression, global_dict, local_dict)
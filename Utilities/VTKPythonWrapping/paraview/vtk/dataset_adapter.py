@@ -45,15 +45,31 @@ def vtkDataArrayToVTKArray(array, dataset=None):
     
 def numpyTovtkDataArray(array, name="numpy_array"):
     """Given a numpy array or a VTKArray and a name, returns a vtkDataArray.
-    The resulting vtkDataArray will store a reference to the numpy array
-    through a DeleteEvent observer: the numpy array is released only when
-    the vtkDataArray is destroyed."""
-    if not array.flags.contiguous:
-        array = array.copy()
-    vtkarray = numpy_support.numpy_to_vtk(array)
+    The vtkDataArray uses the memory of the numpy array directly: no copy
+    is made unless the array is not contiguous or its type has no VTK
+    equivalent. Arrays of more than 2 dimensions are flattened to arrays of
+    tuples. The resulting vtkDataArray will store a reference to the numpy
+    array through a DeleteEvent observer: the numpy array is released only
+    when the vtkDataArray is destroyed."""
+    array = numpy.ascontiguousarray(array)
+    if array.dtype == numpy.bool_:
+        array = array.view(numpy.uint8)
+    vtktype = numpy_support.get_vtk_array_type(array.dtype)
+    nptype = numpy.dtype(numpy_support.get_numpy_array_type(vtktype))
+    if array.dtype != nptype:
+        array = array.astype(nptype)
+
+    ncomps = 1
+    for dim in array.shape[1:]:
+        ncomps *= dim
+    flat = array.ravel()
+
+    vtkarray = numpy_support.create_vtk_array(vtktype)
+    vtkarray.SetNumberOfComponents(ncomps)
+    vtkarray.SetVoidArray(flat, len(flat), 1)
     vtkarray.SetName(name)
     # This makes the VTK array carry a reference to the numpy array.
-    vtkarray.AddObserver('DeleteEvent', MakeObserver(array))
+    vtkarray.AddObserver('DeleteEvent', MakeObserver(flat))
     return vtkarray
 
 def make_tensor_array_contiguous(array):
@@ -97,11 +113,14 @@ class VTKArray(numpy.matrix):
 
         self.VTKObject = None
         try:
-            # This line tells us that they are referring to the same buffer.
+            # This tells us that they are referring to the same buffer.
             # Much like two pointers referring to same memory location in C/C++.
-            if buffer(slf) == buffer(obj2):
+            # Only the addresses and sizes are compared, not the contents.
+            if slf.__array_interface__['data'][0] == \
+              obj2.__array_interface__['data'][0] and \
+              slf.nbytes == obj2.nbytes:
                 self.VTKObject = getattr(obj, 'VTKObject', None)
-        except TypeError:
+        except (AttributeError, TypeError):
             pass
 
         self.Association = getattr(obj, 'Association', None)
@@ -182,14 +201,9 @@ class DataSetAttributes(VTKObjectWrapper):
                  not narray.flags.contiguous):
                 narray  = narray.transpose(0, 2, 1)
 
-        # If array is not contiguous, make a deep copy that is contiguous
-        if not narray.flags.contiguous:
-            narray = narray.copy()
-
-        # Flatten array of matrices to array of vectors
-        if len(shape) == 3:
-            narray = narray.reshape(shape[0], shape[1]*shape[2])
-
+        # numpyTovtkDataArray() shares the memory of contiguous arrays and
+        # flattens arrays of matrices to arrays of vectors. Other arrays are
+        # copied once.
         arr = numpyTovtkDataArray(narray, name)
         self.VTKObject.AddArray(arr)
 